@@ -0,0 +1,146 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DCAFitterBulk.h
+/// \brief Bulk (host) processing of the 2-prong candidates with DCAFitterN
+///
+/// Most of the track pairs fed to the fitter are rejected already at the XY-crossing stage because their helices
+/// are too far in the transverse plane. This test needs only the circle parameters of the tracks, which are computed
+/// here once per track and stored as SoA, so that the test is done for many pairs at once in a branch-free (vectorized)
+/// loop. Only the pairs passing it (selection mask) are fitted by the scalar fitter, hence the results are identical to
+/// fitting all pairs one by one.
+
+#ifndef _ALICEO2_DCA_FITTER_BULK_
+#define _ALICEO2_DCA_FITTER_BULK_
+
+#include "DCAFitter/DCAFitterN.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+namespace o2
+{
+namespace vertexing
+{
+
+///< circle (helix XY projection) parameters of a set of tracks, calculated as in the DCAFitterN::process
+struct TrackCirclesSoA {
+  std::vector<float> xC, yC, rC;
+
+  size_t size() const { return rC.size(); }
+
+  void clear()
+  {
+    xC.clear();
+    yC.clear();
+    rC.clear();
+  }
+
+  void reserve(size_t n)
+  {
+    xC.reserve(n);
+    yC.reserve(n);
+    rC.reserve(n);
+  }
+
+  template <typename T>
+  void add(const T& trc, float bz)
+  {
+    o2::track::TrackAuxPar aux(trc, bz);
+    xC.push_back(aux.xC);
+    yC.push_back(aux.yC);
+    rC.push_back(aux.rC);
+  }
+
+  template <typename T>
+  void fill(const std::vector<T>& tracks, float bz)
+  {
+    clear();
+    reserve(tracks.size());
+    for (const auto& trc : tracks) {
+      add(trc, bz);
+    }
+  }
+
+  ///< true if the fitter would certainly find no crossing for the pair of circles A and B.
+  ///< Straight lines (rC = 0) are never rejected, the margin protects against the difference in the FP contraction
+  ///< between the vectorized and scalar code
+  static bool rejectXY(float xA, float yA, float rA, float xB, float yB, float rB, float maxDistXY)
+  {
+    float xDist = xB - xA, yDist = yB - yA, dist = std::sqrt(xDist * xDist + yDist * yDist);
+    return (rA > o2::constants::math::Almost0) & (rB > o2::constants::math::Almost0) & (dist - (rA + rB) > maxDistXY * 1.0001f + 1e-4f);
+  }
+};
+
+///< fill mask[k] with 1 if the pair of the track ia of the set cA with the track idB[k] of the set cB may give a candidate
+///< with the XY distance cut maxDistXY, with 0 otherwise. Returns the number of selected pairs
+inline int selectPairsXY(const TrackCirclesSoA& cA, int ia, const TrackCirclesSoA& cB, const int* idB, int n, float maxDistXY, uint8_t* mask)
+{
+  const float xA = cA.xC[ia], yA = cA.yC[ia], rA = cA.rC[ia];
+  const float *xB = cB.xC.data(), *yB = cB.yC.data(), *rB = cB.rC.data();
+  int nSel = 0;
+  for (int k = 0; k < n; k++) {
+    int ib = idB[k];
+    mask[k] = !TrackCirclesSoA::rejectXY(xA, yA, rA, xB[ib], yB[ib], rB[ib], maxDistXY);
+    nSel += mask[k];
+  }
+  return nSel;
+}
+
+///< same for the pairs of the tracks first+k of the sets cA and cB
+inline int selectPairsXY(const TrackCirclesSoA& cA, const TrackCirclesSoA& cB, size_t first, int n, float maxDistXY, uint8_t* mask)
+{
+  const float *xA = cA.xC.data() + first, *yA = cA.yC.data() + first, *rA = cA.rC.data() + first;
+  const float *xB = cB.xC.data() + first, *yB = cB.yC.data() + first, *rB = cB.rC.data() + first;
+  int nSel = 0;
+  for (int k = 0; k < n; k++) {
+    mask[k] = !TrackCirclesSoA::rejectXY(xA[k], yA[k], rA[k], xB[k], yB[k], rB[k], maxDistXY);
+    nSel += mask[k];
+  }
+  return nSel;
+}
+
+///< Fit the pairs of tracks (tracks0[i], tracks1[i]) with the fitter, calling onCandidate(i, fitter) for every pair which
+///< produced candidates. The pairs are prefiltered in blocks of BulkLanes pairs. Returns the number of pairs with candidates.
+template <typename Fitter, typename T, typename F>
+size_t processBulk(Fitter& fitter, const std::vector<T>& tracks0, const std::vector<T>& tracks1, F&& onCandidate)
+{
+  static_assert(Fitter::getNProngs() == 2, "bulk processing is implemented for 2-prong candidates only");
+  constexpr int BulkLanes = 256;
+  size_t nPairs = std::min(tracks0.size(), tracks1.size()), nFound = 0;
+  TrackCirclesSoA circ0, circ1;
+  circ0.reserve(nPairs);
+  circ1.reserve(nPairs);
+  for (size_t i = 0; i < nPairs; i++) {
+    circ0.add(tracks0[i], fitter.getBz());
+    circ1.add(tracks1[i], fitter.getBz());
+  }
+  uint8_t mask[BulkLanes];
+  for (size_t first = 0; first < nPairs; first += BulkLanes) {
+    int n = std::min(size_t(BulkLanes), nPairs - first);
+    if (!selectPairsXY(circ0, circ1, first, n, fitter.getMaxDXYIni(), mask)) {
+      continue;
+    }
+    for (int k = 0; k < n; k++) {
+      if (mask[k] && fitter.process(tracks0[first + k], tracks1[first + k])) {
+        onCandidate(first + k, fitter);
+        nFound++;
+      }
+    }
+  }
+  return nFound;
+}
+
+} // namespace vertexing
+} // namespace o2
+
+#endif
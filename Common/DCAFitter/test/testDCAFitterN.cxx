@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "DCAFitter/DCAFitterN.h"
+#include "DCAFitter/DCAFitterBulk.h"
 #include "CommonUtils/TreeStreamRedirector.h"
 #include <TRandom.h>
 #include <TGenPhaseSpace.h>
@@ -552,5 +553,58 @@ BOOST_AUTO_TEST_CASE(DCAFitterNProngs)
   outStream.Close();
 }
 
+BOOST_AUTO_TEST_CASE(DCAFitterNBulk)
+{
+  // bulk processing must give the same results as the scalar one, on the mixture of true and combinatorial pairs
+  constexpr int NTest = 10000, NComb = 10;
+  TGenPhaseSpace genPHS;
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  std::vector<double> k0dec = {pion, pion};
+  std::vector<int> forceQ{1, 1};
+  std::vector<o2::track::TrackParCov> vctracks, tracks0, tracks1;
+  Vec3D vtxGen;
+  double bz = 5.0;
+  for (int iev = 0; iev < NTest; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, k0, k0dec, forceQ);
+    tracks0.push_back(vctracks[0]);
+    tracks1.push_back(vctracks[1]);
+  }
+  for (int iev = 0; iev < NTest; iev++) {
+    for (int ic = 0; ic < NComb; ic++) {
+      tracks0.push_back(tracks0[iev]);
+      tracks1.push_back(tracks1[gRandom->Integer(NTest)]);
+    }
+  }
+  size_t nPairs = tracks0.size();
+
+  o2::vertexing::DCAFitterN<2> ft;
+  ft.setBz(bz);
+  ft.setPropagateToPCA(false);
+  std::vector<int> ncScalar(nPairs, 0), ncBulk(nPairs, 0);
+  std::vector<float> chi2Scalar(nPairs, -1), chi2Bulk(nPairs, -1);
+  TStopwatch swS, swB;
+  for (size_t i = 0; i < nPairs; i++) {
+    ncScalar[i] = ft.process(tracks0[i], tracks1[i]);
+    if (ncScalar[i]) {
+      chi2Scalar[i] = ft.getChi2AtPCACandidate();
+    }
+  }
+  swS.Stop();
+  swB.Start();
+  auto nFound = o2::vertexing::processBulk(ft, tracks0, tracks1, [&](size_t i, const auto& fitter) {
+    ncBulk[i] = fitter.getNCandidates();
+    chi2Bulk[i] = fitter.getChi2AtPCACandidate();
+  });
+  swB.Stop();
+  int nDiff = 0;
+  for (size_t i = 0; i < nPairs; i++) {
+    nDiff += ncScalar[i] != ncBulk[i] || chi2Scalar[i] != chi2Bulk[i];
+  }
+  LOG(info) << "Fitted " << nFound << " of " << nPairs << " 2-prong pairs, scalar: " << nPairs / swS.CpuTime() << " pairs/s, bulk: " << nPairs / swB.CpuTime() << " pairs/s";
+  BOOST_CHECK(nFound > 0.99 * NTest);
+  BOOST_CHECK(nDiff == 0);
+}
+
 } // namespace vertexing
 } // namespace o2
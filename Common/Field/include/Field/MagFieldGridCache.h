@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MagFieldGridCache.h
+/// \brief Definition of the tabulated magnetic field with trilinear interpolation, MagFieldGridCache
+
+#ifndef ALICEO2_FIELD_MAGFIELDGRIDCACHE_H_
+#define ALICEO2_FIELD_MAGFIELDGRIDCACHE_H_
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace o2
+{
+namespace field
+{
+// Field tabulated on the uniform cartesian grid in the box |x|,|y| < xyMax, zMin < z < zMax and interpolated trilinearly.
+// Meant as a cache of the exact parameterization for the regions queried most frequently (e.g. the barrel volume):
+// the query costs a few dozens of flops with no segment search. The interpolation error scales as step^2 times the
+// 2nd derivatives of the field, use validate to check it against the exact field for given step.
+class MagFieldGridCache
+{
+ public:
+  using FieldFunction = std::function<void(const double* xyz, double* b)>;
+
+  MagFieldGridCache() = default;
+  MagFieldGridCache(const MagFieldGridCache& src) = default;
+  ~MagFieldGridCache() = default;
+
+  /// tabulate the field provided by the function at the nodes of the grid with given step
+  void fill(const FieldFunction& fieldFun, float step = 5.f, float xyMax = 260.f, float zMin = -260.f, float zMax = 260.f);
+
+  /// max deviation (in kG) of the interpolated field from the one of the function for nPoints random points in the grid
+  float validate(const FieldFunction& fieldFun, int nPoints = 100000, float* maxDevRel = nullptr) const;
+
+  bool isInside(float x, float y, float z) const
+  {
+    return x > mMin[0] && x < mMax[0] && y > mMin[1] && y < mMax[1] && z > mMin[2] && z < mMax[2];
+  }
+
+  bool Field(const double xyz[3], double bxyz[3]) const;
+  bool Field(const float xyz[3], float bxyz[3]) const;
+
+  bool isFilled() const { return !mB.empty(); }
+  float getStep() const { return mStep; }
+  size_t getMemorySize() const { return mB.size() * sizeof(float); }
+
+ private:
+  template <typename T>
+  bool interpolate(const T* xyz, T* bxyz) const;
+
+  float mMin[3] = {0.f, 0.f, 0.f}; // low edge of the grid
+  float mMax[3] = {0.f, 0.f, 0.f}; // upper edge of the grid
+  float mStep = 0.f;               // grid step
+  float mStepInv = 0.f;            // inverse grid step
+  int mNNodes[3] = {0, 0, 0};      // number of nodes in x,y,z
+  std::vector<float> mB;           // Bx,By,Bz at the nodes, x runs fastest
+};
+
+template <typename T>
+inline bool MagFieldGridCache::interpolate(const T* xyz, T* bxyz) const
+{
+  if (!isInside(xyz[0], xyz[1], xyz[2]) || mB.empty()) {
+    return false;
+  }
+  int id[3];
+  float f[3];
+  for (int i = 0; i < 3; i++) {
+    float t = (float(xyz[i]) - mMin[i]) * mStepInv;
+    id[i] = int(t);
+    if (id[i] > mNNodes[i] - 2) {
+      id[i] = mNNodes[i] - 2;
+    }
+    f[i] = t - id[i];
+  }
+  const size_t strY = 3 * size_t(mNNodes[0]), strZ = strY * mNNodes[1];
+  const float* b000 = &mB[id[2] * strZ + id[1] * strY + 3 * id[0]];
+  const float *b010 = b000 + strY, *b001 = b000 + strZ, *b011 = b001 + strY;
+  for (int c = 0; c < 3; c++) {
+    float b00 = b000[c] + f[0] * (b000[c + 3] - b000[c]);
+    float b10 = b010[c] + f[0] * (b010[c + 3] - b010[c]);
+    float b01 = b001[c] + f[0] * (b001[c + 3] - b001[c]);
+    float b11 = b011[c] + f[0] * (b011[c + 3] - b011[c]);
+    float b0 = b00 + f[1] * (b10 - b00), b1 = b01 + f[1] * (b11 - b01);
+    bxyz[c] = b0 + f[2] * (b1 - b0);
+  }
+  return true;
+}
+
+inline bool MagFieldGridCache::Field(const double xyz[3], double bxyz[3]) const
+{
+  return interpolate(xyz, bxyz);
+}
+
+inline bool MagFieldGridCache::Field(const float xyz[3], float bxyz[3]) const
+{
+  return interpolate(xyz, bxyz);
+}
+
+} // namespace field
+} // namespace o2
+
+#endif
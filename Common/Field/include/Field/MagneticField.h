@@ -20,6 +20,7 @@
 #include "Field/MagFieldParam.h"
 #include "Field/MagneticWrapperChebyshev.h" // for MagneticWrapperChebyshev
 #include "Field/MagFieldFast.h"
+#include "Field/MagFieldGridCache.h"
 #include "TSystem.h"
 #include "Rtypes.h" // for Double_t, Char_t, Int_t, Float_t, etc
 #include "TNamed.h" // for TNamed
@@ -78,6 +79,10 @@ class MagneticField : public FairField
   /// allow fast field param
   void AllowFastField(bool v = true);
 
+  /// allow the exact field tabulated with given step in the box |x|,|y|<xyMax, zMin<z<zMax, interpolated trilinearly.
+  /// Has precedence over the fast param. Is dropped if the field factors are changed.
+  void AllowGridCache(bool v = true, float step = 5.f, float xyMax = 260.f, float zMin = -260.f, float zMax = 260.f);
+
   bool fastFieldExists() const
   {
     return !(mMapType == MagFieldParam::k5kGUniform || mDipoleOnOffFlag == true);
@@ -143,6 +148,10 @@ class MagneticField : public FairField
     bField[2] = bxyz[2];
   }
 
+  /// Method to calculate the field at n points xyz[3*i:3*i+2] in float precision: the points not served by the grid cache
+  /// or the fast param are evaluated by the batched float query of the measured map
+  void fieldBatch(int n, const float* __restrict__ xyz, float* __restrict__ bField);
+
   /// 3d field query alias for Alias Method to calculate the field at point xyz
   void GetBxyz(const Double_t p[3], Double_t* b) override { MagneticField::Field(p, b); }
 
@@ -170,6 +179,9 @@ class MagneticField : public FairField
   /// get fast field direct pointer
   const MagFieldFast* getFastField() const { return mFastField.get(); }
 
+  /// get grid cache direct pointer
+  const MagFieldGridCache* getGridCache() const { return mGridCache.get(); }
+
   // Former MagF methods or their aliases
 
   /// Sets the sign/scale of the current in the L3 according to sPolarityConvention
@@ -249,10 +261,12 @@ class MagneticField : public FairField
   void setBeamType(MagFieldParam::BeamType_t type) { mBeamType = type; }
 
   void setBeamEnergy(float energy) { mBeamEnergy = energy; }
+  void dropGridCache();
 
  private:
   std::unique_ptr<MagneticWrapperChebyshev> mMeasuredMap; //! Measured part of the field map
   std::unique_ptr<MagFieldFast> mFastField;               // ! optional fast parametrization
+  std::unique_ptr<MagFieldGridCache> mGridCache;          //! optional tabulated field
   MagFieldParam::BMap_t mMapType;                         ///< field map type
   Double_t mSolenoid;                                     ///< Solenoid field setting
   MagFieldParam::BeamType_t mBeamType;                    ///< Beam type: A-A (mBeamType=0) or p-p (mBeamType=1)
@@ -22,6 +22,7 @@
 #include "MathUtils/Chebyshev3D.h"     // for Chebyshev3D
 #include "MathUtils/Chebyshev3DCalc.h" // for _INC_CREATION_Chebyshev3D_
 #include "Rtypes.h"                    // for Double_t, Int_t, Float_t, etc
+#include <vector>
 
 namespace o2
 {
@@ -210,6 +211,33 @@ class MagneticWrapperChebyshev : public TNamed
   /// it gets it at closest valid point
   virtual void Field(const Double_t* xyz, Double_t* b) const;
 
+  /// Computes field in cartesian coordinates in float precision, see fieldBatch
+  void Field(const Float_t* xyz, Float_t* b) const { fieldBatch(1, xyz, b); }
+
+  /// Computes field in cartesian coordinates for n points xyz[3*i:3*i+2] in float precision, storing it in b[3*i:3*i+2].
+  /// The solenoid segments are taken from the flattened lookup (if built) and the points of the same segment are
+  /// evaluated together with the vectorized Chebyshev summation. The dipole region is delegated to the double precision
+  /// Field. Differs from the latter only by the float rounding (and by the choice of the segment for the points on the
+  /// boundary of 2 segments).
+  void fieldBatch(int n, const Float_t* xyz, Float_t* b) const;
+
+  /// Builds the flattened lookup of the solenoid segment in the cells of the uniform r,phi,z grid. Every cell fully
+  /// contained in the volume of a single parameterization stores its ID, other cells are resolved by the findSolenoidSegment
+  void buildSolenoidSegmentLUT(float dr = 5.f, int nPhi = 72, float dz = 5.f);
+
+  /// Returns the solenoid segment for the cylindrical point from the flattened lookup, or -1 if it cannot be resolved by it
+  Int_t getSolenoidSegmentFromLUT(const Float_t* rpz) const
+  {
+    int id[3];
+    for (int i = 0; i < 3; i++) {
+      float d = (rpz[i] - mSolenoidLUTMin[i]) * mSolenoidLUTStepInv[i];
+      if (d < 0.f || (id[i] = int(d)) >= mSolenoidLUTNBins[i]) {
+        return -1;
+      }
+    }
+    return mSolenoidSegmentLUT[(id[2] * mSolenoidLUTNBins[1] + id[1]) * mSolenoidLUTNBins[0] + id[0]];
+  }
+
   /// Computes Bz for the point in cartesian coordinates. If point is outside of the parameterized region
   /// it gets it at closest valid point
   Double_t getBz(const Double_t* xyz) const;
@@ -414,6 +442,11 @@ class MagneticWrapperChebyshev : public TNamed
   Float_t mMaxDipoleZ;                ///< Max Z of Dipole parameterization
   TObjArray* mParameterizationDipole; ///< Parameterization pieces for Dipole field
 
+  std::vector<Short_t> mSolenoidSegmentLUT;         //! flattened lookup of the solenoid segment in r,phi,z cells, -1 if not resolved
+  Float_t mSolenoidLUTMin[3] = {0.f, 0.f, 0.f};     //! low edges of the lookup in r,phi,z
+  Float_t mSolenoidLUTStepInv[3] = {0.f, 0.f, 0.f}; //! inverse cell sizes of the lookup in r,phi,z
+  Int_t mSolenoidLUTNBins[3] = {0, 0, 0};           //! number of cells of the lookup in r,phi,z (0 if not built)
+
   ClassDefOverride(o2::field::MagneticWrapperChebyshev,
                    2) // Wrapper class for the set of Chebishev parameterizations of Alice mag.field
 };
@@ -0,0 +1,87 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MagFieldGridCache.cxx
+/// \brief Implementation of the tabulated magnetic field with trilinear interpolation, MagFieldGridCache
+
+#include "Field/MagFieldGridCache.h"
+#include <fairlogger/Logger.h>
+#include <TRandom3.h>
+#include <cmath>
+#include <algorithm>
+
+using namespace o2::field;
+
+void MagFieldGridCache::fill(const FieldFunction& fieldFun, float step, float xyMax, float zMin, float zMax)
+{
+  mB.clear();
+  if (step <= 0.f || xyMax <= 0.f || zMax <= zMin) {
+    LOG(error) << "MagFieldGridCache: wrong grid definition, step=" << step << " |XY|<" << xyMax << " " << zMin << "<Z<" << zMax;
+    return;
+  }
+  mStep = step;
+  mStepInv = 1.f / step;
+  const float vmin[3] = {-xyMax, -xyMax, zMin}, vmax[3] = {xyMax, xyMax, zMax};
+  for (int i = 0; i < 3; i++) {
+    mNNodes[i] = std::max(2, int(std::ceil((vmax[i] - vmin[i]) * mStepInv)) + 1);
+    mMin[i] = vmin[i];
+    mMax[i] = vmin[i] + (mNNodes[i] - 1) * step; // may exceed the requested range by less than the step
+  }
+  mB.resize(size_t(mNNodes[0]) * mNNodes[1] * mNNodes[2] * 3);
+  double xyz[3], b[3];
+  size_t cnt = 0;
+  for (int iz = 0; iz < mNNodes[2]; iz++) {
+    xyz[2] = mMin[2] + iz * step;
+    for (int iy = 0; iy < mNNodes[1]; iy++) {
+      xyz[1] = mMin[1] + iy * step;
+      for (int ix = 0; ix < mNNodes[0]; ix++) {
+        xyz[0] = mMin[0] + ix * step;
+        b[0] = b[1] = b[2] = 0.;
+        fieldFun(xyz, b);
+        mB[cnt++] = b[0];
+        mB[cnt++] = b[1];
+        mB[cnt++] = b[2];
+      }
+    }
+  }
+  LOG(info) << "MagFieldGridCache: tabulated field in " << mMin[0] << "<X,Y<" << mMax[0] << " " << mMin[2] << "<Z<" << mMax[2]
+            << " with step " << step << " cm: " << mNNodes[0] << "x" << mNNodes[1] << "x" << mNNodes[2] << " nodes, "
+            << getMemorySize() / (1024. * 1024.) << " MB";
+}
+
+float MagFieldGridCache::validate(const FieldFunction& fieldFun, int nPoints, float* maxDevRel) const
+{
+  float maxDev = 0.f, maxRel = 0.f;
+  double xyz[3], bExact[3], bGrid[3];
+  TRandom3 rnd(1234); // fixed seed: the validation is reproducible and does not alter the state of gRandom
+  for (int ip = 0; ip < nPoints; ip++) {
+    for (int i = 0; i < 3; i++) {
+      xyz[i] = mMin[i] + rnd.Rndm() * (mMax[i] - mMin[i]);
+    }
+    if (!Field(xyz, bGrid)) {
+      continue;
+    }
+    bExact[0] = bExact[1] = bExact[2] = 0.;
+    fieldFun(xyz, bExact);
+    double bMod = std::sqrt(bExact[0] * bExact[0] + bExact[1] * bExact[1] + bExact[2] * bExact[2]);
+    for (int i = 0; i < 3; i++) {
+      float dev = std::abs(bGrid[i] - bExact[i]);
+      maxDev = std::max(maxDev, dev);
+      if (bMod > 0.) {
+        maxRel = std::max(maxRel, float(dev / bMod));
+      }
+    }
+  }
+  if (maxDevRel) {
+    *maxDevRel = maxRel;
+  }
+  return maxDev;
+}
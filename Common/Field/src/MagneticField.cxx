@@ -18,6 +18,7 @@
 #include <TPRegexp.h>   // for TPRegexp
 #include <TSystem.h>    // for TSystem, gSystem
 #include <fairlogger/Logger.h> // for FairLogger
+#include <algorithm>
 #include "FairParamList.h"
 #include "FairRun.h"
 #include "FairRuntimeDb.h"
@@ -266,6 +267,9 @@ void MagneticField::Field(const Double_t* __restrict__ xyz, Double_t* __restrict
    */
 
   //  b[0]=b[1]=b[2]=0.0;
+  if (mGridCache && mGridCache->Field(xyz, b)) {
+    return;
+  }
   if (mFastField && mFastField->Field(xyz, b)) {
     return;
   }
@@ -292,6 +296,12 @@ Double_t MagneticField::getBz(const Double_t* xyz) const
    * query field Bz component at point
    */
 
+  if (mGridCache) {
+    double b[3];
+    if (mGridCache->Field(xyz, b)) {
+      return b[2];
+    }
+  }
   if (mFastField) {
     double bz = 0;
     if (mFastField->GetBz(xyz, bz)) {
@@ -329,6 +339,7 @@ MagneticField& MagneticField::operator=(const MagneticField& src)
     mDipoleOnOffFlag = src.mDipoleOnOffFlag;
     mParameterNames = src.mParameterNames;
     mFastField.reset(src.mFastField ? new MagFieldFast(*src.getFastField()) : nullptr);
+    mGridCache.reset(src.mGridCache ? new MagFieldGridCache(*src.getGridCache()) : nullptr);
   }
   return *this;
 }
@@ -492,6 +503,7 @@ void MagneticField::setFactorSolenoid(Float_t fc)
   if (mFastField) {
     mFastField->setFactorSol(getFactorSolenoid());
   }
+  dropGridCache();
 }
 
 void MagneticField::setFactorDipole(Float_t fc)
@@ -507,6 +519,7 @@ void MagneticField::setFactorDipole(Float_t fc)
       mMultipicativeFactorDipole = fc;
       break; // case kConvMap2005: mMultipicativeFactorDipole =  fc; break;
   }
+  dropGridCache();
 }
 
 Double_t MagneticField::getFactorSolenoid() const
@@ -726,3 +739,64 @@ void MagneticField::AllowFastField(bool v)
     mFastField.reset(nullptr);
   }
 }
+
+void MagneticField::AllowGridCache(bool v, float step, float xyMax, float zMin, float zMax)
+{
+  mGridCache.reset(nullptr);
+  if (v) {
+    auto fast = std::move(mFastField); // tabulate the exact field
+    auto cache = std::make_unique<MagFieldGridCache>();
+    cache->fill([this](const double* xyz, double* b) { Field(xyz, b); }, step, xyMax, zMin, zMax);
+    float maxDevRel = 0.f, maxDev = cache->validate([this](const double* xyz, double* b) { Field(xyz, b); }, 10000, &maxDevRel);
+    LOG(info) << "MagneticField: grid cache max deviation from the exact field: " << maxDev << " kG (" << maxDevRel * 100. << "% of |B|)";
+    mFastField = std::move(fast);
+    mGridCache = std::move(cache);
+  }
+}
+
+void MagneticField::dropGridCache()
+{
+  if (mGridCache) {
+    LOG(warning) << "MagneticField: field factors were changed, dropping the grid cache";
+    mGridCache.reset(nullptr);
+  }
+}
+
+void MagneticField::fieldBatch(int n, const float* __restrict__ xyz, float* __restrict__ b)
+{
+  constexpr int Chunk = 256;
+  float xyzM[3 * Chunk], bM[3 * Chunk];
+  int idM[Chunk];
+  for (int first = 0; first < n; first += Chunk) {
+    int nc = std::min(Chunk, n - first), nM = 0;
+    for (int i = first; i < first + nc; i++) {
+      const float* p = xyz + 3 * i;
+      float* bp = b + 3 * i;
+      if ((mGridCache && mGridCache->Field(p, bp)) || (mFastField && mFastField->Field(p, bp))) {
+        continue;
+      }
+      if (mMeasuredMap && p[2] > mMeasuredMap->getMinZ() && p[2] < mMeasuredMap->getMaxZ()) {
+        for (int j = 0; j < 3; j++) {
+          xyzM[3 * nM + j] = p[j];
+        }
+        idM[nM++] = i;
+        continue;
+      }
+      double xyzD[3] = {p[0], p[1], p[2]}, bD[3] = {0., 0., 0.};
+      MachineField(xyzD, bD);
+      bp[0] = bD[0];
+      bp[1] = bD[1];
+      bp[2] = bD[2];
+    }
+    if (nM) {
+      mMeasuredMap->fieldBatch(nM, xyzM, bM);
+      for (int k = 0; k < nM; k++) {
+        float* bp = b + 3 * idM[k];
+        float fact = (xyzM[3 * k + 2] > sSolenoidToDipoleZ || mDipoleOnOffFlag) ? mMultipicativeFactorSolenoid : mMultipicativeFactorDipole;
+        for (int j = 0; j < 3; j++) {
+          bp[j] = bM[3 * k + j] * fact;
+        }
+      }
+    }
+  }
+}
@@ -25,6 +25,9 @@
 #include "TNamed.h"     // for TNamed
 #include "TObjArray.h"  // for TObjArray
 #include "TString.h"    // for TString
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace o2::field;
 using namespace o2::math_utils;
@@ -291,6 +294,12 @@ void MagneticWrapperChebyshev::copyFrom(const MagneticWrapperChebyshev& src)
       mParameterizationDipole->AddAtAndExpand(new Chebyshev3D(*src.getParameterDipole(i)), i);
     }
   }
+  mSolenoidSegmentLUT = src.mSolenoidSegmentLUT;
+  for (int i = 0; i < 3; i++) {
+    mSolenoidLUTMin[i] = src.mSolenoidLUTMin[i];
+    mSolenoidLUTStepInv[i] = src.mSolenoidLUTStepInv[i];
+    mSolenoidLUTNBins[i] = src.mSolenoidLUTNBins[i];
+  }
 }
 
 MagneticWrapperChebyshev& MagneticWrapperChebyshev::operator=(const MagneticWrapperChebyshev& rhs)
@@ -304,6 +313,8 @@ MagneticWrapperChebyshev& MagneticWrapperChebyshev::operator=(const MagneticWrap
 
 void MagneticWrapperChebyshev::Clear(const Option_t*)
 {
+  mSolenoidSegmentLUT.clear();
+  mSolenoidLUTNBins[0] = mSolenoidLUTNBins[1] = mSolenoidLUTNBins[2] = 0;
   if (mNumberOfParameterizationSolenoid) {
     mParameterizationSolenoid->SetOwner(kTRUE);
     delete mParameterizationSolenoid;
@@ -445,6 +456,159 @@ void MagneticWrapperChebyshev::Field(const Double_t* xyz, Double_t* b) const
   par->Eval(xyz, b);
 }
 
+namespace
+{
+// atan2 in float precision w/o library call, so that the loop over the points vectorizes: the ratio of the smaller to the larger
+// coordinate is reduced to [-tan(pi/8), tan(pi/8)] where the cephes atanf polynomial is used, the octant is restored by selects
+inline float atan2Poly(float y, float x)
+{
+  constexpr float Pi = 3.14159265358979f, TanPi8 = 0.414213562f;
+  const float ax = std::abs(x), ay = std::abs(y), mx = std::max(ax, ay), mn = std::min(ax, ay);
+  const bool big = mn > TanPi8 * mx; // atan(mn / mx) = pi / 4 + atan((mn - mx) / (mn + mx))
+  const float num = big ? mn - mx : mn, den = big ? mn + mx : mx;
+  const float t = den > 0.f ? num / den : 0.f, t2 = t * t;
+  float phi = (big ? Pi / 4 : 0.f) + ((((8.05374449538e-2f * t2 - 1.38776856032e-1f) * t2 + 1.99777106478e-1f) * t2 - 3.33329491539e-1f) * t2 * t + t);
+  phi = ay > ax ? Pi / 2 - phi : phi;
+  phi = x < 0.f ? Pi - phi : phi;
+  return std::copysign(phi, y);
+}
+} // namespace
+
+void MagneticWrapperChebyshev::fieldBatch(int n, const Float_t* xyz, Float_t* b) const
+{
+  constexpr int MaxBatch = Chebyshev3DCalc::MaxBatch;
+  constexpr int BlockSize = 8 * MaxBatch; // points of the block are grouped by segment
+  float rpz[BlockSize][3], csn[BlockSize][2], arg[3][MaxBatch], res[3][MaxBatch];
+  int segID[BlockSize], order[BlockSize];
+
+  for (int first = 0; first < n; first += BlockSize) {
+    int nb = std::min(BlockSize, n - first), nSol = 0;
+    const float* xyzB = xyz + 3 * first;
+    float* bB = b + 3 * first;
+    for (int i = 0; i < nb; i++) { // cylindrical coordinates, directions cosines to convert the field back to cartesian frame
+      const float* p = xyzB + 3 * i;
+      float r = std::sqrt(p[0] * p[0] + p[1] * p[1]), rInv = r > 0.f ? 1.f / r : 0.f;
+      rpz[i][0] = r;
+      rpz[i][1] = atan2Poly(p[1], p[0]); // within 3e-7 of std::atan2
+      rpz[i][2] = p[2];
+      csn[i][0] = r > 0.f ? p[0] * rInv : 1.f;
+      csn[i][1] = p[1] * rInv;
+    }
+    for (int i = 0; i < nb; i++) { // segments
+      const float* p = xyzB + 3 * i;
+      float* bp = bB + 3 * i;
+      segID[i] = -1;
+      if (p[2] > mMinZSolenoid) {
+        int id = getSolenoidSegmentFromLUT(rpz[i]);
+        if (id < 0) { // not resolved by the lookup
+          Double_t rpzD[3] = {rpz[i][0], rpz[i][1], rpz[i][2]};
+          id = findSolenoidSegment(rpzD);
+#ifndef _BRING_TO_BOUNDARY_ // exact matching to fitted volume is requested
+          if (id >= 0 && !getParameterSolenoid(id)->isInside(rpzD)) {
+            id = -1;
+          }
+#endif
+        }
+        if (id < 0) {
+          bp[0] = bp[1] = bp[2] = 0.f;
+        } else {
+          segID[i] = id;
+          order[nSol++] = i;
+        }
+      } else { // dipole region is rare, use standard query
+        Double_t xyzD[3] = {p[0], p[1], p[2]}, bD[3] = {0., 0., 0.};
+        Field(xyzD, bD);
+        bp[0] = bD[0];
+        bp[1] = bD[1];
+        bp[2] = bD[2];
+      }
+    }
+    // evaluate together the points of the same segment
+    std::stable_sort(order, order + nSol, [&segID](int i0, int i1) { return segID[i0] < segID[i1]; });
+    for (int is = 0; is < nSol;) {
+      int id = segID[order[is]], nl = 0;
+      const Chebyshev3D* par = getParameterSolenoid(id);
+      const float *scale = par->getBoundaryMappingScale(), *offs = par->getBoundaryMappingOffset();
+      while (is + nl < nSol && nl < MaxBatch && segID[order[is + nl]] == id) {
+        const float* pnt = rpz[order[is + nl]];
+        for (int d = 0; d < 3; d++) {
+          arg[d][nl] = (pnt[d] - offs[d]) * scale[d];
+        }
+        nl++;
+      }
+      for (int c = 0; c < 3; c++) {
+        par->getChebyshevCalc(c)->Eval(nl, arg[0], arg[1], arg[2], res[c]);
+      }
+      for (int k = 0; k < nl; k++) { // Br, Bphi, Bz -> Bx, By, Bz
+        int i = order[is + k];
+        float* bp = bB + 3 * i;
+        bp[0] = res[0][k] * csn[i][0] - res[1][k] * csn[i][1];
+        bp[1] = res[0][k] * csn[i][1] + res[1][k] * csn[i][0];
+        bp[2] = res[2][k];
+      }
+      is += nl;
+    }
+  }
+}
+
+void MagneticWrapperChebyshev::buildSolenoidSegmentLUT(float dr, int nPhi, float dz)
+{
+  mSolenoidSegmentLUT.clear();
+  mSolenoidLUTNBins[0] = mSolenoidLUTNBins[1] = mSolenoidLUTNBins[2] = 0;
+  if (!mNumberOfParameterizationSolenoid || dr <= 0.f || dz <= 0.f || nPhi < 1) {
+    return;
+  }
+  if (mNumberOfParameterizationSolenoid > std::numeric_limits<Short_t>::max()) {
+    LOG(warning) << "MagneticWrapperChebyshev: too many solenoid parameterizations (" << mNumberOfParameterizationSolenoid << ") for the segments lookup";
+    return;
+  }
+  const float rMin[3] = {0.f, -float(TMath::Pi()), mMinZSolenoid}, rMax[3] = {mMaxRadiusSolenoid, float(TMath::Pi()), mMaxZSolenoid};
+  int nBins[3] = {std::max(1, int(std::ceil(mMaxRadiusSolenoid / dr))), nPhi, std::max(1, int(std::ceil((mMaxZSolenoid - mMinZSolenoid) / dz)))};
+  double step[3];
+  for (int i = 0; i < 3; i++) {
+    step[i] = (rMax[i] - rMin[i]) / nBins[i];
+  }
+  std::vector<Short_t> lut(size_t(nBins[0]) * nBins[1] * nBins[2], -1);
+  size_t nResolved = 0;
+  for (int iz = 0; iz < nBins[2]; iz++) {
+    for (int ip = 0; ip < nBins[1]; ip++) {
+      for (int ir = 0; ir < nBins[0]; ir++) {
+        const int ib[3] = {ir, ip, iz};
+        Double_t low[3], upp[3], cen[3];
+        for (int i = 0; i < 3; i++) {
+          low[i] = rMin[i] + ib[i] * step[i];
+          upp[i] = low[i] + step[i];
+          cen[i] = 0.5 * (low[i] + upp[i]);
+        }
+        int id = findSolenoidSegment(cen);
+        if (id < 0) {
+          continue;
+        }
+        const Chebyshev3D* par = getParameterSolenoid(id);
+        bool contained = true;
+        for (int i = 0; i < 3; i++) {
+          if (low[i] < par->getBoundMin(i) || upp[i] > par->getBoundMax(i)) {
+            contained = false;
+            break;
+          }
+        }
+        if (contained) {
+          lut[(size_t(iz) * nBins[1] + ip) * nBins[0] + ir] = id;
+          nResolved++;
+        }
+      }
+    }
+  }
+  mSolenoidSegmentLUT.swap(lut);
+  for (int i = 0; i < 3; i++) {
+    mSolenoidLUTMin[i] = rMin[i];
+    mSolenoidLUTStepInv[i] = 1. / step[i];
+    mSolenoidLUTNBins[i] = nBins[i];
+  }
+  LOG(info) << "MagneticWrapperChebyshev: solenoid segments lookup with " << nBins[0] << "x" << nBins[1] << "x" << nBins[2]
+            << " R,Phi,Z cells, " << nResolved << " of them are resolved";
+}
+
 Double_t MagneticWrapperChebyshev::getBz(const Double_t* xyz) const
 {
   Double_t rphiz[3];
@@ -1098,6 +1262,8 @@ void MagneticWrapperChebyshev::resetDipole()
 
 void MagneticWrapperChebyshev::resetSolenoid()
 {
+  mSolenoidSegmentLUT.clear();
+  mSolenoidLUTNBins[0] = mSolenoidLUTNBins[1] = mSolenoidLUTNBins[2] = 0;
   if (mNumberOfParameterizationSolenoid) {
     delete mParameterizationSolenoid;
     mParameterizationSolenoid = nullptr;
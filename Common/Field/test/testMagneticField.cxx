@@ -20,6 +20,9 @@
 #include <fairlogger/Logger.h> // for FairLogger
 #include <TStopwatch.h>
 #include <TRandom.h>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 
 using namespace o2::field;
 
@@ -98,3 +101,97 @@ BOOST_AUTO_TEST_CASE(MagneticField_test)
     BOOST_CHECK(TMath::Abs(rms[i] / nomBz) < 1.e-3);
   }
 }
+
+BOOST_AUTO_TEST_CASE(MagneticField_float_batch_and_grid_test)
+{
+  std::unique_ptr<MagneticField> fld = std::make_unique<MagneticField>("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG);
+  const double nomBz = 5.00685;
+  const int ntst = 20000, repFactor = 20;
+
+  // random points and track-like sequences (straight lines from the origin in 1 cm steps)
+  std::vector<float> xyzRnd(3 * ntst), xyzTrk(3 * ntst);
+  float rnd[3], phi = 0, tgl = 0;
+  for (int it = 0; it < ntst; it++) {
+    gRandom->RndmArray(3, rnd);
+    xyzRnd[3 * it] = rnd[0] * 400. * TMath::Cos(rnd[1] * TMath::Pi() * 2);
+    xyzRnd[3 * it + 1] = rnd[0] * 400. * TMath::Sin(rnd[1] * TMath::Pi() * 2);
+    xyzRnd[3 * it + 2] = (rnd[2] - 0.5) * 500;
+    int step = it % 250;
+    if (!step) {
+      phi = gRandom->Rndm() * TMath::Pi() * 2;
+      tgl = gRandom->Uniform(-1., 1.);
+    }
+    xyzTrk[3 * it] = step * TMath::Cos(phi);
+    xyzTrk[3 * it + 1] = step * TMath::Sin(phi);
+    xyzTrk[3 * it + 2] = step * tgl;
+  }
+  const std::vector<float>* seqs[2] = {&xyzRnd, &xyzTrk};
+  const char* seqNames[2] = {"random", "track-like"};
+
+  auto runDouble = [&](const std::vector<float>& xyz, std::vector<float>& b) { // returns calls/s
+    TStopwatch sw;
+    sw.Start();
+    for (int ii = repFactor; ii--;) {
+      for (int it = 0; it < ntst; it++) {
+        double p[3] = {xyz[3 * it], xyz[3 * it + 1], xyz[3 * it + 2]}, bd[3] = {0.};
+        fld->Field(p, bd);
+        for (int j = 0; j < 3; j++) {
+          b[3 * it + j] = bd[j];
+        }
+      }
+    }
+    sw.Stop();
+    return ntst * repFactor / sw.CpuTime();
+  };
+  auto runBatch = [&](const std::vector<float>& xyz, std::vector<float>& b) {
+    TStopwatch sw;
+    sw.Start();
+    for (int ii = repFactor; ii--;) {
+      fld->fieldBatch(ntst, xyz.data(), b.data());
+    }
+    sw.Stop();
+    return ntst * repFactor / sw.CpuTime();
+  };
+  auto checkDeviation = [&](const std::vector<float>& bRef, const std::vector<float>& b, const char* name, double tolRel) {
+    double mean[3] = {0.}, rms[3] = {0.}, maxDev = 0.;
+    for (int it = 0; it < ntst; it++) {
+      for (int i = 0; i < 3; i++) {
+        double df = bRef[3 * it + i] - b[3 * it + i];
+        mean[i] += df;
+        rms[i] += df * df;
+        maxDev = std::max(maxDev, std::abs(df));
+      }
+    }
+    for (int i = 0; i < 3; i++) {
+      mean[i] /= ntst;
+      rms[i] = std::sqrt(std::max(0., rms[i] / ntst - mean[i] * mean[i]));
+      BOOST_CHECK(std::abs(mean[i] / nomBz) < tolRel);
+      BOOST_CHECK(std::abs(rms[i] / nomBz) < tolRel);
+    }
+    LOG(info) << name << " deviation from exact field: mean " << mean[0] << " " << mean[1] << " " << mean[2] << " RMS " << rms[0] << " "
+              << rms[1] << " " << rms[2] << " max " << maxDev << " kG";
+  };
+
+  std::vector<float> bExact[2], bTest(3 * ntst);
+  double rate[2][4] = {};
+  for (int is = 0; is < 2; is++) {
+    bExact[is].resize(3 * ntst);
+    rate[is][0] = runDouble(*seqs[is], bExact[is]);
+    rate[is][1] = runBatch(*seqs[is], bTest);
+    checkDeviation(bExact[is], bTest, "float batch", 1.e-4);
+  }
+  fld->getMeasuredMap()->buildSolenoidSegmentLUT();
+  for (int is = 0; is < 2; is++) {
+    rate[is][2] = runBatch(*seqs[is], bTest);
+    checkDeviation(bExact[is], bTest, "float batch with segments lookup", 1.e-4);
+  }
+  fld->AllowGridCache(true);
+  for (int is = 0; is < 2; is++) {
+    rate[is][3] = runDouble(*seqs[is], bTest);
+    checkDeviation(bExact[is], bTest, "grid cache", 1.e-3);
+  }
+  for (int is = 0; is < 2; is++) {
+    LOG(info) << "Field calls/s for " << seqNames[is] << " points: exact " << rate[is][0] << " float batch " << rate[is][1]
+              << " float batch with segments lookup " << rate[is][2] << " grid cache " << rate[is][3];
+  }
+}
@@ -169,6 +169,14 @@ class Chebyshev3DCalc : public TNamed
 
   Double_t Eval(const Double_t* par) const;
 
+  /// max number of points evaluated together by the Eval for the set of points
+  static constexpr int MaxBatch = 16;
+
+  /// Evaluates the parameterization for n <= MaxBatch points with the arguments (ALREADY MAPPED to [-1:1] interval)
+  /// par0[i], par1[i], par2[i], storing the results in res[i]. For every point the operations are the same as in the
+  /// Eval(const Float_t* par), but the loops run over the points, so that they are vectorized. Thread-safe.
+  void Eval(int n, const Float_t* par0, const Float_t* par1, const Float_t* par2, Float_t* res) const;
+
  private:
   Int_t mNumberOfCoefficients;    ///< total number of coeeficients
   Int_t mNumberOfRows;            ///< number of significant rows in the 3D coeffs matrix
@@ -17,6 +17,7 @@
 #include <TSystem.h> // for TSystem, gSystem
 #include "TNamed.h"  // for TNamed
 #include "TString.h" // for TString, TString::EStripType::kBoth
+#include <vector>
 
 using namespace o2::math_utils;
 
@@ -203,6 +204,63 @@ void Chebyshev3DCalc::Print(const Option_t*) const
   printf("%d coefficients in %dx%dx%d matrix\n", mNumberOfCoefficients, mNumberOfRows, mNumberOfColumns, nmax3d);
 }
 
+namespace
+{
+/// Clenshaw summation of the Chebyshev series for n points with arguments x[k] and coefficients cf[i * stride + k * LaneStep]
+/// (LaneStep = 0 for the coefficients common to all points), same operations as in the Chebyshev3DCalc::chebyshevEvaluation1D
+template <int LaneStep>
+void chebyshevEvaluation1DBatch(int n, const Float_t* x, const Float_t* cf, int stride, int ncf, Float_t* res)
+{
+  if (ncf <= 0) {
+    for (int k = 0; k < n; k++) {
+      res[k] = 0;
+    }
+    return;
+  }
+  constexpr int MaxBatch = Chebyshev3DCalc::MaxBatch;
+  Float_t b0[MaxBatch], b1[MaxBatch], b2[MaxBatch], x2[MaxBatch];
+  const Float_t* c = cf + (--ncf) * stride;
+  for (int k = 0; k < n; k++) {
+    x2[k] = x[k] + x[k];
+    b0[k] = c[k * LaneStep];
+    b1[k] = b2[k] = 0;
+  }
+  for (int i = ncf; i--;) {
+    c = cf + i * stride;
+    for (int k = 0; k < n; k++) {
+      b2[k] = b1[k];
+      b1[k] = b0[k];
+      b0[k] = c[k * LaneStep] + x2[k] * b1[k] - b2[k];
+    }
+  }
+  for (int k = 0; k < n; k++) {
+    res[k] = b0[k] - x[k] * b1[k];
+  }
+}
+} // namespace
+
+void Chebyshev3DCalc::Eval(int n, const Float_t* par0, const Float_t* par1, const Float_t* par2, Float_t* res) const
+{
+  // the temporaries are per thread and hold the MaxBatch values of every row/column
+  thread_local std::vector<Float_t> tmp2D, tmp1D;
+  if (int(tmp2D.size()) < mNumberOfColumns * MaxBatch) {
+    tmp2D.resize(mNumberOfColumns * MaxBatch);
+  }
+  if (int(tmp1D.size()) < mNumberOfRows * MaxBatch) {
+    tmp1D.resize(mNumberOfRows * MaxBatch);
+  }
+  for (int id0 = mNumberOfRows; id0--;) {
+    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
+    int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    for (int id1 = nCLoc; id1--;) {
+      int id = id1 + col0;
+      chebyshevEvaluation1DBatch<0>(n, par2, mCoefficients + mCoefficientBound2D1[id], 1, mCoefficientBound2D0[id], &tmp2D[id1 * MaxBatch]);
+    }
+    chebyshevEvaluation1DBatch<1>(n, par1, tmp2D.data(), MaxBatch, nCLoc, &tmp1D[id0 * MaxBatch]);
+  }
+  chebyshevEvaluation1DBatch<1>(n, par0, tmp1D.data(), MaxBatch, mNumberOfRows, res);
+}
+
 Float_t Chebyshev3DCalc::evaluateDerivative(int dim, const Float_t* par) const
 {
   int ncfRC;
@@ -328,6 +328,12 @@ struct Block {
   ClassDefNV(Block, 1);
 }; // namespace ctf
 
+/// external encoder to be used for a block only if it is expected to compress the block better than a per-TF dictionary
+template <typename encoder_T>
+struct AdaptiveExternalEncoder {
+  encoder_T encoder;
+};
+
 ///<<======================== Auxiliary classes =======================<<
 
 template <typename H, int N, typename W = uint32_t>
@@ -475,6 +481,16 @@ class EncodedBlocks
   template <typename buffer_T>
   static auto expand(buffer_T& buffer, size_t newsizeBytes);
 
+  /// create in the scratch vector an empty container with the headers of this one, ready to encode the block at the provided slot.
+  /// Used to encode the blocks concurrently, each one to its own scratch container, see appendBlocks
+  template <typename VD>
+  auto createScratch(VD& scratch, int slot) const;
+
+  /// append to the container in the buffer all blocks starting from the 1st unfilled one, taking the block (and its metadata) of slot i
+  /// from the scratch[i] container. The resulting layout is identical to the one obtained by sequential encoding of the blocks
+  template <typename buffer_T>
+  static void appendBlocks(buffer_T& buffer, const std::vector<const EncodedBlocks*>& scratch);
+
   /// copy itself to flat buffer created on the fly from the vector
   template <typename V>
   void copyToFlat(V& vec);
@@ -594,11 +610,11 @@ class EncodedBlocks
   template <typename input_IT, typename buffer_T>
   o2::ctf::CTFIOSize entropyCodeRANSV1(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f);
 
-  template <typename input_IT, typename buffer_T>
-  o2::ctf::CTFIOSize encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, const std::any& encoderExt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1);
+  template <typename input_IT, typename buffer_T, typename encoder_T>
+  o2::ctf::CTFIOSize encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, const encoder_T& encoderExt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1);
 
-  template <typename input_IT, typename buffer_T>
-  o2::ctf::CTFIOSize encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1);
+  template <typename input_IT, typename buffer_T, typename encoder_T = std::nullptr_t>
+  o2::ctf::CTFIOSize encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1, const encoder_T* encoderExt = nullptr);
 
 #ifndef __CLING__
   template <typename input_IT, typename buffer_T>
@@ -791,6 +807,45 @@ auto EncodedBlocks<H, N, W>::expand(buffer_T& buffer, size_t newsizeBytes)
   return get(buffer.data());
 }
 
+///_____________________________________________________________________________
+/// create in the scratch vector an empty container with the headers of this one, ready to encode the block at the provided slot
+template <typename H, int N, typename W>
+template <typename VD>
+auto EncodedBlocks<H, N, W>::createScratch(VD& scratch, int slot) const
+{
+  auto eb = create(scratch);
+  eb->mHeader = mHeader;
+  eb->mANSHeader = mANSHeader;
+  eb->mRegistry.nFilledBlocks = slot;
+  return eb;
+}
+
+///_____________________________________________________________________________
+/// append the blocks encoded in the scratch containers, the buffer is expanded at most once
+template <typename H, int N, typename W>
+template <typename buffer_T>
+void EncodedBlocks<H, N, W>::appendBlocks(buffer_T& buffer, const std::vector<const EncodedBlocks*>& scratch)
+{
+  auto eb = get(buffer.data());
+  const int firstSlot = eb->mRegistry.nFilledBlocks;
+  assert(scratch.size() == N);
+  size_t sz = 0;
+  for (int slot = firstSlot; slot < N; slot++) {
+    sz += estimateBlockSize(scratch[slot]->mBlocks[slot].getNStored());
+  }
+  if (sz > eb->getFreeSize()) {
+    eb = expand(buffer, eb->size() + (sz - eb->getFreeSize()));
+  }
+  for (int slot = firstSlot; slot < N; slot++) {
+    const auto& block = scratch[slot]->mBlocks[slot];
+    if (block.payload) { // the block of an empty message has no payload assigned
+      eb->mBlocks[slot].store(block.getNDict(), block.getNData(), block.getNLiterals(), block.getDict(), block.getData(), block.getLiterals());
+    }
+    eb->mMetadata[slot] = scratch[slot]->mMetadata[slot];
+    eb->mRegistry.nFilledBlocks++;
+  }
+}
+
 ///_____________________________________________________________________________
 /// relocate to different head position, newHead points on start of the dynamic buffer holding the data.
 /// the address of the static part might be actually different (wrapper). This different newHead and
@@ -1282,8 +1337,13 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSV1(const input_IT srcB
     encoderStatistics = pack(srcBegin, srcEnd, slot, buffer);
   } else {
 
-    if (encoderExt.has_value()) {
-      encoderStatistics = encodeRANSV1External(srcBegin, srcEnd, slot, encoderExt, buffer, memfc);
+    using input_t = typename std::iterator_traits<input_IT>::value_type;
+    using ransEncoder_t = typename internal::ExternalEntropyCoder<input_t>::encoder_type;
+    if (const auto* adaptive = std::any_cast<AdaptiveExternalEncoder<ransEncoder_t>>(&encoderExt)) {
+      // the per-TF dictionary is built anyway, the external one is used only if it compresses better
+      encoderStatistics = encodeRANSV1Inplace(srcBegin, srcEnd, slot, opt, buffer, memfc, &adaptive->encoder);
+    } else if (encoderExt.has_value()) {
+      encoderStatistics = encodeRANSV1External(srcBegin, srcEnd, slot, std::any_cast<const ransEncoder_t&>(encoderExt), buffer, memfc);
     } else {
       encoderStatistics = encodeRANSV1Inplace(srcBegin, srcEnd, slot, opt, buffer, memfc);
     }
@@ -1292,8 +1352,8 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSV1(const input_IT srcB
 }
 
 template <typename H, int N, typename W>
-template <typename input_IT, typename buffer_T>
-CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, const std::any& encoderExt, buffer_T* buffer, double_t sizeEstimateSafetyFactor)
+template <typename input_IT, typename buffer_T, typename encoder_T>
+CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, const encoder_T& encoderExt, buffer_T* buffer, double_t sizeEstimateSafetyFactor)
 {
   using storageBuffer_t = W;
   using input_t = typename std::iterator_traits<input_IT>::value_type;
@@ -1309,7 +1369,8 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin,
   auto* thisMetadata = &mMetadata[slot];
 
   const size_t messageLength = std::distance(srcBegin, srcEnd);
-  internal::ExternalEntropyCoder<input_t> encoder{std::any_cast<const ransEncoder_t&>(encoderExt)};
+  static_assert(std::is_same_v<encoder_T, ransEncoder_t>);
+  internal::ExternalEntropyCoder<input_t> encoder{encoderExt};
 
   const size_t payloadSizeWords = encoder.template computePayloadSizeEstimate<storageBuffer_t>(messageLength);
   std::tie(thisBlock, thisMetadata) = expandStorage(slot, payloadSizeWords, buffer);
@@ -1353,8 +1414,8 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin,
 };
 
 template <typename H, int N, typename W>
-template <typename input_IT, typename buffer_T>
-CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer, double_t sizeEstimateSafetyFactor)
+template <typename input_IT, typename buffer_T, typename encoder_T>
+CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer, double_t sizeEstimateSafetyFactor, const encoder_T* encoderExt)
 {
   using storageBuffer_t = W;
   using input_t = typename std::iterator_traits<input_IT>::value_type;
@@ -1382,6 +1443,9 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, c
       encoder = internal::InplaceEntropyCoder<input_t>{proxy.beginIter(), proxy.endIter()};
     }
   } catch (const rans::HistogramError& error) {
+    if constexpr (!std::is_null_pointer_v<encoder_T>) {
+      return encodeRANSV1External(srcBegin, srcEnd, slot, *encoderExt, buffer, sizeEstimateSafetyFactor);
+    }
     LOGP(warning, "Failed to build Dictionary for rANS encoding, using fallback option");
     if (proxy.isCached()) {
       return store(proxy.beginCache(), proxy.endCache(), slot, this->FallbackStorageType, buffer);
@@ -1397,7 +1461,27 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, c
     LOGP(info, "Metrics:{{slot: {}, numSamples: {}, min: {}, max: {}, alphabetRangeBits: {}, nUsedAlphabetSymbols: {}, preferPacking: {}}}", slot, dp.numSamples, dp.min, dp.max, dp.alphabetRangeBits, dp.nUsedAlphabetSymbols, metrics.getSizeEstimate().preferPacking());
   }
   */
-  if (detail::mayPack(opt) && metrics.getSizeEstimate().preferPacking()) {
+  if constexpr (!std::is_null_pointer_v<encoder_T>) {
+    // adaptive mode: choose the cheapest among the per-TF dictionary, the external dictionary and packing
+    const auto& estimate = metrics.getSizeEstimate();
+    const size_t inplaceSizeB = estimate.getCompressedDatasetSize(1.) + estimate.getCompressedDictionarySize(1.) + estimate.getIncompressibleSize(1.);
+    const size_t externalSizeB = encoder.estimateExternalSizeB(*encoderExt);
+    const size_t packedSizeB = estimate.getPackedDatasetSize();
+    if (detail::mayPack(opt) && packedSizeB <= std::min(inplaceSizeB, externalSizeB)) {
+      if (proxy.isCached()) {
+        return pack(proxy.beginCache(), proxy.endCache(), slot, metrics, buffer);
+      } else {
+        return pack(proxy.beginIter(), proxy.endIter(), slot, metrics, buffer);
+      };
+    }
+    if (externalSizeB <= inplaceSizeB) {
+      if (proxy.isCached()) {
+        return encodeRANSV1External(proxy.beginCache(), proxy.endCache(), slot, *encoderExt, buffer, sizeEstimateSafetyFactor);
+      } else {
+        return encodeRANSV1External(proxy.beginIter(), proxy.endIter(), slot, *encoderExt, buffer, sizeEstimateSafetyFactor);
+      };
+    }
+  } else if (detail::mayPack(opt) && metrics.getSizeEstimate().preferPacking()) {
     if (proxy.isCached()) {
       return pack(proxy.beginCache(), proxy.endCache(), slot, metrics, buffer);
     } else {
@@ -16,6 +16,8 @@
 #ifndef ALICEO2_INPLACEENTROPYCODER_H_
 #define ALICEO2_INPLACEENTROPYCODER_H_
 
+#include <cmath>
+#include <limits>
 #include <optional>
 #include <variant>
 #include <type_traits>
@@ -75,6 +77,11 @@ class InplaceEntropyCoder
   template <typename dst_T = uint8_t>
   [[nodiscard]] size_t getPackedIncompressibleSize() const noexcept;
 
+  // estimated size in bytes of the data encoded with the symbol table of an external encoder, must be called before makeEncoder.
+  // Returns max of size_t if the data cannot be encoded with the external encoder.
+  template <typename encoder_T>
+  [[nodiscard]] size_t estimateExternalSizeB(const encoder_T& encoder) const;
+
   // operations
   template <typename src_IT, typename dst_IT>
   [[nodiscard]] dst_IT encode(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd);
@@ -247,6 +254,38 @@ template <typename dst_T>
   return mIncompressiblePacker.template getPackingBufferSize<dst_T>(getNIncompressibleSamples());
 }
 
+template <typename source_T>
+template <typename encoder_T>
+[[nodiscard]] size_t InplaceEntropyCoder<source_T>::estimateExternalSizeB(const encoder_T& encoder) const
+{
+  const auto& symbolTable = encoder.getSymbolTable();
+  const double_t precision = symbolTable.getPrecision();
+  const double_t escapeBits = symbolTable.hasEscapeSymbol() ? precision - std::log2(symbolTable.getEscapeSymbol().getFrequency()) : 0.;
+  const double_t literalBits = mMetrics.getDatasetProperties().alphabetRangeBits;
+
+  double_t nBits = 0;
+  bool isEncodable = true;
+  std::visit([&](auto&& histogram) {
+    rans::internal::forEachIndexValue(histogram, [&](const source_type& index, const uint32_t& frequency) {
+      if (frequency) {
+        const auto& symbol = symbolTable[index];
+        if (symbolTable.isEscapeSymbol(symbol)) {
+          isEncodable = isEncodable && symbolTable.hasEscapeSymbol();
+          nBits += frequency * (escapeBits + literalBits);
+        } else {
+          nBits += frequency * (precision - std::log2(symbol.getFrequency()));
+        }
+      }
+    });
+  },
+             *mHistogram);
+
+  if (!isEncodable) {
+    return std::numeric_limits<size_t>::max();
+  }
+  return rans::addEncoderOverheadEstimateB<>(rans::utils::toBytes(static_cast<size_t>(std::ceil(nBits))));
+};
+
 template <typename source_T>
 template <typename source_IT, std::enable_if_t<(sizeof(typename std::iterator_traits<source_IT>::value_type) < 4), bool>>
 void InplaceEntropyCoder<source_T>::init(source_IT srcBegin, source_IT srcEnd, source_type min, source_type max)
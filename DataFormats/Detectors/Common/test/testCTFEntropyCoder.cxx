@@ -347,4 +347,35 @@ BOOST_AUTO_TEST_CASE(testExternalEncoderCombinedIterator)
   auto [begin, end] = makeInputIterators(testMessage1.data(), testMessage2.data(), testMessage1.size(), ShiftFunctor<uint16_t, rans::utils::toBits<uint8_t>()>{});
 
   encodeExternal(begin, end);
-};
\ No newline at end of file
+};
+template <typename source_T>
+void estimateExternalSize(const std::vector<source_T>& message)
+{
+  const auto& encoder = ExternalEncoders.getEncoder<source_T>();
+  ctf::internal::InplaceEntropyCoder<source_T> inplaceCoder{message.data(), message.data() + message.size()};
+  const size_t estimateB = inplaceCoder.estimateExternalSizeB(encoder);
+
+  ctf::internal::ExternalEntropyCoder<source_T> externalCoder{encoder};
+  std::vector<buffer_type> encodeBuffer(externalCoder.template computePayloadSizeEstimate<buffer_type>(message.size()), 0);
+  auto encoderEnd = externalCoder.encode(message.begin(), message.end(), encodeBuffer.data(), encodeBuffer.data() + encodeBuffer.size());
+  const size_t encodedSizeB = std::distance(encodeBuffer.data(), encoderEnd) * sizeof(buffer_type) + externalCoder.template computePackedIncompressibleSize<uint8_t>();
+
+  LOGP(info, "external encoding: estimated {} bytes, encoded {} bytes", estimateB, encodedSizeB);
+  BOOST_CHECK(estimateB >= 0.8 * encodedSizeB);
+  BOOST_CHECK(estimateB <= 1.2 * encodedSizeB);
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(testExternalSizeEstimate, source_T, source_types)
+{
+  const auto& testMessage = MessageProxy.getMessage<source_T>();
+  estimateExternalSize(testMessage);
+
+  // the external dictionary does not match the transformed data
+  std::vector<source_T> shiftedMessage(testMessage.size());
+  std::transform(testMessage.begin(), testMessage.end(), shiftedMessage.begin(), [](source_T value) { return static_cast<source_T>(value / 2 + 1); });
+  estimateExternalSize(shiftedMessage);
+
+  // the data are compressed better with their own statistics
+  ctf::internal::InplaceEntropyCoder<source_T> shiftedCoder{shiftedMessage.data(), shiftedMessage.data() + shiftedMessage.size()};
+  BOOST_CHECK(shiftedCoder.estimateExternalSizeB(ExternalEncoders.getEncoder<source_T>()) > shiftedCoder.getMetrics().getSizeEstimate().getCompressedDatasetSize(1.));
+};
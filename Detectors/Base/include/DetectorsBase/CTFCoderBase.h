@@ -25,6 +25,7 @@
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "DetectorsCommonDataFormats/CTFIOSize.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "DataFormatsCTP/TriggerOffsetsParam.h"
 #include "DetectorsCommonDataFormats/ANSHeader.h"
 #include "rANS/factory.h"
@@ -35,6 +36,7 @@
 #include "Framework/ConcreteDataMatcher.h"
 #include "Framework/ConfigParamRegistry.h"
 #include <any>
+#include <functional>
 
 namespace o2
 {
@@ -97,7 +99,11 @@ class CTFCoderBase
     } else if (mANSVersion == ANSVersion1) {
       switch (op) {
         case OpType::Encoder:
-          mCoders[slot] = std::make_any<rans::denseEncoder_type<S>>(rans::makeDenseEncoder<>::fromRenormed(renormedHistogram));
+          if (mAdaptiveDict) {
+            mCoders[slot] = std::make_any<AdaptiveExternalEncoder<rans::denseEncoder_type<S>>>(AdaptiveExternalEncoder<rans::denseEncoder_type<S>>{rans::makeDenseEncoder<>::fromRenormed(renormedHistogram)});
+          } else {
+            mCoders[slot] = std::make_any<rans::denseEncoder_type<S>>(rans::makeDenseEncoder<>::fromRenormed(renormedHistogram));
+          }
           break;
         case OpType::Decoder:
           mCoders[slot] = std::make_any<rans::defaultDecoder_type<S>>(rans::makeDecoder<>::fromRenormed(renormedHistogram));
@@ -121,6 +127,13 @@ class CTFCoderBase
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
+  void setNThreads(int n) { mNThreads = n > 1 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  // use the external dictionary only for the blocks it is expected to compress better than a per-TF dictionary, must be set before the encoders are created
+  void setAdaptiveDict(bool v) { mAdaptiveDict = v; }
+  bool getAdaptiveDict() const { return mAdaptiveDict; }
+
   const CTFDictHeader& getExtDictHeader() const { return mExtHeader; }
 
   template <typename T>
@@ -187,6 +200,16 @@ class CTFCoderBase
 
   template <typename CTF>
   std::vector<char> loadDictionaryFromTree(TTree* tree);
+
+  // independent encoding/decoding tasks of single blocks, executed concurrently when mNThreads > 1
+  using BlockTask = std::function<CTFIOSize()>;
+  using BlockEncoder = std::function<CTFIOSize(std::vector<o2::ctf::BufferType>&)>;
+  CTFIOSize runBlockTasks(std::vector<BlockTask>& tasks) const;
+
+  // encode concurrently all blocks starting from the 1st unfilled one of the container in the buffer, the encoder of slot i being blockEncoders[i]
+  template <typename CTF, typename BUF>
+  CTFIOSize encodeBlocks(BUF& buffer, std::vector<BlockEncoder>& blockEncoders) const;
+
   std::vector<std::any> mCoders; // encoders/decoders
   DetID mDet;
   std::string mDictBinding{"ctfdict"};
@@ -204,6 +227,8 @@ class CTFCoderBase
   size_t mIRFrameSelMarginFwd = 0; // margin in BC to add to the IRFrame upper boundary when selection is requested
   long mIRFrameSelShift = 0;       // Global shift of the IRFrames, to account for e.g. detector latency
   int mVerbosity = 0;
+  int mNThreads = 1;         // number of threads for the concurrent encoding/decoding of the blocks
+  bool mAdaptiveDict = false; // choose per block between the external and the per-TF dictionary (ANS version >= 1 encoders only)
 };
 
 ///________________________________
@@ -304,6 +329,12 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   if (ic.options().hasOption("mem-factor")) {
     setMemMarginFactor(ic.options().get<float>("mem-factor"));
   }
+  if (ic.options().hasOption("ctf-threads")) {
+    setNThreads(ic.options().get<int>("ctf-threads"));
+  }
+  if (ic.options().hasOption("ctf-dict-adaptive")) {
+    setAdaptiveDict(ic.options().get<bool>("ctf-dict-adaptive"));
+  }
   if (ic.options().hasOption("irframe-margin-bwd")) {
     mIRFrameSelMarginBwd = ic.options().get<uint32_t>("irframe-margin-bwd");
   }
@@ -350,6 +381,34 @@ size_t CTFCoderBase::finaliseCTFOutput(BUF& buffer)
   return eeb->size();
 }
 
+///________________________________
+template <typename CTF, typename BUF>
+CTFIOSize CTFCoderBase::encodeBlocks(BUF& buffer, std::vector<BlockEncoder>& blockEncoders) const
+{
+  // every block is encoded to its own scratch container, pre-sized by the encoder from the size estimate of the block,
+  // then the blocks are appended in the order of the slots, so the output is identical to the sequential encoding
+  std::vector<std::vector<o2::ctf::BufferType>> scratch(blockEncoders.size());
+  std::vector<BlockTask> tasks;
+  for (size_t slot = 0; slot < blockEncoders.size(); slot++) {
+    if (blockEncoders[slot]) {
+      CTF::get(buffer.data())->createScratch(scratch[slot], slot);
+      tasks.emplace_back([&encoder = blockEncoders[slot], &scratchBuffer = scratch[slot]]() { return encoder(scratchBuffer); });
+    }
+  }
+  if (tasks.empty()) {
+    return {};
+  }
+  auto iosize = runBlockTasks(tasks);
+  std::vector<const typename CTF::base*> scratchBlocks(blockEncoders.size(), nullptr);
+  for (size_t slot = 0; slot < blockEncoders.size(); slot++) {
+    if (blockEncoders[slot]) {
+      scratchBlocks[slot] = CTF::get(scratch[slot].data());
+    }
+  }
+  CTF::base::appendBlocks(buffer, scratchBlocks);
+  return iosize;
+}
+
 ///________________________________
 template <typename CTF>
 bool CTFCoderBase::finaliseCCDB(o2::framework::ConcreteDataMatcher& matcher, void* obj)
@@ -399,7 +458,7 @@ template <typename source_T>
 {
 
   std::any& coder = mCoders[slot];
-  if (coder.has_value()) {
+  if (coder.has_value() && !mAdaptiveDict) { // in the adaptive mode the block may get a per-TF dictionary
     const size_t alphabetRangeBits = [this, &coder]() {
       if (mANSVersion == ANSVersionCompat) {
         const auto& encoder = std::any_cast<const rans::compat::encoder_type<source_T>&>(coder);
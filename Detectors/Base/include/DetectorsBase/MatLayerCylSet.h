@@ -47,6 +47,16 @@ struct MatLayerCylSetLayout {
   int* mInterval2LrID;  //[mNRIntervals] mapping from r2 interval to layer ID
 };
 
+/// Traversal cursor to be kept by the caller for the consecutive getMatBudget queries of the same track (or thread).
+/// The r2 intervals of the layers range of the previous ray are checked first, the full lookup is done only if
+/// the ray moved out of them (or of their neighbours).
+struct MatBudgetCursor {
+  int lmnInt = -1; ///< r2 interval of the min radius of the previous ray
+  int lmxInt = -1; ///< r2 interval of the max radius of the previous ray
+
+  GPUd() void reset() { lmnInt = lmxInt = -1; }
+};
+
 class MatLayerCylSet : public o2::gpu::FlatObject
 {
 
@@ -63,7 +73,7 @@ class MatLayerCylSet : public o2::gpu::FlatObject
   GPUd() int getNLayers() const { return get() ? get()->mNLayers : 0; }
   GPUd() const MatLayerCyl& getLayer(int i) const { return get()->mLayers[i]; }
 
-  GPUd() bool getLayersRange(const Ray& ray, short& lmin, short& lmax) const;
+  GPUd() bool getLayersRange(const Ray& ray, short& lmin, short& lmax, MatBudgetCursor* cursor = nullptr) const;
   GPUd() float getRMin() const { return get()->mRMin; }
   GPUd() float getRMax() const { return get()->mRMax; }
   GPUd() float getZMax() const { return get()->mZMax; }
@@ -93,16 +103,22 @@ class MatLayerCylSet : public o2::gpu::FlatObject
 #endif // !GPUCA_ALIGPUCODE
 
 #ifndef GPUCA_ALIGPUCODE // this part is unvisible on GPU version
-  MatBudget getMatBudget(const math_utils::Point3D<float>& point0, const math_utils::Point3D<float>& point1) const
+  MatBudget getMatBudget(const math_utils::Point3D<float>& point0, const math_utils::Point3D<float>& point1, MatBudgetCursor* cursor = nullptr) const
   {
     // get material budget traversed on the line between point0 and point1
-    return getMatBudget(point0.X(), point0.Y(), point0.Z(), point1.X(), point1.Y(), point1.Z());
+    return getMatBudget(point0.X(), point0.Y(), point0.Z(), point1.X(), point1.Y(), point1.Z(), cursor);
   }
 #endif // !GPUCA_ALIGPUCODE
-  GPUd() MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const;
+  GPUd() MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1, MatBudgetCursor* cursor = nullptr) const;
+
+  /// accumulate the budget of the layers lmin:lmax crossed by the ray
+  GPUd() MatBudget accountLayers(Ray& ray, short lmin, short lmax) const;
 
   GPUd() int searchSegment(float val, int low = -1, int high = -1) const;
 
+  /// searches a segment starting from the segment seg and its neighbours, falling back to the full search
+  GPUd() int searchSegmentNear(float val, int seg) const;
+
   /// searches a layer based on r2 input, using a lookup table
   GPUd() int searchLayerFast(float r2, int low = -1, int high = -1) const;
 
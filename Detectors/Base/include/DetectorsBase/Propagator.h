@@ -27,6 +27,9 @@
 #ifndef GPUCA_GPUCODE
 #include <string>
 #endif
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+#include "gsl/span"
+#endif
 
 namespace o2
 {
@@ -95,6 +98,18 @@ class PropagatorImpl
     return bzOnly ? propagateToX(track, x, getNominalBz(), maxSnp, maxStep, matCorr, tofInfo, signCorr) : PropagateToXBxByBz(track, x, maxSnp, maxStep, matCorr, tofInfo, signCorr);
   }
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+  // Batched propagation of the tracks to xToGo (single value common for all tracks or one value per track), w/o the
+  // LTIntegral filling. The tracks are stepped in lock-step groups of BatchSize, with the field of all tracks of the group
+  // queried at once by the MagneticField::fieldBatch (float host field), so that the results agree with those of the
+  // single-track methods within the float precision of the field rather than bit-by-bit.
+  // status[i] (if provided) is set to the success flag of the track i. Returns the number of successfully propagated tracks.
+  static constexpr int BatchSize = 32;
+  template <typename track_T>
+  int propagateToXBatch(gsl::span<track_T> tracks, gsl::span<const value_type> xToGo, gsl::span<uint8_t> status = {}, bool bzOnly = false,
+                        value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT, int signCorr = 0) const;
+#endif
+
   template <typename track_T>
   GPUd() bool propagateToAlphaX(track_T& track, value_type alpha, value_type x, bool bzOnly = false, value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, int minSteps = 1,
                                 MatCorrType matCorr = MatCorrType::USEMatCorrLUT, track::TrackLTIntegral* tofInfo = nullptr, int signCorr = 0) const;
@@ -151,7 +166,9 @@ class PropagatorImpl
   static int initFieldFromGRP(const std::string grpFileName = "", bool verbose = false);
 #endif
 
-  GPUd() MatBudget getMatBudget(MatCorrType corrType, const o2::math_utils::Point3D<value_type>& p0, const o2::math_utils::Point3D<value_type>& p1) const;
+  /// material budget between p0 and p1, the optional cursor (LUT only) should be kept for the consecutive steps of the same track
+  GPUd() MatBudget getMatBudget(MatCorrType corrType, const o2::math_utils::Point3D<value_type>& p0, const o2::math_utils::Point3D<value_type>& p1,
+                                MatBudgetCursor* cursor = nullptr) const;
 
   GPUd() void getFieldXYZ(const math_utils::Point3D<float> xyz, float* bxyz) const;
 
@@ -18,6 +18,7 @@
 #include "Framework/ProcessingContext.h"
 #include "Framework/InputRecord.h"
 #include "Framework/TimingInfo.h"
+#include <exception>
 
 using namespace o2::ctf;
 using namespace o2::framework;
@@ -95,3 +96,27 @@ void CTFCoderBase::reportIRFrames()
     repDone = true;
   }
 }
+
+CTFIOSize CTFCoderBase::runBlockTasks(std::vector<BlockTask>& tasks) const
+{
+  std::vector<CTFIOSize> sizes(tasks.size());
+  std::vector<std::exception_ptr> errors(tasks.size());
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (size_t i = 0; i < tasks.size(); i++) {
+    try { // exceptions cannot leave the parallel region, rethrow them afterwards
+      sizes[i] = tasks[i]();
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  }
+  CTFIOSize iosize;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (errors[i]) {
+      std::rethrow_exception(errors[i]);
+    }
+    iosize += sizes[i];
+  }
+  return iosize;
+}
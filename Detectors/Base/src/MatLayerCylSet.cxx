@@ -101,7 +101,7 @@ void MatLayerCylSet::finalizeStructures()
   o2::gpu::resizeArray(get()->mR2Intervals, 0, nR2Int);
   o2::gpu::resizeArray(get()->mInterval2LrID, 0, nR2Int);
   get()->mR2Intervals[0] = get()->mRMin2;
-  get()->mR2Intervals[1] = get()->mRMax2;
+  get()->mR2Intervals[1] = getLayer(0).getRMax2(); // the intervals must be ordered for the segment search
   get()->mInterval2LrID[0] = 0;
   auto& nRIntervals = get()->mNRIntervals;
   nRIntervals = 1;
@@ -276,16 +276,25 @@ std::size_t MatLayerCylSet::estimateFlatBufferSize() const
 #endif // ! GPUCA_GPUCODE
 
 //_________________________________________________________________________________________________
-GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const
+GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1, MatBudgetCursor* cursor) const
 {
   // get material budget traversed on the line between point0 and point1
-  MatBudget rval;
+  // if the cursor is provided, the layers range is searched starting from the one of the previous query with the same cursor
   Ray ray(x0, y0, z0, x1, y1, z1);
   short lmin, lmax; // get innermost and outermost relevant layer
-  if (ray.isTooShort() || !getLayersRange(ray, lmin, lmax)) {
+  if (ray.isTooShort() || !getLayersRange(ray, lmin, lmax, cursor)) {
+    MatBudget rval;
     rval.length = ray.getDist();
     return rval;
   }
+  return accountLayers(ray, lmin, lmax);
+}
+
+//_________________________________________________________________________________________________
+GPUd() MatBudget MatLayerCylSet::accountLayers(Ray& ray, short lmin, short lmax) const
+{
+  // accumulate the budget of the layers lmin:lmax crossed by the ray
+  MatBudget rval;
   short lrID = lmax;
   while (lrID >= lmin) { // go from outside to inside
     const auto& lr = getLayer(lrID);
@@ -403,7 +412,7 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
 }
 
 //_________________________________________________________________________________________________
-GPUd() bool MatLayerCylSet::getLayersRange(const Ray& ray, short& lmin, short& lmax) const
+GPUd() bool MatLayerCylSet::getLayersRange(const Ray& ray, short& lmin, short& lmax, MatBudgetCursor* cursor) const
 {
   // get range of layers corresponding to rmin/rmax
   //
@@ -415,7 +424,12 @@ GPUd() bool MatLayerCylSet::getLayersRange(const Ray& ray, short& lmin, short& l
     return false;
   }
   int lmxInt, lmnInt;
-  if (!mInitializedLayerVoxelLU) {
+  if (cursor) { // consecutive steps of the same track stay mostly within the same or neighbouring intervals
+    lmxInt = rmax2 < getRMax2() ? searchSegmentNear(rmax2, cursor->lmxInt) : get()->mNRIntervals - 2;
+    lmnInt = rmin2 >= getRMin2() ? searchSegmentNear(rmin2, cursor->lmnInt) : 0;
+    cursor->lmxInt = lmxInt;
+    cursor->lmnInt = lmnInt;
+  } else if (!mInitializedLayerVoxelLU) {
     lmxInt = rmax2 < getRMax2() ? searchSegment(rmax2, 0) : get()->mNRIntervals - 2;
     lmnInt = rmin2 >= getRMin2() ? searchSegment(rmin2, 0, lmxInt + 1) : 0;
   } else {
@@ -472,6 +486,26 @@ GPUd() int MatLayerCylSet::searchSegment(float val, int low, int high) const
   return mid;
 }
 
+//_________________________________________________________________________________________________
+GPUd() int MatLayerCylSet::searchSegmentNear(float val, int seg) const
+{
+  ///< search segment val belongs to, checking first the segment seg and its neighbours. The val MUST be within the boundaries.
+  ///< The mNRIntervals boundaries define mNRIntervals - 1 segments
+  const auto* r2Intervals = get()->mR2Intervals;
+  if (seg >= 0 && seg < get()->mNRIntervals - 1) {
+    if (val < r2Intervals[seg]) {
+      if (seg > 0 && val >= r2Intervals[seg - 1]) {
+        return seg - 1;
+      }
+    } else if (val < r2Intervals[seg + 1]) {
+      return seg;
+    } else if (seg + 2 < get()->mNRIntervals && val < r2Intervals[seg + 2]) {
+      return seg + 1;
+    }
+  }
+  return mInitializedLayerVoxelLU ? searchLayerFast(val) : searchSegment(val);
+}
+
 #ifndef GPUCA_ALIGPUCODE // this part is unvisible on GPU version
 
 void MatLayerCylSet::flatten()
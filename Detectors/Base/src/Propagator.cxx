@@ -16,6 +16,10 @@
 #include "GPUTPCGMPolynomialField.h"
 #include "MathUtils/Utils.h"
 #include "ReconstructionDataFormats/Vertex.h"
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+#include <type_traits>
+#include <stdexcept>
+#endif
 
 using namespace o2::base;
 using namespace o2::gpu;
@@ -171,6 +175,7 @@ GPUd() bool PropagatorImpl<value_T>::PropagateToXBxByBz(TrackParCov_t& track, va
   }
 
   gpu::gpustd::array<value_type, 3> b{};
+  MatBudgetCursor matCursor; // consecutive steps cross the same or neighbouring material layers
   while (math_utils::detail::abs<value_type>(dx) > Epsilon) {
     auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
     if (dir < 0) {
@@ -180,11 +185,11 @@ GPUd() bool PropagatorImpl<value_T>::PropagateToXBxByBz(TrackParCov_t& track, va
     auto xyz0 = track.getXYZGlo();
     getFieldXYZ(xyz0, &b[0]);
 
-    auto correct = [&track, &xyz0, tofInfo, matCorr, signCorr, this]() {
+    auto correct = [&track, &xyz0, &matCursor, tofInfo, matCorr, signCorr, this]() {
       bool res = true;
       if (matCorr != MatCorrType::USEMatCorrNONE) {
         auto xyz1 = track.getXYZGlo();
-        auto mb = this->getMatBudget(matCorr, xyz0, xyz1);
+        auto mb = this->getMatBudget(matCorr, xyz0, xyz1, &matCursor);
         if (!track.correctForMaterial(mb.meanX2X0, mb.getXRho(signCorr))) {
           res = false;
         }
@@ -240,6 +245,7 @@ GPUd() bool PropagatorImpl<value_T>::PropagateToXBxByBz(TrackPar_t& track, value
   }
 
   gpu::gpustd::array<value_type, 3> b{};
+  MatBudgetCursor matCursor; // consecutive steps cross the same or neighbouring material layers
   while (math_utils::detail::abs<value_type>(dx) > Epsilon) {
     auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
     if (dir < 0) {
@@ -249,11 +255,11 @@ GPUd() bool PropagatorImpl<value_T>::PropagateToXBxByBz(TrackPar_t& track, value
     auto xyz0 = track.getXYZGlo();
     getFieldXYZ(xyz0, &b[0]);
 
-    auto correct = [&track, &xyz0, tofInfo, matCorr, signCorr, this]() {
+    auto correct = [&track, &xyz0, &matCursor, tofInfo, matCorr, signCorr, this]() {
       bool res = true;
       if (matCorr != MatCorrType::USEMatCorrNONE) {
         auto xyz1 = track.getXYZGlo();
-        auto mb = this->getMatBudget(matCorr, xyz0, xyz1);
+        auto mb = this->getMatBudget(matCorr, xyz0, xyz1, &matCursor);
         if (!track.correctForELoss(((signCorr < 0) ? -mb.length : mb.length) * mb.meanRho)) {
           res = false;
         }
@@ -308,6 +314,7 @@ GPUd() bool PropagatorImpl<value_T>::propagateToX(TrackParCov_t& track, value_ty
     signCorr = -dir; // sign of eloss correction is not imposed
   }
 
+  MatBudgetCursor matCursor; // consecutive steps cross the same or neighbouring material layers
   while (math_utils::detail::abs<value_type>(dx) > Epsilon) {
     auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
     if (dir < 0) {
@@ -315,11 +322,11 @@ GPUd() bool PropagatorImpl<value_T>::propagateToX(TrackParCov_t& track, value_ty
     }
     auto x = track.getX() + step;
     auto xyz0 = track.getXYZGlo();
-    auto correct = [&track, &xyz0, tofInfo, matCorr, signCorr, this]() {
+    auto correct = [&track, &xyz0, &matCursor, tofInfo, matCorr, signCorr, this]() {
       bool res = true;
       if (matCorr != MatCorrType::USEMatCorrNONE) {
         auto xyz1 = track.getXYZGlo();
-        auto mb = this->getMatBudget(matCorr, xyz0, xyz1);
+        auto mb = this->getMatBudget(matCorr, xyz0, xyz1, &matCursor);
         if (!track.correctForMaterial(mb.meanX2X0, mb.getXRho(signCorr))) {
           res = false;
         }
@@ -373,6 +380,7 @@ GPUd() bool PropagatorImpl<value_T>::propagateToX(TrackPar_t& track, value_type
     signCorr = -dir; // sign of eloss correction is not imposed
   }
 
+  MatBudgetCursor matCursor; // consecutive steps cross the same or neighbouring material layers
   while (math_utils::detail::abs<value_type>(dx) > Epsilon) {
     auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
     if (dir < 0) {
@@ -381,11 +389,11 @@ GPUd() bool PropagatorImpl<value_T>::propagateToX(TrackPar_t& track, value_type
     auto x = track.getX() + step;
     auto xyz0 = track.getXYZGlo();
 
-    auto correct = [&track, &xyz0, tofInfo, matCorr, signCorr, this]() {
+    auto correct = [&track, &xyz0, &matCursor, tofInfo, matCorr, signCorr, this]() {
       bool res = true;
       if (matCorr != MatCorrType::USEMatCorrNONE) {
         auto xyz1 = track.getXYZGlo();
-        auto mb = this->getMatBudget(matCorr, xyz0, xyz1);
+        auto mb = this->getMatBudget(matCorr, xyz0, xyz1, &matCursor);
         if (!track.correctForELoss(mb.getXRho(signCorr))) {
           res = false;
         }
@@ -721,9 +729,143 @@ GPUd() value_T PropagatorImpl<value_T>::estimateLTFast(o2::track::TrackLTIntegra
   return dcaT;
 }
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+//_______________________________________________________________________
+template <typename value_T>
+template <typename track_T>
+int PropagatorImpl<value_T>::propagateToXBatch(gsl::span<track_T> tracks, gsl::span<const value_type> xToGo, gsl::span<uint8_t> status, bool bzOnly,
+                                               value_type maxSnp, value_type maxStep, MatCorrType matCorr, int signCorr) const
+{
+  // Propagate the group of tracks to xToGo[0] (if xToGo has a single entry) or to xToGo[i].
+  // For every track the sequence of operations is the same as in the PropagateToXBxByBz / propagateToX (bzOnly),
+  // but all tracks of the group are advanced by one step before the next one is done. The field at the start points
+  // of the step is then queried for all active tracks of the group by a single MagneticField::fieldBatch call (float
+  // propagator with the host field map), which may differ from the single-track getFieldXYZ at the float precision
+  // level and outside of the fast field parameterization. The material is queried per track with its own cursor.
+  constexpr bool withCov = std::is_base_of<TrackParCov_t, track_T>::value;
+  int nTracks = tracks.size(), nOK = 0;
+  bool commonX = xToGo.size() == 1;
+  if (!commonX && int(xToGo.size()) < nTracks) {
+    throw std::runtime_error("number of target X values differs from the number of tracks");
+  }
+  value_type dx[BatchSize], xTgt[BatchSize];
+  int dir[BatchSize], sgnCorr[BatchSize], active[BatchSize];
+  math_utils::Point3D<value_type> xyz0[BatchSize];
+  gpu::gpustd::array<value_type, 3> b[BatchSize];
+  MatBudgetCursor matCursor[BatchSize];
+  float xyzF[3 * BatchSize], bF[3 * BatchSize];
+  int idF[BatchSize];
+  const bool batchField = !bzOnly && std::is_same<value_type, float>::value && !mGPUField && mField && (!mFieldFast || mFieldFast == mField->getFastField());
+
+  for (int first = 0; first < nTracks; first += BatchSize) {
+    int nb = nTracks - first < BatchSize ? nTracks - first : BatchSize, nActive = 0;
+    for (int k = 0; k < nb; k++) {
+      xTgt[k] = commonX ? xToGo[0] : xToGo[first + k];
+      dx[k] = xTgt[k] - tracks[first + k].getX();
+      dir[k] = dx[k] > 0.f ? 1 : -1;
+      sgnCorr[k] = signCorr ? signCorr : -dir[k]; // sign of eloss correction is not imposed
+      active[k] = 1;
+      matCursor[k].reset();
+      nActive++;
+    }
+    auto finish = [&](int k, bool ok) {
+      if (ok) {
+        tracks[first + k].setX(xTgt[k]);
+        nOK++;
+      }
+      if (!status.empty()) {
+        status[first + k] = ok;
+      }
+      active[k] = 0;
+      nActive--;
+    };
+    auto correct = [&](int k) {
+      auto& track = tracks[first + k];
+      if (matCorr == MatCorrType::USEMatCorrNONE) {
+        return true;
+      }
+      auto mb = this->getMatBudget(matCorr, xyz0[k], track.getXYZGlo(), &matCursor[k]);
+      if constexpr (withCov) {
+        return track.correctForMaterial(mb.meanX2X0, mb.getXRho(sgnCorr[k]));
+      } else {
+        return track.correctForELoss(mb.getXRho(sgnCorr[k]));
+      }
+    };
+    for (int k = 0; k < nb; k++) {
+      if (math_utils::detail::abs<value_type>(dx[k]) <= Epsilon) {
+        finish(k, true);
+      }
+    }
+    while (nActive) {
+      int nF = 0;
+      for (int k = 0; k < nb; k++) { // start points and field
+        if (!active[k]) {
+          continue;
+        }
+        xyz0[k] = tracks[first + k].getXYZGlo();
+        if (batchField) {
+          xyzF[3 * nF] = xyz0[k].X();
+          xyzF[3 * nF + 1] = xyz0[k].Y();
+          xyzF[3 * nF + 2] = xyz0[k].Z();
+          idF[nF++] = k;
+        } else if (!bzOnly) {
+          getFieldXYZ(xyz0[k], &b[k][0]);
+        }
+      }
+      if (nF) {
+        mField->fieldBatch(nF, xyzF, bF);
+        for (int i = 0; i < nF; i++) {
+          for (int j = 0; j < 3; j++) {
+            b[idF[i]][j] = bF[3 * i + j];
+          }
+        }
+      }
+      for (int k = 0; k < nb; k++) { // propagation
+        if (!active[k]) {
+          continue;
+        }
+        auto& track = tracks[first + k];
+        auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx[k]), maxStep);
+        if (dir[k] < 0) {
+          step = -step;
+        }
+        auto x = track.getX() + step;
+        bool res;
+        if constexpr (withCov) {
+          res = bzOnly ? track.propagateTo(x, mNominalBz) : track.propagateTo(x, b[k]);
+        } else {
+          res = bzOnly ? track.propagateParamTo(x, mNominalBz) : track.propagateParamTo(x, b[k]);
+        }
+        if (!res) {
+          finish(k, false);
+        } else if (maxSnp > 0 && math_utils::detail::abs<value_type>(track.getSnp()) >= maxSnp) {
+          correct(k);
+          finish(k, false);
+        }
+      }
+      for (int k = 0; k < nb; k++) { // material
+        if (!active[k]) {
+          continue;
+        }
+        if (!correct(k)) {
+          finish(k, false);
+          continue;
+        }
+        dx[k] = xTgt[k] - tracks[first + k].getX();
+        if (math_utils::detail::abs<value_type>(dx[k]) <= Epsilon) {
+          finish(k, true);
+        }
+      }
+    }
+  }
+  return nOK;
+}
+#endif
+
 //____________________________________________________________
 template <typename value_T>
-GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type>::MatCorrType corrType, const math_utils::Point3D<value_type>& p0, const math_utils::Point3D<value_type>& p1) const
+GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type>::MatCorrType corrType, const math_utils::Point3D<value_type>& p0, const math_utils::Point3D<value_type>& p1,
+                                                      MatBudgetCursor* cursor) const
 {
 #if !defined(GPUCA_STANDALONE) && !defined(GPUCA_GPUCODE)
   if (corrType == MatCorrType::USEMatCorrTGeo) {
@@ -737,7 +879,7 @@ GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type
     }
   }
 #endif
-  return mMatLUT->getMatBudget(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z());
+  return mMatLUT->getMatBudget(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z(), cursor);
 }
 
 template <typename value_T>
@@ -796,4 +938,10 @@ template class PropagatorImpl<double>;
 template bool PropagatorImpl<double>::propagateToAlphaX<PropagatorImpl<double>::TrackPar_t>(PropagatorImpl<double>::TrackPar_t&, double, double, bool, double, double, int, PropagatorImpl<double>::MatCorrType matCorr, track::TrackLTIntegral*, int) const;
 template bool PropagatorImpl<double>::propagateToAlphaX<PropagatorImpl<double>::TrackParCov_t>(PropagatorImpl<double>::TrackParCov_t&, double, double, bool, double, double, int, PropagatorImpl<double>::MatCorrType matCorr, track::TrackLTIntegral*, int) const;
 #endif
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+template int PropagatorImpl<float>::propagateToXBatch<PropagatorImpl<float>::TrackPar_t>(gsl::span<PropagatorImpl<float>::TrackPar_t>, gsl::span<const float>, gsl::span<uint8_t>, bool, float, float, PropagatorImpl<float>::MatCorrType, int) const;
+template int PropagatorImpl<float>::propagateToXBatch<PropagatorImpl<float>::TrackParCov_t>(gsl::span<PropagatorImpl<float>::TrackParCov_t>, gsl::span<const float>, gsl::span<uint8_t>, bool, float, float, PropagatorImpl<float>::MatCorrType, int) const;
+template int PropagatorImpl<double>::propagateToXBatch<PropagatorImpl<double>::TrackPar_t>(gsl::span<PropagatorImpl<double>::TrackPar_t>, gsl::span<const double>, gsl::span<uint8_t>, bool, double, double, PropagatorImpl<double>::MatCorrType, int) const;
+template int PropagatorImpl<double>::propagateToXBatch<PropagatorImpl<double>::TrackParCov_t>(gsl::span<PropagatorImpl<double>::TrackParCov_t>, gsl::span<const double>, gsl::span<uint8_t>, bool, double, double, PropagatorImpl<double>::MatCorrType, int) const;
+#endif
 } // namespace o2::base
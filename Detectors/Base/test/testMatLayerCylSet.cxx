@@ -0,0 +1,55 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testMatLayerCylSet.cxx
+/// \brief Checks the search of the radial segments of the material LUT starting from the cursor segment
+
+#define BOOST_TEST_MODULE Test MatLayerCylSet
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsBase/MatLayerCylSet.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace o2::base;
+
+BOOST_AUTO_TEST_CASE(MatLayerCylSetSearchSegmentNear)
+{
+  // layers w/o material, with a gap between the 2nd and 3rd ones, the last segment is the outermost layer
+  MatLayerCylSet lut;
+  lut.addLayer(2.f, 3.f, 10.f, 1.f, 1.f);
+  lut.addLayer(3.f, 5.f, 10.f, 1.f, 1.f);
+  lut.addLayer(10.f, 12.f, 10.f, 1.f, 1.f);
+  lut.finalizeStructures();
+  const int nBoundaries = lut.get()->mNRIntervals, nSegments = nBoundaries - 1;
+  const auto* r2Intervals = lut.get()->mR2Intervals;
+  BOOST_REQUIRE(nSegments == 4);
+
+  std::vector<float> vals;
+  for (int is = 0; is < nSegments; is++) { // edges and the middle of every segment, including the last one
+    vals.push_back(r2Intervals[is]);
+    vals.push_back(0.5f * (r2Intervals[is] + r2Intervals[is + 1]));
+    vals.push_back(std::nextafter(r2Intervals[is + 1], 0.f));
+  }
+  for (auto val : vals) {
+    const int segRef = lut.searchSegment(val);
+    BOOST_REQUIRE(segRef >= 0 && segRef < nSegments && val >= r2Intervals[segRef] && val < r2Intervals[segRef + 1]);
+    for (int seg = -1; seg <= nBoundaries; seg++) { // cursor on any segment, also on the invalid ones
+      BOOST_CHECK_MESSAGE(lut.searchSegmentNear(val, seg) == segRef, "val " << val << " seg " << seg);
+    }
+  }
+  // value in the last interval with the cursor on the last segment
+  const float valLast = 0.5f * (r2Intervals[nSegments - 1] + r2Intervals[nSegments]);
+  BOOST_CHECK(lut.searchSegmentNear(valLast, nSegments - 1) == nSegments - 1);
+  BOOST_CHECK(lut.searchSegmentNear(valLast, nSegments - 2) == nSegments - 1);
+}
@@ -0,0 +1,122 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testPropagatorBatch.cxx
+/// \brief Compares the batched propagation of the tracks with the single-track one
+
+#define BOOST_TEST_MODULE Test Propagator batch
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+#include "ReconstructionDataFormats/Track.h"
+#include "MathUtils/Utils.h"
+#include "CommonConstants/MathConstants.h"
+#include <TGeoGlobalMagField.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+using Prop = o2::base::Propagator;
+using Track = o2::track::TrackParCov;
+
+namespace
+{
+// tracks from the beam pipe, low pT ones loop in the field and do not reach the outer radii
+std::vector<Track> generateTracks(int nTracks, float x, std::mt19937& mt)
+{
+  std::uniform_real_distribution<float> distPt(0.1f, 5.f), distAlp(0.f, o2::constants::math::TwoPI), distTgl(-1.5f, 1.5f);
+  std::normal_distribution<float> gaus(0.f, 1.f);
+  std::vector<Track> tracks;
+  for (int i = 0; i < nTracks; i++) {
+    float alp = distAlp(mt), pt = distPt(mt), sign = i % 2 ? 1.f : -1.f;
+    std::array<float, o2::track::kNParams> par{0.01f * gaus(mt), 5.f * gaus(mt), 0.f, distTgl(mt), sign / pt};
+    std::array<float, o2::track::kCovMatSize> cov{1e-4, 0., 1e-4, 0., 0., 1e-5, 0., 0., 0., 1e-5, 0., 0., 0., 0., 1e-4};
+    o2::math_utils::bringToPMPi(alp);
+    tracks.emplace_back(x, alp, par, cov);
+  }
+  return tracks;
+}
+
+bool isClose(float a, float b, float absTol, float relTol)
+{
+  return std::abs(a - b) <= absTol + relTol * std::max(std::abs(a), std::abs(b));
+}
+
+void compare(const std::vector<Track>& tracksS, const std::vector<uint8_t>& statusS, const std::vector<Track>& tracksB, const std::vector<uint8_t>& statusB, float tol)
+{
+  int nOK = 0, nStatusDiff = 0;
+  for (size_t i = 0; i < tracksS.size(); i++) {
+    if (statusS[i] != statusB[i]) { // may happen for the tracks reaching the maxSnp with the slightly different field
+      nStatusDiff++;
+      continue;
+    }
+    if (!statusS[i]) {
+      continue;
+    }
+    nOK++;
+    const auto &trS = tracksS[i], &trB = tracksB[i];
+    BOOST_CHECK(trS.getX() == trB.getX());
+    BOOST_CHECK_MESSAGE(isClose(trS.getY(), trB.getY(), tol, tol) && isClose(trS.getZ(), trB.getZ(), tol, tol), "track " << i << " position differs");
+    BOOST_CHECK_MESSAGE(isClose(trS.getSnp(), trB.getSnp(), tol, tol) && isClose(trS.getTgl(), trB.getTgl(), tol, tol), "track " << i << " direction differs");
+    BOOST_CHECK_MESSAGE(isClose(trS.getQ2Pt(), trB.getQ2Pt(), 0.f, tol), "track " << i << " q/pT differs");
+    for (int j = 0; j < o2::track::kCovMatSize; j++) {
+      BOOST_CHECK_MESSAGE(isClose(trS.getCov()[j], trB.getCov()[j], 1e-9f, 10 * tol), "track " << i << " cov. element " << j << " differs");
+    }
+  }
+  BOOST_CHECK_MESSAGE(tol > 0.f ? nStatusDiff <= int(tracksS.size()) / 100 : nStatusDiff == 0, nStatusDiff << " tracks with different status");
+  BOOST_CHECK(nOK > int(tracksS.size()) / 2);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PropagatorBatch)
+{
+  auto fld = o2::field::MagneticField::createFieldMap();
+  TGeoGlobalMagField::Instance()->SetField(fld);
+  TGeoGlobalMagField::Instance()->Lock();
+  auto prop = Prop::Instance();
+  prop->setMatLUT(nullptr);
+
+  constexpr int NTracks = 1000; // not a multiple of the batch size
+  constexpr float XFrom = 2.f, XTo = 70.f;
+  std::mt19937 mt(1234);
+  const auto tracks = generateTracks(NTracks, XFrom, mt);
+  std::uniform_real_distribution<float> distX(XFrom, 2 * XTo);
+  std::vector<float> xToGo(NTracks);
+  for (auto& x : xToGo) {
+    x = distX(mt);
+  }
+
+  for (bool bzOnly : {false, true}) {
+    for (bool commonX : {true, false}) {
+      auto tracksS = tracks, tracksB = tracks;
+      std::vector<uint8_t> statusS(NTracks), statusB(NTracks);
+      for (int i = 0; i < NTracks; i++) {
+        float x = commonX ? XTo : xToGo[i];
+        statusS[i] = bzOnly ? prop->propagateToX(tracksS[i], x, prop->getNominalBz(), Prop::MAX_SIN_PHI, Prop::MAX_STEP, Prop::MatCorrType::USEMatCorrNONE)
+                            : prop->PropagateToXBxByBz(tracksS[i], x, Prop::MAX_SIN_PHI, Prop::MAX_STEP, Prop::MatCorrType::USEMatCorrNONE);
+      }
+      auto xSpan = commonX ? gsl::span<const float>(&XTo, 1) : gsl::span<const float>(xToGo);
+      int nOK = prop->propagateToXBatch(gsl::span<Track>(tracksB), xSpan, gsl::span<uint8_t>(statusB), bzOnly, Prop::MAX_SIN_PHI, Prop::MAX_STEP, Prop::MatCorrType::USEMatCorrNONE);
+      int nOKS = 0;
+      for (auto s : statusS) {
+        nOKS += s;
+      }
+      BOOST_CHECK(bzOnly ? nOK == nOKS : std::abs(nOK - nOKS) <= NTracks / 100);
+      // with the Bz only the same field value is used, otherwise the batched field query may differ at the float precision
+      compare(tracksS, statusS, tracksB, statusB, bzOnly ? 0.f : 1e-4f);
+    }
+  }
+}
@@ -0,0 +1,247 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFFlatFile
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "CTFWorkflow/CTFFlatFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+namespace
+{
+constexpr int NTFs = 7;
+
+// images of a TF: the detector is present for (tf + id) % 3 != 0, the sizes are not aligned and some exceed the writer buffer
+std::vector<std::vector<BufferType>> makeImages(int tf)
+{
+  std::vector<std::vector<BufferType>> images(DetID::nDetectors);
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if ((tf + id) % 3) {
+      images[id].resize(1 + (977 * (tf + 1) * (id + 1)) % 20000);
+      for (size_t i = 0; i < images[id].size(); i++) {
+        images[id][i] = BufferType(i * 7 + tf * 31 + id);
+      }
+    }
+  }
+  return images;
+}
+
+CTFHeader makeHeader(int tf)
+{
+  CTFHeader header{};
+  header.run = 123456;
+  header.firstTForbit = 1000 + 128 * tf;
+  header.tfCounter = tf;
+  return header;
+}
+
+std::string writeTestFile(const std::string& name, size_t bufferSize, bool directIO)
+{
+  auto fileName = (std::filesystem::temp_directory_path() / name).string();
+  CTFFlatFileWriter writer(bufferSize, directIO);
+  writer.open(fileName);
+  for (int tf = 0; tf < NTFs; tf++) {
+    auto images = makeImages(tf);
+    CTFImages spans{};
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      spans[id] = images[id];
+    }
+    writer.addTF(makeHeader(tf), spans);
+  }
+  BOOST_CHECK(writer.getNTFs() == NTFs);
+  writer.close();
+  BOOST_CHECK(writer.getNWrites() > 1);
+  return fileName;
+}
+
+std::vector<char> readFile(const std::string& fileName)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+template <typename T>
+T get(const std::vector<char>& data, size_t offset)
+{
+  T t;
+  memcpy(&t, data.data() + offset, sizeof(T));
+  return t;
+}
+
+bool isZero(const std::vector<char>& data, size_t start, size_t end)
+{
+  return std::all_of(data.begin() + start, data.begin() + end, [](char c) { return c == 0; });
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CTFFlatFileWriterLayout)
+{
+  // the buffer of 2 pages is smaller than most records, with direct I/O the last write is padded and the file truncated
+  auto fileBuffered = writeTestFile("test_ctf_flatfile_buffered.ctfbin", 2 * CTFFlatFileWriter::PageSize, false);
+  auto fileDirect = writeTestFile("test_ctf_flatfile_direct.ctfbin", 2 * CTFFlatFileWriter::PageSize, true);
+  const auto data = readFile(fileBuffered);
+  BOOST_CHECK(data == readFile(fileDirect));
+  std::filesystem::remove(fileBuffered);
+  std::filesystem::remove(fileDirect);
+
+  const auto fileHeader = get<CTFFlatFileHeader>(data, 0);
+  BOOST_CHECK(fileHeader.magic == CTFFlatFileHeader::Magic);
+  BOOST_CHECK(fileHeader.pageSize == CTFFlatFileWriter::PageSize);
+
+  // trailer at the end, preceded by the index
+  BOOST_REQUIRE(data.size() > sizeof(CTFFlatFileHeader) + sizeof(CTFFlatFileTrailer));
+  const auto trailer = get<CTFFlatFileTrailer>(data, data.size() - sizeof(CTFFlatFileTrailer));
+  BOOST_CHECK(trailer.magic == CTFFlatFileTrailer::Magic);
+  BOOST_REQUIRE(trailer.nEntries == NTFs);
+  BOOST_CHECK(trailer.indexOffset % alignof(CTFFlatIndexEntry) == 0);
+  BOOST_CHECK(trailer.indexOffset + NTFs * sizeof(CTFFlatIndexEntry) + sizeof(CTFFlatFileTrailer) == data.size());
+
+  size_t expectedOffset = CTFFlatFileWriter::PageSize; // the file header is padded to the page
+  BOOST_CHECK(isZero(data, sizeof(CTFFlatFileHeader), expectedOffset));
+  for (int tf = 0; tf < NTFs; tf++) {
+    const auto entry = get<CTFFlatIndexEntry>(data, trailer.indexOffset + tf * sizeof(CTFFlatIndexEntry));
+    BOOST_CHECK(entry.offset == expectedOffset);
+    BOOST_CHECK(entry.offset % CTFFlatFileWriter::PageSize == 0);
+    BOOST_CHECK(entry.tfCounter == uint32_t(tf));
+    BOOST_CHECK(entry.firstTForbit == makeHeader(tf).firstTForbit);
+    const auto record = get<CTFFlatRecordHeader>(data, entry.offset);
+    BOOST_CHECK(record.magic == CTFFlatRecordHeader::Magic);
+    BOOST_CHECK(record.size == entry.size);
+    BOOST_CHECK(record.size % Alignment == 0);
+    BOOST_CHECK(record.header.tfCounter == uint32_t(tf));
+    const auto images = makeImages(tf);
+    size_t imageEnd = sizeof(CTFFlatRecordHeader);
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      BOOST_REQUIRE(record.sizes[id] == images[id].size());
+      if (images[id].empty()) {
+        continue;
+      }
+      BOOST_CHECK(record.offsets[id] % Alignment == 0);
+      BOOST_CHECK(isZero(data, entry.offset + imageEnd, entry.offset + record.offsets[id])); // alignment padding
+      BOOST_CHECK(memcmp(data.data() + entry.offset + record.offsets[id], images[id].data(), images[id].size()) == 0);
+      imageEnd = record.offsets[id] + record.sizes[id];
+    }
+    BOOST_CHECK(alignSize(imageEnd) == record.size);
+    // the next record (or the index) starts at the next page
+    expectedOffset = ((entry.offset + record.size + CTFFlatFileWriter::PageSize - 1) / CTFFlatFileWriter::PageSize) * CTFFlatFileWriter::PageSize;
+    BOOST_CHECK(isZero(data, entry.offset + imageEnd, tf + 1 < NTFs ? expectedOffset : trailer.indexOffset));
+  }
+}
+
+namespace
+{
+void writeFile(const std::string& fileName, const std::vector<char>& data, size_t size)
+{
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  out.write(data.data(), size);
+}
+
+void checkReader(const CTFFlatFileReader& reader, int nTFs)
+{
+  BOOST_REQUIRE(reader.getNTFs() == size_t(nTFs));
+  for (int tf = 0; tf < nTFs; tf++) {
+    BOOST_CHECK(reader.getRecord(tf).header.tfCounter == uint32_t(tf));
+    BOOST_CHECK(reader.findTF(tf) == tf);
+    BOOST_CHECK(reader.findOrbit(makeHeader(tf).firstTForbit) == tf);
+    const auto images = makeImages(tf);
+    const auto spans = reader.getImages(tf);
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      BOOST_REQUIRE(spans[id].size() == images[id].size());
+      BOOST_CHECK(std::equal(spans[id].begin(), spans[id].end(), images[id].begin()));
+    }
+  }
+  BOOST_CHECK(reader.findTF(nTFs) == -1);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CTFFlatFileReaderIndex)
+{
+  auto fileName = writeTestFile("test_ctf_flatfile_reader.ctfbin", 4 * CTFFlatFileWriter::PageSize, false);
+  const auto data = readFile(fileName);
+  const auto trailer = get<CTFFlatFileTrailer>(data, data.size() - sizeof(CTFFlatFileTrailer));
+  CTFFlatFileReader reader;
+
+  // complete file, the index is taken from the trailer
+  reader.open(fileName);
+  checkReader(reader, NTFs);
+  BOOST_CHECK(reader.prefetch(0, NTFs, 0) == 1);
+  BOOST_CHECK(reader.prefetch(1, NTFs, data.size()) == NTFs - 1);
+  reader.release(0, NTFs);
+
+  // trailer cut off, the index is rebuilt by scanning the records
+  writeFile(fileName, data, data.size() - sizeof(CTFFlatFileTrailer));
+  reader.open(fileName);
+  checkReader(reader, NTFs);
+
+  // the index and trailer are missing and the last record is truncated in the middle of a page
+  const auto lastEntry = get<CTFFlatIndexEntry>(data, trailer.indexOffset + (NTFs - 1) * sizeof(CTFFlatIndexEntry));
+  writeFile(fileName, data, lastEntry.offset + lastEntry.size - CTFFlatFileWriter::PageSize / 2);
+  reader.open(fileName);
+  checkReader(reader, NTFs - 1);
+
+  // only the header of the last record is present
+  writeFile(fileName, data, lastEntry.offset + sizeof(CTFFlatRecordHeader));
+  reader.open(fileName);
+  checkReader(reader, NTFs - 1);
+
+  // a corrupted number of entries in the trailer must not be used, the records are scanned instead
+  auto corrupted = data;
+  auto badTrailer = trailer;
+  badTrailer.nEntries = (uint64_t(1) << 61) + NTFs; // nEntries * sizeof(CTFFlatIndexEntry) wraps around to the valid size
+  memcpy(corrupted.data() + corrupted.size() - sizeof(CTFFlatFileTrailer), &badTrailer, sizeof(badTrailer));
+  writeFile(fileName, corrupted, corrupted.size());
+  reader.open(fileName);
+  checkReader(reader, NTFs);
+
+  // index entry pointing outside of the records
+  corrupted = data;
+  auto badEntry = lastEntry;
+  badEntry.size = trailer.indexOffset;
+  memcpy(corrupted.data() + trailer.indexOffset + (NTFs - 1) * sizeof(CTFFlatIndexEntry), &badEntry, sizeof(badEntry));
+  writeFile(fileName, corrupted, corrupted.size());
+  reader.open(fileName);
+  checkReader(reader, NTFs);
+
+  // record with zero size must stop the scan
+  corrupted = data;
+  auto badRecord = get<CTFFlatRecordHeader>(data, lastEntry.offset);
+  badRecord.size = 0;
+  memcpy(corrupted.data() + lastEntry.offset, &badRecord, sizeof(badRecord));
+  writeFile(fileName, corrupted, trailer.indexOffset);
+  reader.open(fileName);
+  checkReader(reader, NTFs - 1);
+
+  // files too short for the header or with a wrong page size are rejected
+  writeFile(fileName, data, 0);
+  BOOST_CHECK_THROW(reader.open(fileName), std::runtime_error);
+  writeFile(fileName, data, sizeof(CTFFlatFileHeader) - 1);
+  BOOST_CHECK_THROW(reader.open(fileName), std::runtime_error);
+  BOOST_CHECK(!reader.isOpen());
+  corrupted = data;
+  auto badHeader = get<CTFFlatFileHeader>(data, 0);
+  badHeader.pageSize = 0;
+  memcpy(corrupted.data(), &badHeader, sizeof(badHeader));
+  writeFile(fileName, corrupted, corrupted.size());
+  BOOST_CHECK_THROW(reader.open(fileName), std::runtime_error);
+
+  std::filesystem::remove(fileName);
+}
@@ -143,6 +143,24 @@ BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions) ^ boost_data::make(C
       }
     }
     coder.encode(vecIO, c, c, trigComp); // compress
+    // concurrent encoding of the blocks must produce an identical CTF
+    std::vector<o2::ctf::BufferType> vecIOPar;
+    coder.setNThreads(4);
+    coder.encode(vecIOPar, c, c, trigComp);
+    BOOST_CHECK(vecIOPar.size() == vecIO.size());
+    const auto* ctf = o2::tpc::CTF::get(vecIO.data());
+    const auto* ctfPar = o2::tpc::CTF::get(vecIOPar.data());
+    for (int i = 0; i < o2::tpc::CTF::getNBlocks(); i++) {
+      const auto &md = ctf->getMetadata(i), &mdPar = ctfPar->getMetadata(i);
+      BOOST_CHECK(md.opt == mdPar.opt && md.messageLength == mdPar.messageLength);
+      BOOST_CHECK(md.nDictWords == mdPar.nDictWords && md.nDataWords == mdPar.nDataWords && md.nLiteralWords == mdPar.nLiteralWords);
+      const auto &bl = ctf->getBlock(i), &blPar = ctfPar->getBlock(i);
+      BOOST_CHECK(bl.getNStored() == blPar.getNStored());
+      if (bl.getNStored()) {
+        BOOST_CHECK(reinterpret_cast<const char*>(bl.payload) - reinterpret_cast<const char*>(vecIO.data()) == reinterpret_cast<const char*>(blPar.payload) - reinterpret_cast<const char*>(vecIOPar.data()));
+        BOOST_CHECK(memcmp(bl.payload, blPar.payload, bl.getNStored() * sizeof(*bl.payload)) == 0);
+      }
+    }
   }
   sw.Stop();
   LOG(info) << "Compressed in " << sw.CpuTime() << " s";
@@ -182,6 +200,17 @@ BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions) ^ boost_data::make(C
   }
   sw.Stop();
   LOG(info) << "Decompressed in " << sw.CpuTime() << " s";
+  {
+    // concurrent decoding of the blocks
+    std::vector<char> vecInPar;
+    std::vector<o2::tpc::TriggerInfoDLBZS> triggersRPar;
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.setCombineColumns(true);
+    coder.setNThreads(4);
+    coder.decode(ctfImage, vecInPar, triggersRPar);
+    BOOST_CHECK(vecInPar.size() == vecIn.size() && memcmp(vecInPar.data(), vecIn.data(), vecIn.size()) == 0);
+    BOOST_CHECK(triggersRPar.size() == triggersR.size() && memcmp(triggersRPar.data(), triggersR.data(), triggersR.size() * sizeof(o2::tpc::TriggerInfoDLBZS)) == 0);
+  }
   //
   // compare with original flat clusters
   BOOST_CHECK(vecIn.size() == bVec.size());
@@ -0,0 +1,156 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFFlatFile.h
+/// @brief  Flat binary container of CTFs, written with large page aligned writes
+
+#ifndef O2_CTF_FLATFILE_H
+#define O2_CTF_FLATFILE_H
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gsl/span>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+// The file consists of the CTFFlatFileHeader, one record per TF and the index of the records followed by the CTFFlatFileTrailer.
+// Every record starts at a page aligned offset with the CTFFlatRecordHeader, the detector images follow it aligned to o2::ctf::Alignment,
+// so that they can be used in place by CTF::getImage.
+struct CTFFlatFileHeader {
+  static constexpr uint64_t Magic = 0x3130465443324f; // "O2CTF01"
+  uint64_t magic = Magic;
+  uint32_t version = 1;
+  uint32_t pageSize = 0; // alignment of the records
+};
+
+struct CTFFlatRecordHeader {
+  static constexpr uint64_t Magic = 0x4443524654434f; // "OCTFRCD"
+  uint64_t magic = Magic;
+  uint64_t size = 0;                                  // size of the record, including this header
+  CTFHeader header{};                                 // CTF header of the TF
+  std::array<uint64_t, o2::detectors::DetID::nDetectors> offsets{}; // offset of the image of every detector wrt the record start
+  std::array<uint64_t, o2::detectors::DetID::nDetectors> sizes{};   // size of the image of every detector
+};
+
+struct CTFFlatIndexEntry {
+  uint64_t offset = 0; // offset of the record in the file
+  uint64_t size = 0;   // size of the record
+  uint64_t run = 0;
+  uint32_t firstTForbit = 0;
+  uint32_t tfCounter = 0;
+};
+
+struct CTFFlatFileTrailer {
+  static constexpr uint64_t Magic = 0x58444e4654434f; // "OCTFNDX"
+  uint64_t indexOffset = 0;
+  uint64_t nEntries = 0;
+  uint64_t magic = Magic;
+};
+
+using CTFImages = std::array<gsl::span<const o2::ctf::BufferType>, o2::detectors::DetID::nDetectors>;
+
+/// writer of the flat CTF container: the data are staged in a page aligned buffer which is written to the file only when full
+class CTFFlatFileWriter
+{
+ public:
+  static constexpr size_t PageSize = 4096;
+  static constexpr const char* FileEnding = ".ctfbin";
+
+  /// bufferSize is rounded up to the page size, with directIO the page cache is bypassed if the file system supports it
+  CTFFlatFileWriter(size_t bufferSize, bool directIO = false);
+  ~CTFFlatFileWriter();
+
+  void open(const std::string& fileName);
+  /// flush the data, write the index and close the file
+  void close();
+  bool isOpen() const { return mFD != -1; }
+  /// add the images of the CTF of a TF, returns the size of the record
+  size_t addTF(const CTFHeader& header, const CTFImages& images);
+
+  size_t getSize() const { return mFileOffset + mBufferFill; }
+  size_t getNTFs() const { return mIndex.size(); }
+  size_t getNWrites() const { return mNWrites; }
+  const std::string& getFileName() const { return mFileName; }
+
+ private:
+  void append(const void* data, size_t size);
+  void padTo(size_t alignment);
+  void flush(bool final);
+
+  struct Deleter {
+    void operator()(char* p) const { std::free(p); }
+  };
+  std::unique_ptr<char, Deleter> mBuffer;
+  size_t mBufferSize = 0;
+  size_t mBufferFill = 0;
+  size_t mFileOffset = 0; // bytes already written to the file
+  size_t mNWrites = 0;
+  int mFD = -1;
+  bool mDirectIO = false;
+  bool mUseDirectIO = false; // direct I/O is used for the current file
+  std::string mFileName;
+  std::vector<CTFFlatIndexEntry> mIndex;
+};
+
+/// reader of the flat CTF container: the file is memory mapped and the detector images are used in place.
+/// The index is taken from the end of the file or, if the file was not closed properly, rebuilt by scanning the records.
+class CTFFlatFileReader
+{
+ public:
+  CTFFlatFileReader() = default;
+  ~CTFFlatFileReader() { close(); }
+  CTFFlatFileReader(const CTFFlatFileReader&) = delete;
+  CTFFlatFileReader& operator=(const CTFFlatFileReader&) = delete;
+
+  /// map the file and load its index, throws on failure
+  void open(const std::string& fileName);
+  void close();
+  bool isOpen() const { return mData != nullptr; }
+
+  size_t getNTFs() const { return mIndex.size(); }
+  const std::vector<CTFFlatIndexEntry>& getIndex() const { return mIndex; }
+  const CTFFlatRecordHeader& getRecord(size_t i) const { return *reinterpret_cast<const CTFFlatRecordHeader*>(mData + mIndex[i].offset); }
+  CTFImages getImages(size_t i) const;
+  /// index of the TF with given counter or first orbit, -1 if absent
+  long findTF(uint32_t tfCounter) const;
+  long findOrbit(uint32_t firstTForbit) const;
+  /// ask the kernel to read ahead the records [first, first + n) or the records fitting to maxBytes, returns the number of records
+  size_t prefetch(size_t first, size_t n, size_t maxBytes) const;
+  /// drop the pages of the records [first, first + n) from the mapping
+  void release(size_t first, size_t n) const;
+  const std::string& getFileName() const { return mFileName; }
+
+ private:
+  bool loadIndex();
+  void scanRecords();
+  bool checkRecord(size_t offset, size_t size, size_t end) const;
+  void advise(size_t first, size_t n, int advice) const;
+
+  const char* mData = nullptr;
+  size_t mSize = 0;
+  std::string mFileName;
+  std::vector<CTFFlatIndexEntry> mIndex;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
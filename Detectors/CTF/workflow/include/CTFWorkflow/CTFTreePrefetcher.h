@@ -0,0 +1,100 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFTreePrefetcher.h
+/// @brief  Read-ahead of the CTFs stored in the ROOT tree
+
+#ifndef O2_CTF_TREEPREFETCHER_H
+#define O2_CTF_TREEPREFETCHER_H
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "CTFWorkflow/CTFFlatFile.h"
+
+class TTree;
+
+namespace o2
+{
+namespace ctf
+{
+
+/// Reads the requested entries of the CTF tree of a file in a separate thread, in the order of the request,
+/// keeping at most maxTFs TFs and maxBytes of data (but at least 1 TF) ready for the consumer.
+/// The file is opened by the prefetcher itself, ROOT::EnableThreadSafety must be called by the user.
+class CTFTreePrefetcher
+{
+ public:
+  using DetID = o2::detectors::DetID;
+  using Reader = void (*)(std::vector<o2::ctf::BufferType>&, TTree&, const std::string&, int);
+
+  struct TF {
+    long entry = -1;
+    std::array<std::vector<o2::ctf::BufferType>, DetID::nDetectors> buffers{};
+    size_t size = 0;
+    CTFImages getImages() const;
+  };
+
+  /// reader of the CTF of detector type C
+  template <typename C>
+  static void readImage(std::vector<o2::ctf::BufferType>& vec, TTree& tree, const std::string& name, int ev)
+  {
+    vec.resize(sizeof(C));
+    C::readFromTree(vec, tree, name, ev);
+  }
+
+  /// readers for the detectors of the mask, the others are set to nullptr
+  static std::array<Reader, DetID::nDetectors> getReaders(DetID::mask_t dets);
+
+  /// readers must be provided for the detectors to read, headers is the index of the tree (the header of every entry)
+  CTFTreePrefetcher(const std::string& fileName, std::vector<long> entries, const std::vector<CTFHeader>& headers,
+                    const std::array<Reader, DetID::nDetectors>& readers, size_t maxTFs, size_t maxBytes);
+  ~CTFTreePrefetcher();
+
+  /// get the next requested entry, blocks until it is read, rethrows the exception of the reading thread
+  TF next();
+  bool hasNext() const { return mNConsumed < mEntries.size(); }
+  double getWaitTime() const { return mWaitTime; } // total time (s) spent waiting for the data
+
+ private:
+  void run();
+
+  std::string mFileName;
+  std::vector<long> mEntries;
+  std::vector<DetID::mask_t> mDetectors; // detectors to read for every requested entry
+  std::array<Reader, DetID::nDetectors> mReaders{};
+  size_t mMaxTFs = 1;
+  size_t mMaxBytes = 0;
+  size_t mNConsumed = 0;
+  double mWaitTime = 0.;
+
+  std::thread mThread;
+  std::mutex mMutex;
+  std::condition_variable mReadyCV; // TF was read
+  std::condition_variable mFreeCV;  // TF was consumed or stop requested
+  std::deque<TF> mQueue;
+  size_t mQueuedBytes = 0;
+  bool mStop = false;
+  std::exception_ptr mError;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
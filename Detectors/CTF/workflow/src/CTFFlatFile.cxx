@@ -0,0 +1,354 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFFlatFile.cxx
+
+#include "CTFWorkflow/CTFFlatFile.h"
+#include "Framework/Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+//___________________________________________________________________
+CTFFlatFileWriter::CTFFlatFileWriter(size_t bufferSize, bool directIO) : mDirectIO(directIO)
+{
+  mBufferSize = std::max(PageSize, ((bufferSize + PageSize - 1) / PageSize) * PageSize);
+  mBuffer.reset(static_cast<char*>(std::aligned_alloc(PageSize, mBufferSize)));
+  if (!mBuffer) {
+    throw std::bad_alloc();
+  }
+}
+
+//___________________________________________________________________
+CTFFlatFileWriter::~CTFFlatFileWriter()
+{
+  try {
+    close();
+  } catch (const std::exception& e) {
+    LOGP(error, "Failed to close {}, reason: {}", mFileName, e.what());
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::open(const std::string& fileName)
+{
+  close();
+  mUseDirectIO = false;
+#ifdef O_DIRECT
+  if (mDirectIO) {
+    mFD = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    mUseDirectIO = mFD != -1;
+    if (!mUseDirectIO) {
+      LOGP(warning, "Direct I/O is not supported for {}, reason: {}, will use buffered writes", fileName, strerror(errno));
+    }
+  }
+#endif
+  if (mFD == -1) {
+    mFD = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  }
+  if (mFD == -1) {
+    throw std::runtime_error(fmt::format("Failed to open {}, reason: {}", fileName, strerror(errno)));
+  }
+  mFileName = fileName;
+  mFileOffset = 0;
+  mBufferFill = 0;
+  mNWrites = 0;
+  mIndex.clear();
+  CTFFlatFileHeader fileHeader;
+  fileHeader.pageSize = PageSize;
+  append(&fileHeader, sizeof(fileHeader));
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::close()
+{
+  if (mFD == -1) {
+    return;
+  }
+  // index and trailer
+  padTo(alignof(CTFFlatIndexEntry));
+  CTFFlatFileTrailer trailer;
+  trailer.indexOffset = getSize();
+  trailer.nEntries = mIndex.size();
+  append(mIndex.data(), mIndex.size() * sizeof(CTFFlatIndexEntry));
+  append(&trailer, sizeof(trailer));
+  size_t nWrites = mNWrites;
+  flush(true);
+  ::close(mFD);
+  mFD = -1;
+  LOGP(info, "Closed {} with {} CTFs, {} bytes, in {} writes", mFileName, mIndex.size(), mFileOffset, nWrites + 1);
+  mIndex.clear();
+}
+
+//___________________________________________________________________
+size_t CTFFlatFileWriter::addTF(const CTFHeader& header, const CTFImages& images)
+{
+  padTo(PageSize);
+  const size_t recordStart = getSize();
+  CTFFlatRecordHeader record;
+  record.header = header;
+  size_t offset = alignSize(sizeof(CTFFlatRecordHeader));
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (images[id].size()) {
+      record.offsets[id] = offset;
+      record.sizes[id] = images[id].size();
+      offset += alignSize(images[id].size());
+    }
+  }
+  record.size = offset;
+  append(&record, sizeof(record));
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (images[id].size()) {
+      padTo(Alignment);
+      append(images[id].data(), images[id].size());
+    }
+  }
+  padTo(Alignment);
+  mIndex.push_back(CTFFlatIndexEntry{recordStart, record.size, header.run, header.firstTForbit, header.tfCounter});
+  return record.size;
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::append(const void* data, size_t size)
+{
+  const auto* src = static_cast<const char*>(data);
+  while (size) {
+    const size_t n = std::min(size, mBufferSize - mBufferFill);
+    memcpy(mBuffer.get() + mBufferFill, src, n);
+    mBufferFill += n;
+    src += n;
+    size -= n;
+    if (mBufferFill == mBufferSize) {
+      flush(false);
+    }
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::padTo(size_t alignment)
+{
+  static const std::array<char, PageSize> zeros{};
+  size_t res = getSize() % alignment;
+  if (res) {
+    append(zeros.data(), alignment - res);
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::flush(bool final)
+{
+  // only full pages can be written with direct I/O, the final partial page is padded and the file is truncated to its actual size
+  const size_t dataSize = mBufferFill;
+  size_t writeSize = dataSize;
+  if (mUseDirectIO && (writeSize % PageSize)) {
+    writeSize += PageSize - writeSize % PageSize;
+    memset(mBuffer.get() + dataSize, 0, writeSize - dataSize);
+  }
+  size_t written = 0;
+  while (written < writeSize) {
+    auto n = ::write(mFD, mBuffer.get() + written, writeSize - written);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(fmt::format("Failed to write {} bytes to {}, reason: {}", writeSize - written, mFileName, strerror(errno)));
+    }
+    written += n;
+  }
+  mNWrites++;
+  mFileOffset += dataSize;
+  mBufferFill = 0;
+  if (final && writeSize != dataSize && ftruncate(mFD, mFileOffset) != 0) {
+    throw std::runtime_error(fmt::format("Failed to truncate {} to {} bytes, reason: {}", mFileName, mFileOffset, strerror(errno)));
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::open(const std::string& fileName)
+{
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::runtime_error(fmt::format("Failed to open {}, reason: {}", fileName, strerror(errno)));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("Failed to stat {}, reason: {}", fileName, strerror(errno)));
+  }
+  // the file header must be present before anything is read from the mapping
+  if (size_t(st.st_size) < sizeof(CTFFlatFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("{} is too short for a flat CTF container", fileName));
+  }
+  auto* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping keeps the file open
+  if (data == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("Failed to map {}, reason: {}", fileName, strerror(errno)));
+  }
+  mData = static_cast<const char*>(data);
+  mSize = st.st_size;
+  mFileName = fileName;
+  const auto& fileHeader = *reinterpret_cast<const CTFFlatFileHeader*>(mData);
+  if (fileHeader.magic != CTFFlatFileHeader::Magic) {
+    close();
+    throw std::runtime_error(fmt::format("{} is not a flat CTF container", fileName));
+  }
+  if (fileHeader.pageSize == 0 || (fileHeader.pageSize & (fileHeader.pageSize - 1))) {
+    auto pageSize = fileHeader.pageSize;
+    close();
+    throw std::runtime_error(fmt::format("{} has invalid page size {}", fileName, pageSize));
+  }
+  if (!loadIndex()) {
+    LOGP(warning, "{} has no valid index, it will be rebuilt from the records", fileName);
+    scanRecords();
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::close()
+{
+  if (mData) {
+    munmap(const_cast<char*>(mData), mSize);
+    mData = nullptr;
+  }
+  mSize = 0;
+  mIndex.clear();
+}
+
+//___________________________________________________________________
+bool CTFFlatFileReader::loadIndex()
+{
+  if (mSize < sizeof(CTFFlatFileHeader) + sizeof(CTFFlatFileTrailer)) {
+    return false;
+  }
+  const size_t indexEnd = mSize - sizeof(CTFFlatFileTrailer);
+  const auto& trailer = *reinterpret_cast<const CTFFlatFileTrailer*>(mData + indexEnd);
+  // bound the trailer fields by the file size before using them in any arithmetics
+  if (trailer.magic != CTFFlatFileTrailer::Magic || trailer.indexOffset > indexEnd || trailer.indexOffset % alignof(CTFFlatIndexEntry) ||
+      trailer.nEntries > (indexEnd - trailer.indexOffset) / sizeof(CTFFlatIndexEntry) ||
+      trailer.indexOffset + trailer.nEntries * sizeof(CTFFlatIndexEntry) != indexEnd) {
+    return false;
+  }
+  const size_t pageSize = reinterpret_cast<const CTFFlatFileHeader*>(mData)->pageSize;
+  const auto* entries = reinterpret_cast<const CTFFlatIndexEntry*>(mData + trailer.indexOffset);
+  mIndex.assign(entries, entries + trailer.nEntries);
+  for (const auto& entry : mIndex) {
+    if (entry.offset < pageSize || entry.offset % pageSize || !checkRecord(entry.offset, entry.size, trailer.indexOffset)) {
+      mIndex.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::scanRecords()
+{
+  // records start at page aligned offsets, the scan stops at the first incomplete record
+  const size_t pageSize = reinterpret_cast<const CTFFlatFileHeader*>(mData)->pageSize;
+  size_t offset = pageSize;
+  mIndex.clear();
+  while (offset + sizeof(CTFFlatRecordHeader) <= mSize) {
+    const auto& record = *reinterpret_cast<const CTFFlatRecordHeader*>(mData + offset);
+    if (!checkRecord(offset, record.size, mSize)) {
+      break;
+    }
+    mIndex.push_back(CTFFlatIndexEntry{offset, record.size, record.header.run, record.header.firstTForbit, record.header.tfCounter});
+    offset += ((record.size + pageSize - 1) / pageSize) * pageSize;
+  }
+}
+
+//___________________________________________________________________
+bool CTFFlatFileReader::checkRecord(size_t offset, size_t size, size_t end) const
+{
+  // the record of given size must fit to [offset, end) and its images must lie within the record
+  if (offset > end || size < sizeof(CTFFlatRecordHeader) || size > end - offset) {
+    return false;
+  }
+  const auto& record = *reinterpret_cast<const CTFFlatRecordHeader*>(mData + offset);
+  if (record.magic != CTFFlatRecordHeader::Magic || record.size != size) {
+    return false;
+  }
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (record.sizes[id] && (record.offsets[id] < sizeof(CTFFlatRecordHeader) || record.offsets[id] > size || record.sizes[id] > size - record.offsets[id])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//___________________________________________________________________
+CTFImages CTFFlatFileReader::getImages(size_t i) const
+{
+  CTFImages images{};
+  const auto& record = getRecord(i);
+  const auto* recordStart = reinterpret_cast<const o2::ctf::BufferType*>(&record);
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (record.sizes[id]) {
+      images[id] = gsl::span<const o2::ctf::BufferType>(recordStart + record.offsets[id], record.sizes[id]);
+    }
+  }
+  return images;
+}
+
+//___________________________________________________________________
+long CTFFlatFileReader::findTF(uint32_t tfCounter) const
+{
+  auto it = std::find_if(mIndex.begin(), mIndex.end(), [tfCounter](const auto& entry) { return entry.tfCounter == tfCounter; });
+  return it == mIndex.end() ? -1 : long(it - mIndex.begin());
+}
+
+//___________________________________________________________________
+long CTFFlatFileReader::findOrbit(uint32_t firstTForbit) const
+{
+  auto it = std::find_if(mIndex.begin(), mIndex.end(), [firstTForbit](const auto& entry) { return entry.firstTForbit == firstTForbit; });
+  return it == mIndex.end() ? -1 : long(it - mIndex.begin());
+}
+
+//___________________________________________________________________
+size_t CTFFlatFileReader::prefetch(size_t first, size_t n, size_t maxBytes) const
+{
+  size_t nPref = 0, bytes = 0;
+  while (first + nPref < mIndex.size() && nPref < n && (!nPref || bytes + mIndex[first + nPref].size <= maxBytes)) {
+    bytes += mIndex[first + nPref++].size;
+  }
+  advise(first, nPref, MADV_WILLNEED);
+  return nPref;
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::release(size_t first, size_t n) const
+{
+  advise(first, n, MADV_DONTNEED);
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::advise(size_t first, size_t n, int advice) const
+{
+  if (!n || first >= mIndex.size()) {
+    return;
+  }
+  const size_t last = std::min(first + n, mIndex.size()) - 1;
+  const size_t start = mIndex[first].offset; // page aligned
+  const size_t end = mIndex[last].offset + mIndex[last].size;
+  if (madvise(const_cast<char*>(mData) + start, end - start, advice) != 0) {
+    LOGP(debug, "madvise({}) failed for {}, reason: {}", advice, mFileName, strerror(errno));
+  }
+}
@@ -12,8 +12,11 @@
 /// @file   CTFReaderSpec.cxx
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
 #include <TFile.h>
 #include <TTree.h>
+#include <TROOT.h>
 
 #include "Framework/Logger.h"
 #include "Framework/ControlService.h"
@@ -26,6 +29,8 @@
 #include "CommonUtils/IRFrameSelector.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "CTFWorkflow/CTFReaderSpec.h"
+#include "CTFWorkflow/CTFFlatFile.h"
+#include "CTFWorkflow/CTFTreePrefetcher.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "CommonUtils/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
@@ -82,11 +87,18 @@ class CTFReaderSpec : public o2::framework::Task
 
  private:
   void openCTFFile(const std::string& flname);
+  void closeCTFFile();
+  void buildTFIndex();
+  void selectEntries();
+  bool isFileOpen() const { return mCTFTree || mFlatFile.isOpen(); }
+  long getNEntries() const { return mTFIndex.size(); }
+  std::string getFileName() const { return mCTFFile ? mCTFFile->GetName() : mFlatFile.getFileName(); }
+  CTFImages getImages();
   bool processTF(ProcessingContext& pc);
   void checkTreeEntries();
   void stopReader();
   template <typename C>
-  void processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const;
+  void processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc, const CTFImages& images) const;
   void setMessageHeader(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& lbl, unsigned subspec) const; // keep just for the reference
   void tryToFixCTFHeader(CTFHeader& ctfHeader) const;
   CTFReaderInp mInput{};
@@ -94,9 +106,24 @@ class CTFReaderSpec : public o2::framework::Task
   std::unique_ptr<o2::utils::FileFetcher> mFileFetcher;
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  CTFFlatFileReader mFlatFile;                    // used instead of the tree for the flat CTF container
+  std::unique_ptr<CTFTreePrefetcher> mPrefetcher; // reads ahead the selected CTFs of the tree
+  CTFTreePrefetcher::TF mPrefetchedTF{};          // CTF being processed, provided by the prefetcher
+  std::array<CTFTreePrefetcher::Reader, DetID::nDetectors> mReaders{};
+  std::vector<CTFHeader> mTFIndex{};              // headers of all CTFs of the current file
+  std::vector<long> mSelEntries{};                // entries of the current file to process
+  std::vector<uint32_t> mSelTFCounters{};         // if not empty, process only CTFs with these TF counters
+  uint32_t mSelOrbitMin = 0;                      // process only CTFs with 1st orbit in [mSelOrbitMin : mSelOrbitMax]
+  uint32_t mSelOrbitMax = 0xffffffff;
+  int mPrefetchTFs = 0;                           // if > 0, read ahead this number of CTFs
+  size_t mPrefetchBytes = 0;                      // max size of the CTFs read ahead
+  size_t mNextSelEntry = 0;                       // next entry to process from mSelEntries
+  size_t mNFlatPrefetched = 0;                    // number of mSelEntries of the flat file for which the read-ahead was requested
+  double mPrefetchWaitTime = 0.;                  // total time (s) spent waiting for the prefetcher
   bool mRunning = false;
   bool mUseLocalTFCounter = false;
   int mCTFCounter = 0;
+  int mFileCTFCounter0 = 0; // CTF counter of the 1st entry of the current file
   int mNFailedFiles = 0;
   int mFilesRead = 0;
   int mTFLength = 128;
@@ -114,6 +141,7 @@ CTFReaderSpec::CTFReaderSpec(const CTFReaderInp& inp) : mInput(inp)
 {
   mTimer.Stop();
   mTimer.Reset();
+  mReaders = CTFTreePrefetcher::getReaders(mInput.detMask);
 }
 
 ///_______________________________________
@@ -134,11 +162,10 @@ void CTFReaderSpec::stopReader()
   mRunning = false;
   mFileFetcher->stop();
   mFileFetcher.reset();
-  mCTFTree.reset();
-  if (mCTFFile) {
-    mCTFFile->Close();
+  closeCTFFile();
+  if (mPrefetchTFs > 0) {
+    LOGP(info, "CTF reading waited {:.3f} s for the data read ahead", mPrefetchWaitTime);
   }
-  mCTFFile.reset();
 }
 
 ///_______________________________________
@@ -148,6 +175,24 @@ void CTFReaderSpec::init(InitContext& ic)
   mUseLocalTFCounter = ic.options().get<bool>("local-tf-counter");
   mImposeRunStartMS = ic.options().get<int64_t>("impose-run-start-timstamp");
   mInput.checkTFLimitBeforeReading = ic.options().get<bool>("limit-tf-before-reading");
+  for (auto tf : o2::RangeTokenizer::tokenize<int>(ic.options().get<std::string>("select-tf-counters"))) {
+    mSelTFCounters.push_back(uint32_t(tf));
+  }
+  std::sort(mSelTFCounters.begin(), mSelTFCounters.end());
+  auto orbitRange = o2::utils::Str::tokenize(ic.options().get<std::string>("select-orbit-range"), ':', true, false);
+  if (orbitRange.size() == 2) {
+    mSelOrbitMin = orbitRange[0].empty() ? 0 : std::stoul(orbitRange[0]);
+    mSelOrbitMax = orbitRange[1].empty() ? 0xffffffff : std::stoul(orbitRange[1]);
+    LOGP(info, "Only CTFs with 1st orbit in [{}:{}] will be processed", mSelOrbitMin, mSelOrbitMax);
+  } else if (!orbitRange.empty()) {
+    throw std::invalid_argument("select-orbit-range must be in the format min:max");
+  }
+  mPrefetchTFs = ic.options().get<int>("prefetch-tfs");
+  mPrefetchBytes = size_t(std::max(1, ic.options().get<int>("prefetch-memory-mb"))) << 20;
+  if (mPrefetchTFs > 0) {
+    ROOT::EnableThreadSafety(); // the CTF trees are read by the prefetcher thread
+    LOGP(info, "Up to {} CTFs of at most {} MB will be read ahead", mPrefetchTFs, mPrefetchBytes >> 20);
+  }
   mRunning = true;
   mFileFetcher = std::make_unique<o2::utils::FileFetcher>(mInput.inpdata, mInput.tffileRegex, mInput.remoteRegex, mInput.copyCmd);
   mFileFetcher->setMaxFilesInQueue(mInput.maxFileCache);
@@ -167,21 +212,32 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
   try {
     mFilesRead++;
-    mCTFFile.reset(TFile::Open(flname.c_str()));
-    if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
-      throw std::runtime_error(fmt::format("failed to open CTF file {}, skipping", flname));
-    }
-    mCTFTree.reset((TTree*)mCTFFile->Get(std::string(o2::base::NameConf::CTFTREENAME).c_str()));
-    if (!mCTFTree) {
-      throw std::runtime_error(fmt::format("failed to load CTF tree from {}, skipping", flname));
+    if (o2::utils::Str::endsWith(flname, CTFFlatFileWriter::FileEnding)) {
+      mFlatFile.open(flname);
+      if (mFlatFile.getNTFs() < 1) {
+        throw std::runtime_error(fmt::format("flat CTF container {} has 0 entries, skipping", flname));
+      }
+    } else {
+      mCTFFile.reset(TFile::Open(flname.c_str()));
+      if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
+        throw std::runtime_error(fmt::format("failed to open CTF file {}, skipping", flname));
+      }
+      mCTFTree.reset((TTree*)mCTFFile->Get(std::string(o2::base::NameConf::CTFTREENAME).c_str()));
+      if (!mCTFTree) {
+        throw std::runtime_error(fmt::format("failed to load CTF tree from {}, skipping", flname));
+      }
+      if (mCTFTree->GetEntries() < 1) {
+        throw std::runtime_error(fmt::format("CTF tree in {} has 0 entries, skipping", flname));
+      }
     }
-    if (mCTFTree->GetEntries() < 1) {
-      throw std::runtime_error(fmt::format("CTF tree in {} has 0 entries, skipping", flname));
+    buildTFIndex();
+    selectEntries();
+    if (mCTFTree && mPrefetchTFs > 0 && !mSelEntries.empty()) {
+      mPrefetcher = std::make_unique<CTFTreePrefetcher>(flname, mSelEntries, mTFIndex, mReaders, mPrefetchTFs, mPrefetchBytes);
     }
   } catch (const std::exception& e) {
     LOG(error) << "Cannot process " << flname << ", reason: " << e.what();
-    mCTFTree.reset();
-    mCTFFile.reset();
+    closeCTFFile();
     mNFailedFiles++;
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
@@ -190,6 +246,96 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
   mCurrTreeEntry = 0;
 }
 
+///_______________________________________
+void CTFReaderSpec::closeCTFFile()
+{
+  if (mPrefetcher) {
+    mPrefetchWaitTime += mPrefetcher->getWaitTime();
+    mPrefetcher.reset();
+  }
+  mPrefetchedTF = CTFTreePrefetcher::TF{};
+  mCTFTree.reset();
+  if (mCTFFile) {
+    mCTFFile->Close();
+  }
+  mCTFFile.reset();
+  mFlatFile.close();
+  mTFIndex.clear();
+  mSelEntries.clear();
+  mNextSelEntry = 0;
+  mNFlatPrefetched = 0;
+}
+
+///_______________________________________
+void CTFReaderSpec::buildTFIndex()
+{
+  // headers of all CTFs of the file, used for the selection of the CTFs to process
+  if (mFlatFile.isOpen()) {
+    for (size_t i = 0; i < mFlatFile.getNTFs(); i++) {
+      mTFIndex.push_back(mFlatFile.getRecord(i).header);
+    }
+    return;
+  }
+  mTFIndex.resize(mCTFTree->GetEntries());
+  for (long i = 0; i < long(mTFIndex.size()); i++) {
+    if (!readFromTree(*(mCTFTree.get()), "CTFHeader", mTFIndex[i], i)) {
+      throw std::runtime_error("did not find CTFHeader");
+    }
+  }
+}
+
+///_______________________________________
+void CTFReaderSpec::selectEntries()
+{
+  for (long i = 0; i < getNEntries(); i++) {
+    int counter = mFileCTFCounter0 + i;
+    const auto& header = mTFIndex[i];
+    if (counter >= mInput.maxTFs) {
+      break;
+    }
+    if ((!mInput.ctfIDs.empty() && std::find(mInput.ctfIDs.begin(), mInput.ctfIDs.end(), counter) == mInput.ctfIDs.end()) ||
+        (!mSelTFCounters.empty() && !std::binary_search(mSelTFCounters.begin(), mSelTFCounters.end(), header.tfCounter)) ||
+        header.firstTForbit < mSelOrbitMin || header.firstTForbit > mSelOrbitMax) {
+      continue;
+    }
+    mSelEntries.push_back(i);
+  }
+  if (long(mSelEntries.size()) != getNEntries()) {
+    LOGP(info, "{} of {} CTFs ({}-{}) in {} are selected", mSelEntries.size(), getNEntries(), mFileCTFCounter0, mFileCTFCounter0 + getNEntries() - 1, getFileName());
+  }
+}
+
+///_______________________________________
+CTFImages CTFReaderSpec::getImages()
+{
+  // images of the current CTF if they are already in memory, the tree is read directly to the output otherwise
+  if (mPrefetcher) {
+    mPrefetchedTF = mPrefetcher->next();
+    if (mPrefetchedTF.entry != mCurrTreeEntry) {
+      throw std::runtime_error(fmt::format("prefetched CTF entry {} differs from the requested {}", mPrefetchedTF.entry, mCurrTreeEntry));
+    }
+    return mPrefetchedTF.getImages();
+  }
+  if (mFlatFile.isOpen()) {
+    if (mPrefetchTFs > 0) { // request read-ahead of the selected CTFs following the current one
+      size_t bytes = 0;
+      mNFlatPrefetched = std::max(mNFlatPrefetched, mNextSelEntry);
+      for (size_t i = mNextSelEntry; i < mSelEntries.size() && i < mNextSelEntry + mPrefetchTFs; i++) {
+        bytes += mFlatFile.getIndex()[mSelEntries[i]].size;
+        if (bytes > mPrefetchBytes) {
+          break;
+        }
+        if (i >= mNFlatPrefetched) {
+          mFlatFile.prefetch(mSelEntries[i], 1, mPrefetchBytes);
+          mNFlatPrefetched = i + 1;
+        }
+      }
+    }
+    return mFlatFile.getImages(mCurrTreeEntry);
+  }
+  return {};
+}
+
 ///_______________________________________
 void CTFReaderSpec::run(ProcessingContext& pc)
 {
@@ -201,18 +347,20 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   long startWait = 0;
 
   while (mRunning) {
-    if (mCTFTree) { // there is a tree open with multiple CTF
-      if (mInput.ctfIDs.empty() || mInput.ctfIDs[mSelIDEntry] == mCTFCounter) { // no selection requested or matching CTF ID is found
+    if (isFileOpen()) { // there is a file open with multiple CTF, the entries not selected by the explicit CTF ID, TF counter or orbit selection are skipped
+      if (mNextSelEntry < mSelEntries.size()) {
+        mCurrTreeEntry = mSelEntries[mNextSelEntry++];
+        mCTFCounter = mFileCTFCounter0 + mCurrTreeEntry;
         LOG(debug) << "TF " << mCTFCounter << " of " << mInput.maxTFs << " loop " << mFileFetcher->getNLoops();
         mSelIDEntry++;
         if (processTF(pc)) {
+          checkTreeEntries();
           break;
         }
+        // IRFrame selection was provided and current entry is not selected
+        LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, getNEntries(), getFileName());
       }
-      // explict CTF ID selection list or IRFrame was provided and current entry is not selected
-      LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
       checkTreeEntries();
-      mCTFCounter++;
       continue;
     }
     //
@@ -244,7 +392,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   if (mCTFCounter >= mInput.maxTFs || (!mInput.ctfIDs.empty() && mSelIDEntry >= mInput.ctfIDs.size())) { // done
     LOGP(info, "All CTFs from selected range were injected, stopping");
     mRunning = false;
-  } else if (mRunning && !mCTFTree && mFileFetcher->getNextFileInQueue().empty() && !mFileFetcher->isRunning()) { // previous tree was done, can we read more?
+  } else if (mRunning && !isFileOpen() && mFileFetcher->getNextFileInQueue().empty() && !mFileFetcher->isRunning()) { // previous tree was done, can we read more?
     mRunning = false;
   }
 
@@ -262,10 +410,8 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
   mTimer.Start(false);
 
   static RateLimiter limiter;
-  CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
-    throw std::runtime_error("did not find CTFHeader");
-  }
+  CTFHeader ctfHeader = mTFIndex[mCurrTreeEntry];
+  const auto images = getImages(); // must be called also for the skipped CTF to keep the prefetcher in sync
   if (mImposeRunStartMS > 0) {
     ctfHeader.creationTime = mImposeRunStartMS + ctfHeader.firstTForbit * o2::constants::lhc::LHCOrbitMUS * 1e-3;
   }
@@ -309,22 +455,22 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
   // send CTF Header
   pc.outputs().snapshot({"header", mInput.subspec}, ctfHeader);
 
-  processDetector<o2::itsmft::CTF>(DetID::ITS, ctfHeader, pc);
-  processDetector<o2::itsmft::CTF>(DetID::MFT, ctfHeader, pc);
-  processDetector<o2::emcal::CTF>(DetID::EMC, ctfHeader, pc);
-  processDetector<o2::hmpid::CTF>(DetID::HMP, ctfHeader, pc);
-  processDetector<o2::phos::CTF>(DetID::PHS, ctfHeader, pc);
-  processDetector<o2::tpc::CTF>(DetID::TPC, ctfHeader, pc);
-  processDetector<o2::trd::CTF>(DetID::TRD, ctfHeader, pc);
-  processDetector<o2::ft0::CTF>(DetID::FT0, ctfHeader, pc);
-  processDetector<o2::fv0::CTF>(DetID::FV0, ctfHeader, pc);
-  processDetector<o2::fdd::CTF>(DetID::FDD, ctfHeader, pc);
-  processDetector<o2::tof::CTF>(DetID::TOF, ctfHeader, pc);
-  processDetector<o2::mid::CTF>(DetID::MID, ctfHeader, pc);
-  processDetector<o2::mch::CTF>(DetID::MCH, ctfHeader, pc);
-  processDetector<o2::cpv::CTF>(DetID::CPV, ctfHeader, pc);
-  processDetector<o2::zdc::CTF>(DetID::ZDC, ctfHeader, pc);
-  processDetector<o2::ctp::CTF>(DetID::CTP, ctfHeader, pc);
+  processDetector<o2::itsmft::CTF>(DetID::ITS, ctfHeader, pc, images);
+  processDetector<o2::itsmft::CTF>(DetID::MFT, ctfHeader, pc, images);
+  processDetector<o2::emcal::CTF>(DetID::EMC, ctfHeader, pc, images);
+  processDetector<o2::hmpid::CTF>(DetID::HMP, ctfHeader, pc, images);
+  processDetector<o2::phos::CTF>(DetID::PHS, ctfHeader, pc, images);
+  processDetector<o2::tpc::CTF>(DetID::TPC, ctfHeader, pc, images);
+  processDetector<o2::trd::CTF>(DetID::TRD, ctfHeader, pc, images);
+  processDetector<o2::ft0::CTF>(DetID::FT0, ctfHeader, pc, images);
+  processDetector<o2::fv0::CTF>(DetID::FV0, ctfHeader, pc, images);
+  processDetector<o2::fdd::CTF>(DetID::FDD, ctfHeader, pc, images);
+  processDetector<o2::tof::CTF>(DetID::TOF, ctfHeader, pc, images);
+  processDetector<o2::mid::CTF>(DetID::MID, ctfHeader, pc, images);
+  processDetector<o2::mch::CTF>(DetID::MCH, ctfHeader, pc, images);
+  processDetector<o2::cpv::CTF>(DetID::CPV, ctfHeader, pc, images);
+  processDetector<o2::zdc::CTF>(DetID::ZDC, ctfHeader, pc, images);
+  processDetector<o2::ctp::CTF>(DetID::CTP, ctfHeader, pc, images);
 
   // send sTF acknowledge message
   if (!mInput.sup0xccdb) {
@@ -334,8 +480,10 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
     stfDist.runNumber = uint32_t(ctfHeader.run);
   }
 
-  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
-  checkTreeEntries();
+  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, getNEntries(), getFileName());
+  if (mFlatFile.isOpen()) { // the images were copied to the output
+    mFlatFile.release(mCurrTreeEntry, 1);
+  }
   mTimer.Stop();
 
   // do we need to wait to respect the delay ?
@@ -359,11 +507,11 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
 ///_______________________________________
 void CTFReaderSpec::checkTreeEntries()
 {
-  // check if the tree has entries left, if needed, close current tree/file
-  if (++mCurrTreeEntry >= mCTFTree->GetEntries()) { // this file is done, check if there are other files
-    mCTFTree.reset();
-    mCTFFile->Close();
-    mCTFFile.reset();
+  // check if the file has selected entries left, if needed, close current tree/file
+  if (mNextSelEntry >= mSelEntries.size()) { // this file is done, check if there are other files
+    mFileCTFCounter0 += getNEntries();
+    mCTFCounter = mFileCTFCounter0;
+    closeCTFFile();
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
     }
@@ -387,10 +535,15 @@ void CTFReaderSpec::setMessageHeader(ProcessingContext& pc, const CTFHeader& ctf
 
 ///_______________________________________
 template <typename C>
-void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const
+void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc, const CTFImages& images) const
 {
   if (mInput.detMask[det]) {
     const auto lbl = det.getName();
+    if (ctfHeader.detectors[det] && !images[det].empty()) { // CTF image is already in memory
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({lbl, mInput.subspec}, images[det].size());
+      std::memcpy(bufVec.data(), images[det].data(), images[det].size());
+      return;
+    }
     auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({lbl, mInput.subspec}, ctfHeader.detectors[det] ? sizeof(C) : 0);
     if (ctfHeader.detectors[det]) {
       C::readFromTree(bufVec, *(mCTFTree.get()), lbl, mCurrTreeEntry);
@@ -474,6 +627,10 @@ DataProcessorSpec getCTFReaderSpec(const CTFReaderInp& inp)
   options.emplace_back(ConfigParamSpec{"local-tf-counter", VariantType::Bool, false, {"reassign header.tfCounter from local TF counter"}});
   options.emplace_back(ConfigParamSpec{"fetch-failure-threshold", VariantType::Float, 0.f, {"Fail if too many failures( >0: fraction, <0: abs number, 0: no threshold)"}});
   options.emplace_back(ConfigParamSpec{"limit-tf-before-reading", VariantType::Bool, false, {"Check TF limiting before reading new TF, otherwhise before injecting it"}});
+  options.emplace_back(ConfigParamSpec{"select-tf-counters", VariantType::String, "", {"comma-separated list of TF counters (from the CTF header) to inject"}});
+  options.emplace_back(ConfigParamSpec{"select-orbit-range", VariantType::String, "", {"inject only CTFs with the 1st TF orbit in the range min:max"}});
+  options.emplace_back(ConfigParamSpec{"prefetch-tfs", VariantType::Int, 0, {"if > 0, read ahead this number of CTFs in a separate thread (ROOT files) or via the page cache (flat CTF containers)"}});
+  options.emplace_back(ConfigParamSpec{"prefetch-memory-mb", VariantType::Int, 1024, {"max size in MB of the CTFs read ahead"}});
   if (!inp.metricChannel.empty()) {
     options.emplace_back(ConfigParamSpec{"channel-config", VariantType::String, inp.metricChannel, {"Out-of-band channel config for TF throttling"}});
   }
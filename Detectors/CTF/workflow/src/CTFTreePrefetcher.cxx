@@ -0,0 +1,174 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFTreePrefetcher.cxx
+
+#include "CTFWorkflow/CTFTreePrefetcher.h"
+#include "CommonUtils/NameConf.h"
+#include "Framework/Logger.h"
+#include "DataFormatsITSMFT/CTF.h"
+#include "DataFormatsTPC/CTF.h"
+#include "DataFormatsTRD/CTF.h"
+#include "DataFormatsFT0/CTF.h"
+#include "DataFormatsFV0/CTF.h"
+#include "DataFormatsFDD/CTF.h"
+#include "DataFormatsTOF/CTF.h"
+#include "DataFormatsMID/CTF.h"
+#include "DataFormatsMCH/CTF.h"
+#include "DataFormatsEMCAL/CTF.h"
+#include "DataFormatsPHOS/CTF.h"
+#include "DataFormatsCPV/CTF.h"
+#include "DataFormatsZDC/CTF.h"
+#include "DataFormatsHMP/CTF.h"
+#include "DataFormatsCTP/CTF.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+using namespace o2::ctf;
+
+//___________________________________________________________________
+std::array<CTFTreePrefetcher::Reader, CTFTreePrefetcher::DetID::nDetectors> CTFTreePrefetcher::getReaders(DetID::mask_t dets)
+{
+  std::array<Reader, DetID::nDetectors> readers{};
+  readers[DetID::ITS] = &readImage<o2::itsmft::CTF>;
+  readers[DetID::MFT] = &readImage<o2::itsmft::CTF>;
+  readers[DetID::EMC] = &readImage<o2::emcal::CTF>;
+  readers[DetID::HMP] = &readImage<o2::hmpid::CTF>;
+  readers[DetID::PHS] = &readImage<o2::phos::CTF>;
+  readers[DetID::TPC] = &readImage<o2::tpc::CTF>;
+  readers[DetID::TRD] = &readImage<o2::trd::CTF>;
+  readers[DetID::FT0] = &readImage<o2::ft0::CTF>;
+  readers[DetID::FV0] = &readImage<o2::fv0::CTF>;
+  readers[DetID::FDD] = &readImage<o2::fdd::CTF>;
+  readers[DetID::TOF] = &readImage<o2::tof::CTF>;
+  readers[DetID::MID] = &readImage<o2::mid::CTF>;
+  readers[DetID::MCH] = &readImage<o2::mch::CTF>;
+  readers[DetID::CPV] = &readImage<o2::cpv::CTF>;
+  readers[DetID::ZDC] = &readImage<o2::zdc::CTF>;
+  readers[DetID::CTP] = &readImage<o2::ctp::CTF>;
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (!dets[id]) {
+      readers[id] = nullptr;
+    }
+  }
+  return readers;
+}
+
+//___________________________________________________________________
+CTFImages CTFTreePrefetcher::TF::getImages() const
+{
+  CTFImages images{};
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    images[id] = buffers[id];
+  }
+  return images;
+}
+
+//___________________________________________________________________
+CTFTreePrefetcher::CTFTreePrefetcher(const std::string& fileName, std::vector<long> entries, const std::vector<CTFHeader>& headers,
+                                     const std::array<Reader, DetID::nDetectors>& readers, size_t maxTFs, size_t maxBytes)
+  : mFileName(fileName), mEntries(std::move(entries)), mReaders(readers), mMaxTFs(std::max(maxTFs, size_t(1))), mMaxBytes(maxBytes)
+{
+  DetID::mask_t readable{};
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (mReaders[id]) {
+      readable.set(id);
+    }
+  }
+  for (auto entry : mEntries) {
+    mDetectors.push_back(headers[entry].detectors & readable);
+  }
+  mThread = std::thread(&CTFTreePrefetcher::run, this);
+}
+
+//___________________________________________________________________
+CTFTreePrefetcher::~CTFTreePrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mFreeCV.notify_all();
+  if (mThread.joinable()) {
+    mThread.join();
+  }
+}
+
+//___________________________________________________________________
+CTFTreePrefetcher::TF CTFTreePrefetcher::next()
+{
+  if (!hasNext()) {
+    throw std::runtime_error(fmt::format("all {} requested CTFs of {} were already provided", mEntries.size(), mFileName));
+  }
+  auto tStart = std::chrono::steady_clock::now();
+  TF tf;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReadyCV.wait(lock, [this] { return !mQueue.empty() || mError; });
+    if (mQueue.empty()) {
+      std::rethrow_exception(mError);
+    }
+    tf = std::move(mQueue.front());
+    mQueue.pop_front();
+    mQueuedBytes -= tf.size;
+  }
+  mFreeCV.notify_one();
+  mWaitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+  mNConsumed++;
+  return tf;
+}
+
+//___________________________________________________________________
+void CTFTreePrefetcher::run()
+{
+  try {
+    std::unique_ptr<TFile> file(TFile::Open(mFileName.c_str()));
+    if (!file || !file->IsOpen() || file->IsZombie()) {
+      throw std::runtime_error(fmt::format("failed to open CTF file {}", mFileName));
+    }
+    std::unique_ptr<TTree> tree((TTree*)file->Get(std::string(o2::base::NameConf::CTFTREENAME).c_str()));
+    if (!tree) {
+      throw std::runtime_error(fmt::format("failed to load CTF tree from {}", mFileName));
+    }
+    for (size_t i = 0; i < mEntries.size(); i++) {
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mFreeCV.wait(lock, [this] { return mStop || mQueue.empty() || (mQueue.size() < mMaxTFs && mQueuedBytes < mMaxBytes); });
+        if (mStop) {
+          return;
+        }
+      }
+      TF tf;
+      tf.entry = mEntries[i];
+      for (int id = DetID::First; id <= DetID::Last; id++) {
+        if (mDetectors[i][id]) {
+          mReaders[id](tf.buffers[id], *tree, DetID::getName(id), int(tf.entry));
+          tf.size += tf.buffers[id].size();
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueuedBytes += tf.size;
+        mQueue.push_back(std::move(tf));
+      }
+      mReadyCV.notify_one();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mError = std::current_exception();
+    }
+    mReadyCV.notify_one();
+  }
+}
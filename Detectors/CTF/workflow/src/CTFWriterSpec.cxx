@@ -19,10 +19,12 @@
 #include "Framework/CommonServices.h"
 #include "Framework/DataTakingContext.h"
 #include "Framework/TimingInfo.h"
+#include "Monitoring/Monitoring.h"
 #include <fairmq/Device.h>
 
 #include "DataFormatsParameters/GRPECSObject.h"
 #include "CTFWorkflow/CTFWriterSpec.h"
+#include "CTFWorkflow/CTFFlatFile.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "CommonUtils/NameConf.h"
 #include "CommonUtils/FileSystemUtils.h"
@@ -56,13 +58,21 @@
 #include <TFile.h>
 #include <TTree.h>
 #include <TRandom.h>
+#include <TROOT.h>
 #include <filesystem>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
 #include <ctime>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <regex>
 #include <numeric>
+#include <cstring>
 
 using namespace o2::framework;
 
@@ -93,6 +103,43 @@ size_t appendToTree(TTree& tree, const std::string brname, T& ptr)
 
 using DetID = o2::detectors::DetID;
 using FTrans = o2::rans::DenseHistogram<int32_t>;
+using FreqsAccumulation = std::array<std::vector<FTrans>, DetID::nDetectors>;
+using FreqsMetaData = std::array<std::vector<o2::ctf::Metadata>, DetID::nDetectors>;
+
+// CTF of a single TF to be written: the images of the detectors with the functions appending them to the tree.
+// For the asynchronous writing the images are copied to the storage owned by the job.
+struct CTFWriteJob {
+  using Appender = size_t (*)(const o2::ctf::BufferType*, TTree&, const std::string&);
+  CTFHeader header{};
+  o2::framework::TimingInfo timingInfo{};
+  o2::framework::DataTakingContext dataTakingContext{};
+  std::string metaDataType{};
+  size_t nCTF = 0;                                  // TF number in the processing
+  size_t size = 0;                                  // total size of the images
+  CTFImages images{};                               // detectors CTF images
+  std::array<Appender, DetID::nDetectors> appenders{};
+  std::array<size_t, DetID::nDetectors> sizes{};    // size of images, replaced by the size written to the tree
+  std::array<size_t, DetID::nDetectors> nSymbols{}; // encoded symbols, for the size report
+  std::array<size_t, DetID::nDetectors> nEncodedBytes{};
+  std::vector<o2::ctf::BufferType> storage{};       // owned copy of the images
+
+  void makeOwning()
+  {
+    size_t sz = 0;
+    for (const auto& img : images) {
+      sz += alignSize(img.size());
+    }
+    storage.resize(sz);
+    sz = 0;
+    for (auto& img : images) {
+      if (img.size()) {
+        std::memcpy(storage.data() + sz, img.data(), img.size());
+        img = gsl::span<const o2::ctf::BufferType>(storage.data() + sz, img.size());
+        sz += alignSize(img.size());
+      }
+    }
+  }
+};
 
 class CTFWriterSpec : public o2::framework::Task
 {
@@ -109,15 +156,28 @@ class CTFWriterSpec : public o2::framework::Task
  private:
   void updateTimeDependentParams(ProcessingContext& pc);
   template <typename C>
-  size_t processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, TTree* tree);
+  size_t processDet(o2::framework::ProcessingContext& pc, DetID det, CTFWriteJob& job);
+  template <typename C>
+  static size_t appendImage(const o2::ctf::BufferType* image, TTree& tree, const std::string& name)
+  {
+    return C::getImage(image).appendToTree(tree, name);
+  }
+  size_t writeTF(CTFWriteJob& job, ProcessingContext* pc);
+  void waitForDiskSpace(ProcessingContext* pc);
+  void enqueueTF(CTFWriteJob&& job, ProcessingContext& pc);
+  void writerLoop();
+  void stopWriter();
   template <typename C>
-  void storeDictionary(DetID det, CTFHeader& header);
-  void storeDictionaries();
+  void storeDictionary(DetID det, CTFHeader& header, const FreqsAccumulation& freqs, const FreqsMetaData& metaData, size_t nCTF);
+  void storeDictionaries(const FreqsAccumulation& freqs, const FreqsMetaData& metaData, size_t nCTF, uint32_t runNumber);
+  void storeDictionariesAsync();
+  void waitForDictionaries();
+  void reportCompression() const;
   void closeTFTreeAndFile();
-  void prepareTFTreeAndFile();
+  void prepareTFTreeAndFile(const CTFWriteJob& job);
   size_t estimateCTFSize(ProcessingContext& pc);
   size_t getAvailableDiskSpace(const std::string& path, int level);
-  void createLockFile(int level);
+  void createLockFile(int level, const o2::framework::TimingInfo& timingInfo);
   void removeLockFile();
   void finalize();
 
@@ -125,6 +185,7 @@ class CTFWriterSpec : public o2::framework::Task
   bool mFinalized = false;
   bool mWriteCTF = true;
   bool mCreateDict = false;
+  bool mSaveDictAsync = false;     // store intermediate dictionaries in the background
   bool mCreateRunEnvDir = true;
   bool mStoreMetaFile = false;
   bool mRejectCurrentTF = false;
@@ -152,8 +213,13 @@ class CTFWriterSpec : public o2::framework::Task
   int mRejRate = 0;                // CTF rejection rule (>0: percentage to reject randomly, <0: reject if timeslice%|value|!=0)
   int mCTFFileCompression = 0;     // CTF file compression level (if >= 0)
   bool mFillMD5 = false;
+  bool mFlatOutput = false;          // write also the flat binary container of the CTFs
+  bool mFlatDirectIO = false;        // bypass the page cache for the flat container
+  size_t mFlatBufferSize = 0;        // size of the staging buffer of the flat container
+  int mAsyncQueueSize = 0;           // if > 0, the CTFs are written by the writer thread, with at most this number of TFs queued
   std::vector<uint32_t> mTFOrbits{}; // 1st orbits of TF accumulated in current file
   o2::framework::DataTakingContext mDataTakingContext{};
+  o2::framework::DataTakingContext mFileDataTakingContext{}; // context of the TFs in the current file
   o2::framework::TimingInfo mTimingInfo{};
   std::string mOutputType{}; // RS FIXME once global/local options clash is solved, --output-type will become device option
   std::string mDictDir{};
@@ -165,11 +231,25 @@ class CTFWriterSpec : public o2::framework::Task
   std::string mCurrentCTFFileNameFull{};
   std::string mSizeReport{};
   std::string mMetaDataType{};
+  std::string mFileMetaDataType{};
+  std::string mCurrentFlatFileNameFull{};
   const std::string LOCKFileDir = "/tmp/ctf-writer-locks";
   std::string mLockFileName{};
   int mLockFD = -1;
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  std::unique_ptr<CTFFlatFileWriter> mFlatFileOut;
+
+  // asynchronous writing: the CTFs are queued to the writer thread, the processing is blocked when the queue is full
+  std::thread mWriterThread;
+  std::mutex mWriterMutex;
+  std::condition_variable mWriterCV;     // new job or stop request for the writer
+  std::condition_variable mWriterDoneCV; // job was written, the queue has a free slot
+  std::deque<CTFWriteJob> mWriteQueue;   // the job being written remains in the queue until it is done
+  size_t mQueuedBytes = 0;
+  bool mWriterStop = false;
+  std::exception_ptr mWriterError;
+  double mBlockedTime = 0.; // total time (s) the processing was blocked by the full queue
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
   std::unique_ptr<TTree> mDictTreeOut; // tree to store dictionary
@@ -178,10 +258,17 @@ class CTFWriterSpec : public o2::framework::Task
   // After accumulation over multiple TFs we store the dictionaries data in the standard CTF format of this detector,
   // i.e. EncodedBlock stored in a tree, BUT with dictionary data only added to each block.
   // The metadata of the block (min,max) will be used for the consistency check at the decoding
-  std::array<std::vector<FTrans>, DetID::nDetectors> mFreqsAccumulation;
-  std::array<std::vector<o2::ctf::Metadata>, DetID::nDetectors> mFreqsMetaData;
+  FreqsAccumulation mFreqsAccumulation;
+  FreqsMetaData mFreqsMetaData;
   std::array<std::bitset<64>, DetID::nDetectors> mIsSaturatedFrequencyTable;
   std::array<std::shared_ptr<void>, DetID::nDetectors> mHeaders;
+  std::future<void> mDictStoring; // intermediate dictionaries being stored in the background
+
+  // compression statistics per detector: encoded symbols, their size in bytes, entropy encoded blocks with external and own dictionary
+  std::array<size_t, DetID::nDetectors> mNSymbols{};
+  std::array<size_t, DetID::nDetectors> mNEncodedBytes{};
+  std::array<size_t, DetID::nDetectors> mNBlocksExtDict{};
+  std::array<size_t, DetID::nDetectors> mNBlocksOwnDict{};
   TStopwatch mTimer;
 
   static const std::string TMPFileEnding;
@@ -220,8 +307,16 @@ void CTFWriterSpec::init(InitContext& ic)
   }
 
   mSaveDictAfter = ic.options().get<int>("save-dict-after");
+  mSaveDictAsync = ic.options().get<bool>("save-dict-async");
+  if (mCreateDict && mSaveDictAfter > 0 && mSaveDictAsync) {
+    ROOT::EnableThreadSafety(); // dictionaries are written in parallel to the CTFs
+  }
   mCTFAutoSave = ic.options().get<long>("save-ctf-after");
   mCTFFileCompression = ic.options().get<int>("ctf-file-compression");
+  mAsyncQueueSize = ic.options().get<int>("async-write-queue");
+  mFlatOutput = ic.options().get<bool>("ctf-flat-output");
+  mFlatDirectIO = ic.options().get<bool>("ctf-flat-direct-io");
+  mFlatBufferSize = size_t(ic.options().get<int>("ctf-flat-buffer-mb")) << 20;
   mCTFMetaFileDir = ic.options().get<std::string>("meta-output-dir");
   if (mCTFMetaFileDir != "/dev/null") {
     mCTFMetaFileDir = o2::utils::Str::rectifyDirectory(mCTFMetaFileDir);
@@ -268,6 +363,15 @@ void CTFWriterSpec::init(InitContext& ic)
   mChkSize = std::max(size_t(mMinSize * 1.1), mMaxSize);
   o2::utils::createDirectoriesIfAbsent(LOCKFileDir);
 
+  if (mWriteCTF && mFlatOutput) {
+    mFlatFileOut = std::make_unique<CTFFlatFileWriter>(mFlatBufferSize, mFlatDirectIO);
+    LOGP(info, "CTFs will be written also to the flat container {} with {} MB writes{}", CTFFlatFileWriter::FileEnding, mFlatBufferSize >> 20, mFlatDirectIO ? " using direct I/O" : "");
+  }
+  if (mWriteCTF && mAsyncQueueSize > 0) {
+    ROOT::EnableThreadSafety(); // the CTF tree is filled by the writer thread
+    LOGP(info, "CTFs will be written asynchronously, with at most {} TFs queued", mAsyncQueueSize);
+  }
+
   if (mCreateDict) { // make sure that there is no local dictonary
     std::string dictFileName = fmt::format("{}{}.root", mDictDir, o2::base::NameConf::CTFDICT);
     if (std::filesystem::exists(dictFileName)) {
@@ -297,12 +401,11 @@ void CTFWriterSpec::updateTimeDependentParams(ProcessingContext& pc)
 //___________________________________________________________________
 // process data of particular detector
 template <typename C>
-size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, TTree* tree)
+size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det, CTFWriteJob& job)
 {
   static bool warnedEmpty = false;
-  size_t sz = 0;
+  size_t sz = 0, nSymbols = 0, nEncodedBytes = 0;
   if (!isPresent(det) || !pc.inputs().isValid(det.getName())) {
-    mSizeReport += fmt::format(" {}:N/A", det.getName());
     return sz;
   }
   auto ctfBuffer = pc.inputs().get<gsl::span<o2::ctf::BufferType>>(det.getName());
@@ -313,11 +416,28 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
     }
     const auto ctfImage = C::getImage(bdata);
     ctfImage.print(o2::utils::Str::concat_string(det.getName(), ": "), mVerbosity);
+    for (int ib = 0; ib < C::getNBlocks(); ib++) {
+      const auto& md = ctfImage.getMetadata(ib);
+      const auto& bl = ctfImage.getBlock(ib);
+      nSymbols += md.messageLength;
+      nEncodedBytes += bl.getNStored() * sizeof(*bl.payload);
+      if (md.opt == o2::ctf::Metadata::OptStore::EENCODE && md.messageLength) {
+        if (md.nDictWords) {
+          mNBlocksOwnDict[det]++;
+        } else {
+          mNBlocksExtDict[det]++;
+        }
+      }
+    }
+    mNSymbols[det] += nSymbols;
+    mNEncodedBytes[det] += nEncodedBytes;
+    sz = ctfBuffer.size();
+    job.nSymbols[det] = nSymbols;
+    job.nEncodedBytes[det] = nEncodedBytes;
     if (mWriteCTF && !mRejectCurrentTF) {
-      sz = ctfImage.appendToTree(*tree, det.getName());
-      header.detectors.set(det);
-    } else {
-      sz = ctfBuffer.size();
+      job.images[det] = ctfBuffer;
+      job.appenders[det] = &CTFWriterSpec::appendImage<C>;
+      job.header.detectors.set(det);
     }
     if (mCreateDict) {
       if (mFreqsAccumulation[det].empty()) {
@@ -368,29 +488,29 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
       warnedEmpty = true;
     }
   }
-  mSizeReport += fmt::format(" {}:{}", det.getName(), fmt::group_digits(sz));
+  job.sizes[det] = sz;
   return sz;
 }
 
 //___________________________________________________________________
 // store dictionary of a particular detector
 template <typename C>
-void CTFWriterSpec::storeDictionary(DetID det, CTFHeader& header)
+void CTFWriterSpec::storeDictionary(DetID det, CTFHeader& header, const FreqsAccumulation& freqs, const FreqsMetaData& metaData, size_t nCTF)
 {
   // create vector whose data contains dictionary in CTF format (EncodedBlock)
-  if (!isPresent(det) || !mFreqsAccumulation[det].size()) {
+  if (!isPresent(det) || !freqs[det].size()) {
     return;
   }
-  auto dictBlocks = C::createDictionaryBlocks(mFreqsAccumulation[det], mFreqsMetaData[det]);
+  auto dictBlocks = C::createDictionaryBlocks(freqs[det], metaData[det]);
   auto& h = C::get(dictBlocks.data())->getHeader();
   h = *reinterpret_cast<typename std::remove_reference<decltype(h)>::type*>(mHeaders[det].get());
   auto& hb = static_cast<o2::ctf::CTFDictHeader&>(h);
   hb = *static_cast<const o2::ctf::CTFDictHeader*>(mHeaders[det].get());
   hb.dictTimeStamp = mDictTimeStamp;
 
-  auto getFileName = [this, det, &hb](bool curr) {
+  auto getFileName = [this, det, &hb, nCTF](bool curr) {
     return fmt::format("{}{}_{}_v{}.{}_{}_{}.root", this->mDictDir, o2::base::NameConf::CTFDICT, det.getName(), int(hb.majorVersion), int(hb.minorVersion),
-                       curr ? this->mDictTimeStamp : this->mPrevDictTimeStamp, curr ? this->mNCTF : this->mNCTFPrevDict);
+                       curr ? this->mDictTimeStamp : this->mPrevDictTimeStamp, curr ? nCTF : this->mNCTFPrevDict);
   };
 
   C::get(dictBlocks.data())->print(o2::utils::Str::concat_string("Storing dictionary for ", det.getName(), ": "));
@@ -399,7 +519,7 @@ void CTFWriterSpec::storeDictionary(DetID det, CTFHeader& header)
   flout.WriteObject(&dictBlocks, o2::base::NameConf::CCDBOBJECT.data());
   flout.WriteObject(&hb, fmt::format("ctf_dict_header_{}", det.getName()).c_str());
   flout.Close();
-  LOGP(info, "Saved {} with {} TFs to {}", hb.asString(), mNCTF, outName);
+  LOGP(info, "Saved {} with {} TFs to {}", hb.asString(), nCTF, outName);
   if (mPrevDictTimeStamp) {
     auto outNamePrev = getFileName(false);
     if (std::filesystem::exists(outNamePrev)) {
@@ -436,108 +556,253 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   mTimer.Start(false);
   updateTimeDependentParams(pc);
   mRejectCurrentTF = (mRejRate > 0 && int(gRandom->Rndm() * 100) < mRejRate) || (mRejRate < -1 && mTimingInfo.timeslice % (-mRejRate));
-  mCurrCTFSize = estimateCTFSize(pc);
-  if (mWriteCTF && !mRejectCurrentTF) {
-    prepareTFTreeAndFile();
-
-    int totalWait = 0, nwaitCycles = 0;
-    while ((mFallBackDirUsed || !mFallBackDirProvided) && mCheckDiskFull) { // we are on the physical disk and not on the RAM disk
-      constexpr size_t MB = 1024 * 1024;
-      constexpr int showFirstN = 10, prsecaleWarnings = 50;
-      try {
-        const auto si = std::filesystem::space(mCTFFileOut->GetName());
-        std::string wmsg{};
-        if (mCheckDiskFull > 0.f && si.available < mCheckDiskFull) {
-          nwaitCycles++;
-          wmsg = fmt::format("Disk has {} MB available while at least {} MB is requested, wait for {} ms (on top of {} ms)", si.available / MB, size_t(mCheckDiskFull) / MB, mWaitDiskFull, totalWait);
-        } else if (mCheckDiskFull < 0.f && float(si.available) / si.capacity < -mCheckDiskFull) { // relative margin requested
-          nwaitCycles++;
-          wmsg = fmt::format("Disk has {:.3f}% available while at least {:.3f}% is requested, wait for {} ms (on top of {} ms)", si.capacity ? float(si.available) / si.capacity * 100.f : 0., -mCheckDiskFull, mWaitDiskFull, totalWait);
-        } else {
-          nwaitCycles = 0;
-        }
-        if (nwaitCycles) {
-          if (mWaitDiskFullMax > 0 && totalWait > mWaitDiskFullMax) {
-            closeTFTreeAndFile(); // try to save whatever we have
-            LOGP(fatal, "Disk has {} MB available out of {} MB after waiting for {} ms", si.available / MB, si.capacity / MB, mWaitDiskFullMax);
-          }
-          if (nwaitCycles < showFirstN + 1 || (prsecaleWarnings && (nwaitCycles % prsecaleWarnings) == 0)) {
-            LOG(alarm) << wmsg;
-          }
-          pc.services().get<RawDeviceService>().waitFor((unsigned int)(mWaitDiskFull));
-          totalWait += mWaitDiskFull;
-          continue;
-        }
-      } catch (std::exception const& e) {
-        LOG(fatal) << "unable to query disk space info for path " << mCurrentCTFFileNameFull << ", reason: " << e.what();
-      }
-      break;
-    }
-  }
   // create header
-  CTFHeader header{mTimingInfo.runNumber, mTimingInfo.creation, mTimingInfo.firstTForbit, mTimingInfo.tfCounter};
-  size_t szCTF = 0;
-  mSizeReport = "";
-  std::array<size_t, DetID::CTP + 1> szCTFperDet{0}; // DetID::TST is between FDD and CTP and remains empty
-  szCTFperDet[DetID::ITS] = processDet<o2::itsmft::CTF>(pc, DetID::ITS, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::TPC] = processDet<o2::tpc::CTF>(pc, DetID::TPC, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::TRD] = processDet<o2::trd::CTF>(pc, DetID::TRD, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::TOF] = processDet<o2::tof::CTF>(pc, DetID::TOF, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::PHS] = processDet<o2::phos::CTF>(pc, DetID::PHS, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::CPV] = processDet<o2::cpv::CTF>(pc, DetID::CPV, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::EMC] = processDet<o2::emcal::CTF>(pc, DetID::EMC, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::HMP] = processDet<o2::hmpid::CTF>(pc, DetID::HMP, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::MFT] = processDet<o2::itsmft::CTF>(pc, DetID::MFT, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::MCH] = processDet<o2::mch::CTF>(pc, DetID::MCH, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::MID] = processDet<o2::mid::CTF>(pc, DetID::MID, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::ZDC] = processDet<o2::zdc::CTF>(pc, DetID::ZDC, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::FT0] = processDet<o2::ft0::CTF>(pc, DetID::FT0, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::FV0] = processDet<o2::fv0::CTF>(pc, DetID::FV0, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::FDD] = processDet<o2::fdd::CTF>(pc, DetID::FDD, header, mCTFTreeOut.get());
-  szCTFperDet[DetID::CTP] = processDet<o2::ctp::CTF>(pc, DetID::CTP, header, mCTFTreeOut.get());
-  szCTF = std::accumulate(szCTFperDet.begin(), szCTFperDet.end(), 0);
-  if (mReportInterval > 0 && (mTimingInfo.tfCounter % mReportInterval) == 0) {
-    LOGP(important, "CTF {} size report:{} - Total:{}", mTimingInfo.tfCounter, mSizeReport, fmt::group_digits(szCTF));
-  }
+  CTFWriteJob job;
+  job.header = CTFHeader{mTimingInfo.runNumber, mTimingInfo.creation, mTimingInfo.firstTForbit, mTimingInfo.tfCounter};
+  job.timingInfo = mTimingInfo;
+  job.dataTakingContext = mDataTakingContext;
+  job.metaDataType = mMetaDataType;
+  job.nCTF = mNCTF;
+  job.size = estimateCTFSize(pc);
+  constexpr std::array<DetID::ID, 16> DetOrder{DetID::ITS, DetID::TPC, DetID::TRD, DetID::TOF, DetID::PHS, DetID::CPV, DetID::EMC, DetID::HMP,
+                                              DetID::MFT, DetID::MCH, DetID::MID, DetID::ZDC, DetID::FT0, DetID::FV0, DetID::FDD, DetID::CTP};
+  processDet<o2::itsmft::CTF>(pc, DetID::ITS, job);
+  processDet<o2::tpc::CTF>(pc, DetID::TPC, job);
+  processDet<o2::trd::CTF>(pc, DetID::TRD, job);
+  processDet<o2::tof::CTF>(pc, DetID::TOF, job);
+  processDet<o2::phos::CTF>(pc, DetID::PHS, job);
+  processDet<o2::cpv::CTF>(pc, DetID::CPV, job);
+  processDet<o2::emcal::CTF>(pc, DetID::EMC, job);
+  processDet<o2::hmpid::CTF>(pc, DetID::HMP, job);
+  processDet<o2::itsmft::CTF>(pc, DetID::MFT, job);
+  processDet<o2::mch::CTF>(pc, DetID::MCH, job);
+  processDet<o2::mid::CTF>(pc, DetID::MID, job);
+  processDet<o2::zdc::CTF>(pc, DetID::ZDC, job);
+  processDet<o2::ft0::CTF>(pc, DetID::FT0, job);
+  processDet<o2::fv0::CTF>(pc, DetID::FV0, job);
+  processDet<o2::fdd::CTF>(pc, DetID::FDD, job);
+  processDet<o2::ctp::CTF>(pc, DetID::CTP, job);
 
   mTimer.Stop();
 
-  if (mWriteCTF && !mRejectCurrentTF) {
-    szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
-    size_t prevSizeMB = mAccCTFSize / (1 << 20);
-    mAccCTFSize += szCTF;
-    mCTFTreeOut->SetEntries(++mNAccCTF);
-    mTFOrbits.push_back(mTimingInfo.firstTForbit);
-    LOG(info) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << mTimer.CpuTime() - cput << " s";
-    if (mNAccCTF > 1) {
-      LOG(info) << "Current CTF tree has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
-    }
-    if (mLockFD != -1) {
-      lseek(mLockFD, 0, SEEK_SET);
-      auto nwr = write(mLockFD, &mAccCTFSize, sizeof(size_t));
-      if (nwr != sizeof(size_t)) {
-        LOG(error) << "Failed to write current CTF size " << mAccCTFSize << " to lock file, bytes written: " << nwr;
-      }
+  size_t szCTF = 0;
+  const bool writeTFNow = mWriteCTF && !mRejectCurrentTF;
+  if (writeTFNow && mAsyncQueueSize <= 0) {
+    szCTF = writeTF(job, &pc); // the sizes are replaced by those written to the tree
+    LOG(info) << "TF#" << mNCTF << ": wrote CTF{" << job.header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << mTimer.CpuTime() - cput << " s";
+  }
+  std::array<size_t, DetID::CTP + 1> szCTFperDet{0}; // DetID::TST is between FDD and CTP and remains empty
+  mSizeReport = "";
+  auto& monitoring = pc.services().get<o2::monitoring::Monitoring>();
+  for (auto det : DetOrder) {
+    szCTFperDet[det] = job.sizes[det];
+    if (!isPresent(det) || !pc.inputs().isValid(DetID::getName(det))) {
+      mSizeReport += fmt::format(" {}:N/A", DetID::getName(det));
+    } else if (job.nSymbols[det]) {
+      const double bitsPerSymbol = 8. * job.nEncodedBytes[det] / job.nSymbols[det];
+      mSizeReport += fmt::format(" {}:{}({:.2f}b/sym)", DetID::getName(det), fmt::group_digits(job.sizes[det]), bitsPerSymbol);
+      monitoring.send(o2::monitoring::Metric{bitsPerSymbol, fmt::format("ctf-{}-bits-per-symbol", DetID::getName(det))}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+    } else {
+      mSizeReport += fmt::format(" {}:{}", DetID::getName(det), fmt::group_digits(job.sizes[det]));
     }
+  }
+  if (mReportInterval > 0 && (mTimingInfo.tfCounter % mReportInterval) == 0) {
+    LOGP(important, "CTF {} size report:{} - Total:{}", mTimingInfo.tfCounter, mSizeReport, fmt::group_digits(std::accumulate(szCTFperDet.begin(), szCTFperDet.end(), size_t(0))));
+  }
 
-    if (mAccCTFSize >= mMinSize || (mMaxCTFPerFile > 0 && mNAccCTF >= mMaxCTFPerFile)) {
-      closeTFTreeAndFile();
-    } else if ((mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) || (mCTFAutoSave < 0 && int(prevSizeMB / (-mCTFAutoSave)) != size_t(mAccCTFSize / (1 << 20)) / (-mCTFAutoSave))) {
-      mCTFTreeOut->AutoSave("override");
-    }
-  } else {
-    LOG(info) << "TF#" << mNCTF << " {" << header << "} CTF writing is disabled, size was " << szCTF << " bytes";
+  if (writeTFNow && mAsyncQueueSize > 0) {
+    enqueueTF(std::move(job), pc);
+  } else if (!writeTFNow) {
+    LOG(info) << "TF#" << mNCTF << " {" << job.header << "} CTF writing is disabled, size was " << job.size << " bytes";
   }
 
   mNCTF++;
   if (mCreateDict && mSaveDictAfter > 0 && (mNCTF % mSaveDictAfter) == 0) {
-    storeDictionaries();
+    if (mSaveDictAsync) {
+      storeDictionariesAsync();
+    } else {
+      storeDictionaries(mFreqsAccumulation, mFreqsMetaData, mNCTF, mTimingInfo.runNumber);
+    }
   }
   int dummy = 0;
   pc.outputs().snapshot({"ctfdone", 0}, dummy);
   pc.outputs().snapshot(Output{"CTF", "SIZES", 0}, szCTFperDet);
 }
 
+//___________________________________________________________________
+size_t CTFWriterSpec::writeTF(CTFWriteJob& job, ProcessingContext* pc)
+{
+  // write the CTF to the tree (and flat container), called from the processing or from the writer thread
+  mCurrCTFSize = job.size;
+  prepareTFTreeAndFile(job);
+  waitForDiskSpace(pc);
+
+  size_t szCTF = 0;
+  for (auto id = DetID::First; id <= DetID::Last; id++) {
+    if (job.images[id].size()) {
+      job.sizes[id] = job.appenders[id](job.images[id].data(), *mCTFTreeOut.get(), DetID::getName(id));
+      szCTF += job.sizes[id];
+    }
+  }
+  szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", job.header);
+  if (mFlatFileOut) {
+    mFlatFileOut->addTF(job.header, job.images);
+  }
+  size_t prevSizeMB = mAccCTFSize / (1 << 20);
+  mAccCTFSize += szCTF;
+  mCTFTreeOut->SetEntries(++mNAccCTF);
+  mTFOrbits.push_back(job.timingInfo.firstTForbit);
+  if (mNAccCTF > 1) {
+    LOG(info) << "Current CTF tree has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
+  }
+  if (mLockFD != -1) {
+    lseek(mLockFD, 0, SEEK_SET);
+    auto nwr = write(mLockFD, &mAccCTFSize, sizeof(size_t));
+    if (nwr != sizeof(size_t)) {
+      LOG(error) << "Failed to write current CTF size " << mAccCTFSize << " to lock file, bytes written: " << nwr;
+    }
+  }
+
+  if (mAccCTFSize >= mMinSize || (mMaxCTFPerFile > 0 && mNAccCTF >= mMaxCTFPerFile)) {
+    closeTFTreeAndFile();
+  } else if ((mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) || (mCTFAutoSave < 0 && int(prevSizeMB / (-mCTFAutoSave)) != size_t(mAccCTFSize / (1 << 20)) / (-mCTFAutoSave))) {
+    mCTFTreeOut->AutoSave("override");
+  }
+  return szCTF;
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::waitForDiskSpace(ProcessingContext* pc)
+{
+  // in the writer thread (no processing context) the waiting blocks only the writer, and the processing once the queue is full
+  int totalWait = 0, nwaitCycles = 0;
+  while ((mFallBackDirUsed || !mFallBackDirProvided) && mCheckDiskFull) { // we are on the physical disk and not on the RAM disk
+    constexpr size_t MB = 1024 * 1024;
+    constexpr int showFirstN = 10, prsecaleWarnings = 50;
+    try {
+      const auto si = std::filesystem::space(mCTFFileOut->GetName());
+      std::string wmsg{};
+      if (mCheckDiskFull > 0.f && si.available < mCheckDiskFull) {
+        nwaitCycles++;
+        wmsg = fmt::format("Disk has {} MB available while at least {} MB is requested, wait for {} ms (on top of {} ms)", si.available / MB, size_t(mCheckDiskFull) / MB, mWaitDiskFull, totalWait);
+      } else if (mCheckDiskFull < 0.f && float(si.available) / si.capacity < -mCheckDiskFull) { // relative margin requested
+        nwaitCycles++;
+        wmsg = fmt::format("Disk has {:.3f}% available while at least {:.3f}% is requested, wait for {} ms (on top of {} ms)", si.capacity ? float(si.available) / si.capacity * 100.f : 0., -mCheckDiskFull, mWaitDiskFull, totalWait);
+      } else {
+        nwaitCycles = 0;
+      }
+      if (nwaitCycles) {
+        if (mWaitDiskFullMax > 0 && totalWait > mWaitDiskFullMax) {
+          closeTFTreeAndFile(); // try to save whatever we have
+          LOGP(fatal, "Disk has {} MB available out of {} MB after waiting for {} ms", si.available / MB, si.capacity / MB, mWaitDiskFullMax);
+        }
+        if (nwaitCycles < showFirstN + 1 || (prsecaleWarnings && (nwaitCycles % prsecaleWarnings) == 0)) {
+          LOG(alarm) << wmsg;
+        }
+        if (pc) {
+          pc->services().get<RawDeviceService>().waitFor((unsigned int)(mWaitDiskFull));
+        } else {
+          std::this_thread::sleep_for(std::chrono::milliseconds(mWaitDiskFull));
+        }
+        totalWait += mWaitDiskFull;
+        continue;
+      }
+    } catch (std::exception const& e) {
+      LOG(fatal) << "unable to query disk space info for path " << mCurrentCTFFileNameFull << ", reason: " << e.what();
+    }
+    break;
+  }
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::enqueueTF(CTFWriteJob&& job, ProcessingContext& pc)
+{
+  // pass the CTF to the writer thread, block if the queue is full and publish the queue state for the rate limiting
+  if (!mWriterThread.joinable()) { // started with the 1st TF or after the stop
+    mWriterStop = false;
+    mWriterThread = std::thread(&CTFWriterSpec::writerLoop, this);
+  }
+  job.makeOwning();
+  auto tStart = std::chrono::steady_clock::now();
+  size_t nQueued = 0, queuedBytes = 0;
+  {
+    std::unique_lock<std::mutex> lock(mWriterMutex);
+    mWriterDoneCV.wait(lock, [this] { return mWriteQueue.size() < size_t(mAsyncQueueSize) || mWriterError; });
+    if (mWriterError) {
+      std::rethrow_exception(mWriterError);
+    }
+    mQueuedBytes += job.storage.size();
+    mWriteQueue.push_back(std::move(job));
+    nQueued = mWriteQueue.size();
+    queuedBytes = mQueuedBytes;
+  }
+  mWriterCV.notify_one();
+  double blocked = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+  mBlockedTime += blocked;
+  auto& monitoring = pc.services().get<o2::monitoring::Monitoring>();
+  monitoring.send(o2::monitoring::Metric{(uint64_t)nQueued, "ctf-writer-queued-tfs"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+  monitoring.send(o2::monitoring::Metric{(uint64_t)queuedBytes, "ctf-writer-queued-bytes"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+  monitoring.send(o2::monitoring::Metric{blocked * 1e3, "ctf-writer-blocked-ms"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::writerLoop()
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mWriterMutex);
+    mWriterCV.wait(lock, [this] { return !mWriteQueue.empty() || mWriterStop; });
+    if (mWriteQueue.empty()) { // stop requested and everything is written
+      return;
+    }
+    auto& job = mWriteQueue.front(); // references to deque elements stay valid when new jobs are added
+    lock.unlock();
+    try {
+      TStopwatch sw;
+      auto szCTF = writeTF(job, nullptr);
+      sw.Stop();
+      LOG(info) << "TF#" << job.nCTF << ": wrote CTF{" << job.header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << sw.CpuTime() << " s";
+    } catch (...) {
+      lock.lock();
+      mWriterError = std::current_exception();
+      mWriteQueue.clear();
+      mQueuedBytes = 0;
+      lock.unlock();
+      mWriterDoneCV.notify_all();
+      return;
+    }
+    lock.lock();
+    mQueuedBytes -= job.storage.size();
+    mWriteQueue.pop_front();
+    lock.unlock();
+    mWriterDoneCV.notify_all();
+  }
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::stopWriter()
+{
+  // write the queued CTFs and stop the writer thread
+  if (!mWriterThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mWriterMutex);
+    mWriterStop = true;
+  }
+  mWriterCV.notify_one();
+  mWriterThread.join();
+  if (mWriterError) {
+    try {
+      std::rethrow_exception(mWriterError);
+    } catch (std::exception const& e) {
+      LOG(error) << "CTF writer thread failed, reason: " << e.what();
+    } catch (...) {
+      LOG(error) << "CTF writer thread failed";
+    }
+  }
+  LOGP(info, "CTF processing was blocked by the writer for {:.3f} s in total", mBlockedTime);
+}
+
 //___________________________________________________________________
 void CTFWriterSpec::finalize()
 {
@@ -545,11 +810,14 @@ void CTFWriterSpec::finalize()
     return;
   }
   if (mCreateDict) {
-    storeDictionaries();
+    waitForDictionaries();
+    storeDictionaries(mFreqsAccumulation, mFreqsMetaData, mNCTF, mTimingInfo.runNumber);
   }
   if (mWriteCTF) {
+    stopWriter();
     closeTFTreeAndFile();
   }
+  reportCompression();
   LOGF(info, "CTF writing total timing: Cpu: %.3e Real: %.3e s in %d slots",
        mTimer.CpuTime(), mTimer.RealTime(), mTimer.Counter() - 1);
   mFinalized = true;
@@ -558,7 +826,7 @@ void CTFWriterSpec::finalize()
 }
 
 //___________________________________________________________________
-void CTFWriterSpec::prepareTFTreeAndFile()
+void CTFWriterSpec::prepareTFTreeAndFile(const CTFWriteJob& job)
 {
   if (!mWriteCTF) {
     return;
@@ -579,7 +847,7 @@ void CTFWriterSpec::prepareTFTreeAndFile()
     mFallBackDirUsed = false;
     auto ctfDir = mCTFDir.empty() ? o2::utils::Str::rectifyDirectory("./") : mCTFDir;
     if (mChkSize > 0 && mFallBackDirProvided) {
-      createLockFile(0);
+      createLockFile(0, job.timingInfo);
       auto sz = getAvailableDiskSpace(ctfDir, 0); // check main storage
       if (sz < mChkSize) {
         removeLockFile();
@@ -588,20 +856,26 @@ void CTFWriterSpec::prepareTFTreeAndFile()
         mFallBackDirUsed = true;
       }
     }
-    if (mCreateRunEnvDir && !mDataTakingContext.envId.empty() && (mDataTakingContext.envId != o2::framework::DataTakingContext::UNKNOWN)) {
-      ctfDir += fmt::format("{}_{}/", mDataTakingContext.envId, mDataTakingContext.runNumber);
+    mFileDataTakingContext = job.dataTakingContext;
+    mFileMetaDataType = job.metaDataType;
+    if (mCreateRunEnvDir && !mFileDataTakingContext.envId.empty() && (mFileDataTakingContext.envId != o2::framework::DataTakingContext::UNKNOWN)) {
+      ctfDir += fmt::format("{}_{}/", mFileDataTakingContext.envId, mFileDataTakingContext.runNumber);
       if (!ctfDir.empty()) {
         o2::utils::createDirectoriesIfAbsent(ctfDir);
         LOGP(info, "Created {} directory for CTFs output", ctfDir);
       }
     }
-    mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(mTimingInfo.runNumber, mTimingInfo.firstTForbit, mTimingInfo.tfCounter, mHostName);
+    mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(job.timingInfo.runNumber, job.timingInfo.firstTForbit, job.timingInfo.tfCounter, mHostName);
     mCurrentCTFFileNameFull = fmt::format("{}{}", ctfDir, mCurrentCTFFileName);
     mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
     if (mCTFFileCompression >= 0) {
       mCTFFileOut->SetCompressionLevel(mCTFFileCompression);
     }
     mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    if (mFlatFileOut) {
+      mCurrentFlatFileNameFull = std::filesystem::path(mCurrentCTFFileNameFull).replace_extension(CTFFlatFileWriter::FileEnding).string();
+      mFlatFileOut->open(fmt::format("{}{}", mCurrentFlatFileNameFull, TMPFileEnding));
+    }
 
     mNCTFFiles++;
   }
@@ -617,6 +891,10 @@ void CTFWriterSpec::closeTFTreeAndFile()
       mCTFTreeOut.reset();
       mCTFFileOut->Close();
       mCTFFileOut.reset();
+      if (mFlatFileOut && mFlatFileOut->isOpen()) { // the flat container is not registered in the metadata
+        mFlatFileOut->close();
+        std::filesystem::rename(mFlatFileOut->getFileName(), mCurrentFlatFileNameFull);
+      }
       // write CTF file metaFile data
       auto actualFileName = TMPFileEnding.empty() ? mCurrentCTFFileNameFull : o2::utils::Str::concat_string(mCurrentCTFFileNameFull, TMPFileEnding);
       if (mStoreMetaFile) {
@@ -624,8 +902,8 @@ void CTFWriterSpec::closeTFTreeAndFile()
         if (!ctfMetaData.fillFileData(actualFileName, mFillMD5, TMPFileEnding)) {
           throw std::runtime_error("metadata file was requested but not created");
         }
-        ctfMetaData.setDataTakingContext(mDataTakingContext);
-        ctfMetaData.type = mMetaDataType;
+        ctfMetaData.setDataTakingContext(mFileDataTakingContext);
+        ctfMetaData.type = mFileMetaDataType;
         ctfMetaData.priority = mFallBackDirUsed ? "low" : "high";
         ctfMetaData.tfOrbits.swap(mTFOrbits);
         auto metaFileNameTmp = fmt::format("{}{}.tmp", mCTFMetaFileDir, mCurrentCTFFileName);
@@ -655,34 +933,34 @@ void CTFWriterSpec::closeTFTreeAndFile()
 }
 
 //___________________________________________________________________
-void CTFWriterSpec::storeDictionaries()
+void CTFWriterSpec::storeDictionaries(const FreqsAccumulation& freqs, const FreqsMetaData& metaData, size_t nCTF, uint32_t runNumber)
 {
   // monolitic dictionary in tree format
   mDictTimeStamp = uint32_t(std::time(nullptr));
-  auto getFileName = [this](bool curr) {
-    return fmt::format("{}{}Tree_{}_{}_{}.root", this->mDictDir, o2::base::NameConf::CTFDICT, DetID::getNames(this->mDets, '-'), curr ? this->mDictTimeStamp : this->mPrevDictTimeStamp, curr ? this->mNCTF : this->mNCTFPrevDict);
+  auto getFileName = [this, nCTF](bool curr) {
+    return fmt::format("{}{}Tree_{}_{}_{}.root", this->mDictDir, o2::base::NameConf::CTFDICT, DetID::getNames(this->mDets, '-'), curr ? this->mDictTimeStamp : this->mPrevDictTimeStamp, curr ? nCTF : this->mNCTFPrevDict);
   };
   auto dictFileName = getFileName(true);
   mDictFileOut.reset(TFile::Open(dictFileName.c_str(), "recreate"));
   mDictTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFDICT).c_str(), "O2 CTF dictionary");
 
-  CTFHeader header{mTimingInfo.runNumber, uint32_t(mNCTF)};
-  storeDictionary<o2::itsmft::CTF>(DetID::ITS, header);
-  storeDictionary<o2::itsmft::CTF>(DetID::MFT, header);
-  storeDictionary<o2::tpc::CTF>(DetID::TPC, header);
-  storeDictionary<o2::trd::CTF>(DetID::TRD, header);
-  storeDictionary<o2::tof::CTF>(DetID::TOF, header);
-  storeDictionary<o2::ft0::CTF>(DetID::FT0, header);
-  storeDictionary<o2::fv0::CTF>(DetID::FV0, header);
-  storeDictionary<o2::fdd::CTF>(DetID::FDD, header);
-  storeDictionary<o2::mid::CTF>(DetID::MID, header);
-  storeDictionary<o2::mch::CTF>(DetID::MCH, header);
-  storeDictionary<o2::emcal::CTF>(DetID::EMC, header);
-  storeDictionary<o2::phos::CTF>(DetID::PHS, header);
-  storeDictionary<o2::cpv::CTF>(DetID::CPV, header);
-  storeDictionary<o2::zdc::CTF>(DetID::ZDC, header);
-  storeDictionary<o2::hmpid::CTF>(DetID::HMP, header);
-  storeDictionary<o2::ctp::CTF>(DetID::CTP, header);
+  CTFHeader header{runNumber, uint32_t(nCTF)};
+  storeDictionary<o2::itsmft::CTF>(DetID::ITS, header, freqs, metaData, nCTF);
+  storeDictionary<o2::itsmft::CTF>(DetID::MFT, header, freqs, metaData, nCTF);
+  storeDictionary<o2::tpc::CTF>(DetID::TPC, header, freqs, metaData, nCTF);
+  storeDictionary<o2::trd::CTF>(DetID::TRD, header, freqs, metaData, nCTF);
+  storeDictionary<o2::tof::CTF>(DetID::TOF, header, freqs, metaData, nCTF);
+  storeDictionary<o2::ft0::CTF>(DetID::FT0, header, freqs, metaData, nCTF);
+  storeDictionary<o2::fv0::CTF>(DetID::FV0, header, freqs, metaData, nCTF);
+  storeDictionary<o2::fdd::CTF>(DetID::FDD, header, freqs, metaData, nCTF);
+  storeDictionary<o2::mid::CTF>(DetID::MID, header, freqs, metaData, nCTF);
+  storeDictionary<o2::mch::CTF>(DetID::MCH, header, freqs, metaData, nCTF);
+  storeDictionary<o2::emcal::CTF>(DetID::EMC, header, freqs, metaData, nCTF);
+  storeDictionary<o2::phos::CTF>(DetID::PHS, header, freqs, metaData, nCTF);
+  storeDictionary<o2::cpv::CTF>(DetID::CPV, header, freqs, metaData, nCTF);
+  storeDictionary<o2::zdc::CTF>(DetID::ZDC, header, freqs, metaData, nCTF);
+  storeDictionary<o2::hmpid::CTF>(DetID::HMP, header, freqs, metaData, nCTF);
+  storeDictionary<o2::ctp::CTF>(DetID::CTP, header, freqs, metaData, nCTF);
   mDictFileOut->cd();
   appendToTree(*mDictTreeOut.get(), "CTFHeader", header);
   mDictTreeOut->SetEntries(1);
@@ -694,7 +972,7 @@ void CTFWriterSpec::storeDictionaries()
     std::filesystem::remove(dictFileNameLnk);
   }
   std::filesystem::create_symlink(dictFileName, dictFileNameLnk);
-  LOGP(info, "Saved CTF dictionaries tree with {} TFs to {} and linked to {}", mNCTF, dictFileName, dictFileNameLnk);
+  LOGP(info, "Saved CTF dictionaries tree with {} TFs to {} and linked to {}", nCTF, dictFileName, dictFileNameLnk);
   if (mPrevDictTimeStamp) {
     auto dictFileNamePrev = getFileName(false);
     if (std::filesystem::exists(dictFileNamePrev)) {
@@ -702,16 +980,45 @@ void CTFWriterSpec::storeDictionaries()
       LOGP(info, "Removed previous dictionary version {}", dictFileNamePrev);
     }
   }
-  mNCTFPrevDict = mNCTF;
+  mNCTFPrevDict = nCTF;
   mPrevDictTimeStamp = mDictTimeStamp;
 }
 
 //___________________________________________________________________
-void CTFWriterSpec::createLockFile(int level)
+void CTFWriterSpec::storeDictionariesAsync()
+{
+  // the refreshed dictionaries are created from the snapshot of the frequency tables while the accumulation continues
+  waitForDictionaries();
+  mDictStoring = std::async(std::launch::async, [this, freqs = mFreqsAccumulation, metaData = mFreqsMetaData, nCTF = mNCTF, runNumber = mTimingInfo.runNumber]() {
+    storeDictionaries(freqs, metaData, nCTF, runNumber);
+  });
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::waitForDictionaries()
+{
+  if (mDictStoring.valid()) {
+    mDictStoring.get();
+  }
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::reportCompression() const
+{
+  for (auto id = DetID::First; id <= DetID::Last; id++) {
+    if (mNSymbols[id]) {
+      LOGP(info, "{} compression: {} symbols in {} bytes, {:.3f} bits/symbol, entropy encoded blocks with external/own dictionary: {}/{}", DetID::getName(id),
+           mNSymbols[id], mNEncodedBytes[id], 8. * mNEncodedBytes[id] / mNSymbols[id], mNBlocksExtDict[id], mNBlocksOwnDict[id]);
+    }
+  }
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::createLockFile(int level, const o2::framework::TimingInfo& timingInfo)
 {
   // create lock file for the CTF to be written to the storage of given level
   while (1) {
-    mLockFileName = fmt::format("{}/ctfs{}-{}_{}_{}_{}.lock", LOCKFileDir, level, o2::utils::Str::getRandomString(8), mTimingInfo.runNumber, mTimingInfo.firstTForbit, mTimingInfo.tfCounter);
+    mLockFileName = fmt::format("{}/ctfs{}-{}_{}_{}_{}.lock", LOCKFileDir, level, o2::utils::Str::getRandomString(8), timingInfo.runNumber, timingInfo.firstTForbit, timingInfo.tfCounter);
     if (!std::filesystem::exists(mLockFileName)) {
       break;
     }
@@ -807,6 +1114,7 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, const std::string& outTyp
     Options{                                                                               //{"output-type", VariantType::String, "ctf", {"output types: ctf (per TF) or dict (create dictionaries) or both or none"}},
             {"save-ctf-after", VariantType::Int64, 0ll, {"autosave CTF tree with multiple CTFs after every N CTFs if >0 or every -N MBytes if < 0"}},
             {"save-dict-after", VariantType::Int, 0, {"if > 0, in dictionary generation mode save it dictionary after certain number of TFs processed"}},
+            {"save-dict-async", VariantType::Bool, false, {"store the intermediate dictionaries (see save-dict-after) in the background"}},
             {"ctf-dict-dir", VariantType::String, "none", {"CTF dictionary directory, must exist"}},
             {"output-dir", VariantType::String, "none", {"CTF output directory, must exist"}},
             {"output-dir-alt", VariantType::String, "/dev/null", {"Alternative CTF output directory, must exist (if not /dev/null)"}},
@@ -817,6 +1125,10 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, const std::string& outTyp
             {"max-ctf-per-file", VariantType::Int, 0, {"if > 0, avoid storing more than requested CTFs per file"}},
             {"ctf-rejection", VariantType::Int, 0, {">0: percentage to reject randomly, <0: reject if timeslice%|value|!=0"}},
             {"ctf-file-compression", VariantType::Int, 0, {"if >= 0: impose CTF file compression level"}},
+            {"async-write-queue", VariantType::Int, 0, {"if > 0, write CTFs in a separate thread, blocking the processing when this number of TFs is queued"}},
+            {"ctf-flat-output", VariantType::Bool, false, {"write CTFs also to the flat binary container (.ctfbin) next to the CTF file"}},
+            {"ctf-flat-buffer-mb", VariantType::Int, 64, {"size of the write buffer of the flat CTF container in MB"}},
+            {"ctf-flat-direct-io", VariantType::Bool, false, {"write the flat CTF container with direct I/O, if supported"}},
             {"require-free-disk", VariantType::Float, 0.f, {"pause writing op. if available disk space is below this margin, in bytes if >0, as a fraction of total if <0"}},
             {"wait-for-free-disk", VariantType::Float, 10.f, {"if paused due to the low disk space, recheck after this time (in s)"}},
             {"max-wait-for-free-disk", VariantType::Float, 60.f, {"produce fatal if paused due to the low disk space for more than this amount in s."}},
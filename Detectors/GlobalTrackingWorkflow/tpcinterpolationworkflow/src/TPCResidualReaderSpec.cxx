@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <vector>
+#include <algorithm>
 #include <boost/algorithm/string/predicate.hpp>
 #include "TFile.h"
 #include "TTree.h"
@@ -53,7 +54,8 @@ class TPCResidualReader : public Task
 
   /// fill residuals for one sector
   /// \param iSec sector of the residuals
-  void fillResiduals(const int iSec);
+  /// \param residuals vector to which the residuals are appended
+  void fillResiduals(const int iSec, std::vector<TrackResiduals::LocalResid>& residuals);
 
   std::unique_ptr<TFile> mFile;
   std::unique_ptr<TTree> mTreeResiduals;
@@ -63,6 +65,7 @@ class TPCResidualReader : public Task
   const SpacePointsCalibConfParam& mParams{SpacePointsCalibConfParam::Instance()}; ///< reference to calibration parameters
   bool mDoBinning{false};
   bool mStoreBinnedResiduals{false};
+  int mNThreads{1}; ///< number of threads for processing the sectors
   GID::mask_t mSources;
   TrackResiduals mTrackResiduals;
   std::vector<std::string> mFileNames;                                                              ///< input files
@@ -76,7 +79,7 @@ class TPCResidualReader : public Task
   std::vector<TrackData> mTrackDataExtra, *mTrackDataExtraPtr = &mTrackDataExtra;                   ///< additional track information (chi2, nClusters, track parameters)
 };
 
-void TPCResidualReader::fillResiduals(const int iSec)
+void TPCResidualReader::fillResiduals(const int iSec, std::vector<TrackResiduals::LocalResid>& residuals)
 {
   auto brStats = mTreeStats->GetBranch(Form("sec%d", iSec));
   brStats->SetAddress(mTrackResiduals.getVoxStatPtr());
@@ -93,7 +96,7 @@ void TPCResidualReader::fillResiduals(const int iSec)
     for (const auto& res : mResiduals) {
       LOGF(debug, "Adding residual from Voxel %i-%i-%i. dy(%i), dz(%i), tg(%i)", res.bvox[0], res.bvox[1], res.bvox[2], res.dy, res.dz, res.tgSlp);
     }
-    mTrackResiduals.getLocalResVec().insert(mTrackResiduals.getLocalResVec().end(), mResiduals.begin(), mResiduals.end());
+    residuals.insert(residuals.end(), mResiduals.begin(), mResiduals.end());
   }
 }
 
@@ -138,6 +141,7 @@ void TPCResidualReader::init(InitContext& ic)
   }
 
   mStoreBinnedResiduals = ic.options().get<bool>("store-binned");
+  mNThreads = std::max(1, ic.options().get<int>("nthreads"));
 }
 
 void TPCResidualReader::run(ProcessingContext& pc)
@@ -221,14 +225,15 @@ void TPCResidualReader::run(ProcessingContext& pc)
     }
   }
 
-  for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
+  // the sectors are processed in parallel, the reading of their residuals is serialized by TrackResiduals
+  auto fillSector = [this](int iSec, std::vector<TrackResiduals::LocalResid>& residuals) {
     if (mDoBinning) {
       // for each sector fill the vector of local residuals from the respective branch
       auto brResid = mTreeResiduals->GetBranch(Form("sec%d", iSec));
       brResid->SetAddress(&mResidualsPtr);
       for (int iEntry = 0; iEntry < brResid->GetEntries(); ++iEntry) {
         brResid->GetEntry(iEntry);
-        mTrackResiduals.getLocalResVec().insert(mTrackResiduals.getLocalResVec().end(), mResiduals.begin(), mResiduals.end());
+        residuals.insert(residuals.end(), mResiduals.begin(), mResiduals.end());
       }
       mTrackResiduals.setStats(mVoxStatsSector[iSec], iSec);
     } else {
@@ -238,15 +243,11 @@ void TPCResidualReader::run(ProcessingContext& pc)
         // set up the tree from the input file
         connectTree(file);
         // fill the residuals for one sector
-        fillResiduals(iSec);
+        fillResiduals(iSec, residuals);
       }
     }
-
-    // do processing
-    mTrackResiduals.processSectorResiduals(iSec);
-    // do cleanup
-    mTrackResiduals.clear();
-  }
+  };
+  mTrackResiduals.processResiduals(fillSector, mNThreads);
 
   mTrackResiduals.closeOutputFile(); // FIXME remove when map output is handled properly
 
@@ -323,6 +324,7 @@ DataProcessorSpec getTPCResidualReaderSpec(bool doBinning, GID::mask_t src)
       {"outfile", VariantType::String, "debugVoxRes.root", {"Output file name"}},
       {"store-binned", VariantType::Bool, false, {"Store the binned residuals together with the voxel results"}},
       {"dont-check-file-access", VariantType::Bool, false, {"Deactivate check if all files are accessible before adding them to the list of files"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads for processing the sectors"}},
     }};
 }
 
@@ -176,8 +176,15 @@ class TimeFrame
   auto getNumberOfExtendedTracks() const { return mNExtendedTracks; }
   auto getNumberOfUsedExtendedClusters() const { return mNExtendedUsedClusters; }
 
-  bool checkMemory(unsigned long max) { return getArtefactsMemory() < max; }
+  bool checkMemory(unsigned long max)
+  {
+    updateArtefactsMemoryPeak(); // sample the peak also when the limit is exceeded and the iteration is aborted
+    return getArtefactsMemory() < max;
+  }
   unsigned long getArtefactsMemory();
+  unsigned long getArtefactsCapacity() const;
+  void updateArtefactsMemoryPeak() { mArtefactsMemoryPeak = std::max(mArtefactsMemoryPeak, getArtefactsCapacity()); }
+  unsigned long getArtefactsMemoryPeak() const { return mArtefactsMemoryPeak; }
   int getROFCutClusterMult() const { return mCutClusterMult; };
   int getROFCutVertexMult() const { return mCutVertexMult; };
   int getROFCutAllMult() const { return mCutClusterMult + mCutVertexMult; }
@@ -323,6 +330,7 @@ class TimeFrame
   std::vector<std::pair<unsigned long long, bool>> mRoadLabels;
   int mCutClusterMult;
   int mCutVertexMult;
+  unsigned long mArtefactsMemoryPeak = 0; /// high-water mark of the tracking artefacts memory in the current iteration
 
   // Vertexer
   std::vector<std::vector<int>> mNTrackletsPerROF;
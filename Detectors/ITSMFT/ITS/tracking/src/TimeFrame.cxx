@@ -412,6 +412,7 @@ void TimeFrame::initialise(const int iteration, const TrackingParameters& trkPar
   mNoVertexROF = 0;
   deepVectorClear(mRoads);
   deepVectorClear(mRoadLabels);
+  mArtefactsMemoryPeak = 0; // the artefacts are rebuilt from scratch in each iteration
 
   mMSangles.resize(trkParam.NLayers);
   mPhiCuts.resize(mClusters.size() - 1, 0.f);
@@ -466,6 +467,24 @@ unsigned long TimeFrame::getArtefactsMemory()
   return size + sizeof(Road<5>) * mRoads.size();
 }
 
+unsigned long TimeFrame::getArtefactsCapacity() const
+{
+  /// memory held by the artefacts vectors: they are cleared w/o releasing the capacity between the ROF slices
+  unsigned long size{0};
+  for (unsigned int iLayer{0}; iLayer < mTracklets.size(); ++iLayer) {
+    size += sizeof(Tracklet) * mTracklets[iLayer].capacity() + sizeof(MCCompLabel) * mTrackletLabels[iLayer].capacity();
+  }
+  for (unsigned int iLayer{0}; iLayer < mCells.size(); ++iLayer) {
+    size += sizeof(CellSeed) * mCells[iLayer].capacity() + sizeof(MCCompLabel) * mCellLabels[iLayer].capacity();
+  }
+  for (auto const* luts : {&mTrackletsLookupTable, &mCellsLookupTable, &mCellsNeighbours, &mCellsNeighboursLUT}) {
+    for (auto const& lut : *luts) {
+      size += sizeof(int) * lut.capacity();
+    }
+  }
+  return size + sizeof(Road<5>) * mRoads.capacity();
+}
+
 void TimeFrame::fillPrimaryVerticesXandAlpha()
 {
   if (mPValphaX.size()) {
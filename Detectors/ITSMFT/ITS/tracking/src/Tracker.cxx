@@ -101,6 +101,7 @@ void Tracker::clustersToTracks(std::function<void(std::string s)> logger, std::f
         nNeighbours += mTimeFrame->getNumberOfNeighbours();
         timeRoads += evaluateTask(
           &Tracker::findRoads, "Road finding", [](std::string) {}, iteration);
+        mTimeFrame->updateArtefactsMemoryPeak();
       }
       iVertex++;
     } while (iVertex < maxNvertices);
@@ -108,6 +109,7 @@ void Tracker::clustersToTracks(std::function<void(std::string s)> logger, std::f
     logger(fmt::format(" - Cell finding: {} cells found in {:.2f} ms", nCells, timeCells));
     logger(fmt::format(" - Neighbours finding: {} neighbours found in {:.2f} ms", nNeighbours, timeNeighbours));
     logger(fmt::format(" - Track finding: {} tracks found in {:.2f} ms", nTracks + mTimeFrame->getNumberOfTracks(), timeRoads));
+    logger(fmt::format(" - Artefacts memory high-water mark of the iteration: {:.2f} MB with {} ROF slice(s)", mTimeFrame->getArtefactsMemoryPeak() / constants::MB, nROFsIterations));
     total += timeTracklets + timeCells + timeNeighbours + timeRoads;
     if (mTrkParams[iteration].UseTrackFollower) {
       int nExtendedTracks{-mTimeFrame->mNExtendedTracks}, nExtendedClusters{-mTimeFrame->mNExtendedUsedClusters};
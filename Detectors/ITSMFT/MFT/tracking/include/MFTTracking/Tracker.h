@@ -62,38 +62,46 @@ class Tracker : public TrackerConfig
     mTrackLabels.clear();
   }
 
-  void findTracks(ROframe<T>& rofData)
-  {
-    if (!mFullClusterScan) {
-      clearSorting();
-      sortClusters(rofData);
-    }
-    findLTFTracks(rofData);
-    findCATracks(rofData);
-  };
+  void findTracks(ROframe<T>& rofData) { findTracks(rofData, *mThreadContexts[0]); }
+  void findTracks(std::vector<ROframe<T>>& rofsData);
 
-  void findLTFTracks(ROframe<T>&);
-  void findCATracks(ROframe<T>&);
+  void findLTFTracks(ROframe<T>& rofData) { findLTFTracks(rofData, *mThreadContexts[0]); }
+  void findCATracks(ROframe<T>& rofData) { findCATracks(rofData, *mThreadContexts[0]); }
   bool fitTracks(ROframe<T>&);
+  void fitTracks(std::vector<ROframe<T>>& rofsData);
   void computeTracksMClabels(const std::vector<T>&);
 
   void configure(const MFTTrackingParam& trkParam, int trackerID);
   void initializeFinder();
   int getTrackerID() const { return mTrackerID; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
  private:
-  void findTracksLTF(ROframe<T>&);
-  void findTracksCA(ROframe<T>&);
+  /// per-thread state of the track finder, the bin tables filled by initializeFinder are shared
+  struct ThreadContext {
+    Road road;                          ///< current road for CA algorithm
+    Int_t maxCellLevel = 0;             ///< max. cell level found in the roads of the current ROF
+    BinIndexRange clusterBinIndexRange; ///< local index range of the clusters of the current ROF in each R-Phi bin
+  };
+
+  void findTracks(ROframe<T>&, ThreadContext&);
+  void findLTFTracks(ROframe<T>&, ThreadContext&);
+  void findCATracks(ROframe<T>&, ThreadContext&);
+  void findTracksLTF(ROframe<T>&, ThreadContext&);
+  void findTracksCA(ROframe<T>&, ThreadContext&);
   void findTracksLTFfcs(ROframe<T>&);
-  void findTracksCAfcs(ROframe<T>&);
-  void computeCellsInRoad(ROframe<T>&);
-  void runForwardInRoad();
-  void runBackwardInRoad(ROframe<T>&);
-  void updateCellStatusInRoad();
+  void findTracksCAfcs(ROframe<T>&, ThreadContext&);
+  void computeCellsInRoad(ROframe<T>&, ThreadContext&);
+  void runForwardInRoad(ThreadContext&);
+  void runBackwardInRoad(ROframe<T>&, ThreadContext&);
+  void updateCellStatusInRoad(ThreadContext&);
 
-  void sortClusters(ROframe<T>& rof)
+  void sortClusters(ROframe<T>& rof, ThreadContext& ctx)
   {
     Int_t nClsInLayer, binPrevIndex, clsMinIndex, clsMaxIndex, jClsLayer;
+    auto& clusterBinIndexRange = ctx.clusterBinIndexRange;
     // sort the clusters in R-Phi
     for (Int_t iLayer = 0; iLayer < constants::mft::LayersNumber; ++iLayer) {
       if (rof.getClustersInLayer(iLayer).size() == 0) {
@@ -114,7 +122,7 @@ class Tracker : public TrackerConfig
 
         clsMaxIndex = jClsLayer - 1;
 
-        mClusterBinIndexRange[iLayer][binPrevIndex] = std::pair<Int_t, Int_t>(clsMinIndex, clsMaxIndex);
+        clusterBinIndexRange[iLayer][binPrevIndex] = std::pair<Int_t, Int_t>(clsMinIndex, clsMaxIndex);
 
         binPrevIndex = rof.getClustersInLayer(iLayer).at(jClsLayer).indexTableBin;
         clsMinIndex = jClsLayer;
@@ -123,35 +131,34 @@ class Tracker : public TrackerConfig
       // last cluster
       clsMaxIndex = jClsLayer - 1;
 
-      mClusterBinIndexRange[iLayer][binPrevIndex] = std::pair<Int_t, Int_t>(clsMinIndex, clsMaxIndex);
+      clusterBinIndexRange[iLayer][binPrevIndex] = std::pair<Int_t, Int_t>(clsMinIndex, clsMaxIndex);
     } // layers
   }
 
-  void clearSorting()
+  void clearSorting(ThreadContext& ctx)
   {
     for (Int_t iLayer = 0; iLayer < constants::mft::LayersNumber; ++iLayer) {
       for (Int_t iBin = 0; iBin <= mRPhiBins + 1; ++iBin) {
-        mClusterBinIndexRange[iLayer][iBin] = std::pair<Int_t, Int_t>(0, -1);
+        ctx.clusterBinIndexRange[iLayer][iBin] = std::pair<Int_t, Int_t>(0, -1);
       }
     }
   }
 
   const Int_t isDiskFace(Int_t layer) const { return (layer % 2); }
   const Float_t getDistanceToSeed(const Cluster&, const Cluster&, const Cluster&) const;
-  void getBinClusterRange(const ROframe<T>&, const Int_t, const Int_t, Int_t&, Int_t&) const;
+  void getBinClusterRange(const ThreadContext&, const Int_t, const Int_t, Int_t&, Int_t&) const;
   const Float_t getCellDeviation(const Cell&, const Cell&) const;
   const Bool_t getCellsConnect(const Cell&, const Cell&) const;
-  void addCellToCurrentTrackCA(const Int_t, const Int_t, ROframe<T>&);
-  void addCellToCurrentRoad(ROframe<T>&, const Int_t, const Int_t, const Int_t, const Int_t, Int_t&);
+  void addCellToCurrentTrackCA(const Int_t, const Int_t, ROframe<T>&, ThreadContext&);
+  void addCellToCurrentRoad(ROframe<T>&, ThreadContext&, const Int_t, const Int_t, const Int_t, const Int_t, Int_t&);
 
   int mTrackerID = 0;
   Float_t mBz;
   std::vector<MCCompLabel> mTrackLabels;
   std::unique_ptr<o2::mft::TrackFitter<T>> mTrackFitter = nullptr;
 
-  Int_t mMaxCellLevel = 0;
-
   bool mUseMC = false;
+  int mNThreads = 1;
 
   /// helper to store points of a track candidate
   struct TrackElement {
@@ -165,8 +172,7 @@ class Tracker : public TrackerConfig
     Int_t idInLayer;
   };
 
-  /// current road for CA algorithm
-  Road mRoad;
+  std::vector<std::unique_ptr<ThreadContext>> mThreadContexts; ///< one finder context per thread
 };
 
 //_________________________________________________________________________________________________
@@ -189,9 +195,9 @@ inline const Float_t Tracker<T>::getDistanceToSeed(const Cluster& cluster1, cons
 
 //_________________________________________________________________________________________________
 template <typename T>
-inline void Tracker<T>::getBinClusterRange(const ROframe<T>& event, const Int_t layer, const Int_t bin, Int_t& clsMinIndex, Int_t& clsMaxIndex) const
+inline void Tracker<T>::getBinClusterRange(const ThreadContext& ctx, const Int_t layer, const Int_t bin, Int_t& clsMinIndex, Int_t& clsMaxIndex) const
 {
-  const auto& pair = getClusterBinIndexRange(layer, bin);
+  const auto& pair = ctx.clusterBinIndexRange[layer][bin];
   clsMinIndex = pair.first;
   clsMaxIndex = pair.second;
 }
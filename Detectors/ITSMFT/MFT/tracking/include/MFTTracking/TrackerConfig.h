@@ -27,6 +27,7 @@ namespace mft
 
 using namespace constants::mft;
 using BinContainer = std::array<std::array<std::array<std::vector<Int_t>, constants::index_table::MaxRPhiBins>, (constants::mft::LayersNumber - 1)>, (constants::mft::LayersNumber - 1)>;
+using BinIndexRange = std::array<std::array<std::pair<Int_t, Int_t>, constants::index_table::MaxRPhiBins>, constants::mft::LayersNumber>;
 using RArray = std::array<Float_t, constants::mft::LayersNumber>;
 using PhiArray = std::array<Int_t, constants::mft::LayersNumber>;
 
@@ -45,8 +46,6 @@ class TrackerConfig
 
   static void initBinContainers();
 
-  const std::pair<Int_t, Int_t>& getClusterBinIndexRange(Int_t layerId, Int_t bin) const { return mClusterBinIndexRange[layerId][bin]; }
-
  protected:
   // tracking configuration parameters
   Int_t mMinTrackPointsLTF{};
@@ -80,9 +79,8 @@ class TrackerConfig
 
   static std::unique_ptr<BinContainer> mBins;
   static std::unique_ptr<BinContainer> mBinsS;
-  std::array<std::array<std::pair<Int_t, Int_t>, constants::index_table::MaxRPhiBins>, constants::mft::LayersNumber> mClusterBinIndexRange{};
 
-  ClassDefNV(TrackerConfig, 3);
+  ClassDefNV(TrackerConfig, 4);
 };
 
 inline Float_t TrackerConfig::mPhiBinSize;
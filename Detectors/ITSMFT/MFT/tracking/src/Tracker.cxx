@@ -20,6 +20,10 @@
 #include "ReconstructionDataFormats/Track.h"
 #include "Framework/Logger.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace o2
 {
 namespace mft
@@ -32,6 +36,21 @@ template <typename T>
 Tracker<T>::Tracker(bool useMC) : mUseMC{useMC}
 {
   mTrackFitter = std::make_unique<o2::mft::TrackFitter<T>>();
+  mThreadContexts.emplace_back(std::make_unique<ThreadContext>());
+}
+
+//_________________________________________________________________________________________________
+template <typename T>
+void Tracker<T>::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+  while (int(mThreadContexts.size()) < mNThreads) {
+    mThreadContexts.emplace_back(std::make_unique<ThreadContext>())->road.initialize();
+  }
 }
 
 //_________________________________________________________________________________________________
@@ -105,7 +124,9 @@ void Tracker<T>::configure(const MFTTrackingParam& trkParam, int trackerID)
     }
     initializeFinder();
   }
-  mRoad.initialize();
+  for (auto& ctx : mThreadContexts) {
+    ctx->road.initialize();
+  }
 }
 
 //_________________________________________________________________________________________________
@@ -237,10 +258,42 @@ void Tracker<T>::initializeFinder()
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::findLTFTracks(ROframe<T>& event)
+void Tracker<T>::findTracks(ROframe<T>& event, ThreadContext& ctx)
 {
   if (!mFullClusterScan) {
-    findTracksLTF(event);
+    clearSorting(ctx);
+    sortClusters(event, ctx);
+  }
+  findLTFTracks(event, ctx);
+  findCATracks(event, ctx);
+}
+
+//_________________________________________________________________________________________________
+template <typename T>
+void Tracker<T>::findTracks(std::vector<ROframe<T>>& events)
+{
+  /// find tracks in a set of ROFs, the ROFs are independent and distributed dynamically over
+  /// the threads; the output order is preserved since tracks are stored in their own ROframe
+  int nROFs = events.size();
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+#ifdef WITH_OPENMP
+    int iThread = omp_get_thread_num();
+#else
+    int iThread = 0;
+#endif
+    findTracks(events[iROF], *mThreadContexts[iThread]);
+  }
+}
+
+//_________________________________________________________________________________________________
+template <typename T>
+void Tracker<T>::findLTFTracks(ROframe<T>& event, ThreadContext& ctx)
+{
+  if (!mFullClusterScan) {
+    findTracksLTF(event, ctx);
   } else {
     findTracksLTFfcs(event);
   }
@@ -248,18 +301,20 @@ void Tracker<T>::findLTFTracks(ROframe<T>& event)
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::findCATracks(ROframe<T>& event)
+void Tracker<T>::findCATracks(ROframe<T>& event, ThreadContext& ctx)
 {
+  // the max. cell level is accumulated per ROF only, to not depend on which ROFs were processed by the same thread before
+  ctx.maxCellLevel = 0;
   if (!mFullClusterScan) {
-    findTracksCA(event);
+    findTracksCA(event, ctx);
   } else {
-    findTracksCAfcs(event);
+    findTracksCAfcs(event, ctx);
   }
 }
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::findTracksLTF(ROframe<T>& event)
+void Tracker<T>::findTracksLTF(ROframe<T>& event, ThreadContext& ctx)
 {
   // find (high momentum) tracks by the Linear Track Finder (LTF) method
 
@@ -305,7 +360,7 @@ void Tracker<T>::findTracksLTF(ROframe<T>& event)
       // loop over the bins in the search window
       for (const auto& binS : (*mBinsS.get())[layer1][layer2 - 1][cluster1.indexTableBin]) {
 
-        getBinClusterRange(event, layer2, binS, clsMinIndexS, clsMaxIndexS);
+        getBinClusterRange(ctx, layer2, binS, clsMinIndexS, clsMaxIndexS);
 
         for (std::vector<Cluster>::iterator it2 = (event.getClustersInLayer(layer2).begin() + clsMinIndexS); it2 != (event.getClustersInLayer(layer2).begin() + clsMaxIndexS + 1); ++it2) {
           Cluster& cluster2 = *it2;
@@ -335,7 +390,7 @@ void Tracker<T>::findTracksLTF(ROframe<T>& event)
             dR2min = mLTFConeRadius ? dR2cut * dRCone * dRCone : dR2cut;
             for (const auto& bin : (*mBins.get())[layer1][layer - 1][cluster1.indexTableBin]) {
 
-              getBinClusterRange(event, layer, bin, clsMinIndex, clsMaxIndex);
+              getBinClusterRange(ctx, layer, bin, clsMinIndex, clsMaxIndex);
 
               for (std::vector<Cluster>::iterator it = (event.getClustersInLayer(layer).begin() + clsMinIndex); it != (event.getClustersInLayer(layer).begin() + clsMaxIndex + 1); ++it) {
                 Cluster& cluster = *it;
@@ -546,7 +601,7 @@ void Tracker<T>::findTracksLTFfcs(ROframe<T>& event)
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::findTracksCA(ROframe<T>& event)
+void Tracker<T>::findTracksCA(ROframe<T>& event, ThreadContext& ctx)
 {
   // layers: 0, 1, 2, ..., 9
   // rules for combining first/last plane in a road:
@@ -587,7 +642,7 @@ void Tracker<T>::findTracksCA(ROframe<T>& event)
         // loop over the bins in the search window
         for (const auto& binS : (*mBinsS.get())[layer1][layer2 - 1][cluster1.indexTableBin]) {
 
-          getBinClusterRange(event, layer2, binS, clsMinIndexS, clsMaxIndexS);
+          getBinClusterRange(ctx, layer2, binS, clsMinIndexS, clsMaxIndexS);
 
           for (std::vector<Cluster>::iterator it2 = (event.getClustersInLayer(layer2).begin() + clsMinIndexS); it2 != (event.getClustersInLayer(layer2).begin() + clsMaxIndexS + 1); ++it2) {
             Cluster& cluster2 = *it2;
@@ -613,7 +668,7 @@ void Tracker<T>::findTracksCA(ROframe<T>& event)
               // loop over the bins in the search window
               for (const auto& bin : (*mBins.get())[layer1][layer - 1][cluster1.indexTableBin]) {
 
-                getBinClusterRange(event, layer, bin, clsMinIndex, clsMaxIndex);
+                getBinClusterRange(ctx, layer, bin, clsMinIndex, clsMaxIndex);
 
                 for (std::vector<Cluster>::iterator it = (event.getClustersInLayer(layer).begin() + clsMinIndex); it != (event.getClustersInLayer(layer).begin() + clsMaxIndex + 1); ++it) {
                   Cluster& cluster = *it;
@@ -659,18 +714,18 @@ void Tracker<T>::findTracksCA(ROframe<T>& event)
               continue;
             }
 
-            mRoad.reset();
+            ctx.road.reset();
             for (Int_t point = 0; point < nPoints; ++point) {
               auto layer = roadPoints[point].layer;
               auto clsInLayer = roadPoints[point].idInLayer;
-              mRoad.setPoint(layer, clsInLayer);
+              ctx.road.setPoint(layer, clsInLayer);
             }
-            mRoad.setRoadId(roadId);
+            ctx.road.setRoadId(roadId);
             ++roadId;
 
-            computeCellsInRoad(event);
-            runForwardInRoad();
-            runBackwardInRoad(event);
+            computeCellsInRoad(event, ctx);
+            runForwardInRoad(ctx);
+            runBackwardInRoad(event, ctx);
 
           } // end clusters in layer2
         }   // end binRPhi
@@ -681,7 +736,7 @@ void Tracker<T>::findTracksCA(ROframe<T>& event)
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::findTracksCAfcs(ROframe<T>& event)
+void Tracker<T>::findTracksCAfcs(ROframe<T>& event, ThreadContext& ctx)
 {
   // layers: 0, 1, 2, ..., 9
   // rules for combining first/last plane in a road:
@@ -776,18 +831,18 @@ void Tracker<T>::findTracksCAfcs(ROframe<T>& event)
             continue;
           }
 
-          mRoad.reset();
+          ctx.road.reset();
           for (Int_t point = 0; point < nPoints; ++point) {
             auto layer = roadPoints[point].layer;
             auto clsInLayer = roadPoints[point].idInLayer;
-            mRoad.setPoint(layer, clsInLayer);
+            ctx.road.setPoint(layer, clsInLayer);
           }
-          mRoad.setRoadId(roadId);
+          ctx.road.setRoadId(roadId);
           ++roadId;
 
-          computeCellsInRoad(event);
-          runForwardInRoad();
-          runBackwardInRoad(event);
+          computeCellsInRoad(event, ctx);
+          runForwardInRoad(ctx);
+          runBackwardInRoad(event, ctx);
 
         } // end clusters in layer2
       }   // end clusters in layer1
@@ -797,7 +852,7 @@ void Tracker<T>::findTracksCAfcs(ROframe<T>& event)
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::computeCellsInRoad(ROframe<T>& event)
+void Tracker<T>::computeCellsInRoad(ROframe<T>& event, ThreadContext& ctx)
 {
   Int_t layer1, layer1min, layer1max, layer2, layer2min, layer2max;
   Int_t nPtsInLayer1, nPtsInLayer2;
@@ -805,7 +860,7 @@ void Tracker<T>::computeCellsInRoad(ROframe<T>& event)
   Int_t cellId;
   Bool_t noCell;
 
-  mRoad.getLength(layer1min, layer1max);
+  ctx.road.getLength(layer1min, layer1max);
   --layer1max;
 
   for (layer1 = layer1min; layer1 <= layer1max; ++layer1) {
@@ -815,30 +870,30 @@ void Tracker<T>::computeCellsInRoad(ROframe<T>& event)
     layer2min = layer1 + 1;
     layer2max = std::min(layer1 + (constants::mft::DisksNumber - isDiskFace(layer1)), constants::mft::LayersNumber - 1);
 
-    nPtsInLayer1 = mRoad.getNPointsInLayer(layer1);
+    nPtsInLayer1 = ctx.road.getNPointsInLayer(layer1);
 
     for (Int_t point1 = 0; point1 < nPtsInLayer1; ++point1) {
 
-      clsInLayer1 = mRoad.getClustersIdInLayer(layer1)[point1];
+      clsInLayer1 = ctx.road.getClustersIdInLayer(layer1)[point1];
 
       layer2 = layer2min;
 
       noCell = kTRUE;
       while (noCell && (layer2 <= layer2max)) {
 
-        nPtsInLayer2 = mRoad.getNPointsInLayer(layer2);
+        nPtsInLayer2 = ctx.road.getNPointsInLayer(layer2);
         /*
         if (nPtsInLayer2 > 1) {
-          LOG(info) << "BV===== more than one point in road " << mRoad.getRoadId() << " in layer " << layer2 << " : " << nPtsInLayer2 << "\n";
+          LOG(info) << "BV===== more than one point in road " << ctx.road.getRoadId() << " in layer " << layer2 << " : " << nPtsInLayer2 << "\n";
         }
   */
         for (Int_t point2 = 0; point2 < nPtsInLayer2; ++point2) {
 
-          clsInLayer2 = mRoad.getClustersIdInLayer(layer2)[point2];
+          clsInLayer2 = ctx.road.getClustersIdInLayer(layer2)[point2];
 
           noCell = kFALSE;
           // create a cell
-          addCellToCurrentRoad(event, layer1, layer2, clsInLayer1, clsInLayer2, cellId);
+          addCellToCurrentRoad(event, ctx, layer1, layer2, clsInLayer1, clsInLayer2, cellId);
         } // end points in layer2
         ++layer2;
 
@@ -849,7 +904,7 @@ void Tracker<T>::computeCellsInRoad(ROframe<T>& event)
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::runForwardInRoad()
+void Tracker<T>::runForwardInRoad(ThreadContext& ctx)
 {
   Int_t layerR, layerL, icellR, icellL;
   Int_t iter = 0;
@@ -863,9 +918,9 @@ void Tracker<T>::runForwardInRoad()
     // R = right, L = left
     for (layerL = 0; layerL < (constants::mft::LayersNumber - 2); ++layerL) {
 
-      for (icellL = 0; icellL < mRoad.getCellsInLayer(layerL).size(); ++icellL) {
+      for (icellL = 0; icellL < ctx.road.getCellsInLayer(layerL).size(); ++icellL) {
 
-        Cell& cellL = mRoad.getCellsInLayer(layerL)[icellL];
+        Cell& cellL = ctx.road.getCellsInLayer(layerL)[icellL];
 
         layerR = cellL.getSecondLayerId();
 
@@ -873,16 +928,16 @@ void Tracker<T>::runForwardInRoad()
           continue;
         }
 
-        for (icellR = 0; icellR < mRoad.getCellsInLayer(layerR).size(); ++icellR) {
+        for (icellR = 0; icellR < ctx.road.getCellsInLayer(layerR).size(); ++icellR) {
 
-          Cell& cellR = mRoad.getCellsInLayer(layerR)[icellR];
+          Cell& cellR = ctx.road.getCellsInLayer(layerR)[icellR];
 
           if ((cellL.getLevel() == cellR.getLevel()) && getCellsConnect(cellL, cellR)) {
             if (iter == 1) {
-              mRoad.addRightNeighbourToCell(layerL, icellL, layerR, icellR);
-              mRoad.addLeftNeighbourToCell(layerR, icellR, layerL, icellL);
+              ctx.road.addRightNeighbourToCell(layerL, icellL, layerR, icellR);
+              ctx.road.addLeftNeighbourToCell(layerR, icellR, layerL, icellL);
             }
-            mRoad.incrementCellLevel(layerR, icellR);
+            ctx.road.incrementCellLevel(layerR, icellR);
             levelChange = kTRUE;
 
           } // end matching cells
@@ -890,16 +945,16 @@ void Tracker<T>::runForwardInRoad()
       }     // end loop cellL
     }       // end loop layer
 
-    updateCellStatusInRoad();
+    updateCellStatusInRoad(ctx);
 
   } // end while (levelChange)
 }
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
+void Tracker<T>::runBackwardInRoad(ROframe<T>& event, ThreadContext& ctx)
 {
-  if (mMaxCellLevel == 1) {
+  if (ctx.maxCellLevel == 1) {
     return; // we have only isolated cells
   }
 
@@ -918,9 +973,9 @@ void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
 
   for (Int_t layer = maxLayer; layer >= minLayer; --layer) {
 
-    for (cellId = 0; cellId < mRoad.getCellsInLayer(layer).size(); ++cellId) {
+    for (cellId = 0; cellId < ctx.road.getCellsInLayer(layer).size(); ++cellId) {
 
-      if (mRoad.isCellUsed(layer, cellId) || (mRoad.getCellLevel(layer, cellId) < (mMinTrackPointsCA - 1))) {
+      if (ctx.road.isCellUsed(layer, cellId) || (ctx.road.getCellLevel(layer, cellId) < (mMinTrackPointsCA - 1))) {
         continue;
       }
 
@@ -938,7 +993,7 @@ void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
         layerRC = trackCells[nCells - 1].layer;
         cellIdRC = trackCells[nCells - 1].idInLayer;
 
-        const Cell& cellRC = mRoad.getCellsInLayer(layerRC)[cellIdRC];
+        const Cell& cellRC = ctx.road.getCellsInLayer(layerRC)[cellIdRC];
 
         addCellToNewTrack = kFALSE;
 
@@ -951,9 +1006,9 @@ void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
           layerL = leftNeighbour.first;
           cellIdL = leftNeighbour.second;
 
-          const Cell& cellL = mRoad.getCellsInLayer(layerL)[cellIdL];
+          const Cell& cellL = ctx.road.getCellsInLayer(layerL)[cellIdL];
 
-          if (mRoad.isCellUsed(layerL, cellIdL) || (mRoad.getCellLevel(layerL, cellIdL) != (mRoad.getCellLevel(layerRC, cellIdRC) - 1))) {
+          if (ctx.road.isCellUsed(layerL, cellIdL) || (ctx.road.getCellLevel(layerL, cellIdL) != (ctx.road.getCellLevel(layerRC, cellIdRC) - 1))) {
             continue;
           }
 
@@ -985,7 +1040,7 @@ void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
 
       layerC = trackCells[0].layer;
       cellIdC = trackCells[0].idInLayer;
-      const Cell& cellC = mRoad.getCellsInLayer(layerC)[cellIdC];
+      const Cell& cellC = ctx.road.getCellsInLayer(layerC)[cellIdC];
       hasDisk[cellC.getSecondLayerId() / 2] = kTRUE;
       for (icell = 0; icell < nCells; ++icell) {
         layerC = trackCells[icell].layer;
@@ -1009,10 +1064,10 @@ void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
       for (icell = 0; icell < nCells; ++icell) {
         layerC = trackCells[icell].layer;
         cellIdC = trackCells[icell].idInLayer;
-        addCellToCurrentTrackCA(layerC, cellIdC, event);
-        mRoad.setCellUsed(layerC, cellIdC, kTRUE);
+        addCellToCurrentTrackCA(layerC, cellIdC, event, ctx);
+        ctx.road.setCellUsed(layerC, cellIdC, kTRUE);
         // marked the used clusters
-        const Cell& cellC = mRoad.getCellsInLayer(layerC)[cellIdC];
+        const Cell& cellC = ctx.road.getCellsInLayer(layerC)[cellIdC];
         event.getClustersInLayer(cellC.getFirstLayerId())[cellC.getFirstClusterIndex()].setUsed(true);
         event.getClustersInLayer(cellC.getSecondLayerId())[cellC.getSecondClusterIndex()].setUsed(true);
       }
@@ -1023,23 +1078,23 @@ void Tracker<T>::runBackwardInRoad(ROframe<T>& event)
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::updateCellStatusInRoad()
+void Tracker<T>::updateCellStatusInRoad(ThreadContext& ctx)
 {
   Int_t layerMin, layerMax;
-  mRoad.getLength(layerMin, layerMax);
+  ctx.road.getLength(layerMin, layerMax);
   for (Int_t layer = layerMin; layer < layerMax; ++layer) {
-    for (Int_t icell = 0; icell < mRoad.getCellsInLayer(layer).size(); ++icell) {
-      mRoad.updateCellLevel(layer, icell);
-      mMaxCellLevel = std::max(mMaxCellLevel, mRoad.getCellLevel(layer, icell));
+    for (Int_t icell = 0; icell < ctx.road.getCellsInLayer(layer).size(); ++icell) {
+      ctx.road.updateCellLevel(layer, icell);
+      ctx.maxCellLevel = std::max(ctx.maxCellLevel, ctx.road.getCellLevel(layer, icell));
     }
   }
 }
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::addCellToCurrentRoad(ROframe<T>& event, const Int_t layer1, const Int_t layer2, const Int_t clsInLayer1, const Int_t clsInLayer2, Int_t& cellId)
+void Tracker<T>::addCellToCurrentRoad(ROframe<T>& event, ThreadContext& ctx, const Int_t layer1, const Int_t layer2, const Int_t clsInLayer1, const Int_t clsInLayer2, Int_t& cellId)
 {
-  Cell& cell = mRoad.addCellInLayer(layer1, layer2, clsInLayer1, clsInLayer2, cellId);
+  Cell& cell = ctx.road.addCellInLayer(layer1, layer2, clsInLayer1, clsInLayer2, cellId);
 
   Cluster& cluster1 = event.getClustersInLayer(layer1)[clsInLayer1];
   Cluster& cluster2 = event.getClustersInLayer(layer2)[clsInLayer2];
@@ -1058,10 +1113,10 @@ void Tracker<T>::addCellToCurrentRoad(ROframe<T>& event, const Int_t layer1, con
 
 //_________________________________________________________________________________________________
 template <typename T>
-void Tracker<T>::addCellToCurrentTrackCA(const Int_t layer1, const Int_t cellId, ROframe<T>& event)
+void Tracker<T>::addCellToCurrentTrackCA(const Int_t layer1, const Int_t cellId, ROframe<T>& event, ThreadContext& ctx)
 {
   auto& trackCA = event.getCurrentTrack();
-  const Cell& cell = mRoad.getCellsInLayer(layer1)[cellId];
+  const Cell& cell = ctx.road.getCellsInLayer(layer1)[cellId];
   const Int_t layer2 = cell.getSecondLayerId();
   const Int_t clsInLayer1 = cell.getFirstClusterIndex();
   const Int_t clsInLayer2 = cell.getSecondClusterIndex();
@@ -1101,6 +1156,20 @@ bool Tracker<T>::fitTracks(ROframe<T>& event)
   return true;
 }
 
+//_________________________________________________________________________________________________
+template <typename T>
+void Tracker<T>::fitTracks(std::vector<ROframe<T>>& events)
+{
+  // the fitter holds only configuration, hence it can be shared by the threads
+  int nROFs = events.size();
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+    fitTracks(events[iROF]);
+  }
+}
+
 //_________________________________________________________________________________________________
 template <typename T>
 Tracker<T>::~Tracker()
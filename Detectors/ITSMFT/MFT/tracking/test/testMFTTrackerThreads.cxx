@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testMFTTrackerThreads.cxx
+/// \brief Checks that the tracks found in a set of ROFs do not depend on the number of tracker threads
+
+#define BOOST_TEST_MODULE Test MFT Tracker threads
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "MFTTracking/Tracker.h"
+#include "MFTTracking/TrackCA.h"
+#include "MFTTracking/MFTTrackingParam.h"
+#include "MathUtils/Utils.h"
+
+#include <random>
+#include <vector>
+
+using namespace o2::mft;
+
+namespace
+{
+constexpr int NROFs = 64;
+
+// straight tracks from vertices around the IP crossing all MFT layers, with noise clusters on top
+std::vector<ROframe<TrackLTFL>> makeROFs(const Tracker<TrackLTFL>& tracker)
+{
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<float> zvDist(-5.f, 5.f), r0Dist(3.f, 8.f), phiDist(0.f, o2::constants::math::TwoPI), noiseRDist(2.5f, 12.f);
+  std::normal_distribution<float> smear(0.f, 5.e-4f);
+  std::vector<ROframe<TrackLTFL>> rofs(NROFs);
+  for (int iROF = 0; iROF < NROFs; iROF++) {
+    auto& rof = rofs[iROF];
+    int extIndex = 0;
+    auto addCluster = [&](int layer, float x, float y) {
+      float r = std::hypot(x, y), phi = std::atan2(y, x);
+      o2::math_utils::bringTo02PiGen(phi);
+      int bin = tracker.getBinIndex(tracker.getRBinIndex(r, layer), tracker.getPhiBinIndex(phi));
+      float z = constants::mft::LayerZCoordinate()[layer];
+      rof.addClusterToLayer(layer, x, y, z, phi, r, rof.getClustersInLayer(layer).size(), bin, 1.e-6f, 1.e-6f, 0);
+      rof.addClusterExternalIndexToLayer(layer, extIndex++);
+      rof.addClusterSizeToLayer(layer, 1);
+    };
+    // the track multiplicity varies a lot between the ROFs, to have unbalanced work for the threads
+    const int nTracks = iROF % 8 == 0 ? 150 : rng() % 30;
+    for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+      float zv = zvDist(rng), r0 = r0Dist(rng), phi0 = phiDist(rng);
+      float z0 = constants::mft::LayerZCoordinate()[0];
+      for (int layer = 0; layer < constants::mft::LayersNumber; layer++) {
+        float r = r0 * (constants::mft::LayerZCoordinate()[layer] - zv) / (z0 - zv);
+        if (r < constants::index_table::RMin[layer] || r > constants::index_table::RMax[layer]) {
+          continue;
+        }
+        addCluster(layer, r * std::cos(phi0) + smear(rng), r * std::sin(phi0) + smear(rng));
+      }
+    }
+    for (int layer = 0; layer < constants::mft::LayersNumber; layer++) {
+      const int nNoise = rng() % 20;
+      for (int i = 0; i < nNoise; i++) {
+        float r = noiseRDist(rng), phi = phiDist(rng);
+        addCluster(layer, r * std::cos(phi), r * std::sin(phi));
+      }
+    }
+  }
+  return rofs;
+}
+
+std::vector<ROframe<TrackLTFL>> runTracker(Tracker<TrackLTFL>& tracker, int nThreads)
+{
+  auto rofs = makeROFs(tracker);
+  tracker.setNThreads(nThreads);
+  tracker.findTracks(rofs);
+  tracker.fitTracks(rofs);
+  return rofs;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(MFTTrackerThreads)
+{
+  // a single tracker instance, the bin tables are static and are not rebuilt for a new instance
+  Tracker<TrackLTFL> tracker(false);
+  tracker.setBz(0.f);
+  tracker.configure(MFTTrackingParam::Instance(), 0);
+
+  auto reference = runTracker(tracker, 1);
+  size_t nTracks = 0;
+  for (int nThreads : {4, 7}) {
+    auto rofs = runTracker(tracker, nThreads);
+    for (int iROF = 0; iROF < NROFs; iROF++) {
+      auto& tracks = rofs[iROF].getTracks();
+      auto& refTracks = reference[iROF].getTracks();
+      BOOST_REQUIRE_MESSAGE(tracks.size() == refTracks.size(), "ROF " << iROF << " with " << nThreads << " threads");
+      for (size_t i = 0; i < tracks.size(); i++) {
+        const auto& trk = tracks[i];
+        const auto& ref = refTracks[i];
+        BOOST_CHECK(trk.isCA() == ref.isCA());
+        BOOST_CHECK(trk.getNumberOfPoints() == ref.getNumberOfPoints());
+        BOOST_CHECK(trk.getClustersId() == ref.getClustersId());
+        BOOST_CHECK(trk.getLayers() == ref.getLayers());
+        BOOST_CHECK(trk.getX() == ref.getX());
+        BOOST_CHECK(trk.getY() == ref.getY());
+        BOOST_CHECK(trk.getTgl() == ref.getTgl());
+        BOOST_CHECK(trk.getPhi() == ref.getPhi());
+      }
+      nTracks += tracks.size();
+    }
+  }
+  BOOST_CHECK(nTracks > 0);
+}
@@ -20,7 +20,6 @@
 #include "MFTBase/GeometryTGeo.h"
 
 #include <vector>
-#include <future>
 
 #include "TGeoGlobalMagField.h"
 
@@ -44,7 +43,6 @@ namespace o2
 {
 namespace mft
 {
-//#define _TIMING_
 
 void TrackerDPL::init(InitContext& ic)
 {
@@ -113,83 +111,21 @@ void TrackerDPL::run(ProcessingContext& pc)
 
   std::uint32_t roFrameId = 0;
   int nROFs = rofs.size();
-  auto rofsPerWorker = std::max(1, nROFs / mNThreads);
-  LOG(debug) << "nROFs = " << nROFs << " rofsPerWorker = " << rofsPerWorker;
+  LOG(debug) << "nROFs = " << nROFs << " nThreads = " << mNThreads;
 
-  auto loadData = [&, this](auto& trackerVec, auto& roFrameDataVec) {
-    auto& tracker = trackerVec[0]; // Use first tracker to load the data: serial operation
+  auto loadData = [&, this](auto& tracker, auto& roFrameDataVec) {
     gsl::span<const unsigned char>::iterator pattIt = patterns.begin();
 
     auto iROF = 0;
 
     for (const auto& rof : rofs) {
-      int worker = std::min(int(iROF / rofsPerWorker), mNThreads - 1);
-      auto& roFrameData = roFrameDataVec[worker].emplace_back();
+      auto& roFrameData = roFrameDataVec.emplace_back();
       int nclUsed = ioutils::loadROFrameData(rof, roFrameData, compClusters, pattIt, mDict, labels, tracker.get(), filter);
-      LOG(debug) << "ROframeId: " << iROF << ", clusters loaded : " << nclUsed << " on worker " << worker;
+      LOG(debug) << "ROframeId: " << iROF << ", clusters loaded : " << nclUsed;
       iROF++;
     }
   };
 
-  auto launchTrackFinder = [](auto* tracker, auto* workerROFs) {
-#ifdef _TIMING_
-    long tStart = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count(), tStartROF = tStart, tEnd = tStart;
-    size_t rofCNT = 0;
-#endif
-    for (auto& rofData : *workerROFs) {
-      tracker->findTracks(rofData);
-#ifdef _TIMING_
-      long tEndROF = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-      LOGP(info, "launchTrackFinder| tracker:{} did {}-th ROF in {} mus: {} clusters -> {} tracks", tracker->getTrackerID(), ++rofCNT, tEndROF - tStartROF, rofData.getTotalClusters(), rofData.getTracks().size());
-      tStartROF = tEnd = tEndROF;
-#endif
-    }
-#ifdef _TIMING_
-    LOGP(info, "launchTrackFinder| done: tracker:{} processed {} ROFS in {} mus", tracker->getTrackerID(), workerROFs->size(), tEnd - tStart);
-#endif
-  };
-
-  auto launchFitter = [](auto* tracker, auto* workerROFs) {
-#ifdef _TIMING_
-    long tStart = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-#endif
-    for (auto& rofData : *workerROFs) {
-      tracker->fitTracks(rofData);
-    }
-#ifdef _TIMING_
-    long tEnd = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-    LOGP(info, "launchTrackFitter| done: tracker:{} fitted  {} ROFS in {} mus", tracker->getTrackerID(), workerROFs->size(), tEnd - tStart);
-#endif
-  };
-
-  auto runMFTTrackFinder = [&, this](auto& trackerVec, auto& roFrameDataVec) {
-    std::vector<std::future<void>> finder;
-    for (int i = 0; i < mNThreads; i++) {
-      auto& tracker = trackerVec[i];
-      auto& workerData = roFrameDataVec[i];
-      auto f = std::async(std::launch::async, launchTrackFinder, tracker.get(), &workerData);
-      finder.push_back(std::move(f));
-    }
-
-    for (int i = 0; i < mNThreads; i++) {
-      finder[i].wait();
-    }
-  };
-
-  auto runTrackFitter = [&, this](auto& trackerVec, auto& roFrameDataVec) {
-    std::vector<std::future<void>> fitter;
-    for (int i = 0; i < mNThreads; i++) {
-      auto& tracker = trackerVec[i];
-      auto& workerData = roFrameDataVec[i];
-      auto f = std::async(std::launch::async, launchFitter, tracker.get(), &workerData);
-      fitter.push_back(std::move(f));
-    }
-
-    for (int i = 0; i < mNThreads; i++) {
-      fitter[i].wait();
-    }
-  };
-
   // snippet to convert found tracks to final output tracks with separate cluster indices
   auto copyTracks = [](auto& new_tracks, auto& allTracks, auto& allClusIdx) {
     for (auto& trc : new_tracks) {
@@ -206,122 +142,61 @@ void TrackerDPL::run(ProcessingContext& pc)
     }
   };
 
-  if (mFieldOn) {
-
-    std::vector<std::vector<o2::mft::ROframe<TrackLTF>>> roFrameVec(mNThreads); // One vector of ROFrames per thread
-    LOG(debug) << "Reserving ROFs ";
-
-    for (auto& rof : roFrameVec) {
-      rof.reserve(rofsPerWorker);
-    }
+  auto runTracking = [&, this](auto& tracker, auto& roFrameVec, auto& tracksTmp) {
+    roFrameVec.reserve(nROFs);
     LOG(debug) << "Loading data into ROFs.";
 
     mTimer[SWLoadData].Start(false);
-    loadData(mTrackerVec, roFrameVec);
+    loadData(tracker, roFrameVec);
     mTimer[SWLoadData].Stop();
 
+    // ROFs are distributed over the threads of the tracker, which share the finder bin tables
     LOG(debug) << "Running MFT Track finder.";
 
     mTimer[SWFindMFTTracks].Start(false);
-    runMFTTrackFinder(mTrackerVec, roFrameVec);
+    tracker->findTracks(roFrameVec);
     mTimer[SWFindMFTTracks].Stop();
 
     LOG(debug) << "Runnig track fitter.";
 
     mTimer[SWFitTracks].Start(false);
-    runTrackFitter(mTrackerVec, roFrameVec);
+    tracker->fitTracks(roFrameVec);
     mTimer[SWFitTracks].Stop();
 
     if (mUseMC) {
       LOG(debug) << "Computing MC Labels.";
 
       mTimer[SWComputeLabels].Start(false);
-      auto& tracker = mTrackerVec[0];
-
-      for (int i = 0; i < mNThreads; i++) {
-        for (auto& rofData : roFrameVec[i]) {
-          tracker->computeTracksMClabels(rofData.getTracks());
-          trackLabels.swap(tracker->getTrackLabels());
-          std::copy(trackLabels.begin(), trackLabels.end(), std::back_inserter(allTrackLabels));
-          trackLabels.clear();
-        }
+      for (auto& rofData : roFrameVec) {
+        tracker->computeTracksMClabels(rofData.getTracks());
+        trackLabels.swap(tracker->getTrackLabels());
+        std::copy(trackLabels.begin(), trackLabels.end(), std::back_inserter(allTrackLabels));
+        trackLabels.clear();
       }
       mTimer[SWComputeLabels].Stop();
     }
 
     auto rof = rofs.begin();
 
-    for (int i = 0; i < mNThreads; i++) {
-      for (auto& rofData : roFrameVec[i]) {
-        int ntracksROF = 0, firstROFTrackEntry = allTracksMFT.size();
-        tracks.swap(rofData.getTracks());
-        ntracksROF = tracks.size();
-        copyTracks(tracks, allTracksMFT, allClusIdx);
-
-        rof->setFirstEntry(firstROFTrackEntry);
-        rof->setNEntries(ntracksROF);
-        *rof++;
-        roFrameId++;
-      }
+    for (auto& rofData : roFrameVec) {
+      int ntracksROF = 0, firstROFTrackEntry = allTracksMFT.size();
+      tracksTmp.swap(rofData.getTracks());
+      ntracksROF = tracksTmp.size();
+      copyTracks(tracksTmp, allTracksMFT, allClusIdx);
+      rof->setFirstEntry(firstROFTrackEntry);
+      rof->setNEntries(ntracksROF);
+      *rof++;
+      roFrameId++;
     }
+  };
 
+  if (mFieldOn) {
+    std::vector<o2::mft::ROframe<TrackLTF>> roFrameVec;
+    runTracking(mTracker, roFrameVec, tracks);
   } else {
     LOG(debug) << "Field is off! ";
-    std::vector<std::vector<o2::mft::ROframe<TrackLTFL>>> roFrameVec(mNThreads); // One vector of ROFrames per thread
-    LOG(debug) << "Reserving ROFs ";
-
-    for (auto& rof : roFrameVec) {
-      rof.reserve(rofsPerWorker);
-    }
-    LOG(debug) << "Loading data into ROFs.";
-
-    mTimer[SWLoadData].Start(false);
-    loadData(mTrackerLVec, roFrameVec);
-    mTimer[SWLoadData].Stop();
-
-    LOG(debug) << "Running MFT Track finder.";
-
-    mTimer[SWFindMFTTracks].Start(false);
-    runMFTTrackFinder(mTrackerLVec, roFrameVec);
-    mTimer[SWFindMFTTracks].Stop();
-
-    LOG(debug) << "Runnig track fitter.";
-
-    mTimer[SWFitTracks].Start(false);
-    runTrackFitter(mTrackerLVec, roFrameVec);
-    mTimer[SWFitTracks].Stop();
-
-    if (mUseMC) {
-      LOG(debug) << "Computing MC Labels.";
-
-      mTimer[SWComputeLabels].Start(false);
-      auto& tracker = mTrackerLVec[0];
-
-      for (int i = 0; i < mNThreads; i++) {
-        for (auto& rofData : roFrameVec[i]) {
-          tracker->computeTracksMClabels(rofData.getTracks());
-          trackLabels.swap(tracker->getTrackLabels());
-          std::copy(trackLabels.begin(), trackLabels.end(), std::back_inserter(allTrackLabels));
-          trackLabels.clear();
-        }
-      }
-      mTimer[SWComputeLabels].Stop();
-    }
-
-    auto rof = rofs.begin();
-
-    for (int i = 0; i < mNThreads; i++) {
-      for (auto& rofData : roFrameVec[i]) {
-        int ntracksROF = 0, firstROFTrackEntry = allTracksMFT.size();
-        tracksL.swap(rofData.getTracks());
-        ntracksROF = tracksL.size();
-        copyTracks(tracksL, allTracksMFT, allClusIdx);
-        rof->setFirstEntry(firstROFTrackEntry);
-        rof->setNEntries(ntracksROF);
-        *rof++;
-        roFrameId++;
-      }
-    }
+    std::vector<o2::mft::ROframe<TrackLTFL>> roFrameVec;
+    runTracking(mTrackerL, roFrameVec, tracksL);
   }
 
   LOG(info) << "MFTTracker pushed " << allTracksMFT.size() << " tracks";
@@ -339,6 +214,12 @@ void TrackerDPL::endOfStream(EndOfStreamContext& ec)
   for (int i = 0; i < NStopWatches; i++) {
     LOGF(info, "Timing %18s: Cpu: %.3e s; Real: %.3e s in %d slots", TimerName[i], mTimer[i].CpuTime(), mTimer[i].RealTime(), mTimer[i].Counter() - 1);
   }
+  // CPU/Real ratio of the finder and fitter timers gives the effective thread scaling
+  for (auto sw : {SWFindMFTTracks, SWFitTracks}) {
+    if (mTimer[sw].RealTime() > 0.) {
+      LOGF(info, "Scaling %17s: Cpu/Real = %.2f with %d threads", TimerName[sw], mTimer[sw].CpuTime() / mTimer[sw].RealTime(), mNThreads);
+    }
+  }
 }
 ///_______________________________________
 void TrackerDPL::updateTimeDependentParams(ProcessingContext& pc)
@@ -373,20 +254,18 @@ void TrackerDPL::updateTimeDependentParams(ProcessingContext& pc)
       LOG(info) << "Starting MFT Linear tracker: Field is off!";
       LOG(info) << "  MFT tracker running with " << mNThreads << " threads";
       mFieldOn = false;
-      for (auto i = 0; i < mNThreads; i++) {
-        auto& tracker = mTrackerLVec.emplace_back(std::make_unique<o2::mft::Tracker<TrackLTFL>>(mUseMC));
-        tracker->setBz(0);
-        tracker->configure(trackingParam, i);
-      }
+      mTrackerL = std::make_unique<o2::mft::Tracker<TrackLTFL>>(mUseMC);
+      mTrackerL->setBz(0);
+      mTrackerL->configure(trackingParam, 0);
+      mTrackerL->setNThreads(mNThreads);
     } else {
       LOG(info) << "Starting MFT tracker: Field is on! Bz = " << Bz;
       LOG(info) << "  MFT tracker running with " << mNThreads << " threads";
       mFieldOn = true;
-      for (auto i = 0; i < mNThreads; i++) {
-        auto& tracker = mTrackerVec.emplace_back(std::make_unique<o2::mft::Tracker<TrackLTF>>(mUseMC));
-        tracker->setBz(Bz);
-        tracker->configure(trackingParam, i);
-      }
+      mTracker = std::make_unique<o2::mft::Tracker<TrackLTF>>(mUseMC);
+      mTracker->setBz(Bz);
+      mTracker->configure(trackingParam, 0);
+      mTracker->setNThreads(mNThreads);
     }
   }
 }
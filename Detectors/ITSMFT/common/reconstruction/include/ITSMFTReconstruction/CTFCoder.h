@@ -116,7 +116,16 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>&
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  std::vector<BlockEncoder> blockEncoders(getNThreads() > 1 ? CTF::getNBlocks() : 0);
+  auto encodeITSMFT = [&buff, &optField, &coders = mCoders, mfc = getMemMarginFactor(), &blockEncoders](const auto& part, int slot, uint8_t bits) -> o2::ctf::CTFIOSize {
+    auto encodeBlock = [&part, &optField, &coders, mfc, slot, bits](auto& buffer) { return CTF::get(buffer.data())->encode(part, slot, bits, optField[slot], &buffer, coders[slot], mfc); };
+    if (blockEncoders.empty()) {
+      return encodeBlock(buff);
+    }
+    blockEncoders[slot] = encodeBlock; // blocks are independent, encode them concurrently at the end
+    return {};
+  };
+#define ENCODEITSMFT(part, slot, bits) encodeITSMFT(part, int(slot), bits);
   // clang-format off
   iosize += ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
   iosize += ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
@@ -130,6 +139,7 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>&
   iosize += ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
   iosize += ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
   // clang-format on
+  iosize += encodeBlocks<CTF>(buff, blockEncoders);
   //CTF::get(buff.data())->print(getPrefix());
   iosize.rawIn = rofRecVec.size() * sizeof(ROFRecord) + cclusVec.size() * sizeof(CompClusterExt) + pattVec.size() * sizeof(unsigned char);
   return iosize;
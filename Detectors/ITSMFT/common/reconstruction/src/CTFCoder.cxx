@@ -240,7 +240,16 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec, o2::c
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   ec.print(getPrefix(), mVerbosity);
-#define DECODEITSMFT(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  std::vector<BlockTask> blockDecoders;
+  auto decodeITSMFT = [&ec, &coders = mCoders, &blockDecoders, parallel = getNThreads() > 1](auto& part, int slot) -> o2::ctf::CTFIOSize {
+    auto decodeBlock = [&ec, &coders, &part, slot]() { return ec.decode(part, slot, coders[slot]); };
+    if (!parallel) {
+      return decodeBlock();
+    }
+    blockDecoders.emplace_back(decodeBlock); // blocks are independent, decode them concurrently at the end
+    return {};
+  };
+#define DECODEITSMFT(part, slot) decodeITSMFT(part, int(slot))
   // clang-format off
   iosize += DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
   iosize += DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF);
@@ -254,5 +263,6 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec, o2::c
   iosize += DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
   iosize += DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
   // clang-format on
+  iosize += runBlockTasks(blockDecoders);
   return cc;
 }
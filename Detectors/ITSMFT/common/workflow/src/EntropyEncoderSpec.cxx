@@ -134,6 +134,8 @@ DataProcessorSpec getEntropyEncoderSpec(o2::header::DataOrigin orig, bool selIR)
             {"irframe-margin-bwd", VariantType::UInt32, 0u, {"margin in BC to add to the IRFrame lower boundary when selection is requested"}},
             {"irframe-margin-fwd", VariantType::UInt32, 0u, {"margin in BC to add to the IRFrame upper boundary when selection is requested"}},
             {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
+            {"ctf-threads", VariantType::Int, 1, {"number of threads for the concurrent encoding of the CTF blocks"}},
+            {"ctf-dict-adaptive", VariantType::Bool, false, {"use the external dictionary only for the blocks it compresses better than a per-TF dictionary"}},
             {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
 }
 
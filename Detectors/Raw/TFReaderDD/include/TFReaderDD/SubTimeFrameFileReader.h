@@ -25,6 +25,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
 #include <fstream>
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
@@ -36,10 +37,30 @@ namespace o2
 namespace rawdd
 {
 
+class TFRegionBuffer;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// SubTimeFrameFileReader
 ////////////////////////////////////////////////////////////////////////////////
 using MessagesPerRoute = std::unordered_map<std::string, std::unique_ptr<fair::mq::Parts>>;
+using TransportGetter = std::function<fair::mq::TransportFactory*(const std::string& channel)>;
+
+/// TF decoded from the headers in the file: output header stacks, channels and locations of the payloads in the file
+struct TFLayout {
+  struct Part {
+    o2::header::Stack header{};
+    std::string channel{};
+    std::uint64_t offset = 0; // payload position in the file
+    std::uint64_t size = 0;   // payload size
+  };
+  std::vector<Part> parts{};    // data parts to send
+  std::vector<Part> stfParts{}; // DISTSUBTIMEFRAME parts, with stfHeader as a payload
+  o2::header::STFHeader stfHeader{};
+  std::uint64_t start = 0;       // position of the TF in the file
+  std::uint64_t end = 0;         // end of the TF in the file
+  std::uint64_t payloadSize = 0; // total size of the payloads to send
+  size_t slice = 0;
+};
 
 class SubTimeFrameFileReader
 {
@@ -52,6 +73,19 @@ class SubTimeFrameFileReader
   /// Read a single TF from the file
   std::unique_ptr<MessagesPerRoute> read(fair::mq::Device* device, const std::vector<o2f::OutputRoute>& outputRoutes, const std::string& rawChannel, size_t slice, bool sup0xccdb, int verbosity);
 
+  /// Decode the headers of the next TF in the file, w/o accessing its payloads.
+  /// With prefetchTF the read-ahead of the whole TF is requested as soon as its size is known from the meta header
+  std::unique_ptr<TFLayout> readLayout(const std::vector<o2f::OutputRoute>& outputRoutes, const std::string& rawChannel, size_t slice, bool sup0xccdb, int verbosity, bool prefetchTF = false);
+
+  /// Create the messages of the TF decoded by readLayout, copying the payloads with nThreads threads.
+  /// If the region is provided and has enough free space, the payloads are published from it instead of allocating a message per part
+  std::unique_ptr<MessagesPerRoute> build(fair::mq::Device* device, const TFLayout& layout, int verbosity, int nThreads = 1, TFRegionBuffer* region = nullptr);
+  std::unique_ptr<MessagesPerRoute> build(const TransportGetter& getTransport, const TFLayout& layout, int verbosity, int nThreads = 1, TFRegionBuffer* region = nullptr);
+
+  /// Request the read-ahead of the TF data from the file
+  void prefetch(const TFLayout& layout) const { prefetch(layout.start, layout.end - layout.start); }
+  void prefetch(std::uint64_t start, std::uint64_t size) const;
+
   /// Tell the current position of the file
   inline std::uint64_t position() const { return mFileMapOffset; }
 
@@ -66,6 +100,9 @@ class SubTimeFrameFileReader
   /// Is the stream position at EOF
   inline bool eof() const { return mFileMapOffset == mFileSize; }
 
+  /// Was the file read w/o errors so far
+  inline bool isValid() const { return mFileMap.is_open() && mValid; }
+
   /// Tell the size of the file
   inline std::uint64_t size() const { return mFileSize; }
 
@@ -75,13 +112,14 @@ class SubTimeFrameFileReader
   boost::iostreams::mapped_file_source mFileMap;
   std::uint64_t mFileMapOffset = 0;
   std::uint64_t mFileSize = 0;
+  bool mValid = true; // the file stays mapped after an error since the data of the already decoded TFs may be still in use
 
   // helper to make sure written chunks are buffered, only allow pointers
   template <typename pointer,
             typename = std::enable_if_t<std::is_pointer<pointer>::value>>
   bool read_advance(pointer pPtr, std::uint64_t pLen)
   {
-    if (!mFileMap.is_open()) {
+    if (!isValid()) {
       return false;
     }
 
@@ -91,10 +129,7 @@ class SubTimeFrameFileReader
     if (lToRead != pLen) {
       LOGP(error, "FileReader: request to read beyond the file end. pos={} size={} len={}",
            mFileMapOffset, mFileSize, pLen);
-      LOGP(error, "Closing the file {}. The read data is invalid.", mFileName);
-      mFileMap.close();
-      mFileMapOffset = 0;
-      mFileSize = 0;
+      invalidate();
       return false;
     }
 
@@ -115,10 +150,7 @@ class SubTimeFrameFileReader
     if (pLen != lToIgnore) {
       LOGP(error, "FileReader: request to ignore bytes beyond the file end. pos={} size={} len={}",
            mFileMapOffset, mFileSize, pLen);
-      LOGP(error, "Closing the file {}. The read data is invalid.", mFileName);
-      mFileMap.close();
-      mFileMapOffset = 0;
-      mFileSize = 0;
+      invalidate();
       return false;
     }
 
@@ -127,6 +159,16 @@ class SubTimeFrameFileReader
     return true;
   }
 
+  // stop reading the file after an error
+  void invalidate()
+  {
+    if (mValid) {
+      LOGP(error, "Stop reading the file {}. The data after position {} is invalid.", mFileName, mFileMapOffset);
+    }
+    mValid = false;
+    mFileMapOffset = mFileSize;
+  }
+
   std::size_t getHeaderStackSize();
   o2::header::Stack getHeaderStack(std::size_t& pOrigsize);
 
@@ -0,0 +1,79 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef ALICEO2_TF_REGION_BUFFER_RAWDD_H_
+#define ALICEO2_TF_REGION_BUFFER_RAWDD_H_
+
+#include <fairmq/Message.h>
+#include <fairmq/TransportFactory.h>
+#include <fairmq/UnmanagedRegion.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace o2
+{
+namespace rawdd
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// Ring buffer in the FairMQ unmanaged region (shared memory for the shmem transport), used to publish the payloads
+/// of the TF as region messages w/o allocating a message per part. The space of the TF is reused once all its messages
+/// were released by the consumers.
+////////////////////////////////////////////////////////////////////////////////
+class TFRegionBuffer
+{
+ public:
+  struct Block {
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+    std::atomic<int> nPending{1}; // messages not released yet + 1 for the creator
+  };
+
+  TFRegionBuffer(fair::mq::TransportFactory& transport, std::uint64_t size);
+  ~TFRegionBuffer();
+
+  /// Reserve size bytes in the region, nullptr is returned if there is not enough free space
+  Block* allocate(std::uint64_t size);
+
+  /// Create the message for size bytes at offset in the block
+  fair::mq::MessagePtr createMessage(Block& block, std::uint64_t offset, std::uint64_t size);
+
+  /// Release the block reference: by the creator once all messages are created, by the region callback when the message is released
+  void release(Block& block);
+
+  /// Wait until all blocks are released or the timeout expires, returns true if nothing is in use
+  bool waitReleased(std::chrono::milliseconds timeout);
+
+  fair::mq::TransportFactory& getTransport() const { return mTransport; }
+  std::uint64_t getSize() const { return mSize; }
+  std::uint64_t getNAllocated() const { return mNAllocated; }
+  std::uint64_t getNFailed() const { return mNFailed; }
+  size_t getNBlocks();
+
+ private:
+  fair::mq::TransportFactory& mTransport;
+  fair::mq::UnmanagedRegionPtr mRegion;
+  std::uint64_t mSize = 0;
+  std::uint64_t mNAllocated = 0; // number of successful allocations
+  std::uint64_t mNFailed = 0;    // number of allocations failed for the lack of space
+  std::deque<Block> mBlocks;     // blocks in use, in the order of allocation
+  std::mutex mMutex;
+  std::condition_variable mReleased; // notified when all blocks are released
+};
+
+} // namespace rawdd
+} // namespace o2
+
+#endif /* ALICEO2_TF_REGION_BUFFER_RAWDD_H_ */
@@ -12,6 +12,7 @@
 // Adapthed with minimal changes from Gvozden Nescovic code to read sTFs files created by DataDistribution
 
 #include "TFReaderDD/SubTimeFrameFileReader.h"
+#include "TFReaderDD/TFRegionBuffer.h"
 #include "DetectorsRaw/RDHUtils.h"
 #include "Framework/Logger.h"
 #include "Framework/OutputRoute.h"
@@ -21,6 +22,7 @@
 #include <fairmq/Message.h>
 #include <fairmq/Parts.h>
 #include <mutex>
+#include <unistd.h>
 
 #if __linux__
 #include <sys/mman.h>
@@ -67,7 +69,7 @@ SubTimeFrameFileReader::SubTimeFrameFileReader(const std::string& pFileName, o2:
 
 SubTimeFrameFileReader::~SubTimeFrameFileReader()
 {
-  if (!mFileMap.is_open()) {
+  if (mFileMap.is_open()) {
 #if __linux__
     madvise((void*)mFileMap.data(), mFileMap.size(), MADV_DONTNEED);
 #endif
@@ -186,9 +188,17 @@ std::mutex stfMtx;
 std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device* device, const std::vector<o2f::OutputRoute>& outputRoutes,
                                                                const std::string& rawChannel, size_t slice, bool sup0xccdb, int verbosity)
 {
-  std::unique_ptr<MessagesPerRoute> messagesPerRoute = std::make_unique<MessagesPerRoute>();
-  auto& msgMap = *messagesPerRoute.get();
   assert(device);
+  auto layout = readLayout(outputRoutes, rawChannel, slice, sup0xccdb, verbosity);
+  if (!layout) {
+    return nullptr;
+  }
+  return build(device, *layout, verbosity);
+}
+
+std::unique_ptr<TFLayout> SubTimeFrameFileReader::readLayout(const std::vector<o2f::OutputRoute>& outputRoutes, const std::string& rawChannel,
+                                                             size_t slice, bool sup0xccdb, int verbosity, bool prefetchTF)
+{
   std::unordered_map<o2::header::DataHeader, std::pair<std::string, bool>> channelsMap;
   auto findOutputChannel = [&outputRoutes, &rawChannel, &channelsMap](const o2::header::DataHeader* h, size_t tslice) -> const std::string& {
     if (!rawChannel.empty()) {
@@ -209,21 +219,10 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
     return chFromMap.first;
   };
 
-  auto addPart = [&msgMap](fair::mq::MessagePtr hd, fair::mq::MessagePtr pl, const std::string& fairMQChannel) {
-    fair::mq::Parts* parts = nullptr;
-    parts = msgMap[fairMQChannel].get(); // fair::mq::Parts*
-    if (!parts) {
-      msgMap[fairMQChannel] = std::make_unique<fair::mq::Parts>();
-      parts = msgMap[fairMQChannel].get();
-    }
-    parts->AddPart(std::move(hd));
-    parts->AddPart(std::move(pl));
-  };
-
   // record current position
   const auto lTfStartPosition = position();
 
-  if (lTfStartPosition == size() || !mFileMap.is_open() || eof()) {
+  if (lTfStartPosition == size() || !isValid() || eof()) {
     return nullptr;
   }
   auto tfID = slice;
@@ -248,7 +247,7 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
   auto lMetaHdrStack = getHeaderStack(lMetaHdrStackSize);
   if (lMetaHdrStackSize == 0) {
     LOG(error) << "Failed to read the TF file header. The file might be corrupted.";
-    mFileMap.close();
+    invalidate();
     return nullptr;
   }
   lStfMetaDataHdr = o2::header::DataHeader::Get(lMetaHdrStack.first());
@@ -268,7 +267,7 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
   // verify we're actually reading the correct data in
   if (!(SubTimeFrameFileMeta::getDataHeader().dataDescription == lStfMetaDataHdr->dataDescription)) {
     LOGP(warning, "Reading bad data: SubTimeFrame META header");
-    mFileMap.close();
+    invalidate();
     return nullptr;
   }
 
@@ -276,16 +275,19 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
   const auto lStfSizeInFile = lStfFileMeta.mStfSizeInFile;
   if (lStfSizeInFile == (sizeof(DataHeader) + sizeof(SubTimeFrameFileMeta))) {
     LOGP(warning, "Reading an empty TF from file. Only meta information present");
-    mFileMap.close();
+    invalidate();
     return nullptr;
   }
 
   // check there's enough data in the file
   if ((lTfStartPosition + lStfSizeInFile) > this->size()) {
     LOGP(warning, "Not enough data in file for this TF. Required: {}, available: {}", lStfSizeInFile, (this->size() - lTfStartPosition));
-    mFileMap.close();
+    invalidate();
     return nullptr;
   }
+  if (prefetchTF) { // the data of the TF is read ahead while its headers are decoded
+    prefetch(lTfStartPosition, lStfSizeInFile);
+  }
 
   // Index
   std::size_t lStfIndexHdrStackSize = 0;
@@ -294,30 +296,29 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
   // Read DataHeader + SubTimeFrameFileMeta
   auto lStfIndexHdrStack = getHeaderStack(lStfIndexHdrStackSize);
   if (lStfIndexHdrStackSize == 0) {
-    mFileMap.close();
+    invalidate();
     return nullptr;
   }
   lStfIndexHdr = o2::header::DataHeader::Get(lStfIndexHdrStack.first());
   if (!lStfIndexHdr) {
     LOG(error) << "Failed to read the TF index structure. The file might be corrupted.";
+    invalidate();
     return nullptr;
   }
 
   if (!ignore_nbytes(lStfIndexHdr->payloadSize)) {
     return nullptr;
   }
-#ifdef _RUN_TIMING_MEASUREMENT_
-  TStopwatch readSW, findChanSW, msgSW, addPartSW;
-  findChanSW.Stop();
-  msgSW.Stop();
-  addPartSW.Stop();
-#endif
   // Remaining data size of the TF:
   // total size in file - meta (hdr+struct) - index (hdr + payload)
   const auto lStfDataSize = lStfSizeInFile - (lMetaHdrStackSize + sizeof(SubTimeFrameFileMeta)) - (lStfIndexHdrStackSize + lStfIndexHdr->payloadSize);
 
+  auto layout = std::make_unique<TFLayout>();
+  layout->start = lTfStartPosition;
+  layout->slice = tfID;
+  auto& stfHeader = layout->stfHeader;
+  stfHeader = STFHeader{tfID, -1u, -1u};
   std::int64_t lLeftToRead = lStfDataSize;
-  STFHeader stfHeader{tfID, -1u, -1u};
   // read <hdrStack + data> pairs
   while (lLeftToRead > 0) {
 
@@ -325,13 +326,13 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
     std::size_t lDataHeaderStackSize = 0;
     Stack lDataHeaderStack = getHeaderStack(lDataHeaderStackSize);
     if (lDataHeaderStackSize == 0) {
-      mFileMap.close();
+      invalidate();
       return nullptr;
     }
     const DataHeader* lDataHeader = o2::header::DataHeader::Get(lDataHeaderStack.first());
     if (!lDataHeader) {
       LOG(error) << "Failed to read the TF HBF DataHeader structure. The file might be corrupted.";
-      mFileMap.close();
+      invalidate();
       return nullptr;
     }
     DataHeader locDataHeader(*lDataHeader);
@@ -350,7 +351,6 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
       }
       locDataHeader.runNumber = runNumberFallBack;
     }
-    o2::header::Stack headerStack{locDataHeader, o2f::DataProcessingHeader{tfID, 1, lStfFileMeta.mWriteTimeMs}};
     if (stfHeader.runNumber == -1) {
       stfHeader.id = locDataHeader.tfCounter;
       stfHeader.runNumber = locDataHeader.runNumber;
@@ -370,61 +370,37 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
       lLeftToRead -= (lDataHeaderStackSize + lDataSize); // update the counter
       continue;
     }
-#ifdef _RUN_TIMING_MEASUREMENT_
-    findChanSW.Start(false);
-#endif
     const auto& fmqChannel = findOutputChannel(&locDataHeader, tfID);
-#ifdef _RUN_TIMING_MEASUREMENT_
-    findChanSW.Stop();
-#endif
     if (fmqChannel.empty()) { // no output channel
       if (!ignore_nbytes(lDataSize)) {
         return nullptr;
       }
       lLeftToRead -= (lDataHeaderStackSize + lDataSize); // update the counter
       continue;
-      //mFileMap.close();
-      //return nullptr;
     }
-    // read the data
-
-    auto fmqFactory = device->GetChannel(fmqChannel, 0).Transport();
-#ifdef _RUN_TIMING_MEASUREMENT_
-    msgSW.Start(false);
-#endif
-    auto lHdrStackMsg = fmqFactory->CreateMessage(headerStack.size(), fair::mq::Alignment{64});
-    auto lDataMsg = fmqFactory->CreateMessage(lDataSize, fair::mq::Alignment{64});
-#ifdef _RUN_TIMING_MEASUREMENT_
-    msgSW.Stop();
-#endif
-    memcpy(lHdrStackMsg->GetData(), headerStack.data(), headerStack.size());
-
-    if (!read_advance(lDataMsg->GetData(), lDataSize)) {
+    // register the data, its payload will be accessed only when the messages are built
+    auto& part = layout->parts.emplace_back();
+    part.header = o2::header::Stack{locDataHeader, o2f::DataProcessingHeader{tfID, 1, lStfFileMeta.mWriteTimeMs}};
+    part.channel = fmqChannel;
+    part.offset = position();
+    part.size = lDataSize;
+    if (!ignore_nbytes(lDataSize)) {
       return nullptr;
     }
-    if (verbosity > 0) {
-      if (verbosity > 1 || locDataHeader.splitPayloadIndex == 0) {
-        printStack(headerStack);
-        if (o2::raw::RDHUtils::checkRDH(lDataMsg->GetData()) && verbosity > 2) {
-          o2::raw::RDHUtils::printRDH(lDataMsg->GetData());
-        }
-      }
+    layout->payloadSize += lDataSize;
+    if (verbosity > 0 && (verbosity > 1 || locDataHeader.splitPayloadIndex == 0)) {
+      printStack(part.header);
     }
-#ifdef _RUN_TIMING_MEASUREMENT_
-    addPartSW.Start(false);
-#endif
-    addPart(std::move(lHdrStackMsg), std::move(lDataMsg), fmqChannel);
-#ifdef _RUN_TIMING_MEASUREMENT_
-    addPartSW.Stop();
-#endif
     // update the counter
     lLeftToRead -= (lDataHeaderStackSize + lDataSize);
   }
 
   if (lLeftToRead < 0) {
     LOG(error) << "FileRead: Read more data than it is indicated in the META header!";
+    invalidate();
     return nullptr;
   }
+  layout->end = position();
   // add TF acknowledge part
   // in case of empty TF fall-back to previous runNumber and fistTForbit
   if (stfHeader.runNumber == -1u) {
@@ -442,34 +418,167 @@ std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::read(fair::mq::Device*
     stfDistDataHeader.tfCounter = stfHeader.id;
     const auto fmqChannel = findOutputChannel(&stfDistDataHeader, tfID);
     if (!fmqChannel.empty()) { // no output channel
-      auto fmqFactory = device->GetChannel(fmqChannel, 0).Transport();
-      o2::header::Stack headerStackSTF{stfDistDataHeader, o2f::DataProcessingHeader{tfID, 1, lStfFileMeta.mWriteTimeMs}};
+      auto& part = layout->stfParts.emplace_back();
+      part.header = o2::header::Stack{stfDistDataHeader, o2f::DataProcessingHeader{tfID, 1, lStfFileMeta.mWriteTimeMs}};
+      part.channel = fmqChannel;
+      part.size = sizeof(STFHeader);
       if (verbosity > 0) {
-        printStack(headerStackSTF);
+        printStack(part.header);
+      }
+    }
+  }
+  return layout;
+}
+
+std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::build(fair::mq::Device* device, const TFLayout& layout, int verbosity, int nThreads, TFRegionBuffer* region)
+{
+  assert(device);
+  return build([device](const std::string& channel) { return device->GetChannel(channel, 0).Transport(); }, layout, verbosity, nThreads, region);
+}
+
+std::unique_ptr<MessagesPerRoute> SubTimeFrameFileReader::build(const TransportGetter& getTransport, const TFLayout& layout, int verbosity, int nThreads, TFRegionBuffer* region)
+{
+  std::unique_ptr<MessagesPerRoute> messagesPerRoute = std::make_unique<MessagesPerRoute>();
+  auto& msgMap = *messagesPerRoute.get();
+  if (!mFileMap.is_open()) {
+    return nullptr;
+  }
+#ifdef _RUN_TIMING_MEASUREMENT_
+  TStopwatch readSW, msgSW, copySW, addPartSW;
+  msgSW.Stop();
+  copySW.Stop();
+  addPartSW.Stop();
+#endif
+  auto addPart = [&msgMap](fair::mq::MessagePtr hd, fair::mq::MessagePtr pl, const std::string& fairMQChannel) {
+    fair::mq::Parts* parts = nullptr;
+    parts = msgMap[fairMQChannel].get(); // fair::mq::Parts*
+    if (!parts) {
+      msgMap[fairMQChannel] = std::make_unique<fair::mq::Parts>();
+      parts = msgMap[fairMQChannel].get();
+    }
+    parts->AddPart(std::move(hd));
+    parts->AddPart(std::move(pl));
+  };
+  const std::string* lastChannel = nullptr;
+  fair::mq::TransportFactory* fmqFactory = nullptr;
+  auto getFactory = [&getTransport, &lastChannel, &fmqFactory](const std::string& channel) {
+    if (!lastChannel || *lastChannel != channel) { // parts of the same channel are normally consecutive
+      fmqFactory = getTransport(channel);
+      lastChannel = &channel;
+    }
+    return fmqFactory;
+  };
+
+  // if possible, reserve the space for all payloads of the TF in the region
+  constexpr std::uint64_t Alignment = 64;
+  auto alignedSize = [](std::uint64_t sz) { return (sz + Alignment - 1) / Alignment * Alignment; };
+  TFRegionBuffer::Block* block = nullptr;
+  if (region) {
+    std::uint64_t regionSize = 0;
+    for (const auto& part : layout.parts) {
+      if (part.size && getFactory(part.channel) == &region->getTransport()) {
+        regionSize += alignedSize(part.size);
       }
-      auto hdMessageSTF = fmqFactory->CreateMessage(headerStackSTF.size(), fair::mq::Alignment{64});
-      auto plMessageSTF = fmqFactory->CreateMessage(stfDistDataHeader.payloadSize, fair::mq::Alignment{64});
-      memcpy(hdMessageSTF->GetData(), headerStackSTF.data(), headerStackSTF.size());
-      memcpy(plMessageSTF->GetData(), &stfHeader, sizeof(STFHeader));
+    }
+    if (regionSize) {
+      block = region->allocate(regionSize);
+    }
+  }
+
+  // create the messages, the payloads are copied once all messages are available
+  struct Copy {
+    void* dest = nullptr;
+    const char* src = nullptr;
+    std::uint64_t size = 0;
+  };
+  constexpr std::uint64_t MaxCopySize = 4 * 1024 * 1024; // split large payloads to balance the copy between the threads
+  std::vector<Copy> copies;
+  std::uint64_t regionOffset = 0;
+  for (const auto& part : layout.parts) {
+#ifdef _RUN_TIMING_MEASUREMENT_
+    msgSW.Start(false);
+#endif
+    auto factory = getFactory(part.channel);
+    auto lHdrStackMsg = factory->CreateMessage(part.header.size(), fair::mq::Alignment{64});
+    memcpy(lHdrStackMsg->GetData(), part.header.data(), part.header.size());
+    fair::mq::MessagePtr lDataMsg;
+    if (block && part.size && factory == &region->getTransport()) {
+      lDataMsg = region->createMessage(*block, regionOffset, part.size);
+      regionOffset += alignedSize(part.size);
+    } else {
+      lDataMsg = factory->CreateMessage(part.size, fair::mq::Alignment{64});
+    }
 #ifdef _RUN_TIMING_MEASUREMENT_
-      addPartSW.Start(false);
+    msgSW.Stop();
 #endif
-      addPart(std::move(hdMessageSTF), std::move(plMessageSTF), fmqChannel);
+    for (std::uint64_t done = 0; done < part.size; done += MaxCopySize) {
+      copies.push_back(Copy{static_cast<char*>(lDataMsg->GetData()) + done, mFileMap.data() + part.offset + done, std::min(MaxCopySize, part.size - done)});
+    }
 #ifdef _RUN_TIMING_MEASUREMENT_
-      addPartSW.Stop();
+    addPartSW.Start(false);
+#endif
+    addPart(std::move(lHdrStackMsg), std::move(lDataMsg), part.channel);
+#ifdef _RUN_TIMING_MEASUREMENT_
+    addPartSW.Stop();
+#endif
+  }
+  if (block) {
+    region->release(*block); // all messages of the block were created
+  }
+#ifdef _RUN_TIMING_MEASUREMENT_
+  copySW.Start(false);
+#endif
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads) if (nThreads > 1)
 #endif
+  for (size_t i = 0; i < copies.size(); i++) {
+    std::memcpy(copies[i].dest, copies[i].src, copies[i].size);
+  }
+#ifdef _RUN_TIMING_MEASUREMENT_
+  copySW.Stop();
+#endif
+  if (verbosity > 2) {
+    for (auto& msgIt : msgMap) {
+      auto& parts = *msgIt.second.get();
+      for (int ip = 0; ip < parts.Size(); ip += 2) {
+        if (parts[ip + 1].GetSize() && o2::raw::RDHUtils::checkRDH(parts[ip + 1].GetData())) {
+          o2::raw::RDHUtils::printRDH(parts[ip + 1].GetData());
+        }
+      }
     }
   }
 
+  for (const auto& part : layout.stfParts) {
+    auto factory = getFactory(part.channel);
+    auto hdMessageSTF = factory->CreateMessage(part.header.size(), fair::mq::Alignment{64});
+    auto plMessageSTF = factory->CreateMessage(part.size, fair::mq::Alignment{64});
+    memcpy(hdMessageSTF->GetData(), part.header.data(), part.header.size());
+    memcpy(plMessageSTF->GetData(), &layout.stfHeader, sizeof(STFHeader));
+    addPart(std::move(hdMessageSTF), std::move(plMessageSTF), part.channel);
+  }
+
 #ifdef _RUN_TIMING_MEASUREMENT_
   readSW.Stop();
   LOG(info) << "TF creation time: CPU: " << readSW.CpuTime() << " Wall: " << readSW.RealTime() << " s";
   LOG(info) << "AddPart Timer CPU: " << addPartSW.CpuTime() << " Wall: " << addPartSW.RealTime() << " s";
   LOG(info) << "CreMsg  Timer CPU: " << msgSW.CpuTime() << " Wall: " << msgSW.RealTime() << " s";
-  LOG(info) << "FndChan Timer CPU: " << findChanSW.CpuTime() << " Wall: " << findChanSW.RealTime() << " s";
+  LOG(info) << "Copy    Timer CPU: " << copySW.CpuTime() << " Wall: " << copySW.RealTime() << " s";
 #endif
   return messagesPerRoute;
 }
 
+void SubTimeFrameFileReader::prefetch(std::uint64_t start, std::uint64_t size) const
+{
+#if __linux__
+  if (!mFileMap.is_open() || !size || start >= mFileSize) {
+    return;
+  }
+  static const std::uint64_t pageSize = sysconf(_SC_PAGESIZE);
+  const auto end = std::min(start + size, mFileSize);
+  start = start / pageSize * pageSize;
+  madvise((void*)(mFileMap.data() + start), end - start, MADV_WILLNEED);
+#endif
+}
+
 } // namespace rawdd
 } // namespace o2
@@ -31,6 +31,8 @@
 #include "TFReaderSpec.h"
 #include "TFReaderDD/SubTimeFrameFileReader.h"
 #include "TFReaderDD/SubTimeFrameFile.h"
+#include "TFReaderDD/TFRegionBuffer.h"
+#include "Monitoring/Monitoring.h"
 #include "CommonUtils/FileFetcher.h"
 #include "CommonUtils/FIFO.h"
 #include <unistd.h>
@@ -67,6 +69,7 @@ class TFReaderSpec : public o2f::Task
 
  private:
   void stopProcessing(o2f::ProcessingContext& ctx);
+  void releaseRegion();
   void TFBuilder();
 
  private:
@@ -80,11 +83,15 @@ class TFReaderSpec : public o2f::Task
   int mTFBuilderCounter = 0;
   int mNWaits = 0;
   long mTotalWaitTime = 0;
+  size_t mTotalSentBytes = 0;
+  double mTotalBuildTime = 0.;                          // time spent by the builder on creating the messages, in s
+  std::chrono::steady_clock::time_point mFirstSentTime; // sending time of the 1st TF, the rates are calculated from it
   size_t mSelIDEntry = 0; // next TFID to select from the mInput.tfIDs (if non-empty)
   bool mRunning = false;
   bool mWaitSendingLast = false;
   TFReaderInp mInput; // command line inputs
   std::thread mTFBuilderThread{};
+  std::unique_ptr<TFRegionBuffer> mRegion; // optional region to publish the payloads from
 };
 
 //___________________________________________________________
@@ -112,6 +119,10 @@ void TFReaderSpec::run(o2f::ProcessingContext& ctx)
   if (!mDevice) {
     mDevice = ctx.services().get<o2f::RawDeviceService>().device();
     mOutputRoutes = ctx.services().get<o2f::RawDeviceService>().spec().outputs; // copy!!!
+    if (mInput.regionSize) {
+      const auto& channel = mInput.rawChannelConfig.empty() ? mOutputRoutes.front().channel : mInput.rawChannelConfig;
+      mRegion = std::make_unique<TFRegionBuffer>(*mDevice->GetChannel(channel, 0).Transport(), mInput.regionSize);
+    }
     // start TFBuilder thread
     mRunning = true;
     mTFBuilderThread = std::thread(&TFReaderSpec::TFBuilder, this);
@@ -270,6 +281,15 @@ void TFReaderSpec::run(o2f::ProcessingContext& ctx)
       tNow = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
       LOGP(info, "Sent TF {} of size {} with {} parts, {:.4f} s elapsed from previous TF., WaitSending={}", mTFCounter, dataSize, nparts, mTFCounter ? double(tNow - tLastTF) * 1e-6 : 0., mWaitSendingLast);
       tLastTF = tNow;
+      if (!mTFCounter) {
+        mFirstSentTime = std::chrono::steady_clock::now();
+      } else { // rates since the 1st TF was sent
+        mTotalSentBytes += dataSize;
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - mFirstSentTime).count();
+        auto& monitoring = ctx.services().get<o2::monitoring::Monitoring>();
+        monitoring.send(o2::monitoring::Metric{mTFCounter / elapsed, "tf-reader-tf-per-s"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+        monitoring.send(o2::monitoring::Metric{mTotalSentBytes / elapsed / (1 << 30), "tf-reader-gb-per-s"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+      }
       ++mTFCounter;
 
       while (mTFQueue.size() == 0 && mWaitSendingLast) {
@@ -298,6 +318,22 @@ void TFReaderSpec::endOfStream(o2f::EndOfStreamContext& ec)
   if (mTFBuilderThread.joinable()) {
     mTFBuilderThread.join();
   }
+  releaseRegion();
+}
+
+//___________________________________________________________
+void TFReaderSpec::releaseRegion()
+{
+  mTFQueue.clear(); // the messages of unsent TFs may refer to the region
+  if (!mRegion) {
+    return;
+  }
+  // the messages already sent may still be in use by the consumers, the region must stay alive until they are released
+  constexpr auto DrainTimeout = 5s;
+  if (!mRegion->waitReleased(DrainTimeout)) {
+    LOGP(warn, "{} region blocks were not released within {} s, destroying the region", mRegion->getNBlocks(), DrainTimeout.count());
+  }
+  mRegion.reset();
 }
 
 //___________________________________________________________
@@ -317,6 +353,12 @@ void TFReaderSpec::stopProcessing(o2f::ProcessingContext& ctx)
   if (mTFBuilderThread.joinable()) {
     mTFBuilderThread.join();
   }
+  releaseRegion();
+  if (mTFCounter > 1) {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - mFirstSentTime).count();
+    LOGP(info, "Sending rate after the 1st TF: {:.2f} TF/s, {:.3f} GB/s, {:.3f} s spent on building the TF messages", (mTFCounter - 1) / elapsed,
+         mTotalSentBytes / elapsed / (1 << 30), mTotalBuildTime);
+  }
   if (!mInput.rawChannelConfig.empty()) {
     auto device = ctx.services().get<o2f::RawDeviceService>().device();
     o2f::SourceInfoHeader exitHdr;
@@ -388,9 +430,10 @@ void TFReaderSpec::TFBuilder()
     LOG(info) << "Processing file " << tfFileName;
     SubTimeFrameFileReader reader(tfFileName, mInput.detMask);
     size_t locID = 0;
+    std::unique_ptr<TFLayout> layout; // headers of the TF decoded in advance
     // try
     {
-      while (mRunning && mTFBuilderCounter < mInput.maxTFs) {
+      while (mRunning && mTFBuilderCounter < mInput.maxTFs && (mInput.tfIDs.empty() || mSelIDEntry < mInput.tfIDs.size())) {
         if (mTFQueue.size() >= size_t(mInput.maxTFCache)) {
           if (mTFQueue.size() > 1) {
             mWaitSendingLast = false;
@@ -398,34 +441,45 @@ void TFReaderSpec::TFBuilder()
           std::this_thread::sleep_for(sleepTime);
           continue;
         }
-        auto tf = reader.read(mDevice, mOutputRoutes, mInput.rawChannelConfig, mSelIDEntry, mInput.sup0xccdb, mInput.verbosity);
+        if (!layout) {
+          layout = reader.readLayout(mOutputRoutes, mInput.rawChannelConfig, mSelIDEntry, mInput.sup0xccdb, mInput.verbosity);
+        }
+        if (!layout) {
+          break;
+        }
         bool acceptTF = true;
-        if (tf) {
-          locID++;
-          if (!mInput.tfIDs.empty()) {
-            acceptTF = false;
-            if (mInput.tfIDs[mSelIDEntry] == mTFBuilderCounter) {
-              mWaitSendingLast = false;
-              acceptTF = true;
-              LOGP(info, "Retrieved TF#{} will be pushed as slice {} following user request", mTFBuilderCounter, mSelIDEntry);
-              mSelIDEntry++;
-            } else {
-              LOGP(info, "Retrieved TF#{} will be discared following user request", mTFBuilderCounter);
-            }
-          } else {
+        locID++;
+        if (!mInput.tfIDs.empty()) {
+          acceptTF = false;
+          if (mInput.tfIDs[mSelIDEntry] == mTFBuilderCounter) {
+            mWaitSendingLast = false;
+            acceptTF = true;
+            LOGP(info, "Retrieved TF#{} will be pushed as slice {} following user request", mTFBuilderCounter, mSelIDEntry);
             mSelIDEntry++;
+          } else {
+            LOGP(info, "Retrieved TF#{} will be discared following user request", mTFBuilderCounter);
           }
-          mTFBuilderCounter++;
+        } else {
+          mSelIDEntry++;
         }
-        if (!acceptTF) {
-          continue;
+        mTFBuilderCounter++;
+        // decode the headers of the next TF and request the read-ahead of its data while the current one is built and sent
+        std::unique_ptr<TFLayout> nextLayout;
+        if (mTFBuilderCounter < mInput.maxTFs && (mInput.tfIDs.empty() || mSelIDEntry < mInput.tfIDs.size())) {
+          const bool prefetchTF = mInput.tfIDs.empty() || mInput.tfIDs[mSelIDEntry] == mTFBuilderCounter;
+          nextLayout = reader.readLayout(mOutputRoutes, mInput.rawChannelConfig, mSelIDEntry, mInput.sup0xccdb, mInput.verbosity, prefetchTF);
         }
-        if (mRunning && tf) {
+        if (acceptTF && mRunning) {
+          auto tStart = std::chrono::steady_clock::now();
+          auto tf = reader.build(mDevice, *layout, mInput.verbosity, mInput.copyThreads, mRegion.get());
+          mTotalBuildTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+          if (!tf) {
+            break;
+          }
           mWaitSendingLast = true;
           mTFQueue.push(std::move(tf));
-        } else {
-          break;
         }
+        layout = std::move(nextLayout);
       }
       // remove already processed file from the queue, unless they are needed for further looping
       if (mFileFetcher) {
@@ -43,6 +43,8 @@ struct TFReaderInp {
   int64_t delay_us = 0;
   int maxLoops = 0;
   int maxTFs = -1;
+  int copyThreads = 1;   // threads to copy the TF payloads to the messages
+  size_t regionSize = 0; // if > 0, size of the unmanaged region to publish the TF payloads from
   bool sendDummyForMissing = true;
   bool sup0xccdb = false;
   std::vector<o2::header::DataHeader> hdVec;
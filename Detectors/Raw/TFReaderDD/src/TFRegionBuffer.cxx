@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "TFReaderDD/TFRegionBuffer.h"
+#include "Framework/Logger.h"
+#include <stdexcept>
+
+namespace o2
+{
+namespace rawdd
+{
+
+TFRegionBuffer::TFRegionBuffer(fair::mq::TransportFactory& transport, std::uint64_t size) : mTransport(transport), mSize(size)
+{
+  mRegion = mTransport.CreateUnmanagedRegion(
+    mSize, fair::mq::RegionCallback{[this](void*, size_t, void* hint) { release(*static_cast<Block*>(hint)); }}, fair::mq::RegionConfig{});
+  if (!mRegion) {
+    throw std::runtime_error(fmt::format("failed to create unmanaged region of {} bytes", mSize));
+  }
+  LOGP(info, "Created unmanaged region of {} MB for the TF payloads", mSize >> 20);
+}
+
+TFRegionBuffer::~TFRegionBuffer()
+{
+  mRegion.reset(); // no callbacks after this point
+  if (mNAllocated) {
+    LOGP(info, "Region provided space to {} TFs, {} TFs did not fit", mNAllocated, mNFailed);
+  }
+}
+
+TFRegionBuffer::Block* TFRegionBuffer::allocate(std::uint64_t size)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::uint64_t offset = 0;
+  bool found = mBlocks.empty() && size <= mSize;
+  if (!mBlocks.empty()) {
+    const auto first = mBlocks.front().offset, free = mBlocks.back().offset + mBlocks.back().size;
+    if (free > first) { // used space is contiguous: try the tail of the region, then its head
+      if (size <= mSize - free) {
+        offset = free;
+        found = true;
+      } else if (size <= first) {
+        found = true;
+      }
+    } else if (size <= first - free) { // used space wraps around the end of the region
+      offset = free;
+      found = true;
+    }
+  }
+  if (!found) {
+    mNFailed++;
+    return nullptr;
+  }
+  mNAllocated++;
+  auto& block = mBlocks.emplace_back();
+  block.offset = offset;
+  block.size = size;
+  return &block;
+}
+
+fair::mq::MessagePtr TFRegionBuffer::createMessage(Block& block, std::uint64_t offset, std::uint64_t size)
+{
+  block.nPending++;
+  return mTransport.CreateMessage(mRegion, static_cast<char*>(mRegion->GetData()) + block.offset + offset, size, &block);
+}
+
+void TFRegionBuffer::release(Block& block)
+{
+  if (--block.nPending) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  while (!mBlocks.empty() && mBlocks.front().nPending == 0) { // the space can be reused only in the order of allocation
+    mBlocks.pop_front();
+  }
+  if (mBlocks.empty()) {
+    mReleased.notify_all();
+  }
+}
+
+bool TFRegionBuffer::waitReleased(std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mReleased.wait_for(lock, timeout, [this]() { return mBlocks.empty(); });
+}
+
+size_t TFRegionBuffer::getNBlocks()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mBlocks.size();
+}
+
+} // namespace rawdd
+} // namespace o2
@@ -36,6 +36,8 @@ void customize(std::vector<ConfigParamSpec>& workflowOptions)
   options.push_back(ConfigParamSpec{"remote-regex", VariantType::String, "^(alien://|)/alice/data/.+", {"regex string to identify remote files"}}); // Use "^/eos/aliceo2/.+" for direct EOS access
   options.push_back(ConfigParamSpec{"max-cached-tf", VariantType::Int, 3, {"max TFs to cache in memory"}});
   options.push_back(ConfigParamSpec{"max-cached-files", VariantType::Int, 3, {"max TF files queued (copied for remote source)"}});
+  options.push_back(ConfigParamSpec{"copy-threads", VariantType::Int, 1, {"number of threads to copy the TF payloads to the messages"}});
+  options.push_back(ConfigParamSpec{"payload-region-size", VariantType::Int, 0, {"if > 0: size in MB of the unmanaged shm region to publish TF payloads from"}});
   options.push_back(ConfigParamSpec{"tf-reader-verbosity", VariantType::Int, 0, {"verbosity level (1 or 2: check RDH, print DH/DPH for 1st or all slices, >2 print RDH)"}});
   options.push_back(ConfigParamSpec{"raw-channel-config", VariantType::String, "", {"optional raw FMQ channel for non-DPL output"}});
   options.push_back(ConfigParamSpec{"send-diststf-0xccdb", VariantType::Bool, false, {"send explicit FLP/DISTSUBTIMEFRAME/0xccdb output"}});
@@ -76,6 +78,8 @@ WorkflowSpec defineDataProcessing(ConfigContext const& configcontext)
   rinp.verbosity = configcontext.options().get<int>("tf-reader-verbosity");
   rinp.maxTFCache = std::max(1, configcontext.options().get<int>("max-cached-tf"));
   rinp.maxFileCache = std::max(1, configcontext.options().get<int>("max-cached-files"));
+  rinp.copyThreads = std::max(1, configcontext.options().get<int>("copy-threads"));
+  rinp.regionSize = size_t(std::max(0, configcontext.options().get<int>("payload-region-size"))) << 20;
   rinp.copyCmd = configcontext.options().get<std::string>("copy-cmd");
   rinp.tffileRegex = configcontext.options().get<std::string>("tf-file-regex");
   rinp.remoteRegex = configcontext.options().get<std::string>("remote-regex");
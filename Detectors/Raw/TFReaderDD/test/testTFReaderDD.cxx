@@ -0,0 +1,248 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test TFReaderDD
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "TFReaderDD/SubTimeFrameFile.h"
+#include "TFReaderDD/SubTimeFrameFileReader.h"
+#include "TFReaderDD/TFRegionBuffer.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Headers/DataHeader.h"
+#include "Headers/STFHeader.h"
+#include <fairmq/TransportFactory.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace o2::rawdd;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(TFRegionBufferRing)
+{
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  TFRegionBuffer region(*transport, 1000);
+
+  // blocks are allocated at the tail of the used space
+  auto* blockA = region.allocate(400);
+  auto* blockB = region.allocate(400);
+  BOOST_REQUIRE(blockA && blockB);
+  BOOST_CHECK(blockA->offset == 0);
+  BOOST_CHECK(blockB->offset == 400);
+  BOOST_CHECK(region.allocate(300) == nullptr); // does not fit to the tail nor to the head
+  BOOST_CHECK(region.allocate(1001) == nullptr);
+  BOOST_CHECK(region.getNAllocated() == 2);
+  BOOST_CHECK(region.getNFailed() == 2);
+
+  auto msgA = region.createMessage(*blockA, 100, 50);
+  auto msgB = region.createMessage(*blockB, 0, 400);
+  BOOST_CHECK(msgA->GetSize() == 50);
+  BOOST_CHECK(static_cast<char*>(msgB->GetData()) - static_cast<char*>(msgA->GetData()) == 300);
+  const auto* dataA = static_cast<char*>(msgA->GetData()) - 100; // start of the region
+  region.release(*blockA); // all messages of the blocks were created
+  region.release(*blockB);
+  BOOST_CHECK(region.getNBlocks() == 2);
+
+  // out of order release: the space of B can be reused only after A is released
+  msgB.reset();
+  BOOST_CHECK(!region.waitReleased(100ms));
+  BOOST_CHECK(region.getNBlocks() == 2);
+  BOOST_CHECK(region.allocate(300) == nullptr);
+  msgA.reset();
+  BOOST_CHECK(region.waitReleased(1s));
+  BOOST_CHECK(region.getNBlocks() == 0);
+
+  // the released space is reused from the beginning of the region
+  auto* blockC = region.allocate(600);
+  auto* blockD = region.allocate(300);
+  BOOST_REQUIRE(blockC && blockD);
+  BOOST_CHECK(blockC->offset == 0);
+  BOOST_CHECK(blockD->offset == 600);
+  auto msgC = region.createMessage(*blockC, 0, 600);
+  BOOST_CHECK(msgC->GetData() == dataA);
+  region.release(*blockC);
+  region.release(*blockD); // no messages, D is released but waits for C
+  BOOST_CHECK(region.getNBlocks() == 2);
+  auto* blockE = region.allocate(50);
+  BOOST_REQUIRE(blockE);
+  BOOST_CHECK(blockE->offset == 900);
+  msgC.reset();
+  BOOST_CHECK(!region.waitReleased(100ms)); // E is still in use
+  BOOST_CHECK(region.getNBlocks() == 1);
+
+  // the tail has only 50 bytes left, the allocation wraps to the head of the region
+  auto* blockF = region.allocate(800);
+  BOOST_REQUIRE(blockF);
+  BOOST_CHECK(blockF->offset == 0);
+  // the used space wraps around the end of the region now, only the gap between F and E is free
+  auto* blockG = region.allocate(100);
+  BOOST_REQUIRE(blockG);
+  BOOST_CHECK(blockG->offset == 800);
+  BOOST_CHECK(region.allocate(1) == nullptr);
+
+  auto msgF = region.createMessage(*blockF, 0, 800);
+  BOOST_CHECK(msgF->GetData() == dataA);
+  for (auto* block : {blockE, blockF, blockG}) {
+    region.release(*block);
+  }
+  BOOST_CHECK(region.getNBlocks() == 2); // E was released, F is in use, G waits for F
+  msgF.reset();
+  BOOST_CHECK(region.waitReleased(1s));
+  BOOST_CHECK(region.getNAllocated() == 7);
+  BOOST_CHECK(region.getNFailed() == 4);
+}
+
+namespace
+{
+struct TFRef {
+  std::vector<o2::header::DataHeader> headers;
+  std::vector<std::vector<char>> payloads;
+};
+
+// write the TFs in the format of the DataDistribution STF files
+std::vector<TFRef> writeSTFFile(const std::string& fileName, int nTFs)
+{
+  std::mt19937 rng(12345);
+  std::vector<TFRef> refs(nTFs);
+  std::ofstream out(fileName, std::ios::binary);
+  for (int tf = 0; tf < nTFs; tf++) {
+    auto& ref = refs[tf];
+    std::string data;
+    const int nParts = 1 + rng() % 20;
+    for (int ip = 0; ip < nParts; ip++) {
+      const size_t size = ip % 5 == 0 ? 0 : rng() % (ip % 3 ? 20000 : 200000);
+      o2::header::DataHeader dh{"RAWDATA", ip % 2 ? "ITS" : "TPC", uint32_t(ip), size};
+      dh.tfCounter = 100 + tf;
+      dh.runNumber = 555;
+      dh.firstTForbit = 256 * tf;
+      auto& payload = ref.payloads.emplace_back(size);
+      for (auto& c : payload) {
+        c = char(rng());
+      }
+      data.append(reinterpret_cast<const char*>(&dh), sizeof(dh));
+      data.append(payload.data(), size);
+      ref.headers.push_back(dh);
+    }
+    SubTimeFrameFileDataIndex index;
+    SubTimeFrameFileMeta meta(SubTimeFrameFileMeta::getSizeInFile() + index.getSizeInFile() + data.size());
+    out << meta << index;
+    out.write(data.data(), data.size());
+  }
+  return refs;
+}
+
+void checkTF(MessagesPerRoute& tf, const TFRef& ref, size_t slice)
+{
+  BOOST_REQUIRE(tf.size() == 1);
+  auto& parts = *tf.at("raw");
+  BOOST_REQUIRE(parts.Size() == int(2 * ref.headers.size() + 2)); // data and the DISTSUBTIMEFRAME part
+  for (size_t i = 0; i < ref.headers.size(); i++) {
+    const auto* dh = o2::header::get<o2::header::DataHeader*>(parts[2 * i].GetData());
+    const auto* dph = o2::header::get<o2::framework::DataProcessingHeader*>(parts[2 * i].GetData());
+    BOOST_REQUIRE(dh && dph);
+    BOOST_CHECK(dph->startTime == slice);
+    BOOST_CHECK(dh->subSpecification == ref.headers[i].subSpecification);
+    BOOST_CHECK(dh->tfCounter == ref.headers[i].tfCounter);
+    BOOST_REQUIRE(parts[2 * i + 1].GetSize() == ref.payloads[i].size());
+    BOOST_CHECK(ref.payloads[i].empty() || memcmp(parts[2 * i + 1].GetData(), ref.payloads[i].data(), ref.payloads[i].size()) == 0);
+  }
+  const auto* stfHeader = static_cast<const o2::header::STFHeader*>(parts[parts.Size() - 1].GetData());
+  BOOST_CHECK(stfHeader->id == ref.headers[0].tfCounter);
+  BOOST_CHECK(stfHeader->runNumber == 555);
+  BOOST_CHECK(stfHeader->firstOrbit == ref.headers[0].firstTForbit);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(SubTimeFrameFileReaderLayoutBuild)
+{
+  constexpr int NTFs = 12;
+  const auto fileName = (std::filesystem::temp_directory_path() / "testTFReaderDD.tf").string();
+  const auto refs = writeSTFFile(fileName, NTFs);
+  const std::vector<o2::framework::OutputRoute> routes; // all data goes to the raw channel
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  auto getTransport = [&transport](const std::string&) { return transport.get(); };
+
+  // with the region of 512 kB some TFs do not fit while the previous ones are in use and fall back to the regular messages
+  for (size_t regionSize : {size_t(0), size_t(512 * 1024), size_t(8 * 1024 * 1024)}) {
+    std::unique_ptr<TFRegionBuffer> region;
+    if (regionSize) {
+      region = std::make_unique<TFRegionBuffer>(*transport, regionSize);
+    }
+    SubTimeFrameFileReader reader(fileName, o2::detectors::DetID::FullMask);
+    BOOST_REQUIRE(reader.isValid());
+    std::vector<std::unique_ptr<MessagesPerRoute>> inUse;
+    auto layout = reader.readLayout(routes, "raw", 0, true, 0);
+    for (int tf = 0; tf < NTFs; tf++) {
+      BOOST_REQUIRE(layout);
+      BOOST_CHECK(layout->slice == size_t(tf));
+      BOOST_CHECK(layout->parts.size() == refs[tf].headers.size());
+      BOOST_CHECK(layout->stfParts.size() == 1);
+      BOOST_CHECK(layout->stfHeader.id == refs[tf].headers[0].tfCounter);
+      size_t payloadSize = 0;
+      for (const auto& payload : refs[tf].payloads) {
+        payloadSize += payload.size();
+      }
+      BOOST_CHECK(layout->payloadSize == payloadSize);
+      BOOST_CHECK(layout->end == reader.position());
+      // the next layout is decoded before the current TF is built, as in the reader workflow
+      auto nextLayout = reader.readLayout(routes, "raw", tf + 1, true, 0, true);
+      auto msg = reader.build(getTransport, *layout, 0, 2, region.get());
+      BOOST_REQUIRE(msg);
+      checkTF(*msg, refs[tf], tf);
+      inUse.push_back(std::move(msg));
+      if (inUse.size() > 2) { // keep the last TFs alive to have several region blocks in use
+        inUse.erase(inUse.begin());
+      }
+      layout = std::move(nextLayout);
+    }
+    BOOST_CHECK(!layout);
+    BOOST_CHECK(reader.eof());
+    BOOST_CHECK(reader.isValid());
+    for (int i = 0; i < int(inUse.size()); i++) { // the messages are still valid
+      checkTF(*inUse[i], refs[NTFs - inUse.size() + i], NTFs - inUse.size() + i);
+    }
+    inUse.clear();
+    if (region) {
+      BOOST_CHECK(region->waitReleased(1s));
+      BOOST_CHECK(region->getNAllocated() + region->getNFailed() == NTFs);
+      BOOST_CHECK(regionSize < (1 << 20) ? region->getNFailed() > 0 : region->getNFailed() == 0);
+    }
+  }
+
+  // the file truncated in the middle of a TF: the complete TFs are read, then the reader stops
+  std::ifstream in(fileName, std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  size_t cut = 0;
+  {
+    SubTimeFrameFileReader reader(fileName, o2::detectors::DetID::FullMask);
+    for (int tf = 0; tf < 5; tf++) {
+      reader.readLayout(routes, "raw", tf, true, 0);
+    }
+    cut = reader.position() + 1000;
+  }
+  std::ofstream(fileName, std::ios::binary | std::ios::trunc).write(data.data(), cut);
+  SubTimeFrameFileReader reader(fileName, o2::detectors::DetID::FullMask);
+  for (int tf = 0; tf < 5; tf++) {
+    auto layout = reader.readLayout(routes, "raw", tf, true, 0, true);
+    BOOST_REQUIRE(layout);
+    auto msg = reader.build(getTransport, *layout, 0);
+    BOOST_REQUIRE(msg);
+    checkTF(*msg, refs[tf], tf);
+  }
+  BOOST_CHECK(!reader.readLayout(routes, "raw", 5, true, 0));
+  BOOST_CHECK(!reader.isValid());
+  std::filesystem::remove(fileName);
+}
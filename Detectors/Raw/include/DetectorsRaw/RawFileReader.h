@@ -19,6 +19,7 @@
 #include <cstdio>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include <tuple>
 #include <vector>
 #include <string>
@@ -52,8 +53,12 @@ struct ReaderInp {
   uint32_t errMap = 0xffffffff;
   uint32_t minTF = 0;
   uint32_t maxTF = 0xffffffff;
+  int readAheadTFs = 0;
+  int scanThreads = 1;
   bool partPerSP = true;
   bool cache = false;
+  bool mapFiles = false;
+  bool useIndexFiles = false;
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
   bool sup0xccdb = false;
@@ -169,6 +174,24 @@ class RawFileReader
     void print(const std::string& pref = "") const;
   };
 
+  //=====================================================================================
+  // RDH found in the file at given offset, result of the files scan stored in the index file
+  struct RDHRecord {
+    size_t offset = 0;
+    RDHAny rdh;
+  };
+
+  //=====================================================================================
+  // raw file mapped to memory, unmapped when the last reference to it is released
+  struct MappedFile {
+    const char* data = nullptr; //! start of the mapping
+    size_t size = 0;            //! file size
+    MappedFile(const char* d, size_t s) : data(d), size(s) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+  };
+
   //=====================================================================================
   struct LinkData {
     RDHAny rdhl; //! RDH with the running info of the last RDH seen
@@ -209,14 +232,19 @@ class RawFileReader
     size_t readNextHBF(char* buff);
     size_t readNextTF(char* buff);
     size_t readNextSuperPage(char* buff, const PartStat* pstat = nullptr);
+    const char* mapNextSuperPage(size_t& size, const PartStat* pstat = nullptr);
     size_t skipNextHBF();
     size_t skipNextTF();
 
     bool rewindToTF(uint32_t tf);
+    void adviseTF(uint32_t tf) const;
     void print(bool verbose = false, const std::string& pref = "") const;
     std::string describe() const;
 
    private:
+    int getNextSuperPageEnd(size_t& sz, const PartStat* pstat) const;
+    const char* getMappedData(const LinkBlock& blc, size_t sz) const;
+
     RawFileReader* reader = nullptr; //!
   };
 
@@ -272,6 +300,21 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  void setScanChunkSize(size_t s) { mScanChunkSize = s < MinScanChunkSize ? MinScanChunkSize : s; }
+  size_t getScanChunkSize() const { return mScanChunkSize; }
+
+  void setUseIndexFiles(bool v) { mUseIndexFiles = v; }
+  bool getUseIndexFiles() const { return mUseIndexFiles; }
+  std::string getIndexFileName(int fileID) const;
+
+  bool getMapFiles() const { return mMapFiles; }
+  void setMapFiles(bool v) { mMapFiles = v; }
+  std::shared_ptr<const MappedFile> getMappedFile(int fileID) const { return fileID < int(mMappedFiles.size()) ? mMappedFiles[fileID] : nullptr; }
+  void adviseTF(uint32_t tf) const;
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -289,9 +332,46 @@ class RawFileReader
   static std::string nochk_opt(ErrTypes e);
   static std::string nochk_expl(ErrTypes e);
 
+  static constexpr std::string_view IndexFileEnding = ".rdhidx"; // RDHs index is stored in the file with the raw file name + this suffix
+  static constexpr size_t MinScanChunkSize = 0x1 << 16;          // smallest size of the file chunk to scan in a thread
+  static constexpr int NRDHsToSync = 4;                          // number of consistent RDHs to validate the scan start in the chunk
+
  private:
+  // result of following the RDHs chain
+  struct RDHScan {
+    enum Stop { None,      // reached the end of the range to scan
+                Synced,    // reached the RDH already found
+                EndOfFile, // reached the end of the file
+                Truncated, // RDH exceeds the file size
+                Corrupted  // RDH offsetToNext is too small
+    };
+    std::vector<RDHRecord> rdhs;
+    size_t next = 0; // position following the last RDH found
+    Stop stop = None;
+  };
+  // header of the RDHs index file
+  struct RDHIndexHeader {
+    static constexpr char Magic[8] = {'O', '2', 'R', 'D', 'H', 'I', 'D', 'X'};
+    static constexpr uint32_t Version = 1;
+    char magic[8] = {};
+    uint32_t version = Version;
+    uint64_t fileSize = 0; // size of the indexed raw file
+    int64_t fileMTime = 0; // modification time (in file clock ticks) of the indexed raw file
+    uint64_t nRDHs = 0;    // number of RDHRecords following the header
+  };
+
   int getLinkLocalID(const RDHAny& rdh, int fileID);
   bool preprocessFile(int ifl);
+  bool preprocessScannedFile(int ifl, const std::vector<RDHRecord>& rdhs);
+  bool processRDH(const RDHAny& rdh, LinkSpec_t& specPrev, int& lIDPrev);
+  void scanFiles(int fileMin, int fileMax, std::vector<std::vector<RDHRecord>>& rdhs, std::vector<bool>& scanned);
+  bool loadIndex(int fileID, std::vector<RDHRecord>& rdhs) const;
+  void writeIndex(int fileID, const std::vector<RDHRecord>& rdhs) const;
+  static size_t findRDHChain(const char* data, size_t size, size_t start, size_t end);
+  static void followRDHs(const char* data, size_t size, size_t pos, size_t end, RDHScan& scan, const std::vector<RDHRecord>* sync = nullptr);
+  std::shared_ptr<const MappedFile> mapFile(int fileID) const;
+  void mapFiles();
+  void adviseRange(int fileID, size_t offset, size_t size) const;
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -303,6 +383,7 @@ class RawFileReader
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  std::vector<std::shared_ptr<const MappedFile>> mMappedFiles;          //! input files mapped to memory (if requested)
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
   bool mInitDone = false;
   bool mEmpty = true;
@@ -320,6 +401,10 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMapFiles = false;                                           //! map input files to memory instead of reading them
+  bool mUseIndexFiles = false;                                      //! load RDHs from the index files (create them if absent)
+  int mNThreads = 1;                                                //! number of threads for the files scan
+  size_t mScanChunkSize = 0x1UL << 27;                              //! size of the file chunk to scan in a thread
   bool mStopProcessing = false;                                     //! stop processing after error
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
@@ -14,7 +14,9 @@
 /// @brief  Reader for (multiple) raw data files
 
 #include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <iomanip>
 #include <memory>
@@ -30,6 +32,9 @@
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace o2::raw;
 namespace o2h = o2::header;
@@ -43,6 +48,15 @@ void RawFileReader::LinkBlock::print(const std::string& pref) const
        testFlag(EndHB), ir.orbit, tfID);
 }
 
+//====================== methods of MappedFile ========================
+//____________________________________________
+RawFileReader::MappedFile::~MappedFile()
+{
+  if (data) {
+    munmap(const_cast<char*>(data), size);
+  }
+}
+
 //====================== methods of LinkData ========================
 
 //____________________________________________
@@ -133,6 +147,8 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
     ibl++;
     if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
+    } else if (auto ptr = getMappedData(blc, blc.size)) {
+      memcpy(buff + sz, ptr, blc.size);
     } else {
       auto fl = reader->mFiles[blc.fileID];
       if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
@@ -265,28 +281,13 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
     return sz;
   }
-  int ibl = nextBlock2Read, nbl = blocks.size();
-  auto tfID = blocks[nextBlock2Read].tfID;
+  int ibl = getNextSuperPageEnd(sz, pstat);
   bool error = false;
-  if (pstat) { // info is provided, use it derictly
-    sz = pstat->size;
-    ibl += pstat->nBlocks;
-  } else { // need to calculate blocks to read
-    while (ibl < nbl) {
-      auto& blc = blocks[ibl];
-      if (ibl > nextBlock2Read && (blc.tfID != blocks[nextBlock2Read].tfID ||
-                                   blc.testFlag(LinkBlock::StartSP) ||
-                                   (sz + blc.size) > reader->mNominalSPageSize ||
-                                   blocks[ibl - 1].offset + blocks[ibl - 1].size < blc.offset)) { // new superpage or TF
-        break;
-      }
-      ibl++;
-      sz += blc.size;
-    }
-  }
   if (sz) {
     if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
       memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
+    } else if (auto ptr = getMappedData(blocks[nextBlock2Read], sz)) {
+      memcpy(buff, ptr, sz);
     } else {
       auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
       if (fseek(fl, blocks[nextBlock2Read].offset, SEEK_SET) || fread(buff, 1, sz, fl) != sz) {
@@ -303,6 +304,84 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+const char* RawFileReader::LinkData::mapNextSuperPage(size_t& size, const RawFileReader::PartStat* pstat)
+{
+  // provide the data of the next superpage directly from the mapped file and move to the following one,
+  // the data stay valid as long as the reference to the corresponding MappedFile is kept.
+  // If the file is not mapped, nullptr is returned and the link is not advanced (the data can be read instead)
+  size = 0;
+  if (nextBlock2Read < 0 || nextBlock2Read >= int(blocks.size())) { // no data left
+    return nullptr;
+  }
+  size_t sz = 0;
+  int ibl = getNextSuperPageEnd(sz, pstat);
+  auto ptr = getMappedData(blocks[nextBlock2Read], sz);
+  if (ptr) {
+    size = sz;
+    nextBlock2Read = ibl;
+  }
+  return ptr;
+}
+
+//____________________________________________
+int RawFileReader::LinkData::getNextSuperPageEnd(size_t& sz, const RawFileReader::PartStat* pstat) const
+{
+  // get the size of the next superpage and the block following it
+  int ibl = nextBlock2Read, nbl = blocks.size();
+  sz = 0;
+  if (pstat) { // info is provided, use it derictly
+    sz = pstat->size;
+    return ibl + pstat->nBlocks;
+  }
+  while (ibl < nbl) { // need to calculate blocks to read
+    const auto& blc = blocks[ibl];
+    if (ibl > nextBlock2Read && (blc.tfID != blocks[nextBlock2Read].tfID ||
+                                 blc.testFlag(LinkBlock::StartSP) ||
+                                 (sz + blc.size) > reader->mNominalSPageSize ||
+                                 blocks[ibl - 1].offset + blocks[ibl - 1].size < blc.offset)) { // new superpage or TF
+      break;
+    }
+    ibl++;
+    sz += blc.size;
+  }
+  return ibl;
+}
+
+//____________________________________________
+const char* RawFileReader::LinkData::getMappedData(const LinkBlock& blc, size_t sz) const
+{
+  // pointer on the sz bytes of data starting from the block in the mapped file, nullptr if not mapped
+  if (blc.fileID >= reader->mMappedFiles.size() || !reader->mMappedFiles[blc.fileID]) {
+    return nullptr;
+  }
+  const auto& mf = *reader->mMappedFiles[blc.fileID];
+  if (blc.offset + sz > mf.size) {
+    LOGP(error, "Data of {} at offset {} of size {} exceed the size {} of mapped file {}", describe(), blc.offset, sz, mf.size, reader->mFileNames[blc.fileID]);
+    return nullptr;
+  }
+  return mf.data + blc.offset;
+}
+
+//____________________________________________
+void RawFileReader::LinkData::adviseTF(uint32_t tf) const
+{
+  // request the read-ahead of the data of the TF from the mapped files, contiguous blocks are requested at once
+  if (tf >= tfStartBlock.size()) {
+    return;
+  }
+  int ibl = tfStartBlock[tf].first, nbl = blocks.size();
+  const auto tfID = blocks[ibl].tfID;
+  while (ibl < nbl && blocks[ibl].tfID == tfID) {
+    const auto& blc0 = blocks[ibl];
+    size_t end = blc0.offset + blc0.size;
+    while (++ibl < nbl && blocks[ibl].tfID == tfID && blocks[ibl].fileID == blc0.fileID && blocks[ibl].offset == end) {
+      end += blocks[ibl].size;
+    }
+    reader->adviseRange(blc0.fileID, blc0.offset, end - blc0.offset);
+  }
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getLargestSuperPage() const
 {
@@ -596,40 +675,12 @@ bool RawFileReader::preprocessFile(int ifl)
         break;
       }
       nRDHread++;
-      LinkSpec_t spec = createSpec(std::get<0>(mDataSpecs[mCurrentFileID]), RDHUtils::getSubSpec(rdh));
-      int lID = lIDPrev;
-      if (spec != specPrev) { // link has changed
-        specPrev = spec;
-        if (lIDPrev != -1) {
-          mMultiLinkFile = true;
-        }
-        lID = getLinkLocalID(rdh, mCurrentFileID);
-      }
-      bool newSPage = lID != lIDPrev;
-      try {
-        mLinksData[lID].preprocessCRUPage(rdh, newSPage);
-      } catch (...) {
-        LOG(error) << "Corrupted data, abandoning processing";
-        mStopProcessing = true;
-        break;
-      }
-
-      if (mLinksData[lID].nTimeFrames && (mLinksData[lID].nTimeFrames - 1 > mMaxTFToRead)) { // limit reached, discard the last read
-        mLinksData[lID].nTimeFrames--;
-        mLinksData[lID].blocks.pop_back();
-        if (mLinksData[lID].nHBFrames > 0) {
-          mLinksData[lID].nHBFrames--;
-        }
-        if (mLinksData[lID].nCRUPages > 0) {
-          mLinksData[lID].nCRUPages--;
-        }
-        lIDPrev = -1; // last block is closed
+      if (!processRDH(rdh, specPrev, lIDPrev)) {
         readMore = false;
         break;
       }
       boffs += RDHUtils::getOffsetToNext(rdh);
       mPosInFile += RDHUtils::getOffsetToNext(rdh);
-      lIDPrev = lID;
       if (boffs + sizeof(RDHUtils::RDHAny) >= nr) {
         if (fseek(fl, mPosInFile, SEEK_SET)) {
           readMore = false;
@@ -644,6 +695,280 @@ bool RawFileReader::preprocessFile(int ifl)
   return nRDHread > 0;
 }
 
+//_____________________________________________________________________
+bool RawFileReader::preprocessScannedFile(int ifl, const std::vector<RDHRecord>& rdhs)
+{
+  // preprocess file using the RDHs found by the scan (or loaded from the index), check RDH data, build statistics
+  mCurrentFileID = ifl;
+  LinkSpec_t specPrev = 0xffffffffffffffff;
+  int lIDPrev = -1;
+  mMultiLinkFile = false;
+  mPosInFile = 0;
+  size_t nRDHread = 0;
+  for (const auto& rec : rdhs) {
+    mPosInFile = rec.offset;
+    nRDHread++;
+    if (!processRDH(rec.rdh, specPrev, lIDPrev)) {
+      break;
+    }
+    mPosInFile += RDHUtils::getOffsetToNext(rec.rdh);
+  }
+  LOGF(info, "File %3d : %9li bytes scanned, %6d RDH read for %4d links from %s",
+       mCurrentFileID, mPosInFile, nRDHread, int(mLinkEntries.size()), mFileNames[mCurrentFileID]);
+  return nRDHread > 0;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::processRDH(const RDHAny& rdh, LinkSpec_t& specPrev, int& lIDPrev)
+{
+  // account RDH located at mPosInFile of the current file, return false if the file processing must be stopped
+  LinkSpec_t spec = createSpec(std::get<0>(mDataSpecs[mCurrentFileID]), RDHUtils::getSubSpec(rdh));
+  int lID = lIDPrev;
+  if (spec != specPrev) { // link has changed
+    specPrev = spec;
+    if (lIDPrev != -1) {
+      mMultiLinkFile = true;
+    }
+    lID = getLinkLocalID(rdh, mCurrentFileID);
+  }
+  bool newSPage = lID != lIDPrev;
+  try {
+    mLinksData[lID].preprocessCRUPage(rdh, newSPage);
+  } catch (...) {
+    LOG(error) << "Corrupted data, abandoning processing";
+    mStopProcessing = true;
+    return false;
+  }
+
+  if (mLinksData[lID].nTimeFrames && (mLinksData[lID].nTimeFrames - 1 > mMaxTFToRead)) { // limit reached, discard the last read
+    mLinksData[lID].nTimeFrames--;
+    mLinksData[lID].blocks.pop_back();
+    if (mLinksData[lID].nHBFrames > 0) {
+      mLinksData[lID].nHBFrames--;
+    }
+    if (mLinksData[lID].nCRUPages > 0) {
+      mLinksData[lID].nCRUPages--;
+    }
+    lIDPrev = -1; // last block is closed
+    return false;
+  }
+  lIDPrev = lID;
+  return true;
+}
+
+//_____________________________________________________________________
+void RawFileReader::scanFiles(int fileMin, int fileMax, std::vector<std::vector<RDHRecord>>& rdhs, std::vector<bool>& scanned)
+{
+  // find RDHs of the files in the [fileMin:fileMax) range, loading them from the index files if possible.
+  // Files which cannot be mapped are left for the sequential preprocessing.
+  // The files are split to chunks scanned in parallel: the scan of every chunk but the 1st one starts from the 1st chain
+  // of consistent RDHs found in it, the chunks are stitched if the RDHs chain of the previous chunk leads to the start of
+  // the next one, otherwise the RDHs are followed sequentially until an RDH of the next chunk is met.
+  struct Chunk {
+    int fileID = 0;
+    size_t start = 0, end = 0;
+    RDHScan scan;
+  };
+  std::vector<std::shared_ptr<const MappedFile>> mapped(fileMax - fileMin);
+  std::vector<Chunk> chunks;
+  for (int ifl = fileMin; ifl < fileMax; ifl++) {
+    rdhs[ifl].clear();
+    scanned[ifl] = mUseIndexFiles && loadIndex(ifl, rdhs[ifl]);
+    if (scanned[ifl]) {
+      continue;
+    }
+    auto& mf = mapped[ifl - fileMin];
+    if (!(mf = getMappedFile(ifl)) && !(mf = mapFile(ifl))) {
+      continue;
+    }
+    for (size_t start = 0; start < mf->size; start += mScanChunkSize) {
+      auto& chunk = chunks.emplace_back();
+      chunk.fileID = ifl;
+      chunk.start = start;
+      chunk.end = std::min(start + mScanChunkSize, mf->size);
+    }
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ic = 0; ic < int(chunks.size()); ic++) {
+    auto& chunk = chunks[ic];
+    const auto& mf = *mapped[chunk.fileID - fileMin];
+    auto pos = chunk.start ? findRDHChain(mf.data, mf.size, chunk.start, chunk.end) : 0;
+    followRDHs(mf.data, mf.size, pos, chunk.end, chunk.scan);
+  }
+  // stitch the chunks
+  for (size_t ic = 0; ic < chunks.size();) {
+    int ifl = chunks[ic].fileID;
+    const auto& mf = *mapped[ifl - fileMin];
+    auto& res = rdhs[ifl];
+    RDHScan tail;
+    tail.next = 0;
+    for (; ic < chunks.size() && chunks[ic].fileID == ifl; ic++) {
+      auto& chunk = chunks[ic];
+      if (tail.stop != RDHScan::None) {
+        continue;
+      }
+      auto& cRDHs = chunk.scan.rdhs;
+      size_t first = 0;
+      if (cRDHs.empty() || cRDHs.front().offset != tail.next) { // no match, follow the RDHs until an RDH of this chunk is met
+        RDHScan gap;
+        followRDHs(mf.data, mf.size, tail.next, chunk.end, gap, &cRDHs);
+        res.insert(res.end(), gap.rdhs.begin(), gap.rdhs.end());
+        if (gap.stop != RDHScan::Synced) {
+          tail.next = gap.next;
+          tail.stop = gap.stop;
+          continue;
+        }
+        first = std::lower_bound(cRDHs.begin(), cRDHs.end(), gap.next, [](const RDHRecord& r, size_t offs) { return r.offset < offs; }) - cRDHs.begin();
+      }
+      res.insert(res.end(), cRDHs.begin() + first, cRDHs.end());
+      tail.next = chunk.scan.next;
+      tail.stop = chunk.scan.stop;
+      std::vector<RDHRecord>().swap(cRDHs); // release memory
+    }
+    if (tail.stop == RDHScan::Corrupted) {
+      LOGP(error, "File {} has RDH with offsetToNext < RDH size at pos {}, the following data are ignored", ifl, tail.next);
+    } else if (tail.stop == RDHScan::Truncated) {
+      LOGP(warning, "File {} truncated: RDH at pos {} exceeds fileSize {}", ifl, tail.next, mf.size);
+    }
+    scanned[ifl] = true;
+    if (mUseIndexFiles) {
+      writeIndex(ifl, res);
+    }
+  }
+}
+
+//_____________________________________________________________________
+size_t RawFileReader::findRDHChain(const char* data, size_t size, size_t start, size_t end)
+{
+  // find 1st position in the [start:end) range (with the step of GBT word) with the chain of valid RDHs (ending at the end of data
+  // or having NRDHsToSync RDHs), return end if not found
+  constexpr size_t Step = RDHUtils::GBTWord128;
+  for (size_t pos = (start + Step - 1) / Step * Step; pos < end; pos += Step) {
+    size_t posChain = pos;
+    int nValid = 0;
+    while (nValid < NRDHsToSync && posChain + sizeof(RDHAny) <= size) {
+      const void* rdh = data + posChain;
+      auto version = RDHUtils::getVersion(rdh);
+      if (version < 3 || version > 7 || !RDHUtils::checkRDH(rdh, false) || RDHUtils::getMemorySize(rdh) > RDHUtils::getOffsetToNext(rdh)) {
+        break;
+      }
+      nValid++;
+      posChain += RDHUtils::getOffsetToNext(rdh);
+    }
+    if (nValid == NRDHsToSync || (nValid && posChain == size)) {
+      return pos;
+    }
+  }
+  return end;
+}
+
+//_____________________________________________________________________
+void RawFileReader::followRDHs(const char* data, size_t size, size_t pos, size_t end, RDHScan& scan, const std::vector<RDHRecord>* sync)
+{
+  // follow the RDHs chain from pos until the 1st RDH at or after end, or until the RDH found in the (ordered) sync vector
+  scan.stop = RDHScan::None;
+  while (pos < end) {
+    if (sync) {
+      auto it = std::lower_bound(sync->begin(), sync->end(), pos, [](const RDHRecord& r, size_t offs) { return r.offset < offs; });
+      if (it != sync->end() && it->offset == pos) {
+        scan.stop = RDHScan::Synced;
+        break;
+      }
+    }
+    if (pos + sizeof(RDHAny) > size) { // remaining data cannot hold an RDH
+      scan.stop = RDHScan::Truncated;
+      break;
+    }
+    const auto& rdh = *reinterpret_cast<const RDHAny*>(data + pos);
+    auto offs = RDHUtils::getOffsetToNext(rdh);
+    if (offs < sizeof(RDHAny)) {
+      scan.stop = RDHScan::Corrupted;
+      break;
+    }
+    if (pos + offs > size) {
+      scan.stop = RDHScan::Truncated;
+      break;
+    }
+    scan.rdhs.push_back(RDHRecord{pos, rdh});
+    pos += offs;
+  }
+  if (pos >= size && scan.stop == RDHScan::None) {
+    scan.stop = RDHScan::EndOfFile;
+  }
+  scan.next = pos;
+}
+
+//_____________________________________________________________________
+std::string RawFileReader::getIndexFileName(int fileID) const
+{
+  return mFileNames[fileID] + std::string(IndexFileEnding);
+}
+
+//_____________________________________________________________________
+bool RawFileReader::loadIndex(int fileID, std::vector<RDHRecord>& rdhs) const
+{
+  // load RDHs of the file from its index file, provided it corresponds to the current version of the file
+  std::error_code ec;
+  auto fileSize = std::filesystem::file_size(mFileNames[fileID], ec);
+  auto fileMTime = std::filesystem::last_write_time(mFileNames[fileID], ec).time_since_epoch().count();
+  if (ec) {
+    return false;
+  }
+  auto fname = getIndexFileName(fileID);
+  std::unique_ptr<FILE, decltype(&fclose)> fl(fopen(fname.c_str(), "rb"), &fclose);
+  if (!fl) {
+    return false;
+  }
+  RDHIndexHeader hd;
+  if (fread(&hd, sizeof(hd), 1, fl.get()) != 1 || std::memcmp(hd.magic, RDHIndexHeader::Magic, sizeof(hd.magic)) || hd.version != RDHIndexHeader::Version) {
+    LOGP(warning, "Ignoring index file {} of unknown format", fname);
+    return false;
+  }
+  if (hd.fileSize != fileSize || hd.fileMTime != int64_t(fileMTime)) {
+    LOGP(warning, "Ignoring outdated index file {}", fname);
+    return false;
+  }
+  rdhs.resize(hd.nRDHs);
+  if (fread(rdhs.data(), sizeof(RDHRecord), hd.nRDHs, fl.get()) != hd.nRDHs) {
+    LOGP(warning, "Failed to read {} RDHs from index file {}", hd.nRDHs, fname);
+    rdhs.clear();
+    return false;
+  }
+  LOGP(info, "Loaded {} RDHs of {} from index file {}", hd.nRDHs, mFileNames[fileID], fname);
+  return true;
+}
+
+//_____________________________________________________________________
+void RawFileReader::writeIndex(int fileID, const std::vector<RDHRecord>& rdhs) const
+{
+  // write RDHs of the file to its index file
+  std::error_code ec;
+  RDHIndexHeader hd;
+  std::memcpy(hd.magic, RDHIndexHeader::Magic, sizeof(hd.magic));
+  hd.fileSize = std::filesystem::file_size(mFileNames[fileID], ec);
+  hd.fileMTime = std::filesystem::last_write_time(mFileNames[fileID], ec).time_since_epoch().count();
+  if (ec) {
+    return;
+  }
+  hd.nRDHs = rdhs.size();
+  auto fname = getIndexFileName(fileID), fnameTmp = fname + ".part";
+  FILE* fl = fopen(fnameTmp.c_str(), "wb");
+  if (!fl) {
+    LOGP(warning, "Failed to create index file {}: {}", fnameTmp, strerror(errno));
+    return;
+  }
+  bool ok = fwrite(&hd, sizeof(hd), 1, fl) == 1 && fwrite(rdhs.data(), sizeof(RDHRecord), rdhs.size(), fl) == rdhs.size();
+  ok = (fclose(fl) == 0) && ok;
+  if (!ok || std::rename(fnameTmp.c_str(), fname.c_str())) {
+    LOGP(warning, "Failed to write index file {}", fname);
+    std::remove(fnameTmp.c_str());
+    return;
+  }
+  LOGP(info, "Stored {} RDHs of {} to index file {}", rdhs.size(), mFileNames[fileID], fname);
+}
+
 //_____________________________________________________________________
 void RawFileReader::printStat(bool verbose) const
 {
@@ -667,6 +992,7 @@ void RawFileReader::clear()
   }
   mFiles.clear();
   mFileNames.clear();
+  mMappedFiles.clear(); // the mappings are released once the data sent from them are consumed
 
   mCurrentFileID = 0;
   mMultiLinkFile = false;
@@ -724,11 +1050,35 @@ bool RawFileReader::init()
 
   int nf = mFiles.size();
   mEmpty = true;
-  for (int i = 0; i < nf; i++) {
-    if (preprocessFile(i)) {
-      mEmpty = false;
+  if (mMapFiles) {
+    mapFiles();
+  }
+  TStopwatch sw;
+  if (mNThreads > 1 || mUseIndexFiles) { // find RDHs in parallel or from the index, the files are scanned in batches to limit the memory
+    std::vector<std::vector<RDHRecord>> rdhs(nf);
+    std::vector<bool> scanned(nf);
+    for (int ifl = 0, ifl1 = 0; ifl < nf && !mStopProcessing; ifl = ifl1) {
+      for (size_t batchSize = 0; ifl1 < nf && (ifl1 == ifl || batchSize < mNThreads * mScanChunkSize); ifl1++) {
+        struct stat st;
+        batchSize += fstat(fileno(mFiles[ifl1]), &st) ? 0 : st.st_size;
+      }
+      scanFiles(ifl, ifl1, rdhs, scanned);
+      for (int i = ifl; i < ifl1 && !mStopProcessing; i++) {
+        if (scanned[i] ? preprocessScannedFile(i, rdhs[i]) : preprocessFile(i)) {
+          mEmpty = false;
+        }
+        std::vector<RDHRecord>().swap(rdhs[i]);
+      }
+    }
+  } else {
+    for (int i = 0; i < nf; i++) {
+      if (preprocessFile(i)) {
+        mEmpty = false;
+      }
     }
   }
+  sw.Stop();
+  LOGP(info, "Preprocessed {} files with {} threads{} in {:.3f} s (CPU {:.3f} s)", nf, mNThreads, mUseIndexFiles ? " using index files" : "", sw.RealTime(), sw.CpuTime());
   if (mStopProcessing) {
     LOG(error) << "Abandoning processing due to corrupted data";
     return false;
@@ -788,6 +1138,66 @@ bool RawFileReader::init()
   return !mEmpty;
 }
 
+//_____________________________________________________________________
+void RawFileReader::mapFiles()
+{
+  // map input files to memory, those which cannot be mapped will be read
+  mMappedFiles.clear();
+  mMappedFiles.resize(mFiles.size());
+  size_t totSize = 0;
+  for (int i = 0; i < int(mFiles.size()); i++) {
+    if ((mMappedFiles[i] = mapFile(i))) {
+      totSize += mMappedFiles[i]->size;
+    }
+  }
+  LOGP(info, "Mapped {} bytes of {} input files", totSize, mFiles.size());
+}
+
+//_____________________________________________________________________
+std::shared_ptr<const RawFileReader::MappedFile> RawFileReader::mapFile(int fileID) const
+{
+  // map input file to memory, nullptr is returned in case of failure
+  struct stat st;
+  int fd = fileno(mFiles[fileID]);
+  if (fstat(fd, &st) || st.st_size <= 0) {
+    LOGP(warning, "Failed to get the size of file {}, it will be read", mFileNames[fileID]);
+    return nullptr;
+  }
+  void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    LOGP(warning, "Failed to map file {} ({}), it will be read", mFileNames[fileID], strerror(errno));
+    return nullptr;
+  }
+  return std::make_shared<const MappedFile>(static_cast<const char*>(ptr), size_t(st.st_size));
+}
+
+//_____________________________________________________________________
+void RawFileReader::adviseRange(int fileID, size_t offset, size_t size) const
+{
+  // request the read-ahead of the range of mapped file
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  if (fileID >= int(mMappedFiles.size()) || !mMappedFiles[fileID]) {
+    return;
+  }
+  const auto& mf = *mMappedFiles[fileID];
+  size_t beg = offset & ~(pageSize - 1), end = std::min(offset + size, mf.size);
+  if (beg < end && madvise(const_cast<char*>(mf.data) + beg, end - beg, MADV_WILLNEED)) {
+    LOGP(debug, "madvise failed for {} bytes at {} of file {}", end - beg, beg, mFileNames[fileID]);
+  }
+}
+
+//_____________________________________________________________________
+void RawFileReader::adviseTF(uint32_t tf) const
+{
+  // request the read-ahead of the TF data of all links from the mapped files
+  if (mMappedFiles.empty()) {
+    return;
+  }
+  for (const auto& link : mLinksData) {
+    link.adviseTF(tf);
+  }
+}
+
 //_____________________________________________________________________
 o2h::DataOrigin RawFileReader::getDataOrigin(const std::string& ors)
 {
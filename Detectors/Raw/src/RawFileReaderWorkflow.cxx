@@ -48,6 +48,7 @@
 #include <regex>
 #include <chrono>
 #include <thread>
+#include <memory>
 
 using namespace o2::raw;
 using DetID = o2::detectors::DetID;
@@ -86,6 +87,9 @@ class RawReaderSpecs : public o2f::Task
   size_t mLoopsDone = 0;
   size_t mSentSize = 0;
   size_t mSentMessages = 0;
+  size_t mMappedMessages = 0;
+  uint32_t mNextTFToAdvise = 0;                                    // next TF to request the read-ahead for
+  int mReadAheadTFs = 0;                                           // number of TFs to read ahead from the mapped files
   bool mPartPerSP = true;                                          // fill part per superpage
   bool mSup0xccdb = false;                                         // suppress explicit FLP/DISTSUBTIMEFRAME/0xccdb output
   std::string mRawChannelName = "";                                // name of optional non-DPL channel
@@ -96,16 +100,22 @@ class RawReaderSpecs : public o2f::Task
 
 //___________________________________________________________
 RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
-  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize, rinp.onlyDet)), mRawChannelName(rinp.rawChannelConfig), mPreferCalcTF(rinp.preferCalcTF), mMinSHM(rinp.minSHM)
+  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize, rinp.onlyDet)), mRawChannelName(rinp.rawChannelConfig), mPreferCalcTF(rinp.preferCalcTF), mMinSHM(rinp.minSHM), mReadAheadTFs(rinp.readAheadTFs)
 {
   mReader->setCheckErrors(rinp.errMap);
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMapFiles(rinp.mapFiles);
+  mReader->setNThreads(rinp.scanThreads);
+  mReader->setUseIndexFiles(rinp.useIndexFiles);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
   LOG(info) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
   LOG(info) << "Number of loops over whole data requested: " << mLoop;
+  if (rinp.mapFiles) {
+    LOGP(info, "Input files will be mapped to memory, {}, read-ahead of {} TFs", mPartPerSP ? "superpages sent w/o intermediate copy" : "HBFs copied from the mapping", mReadAheadTFs);
+  }
   mTimer.Stop();
   mTimer.Reset();
   processDropTF(rinp.dropTF);
@@ -221,6 +231,12 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
   }
   mReader->setNextTFToRead(tfID);
   std::vector<RawFileReader::PartStat> partsSP;
+  if (mReader->getMapFiles()) { // request the read-ahead of the TFs to come
+    mNextTFToAdvise = std::max(mNextTFToAdvise, tfID);
+    while (mNextTFToAdvise <= std::min(tfID + mReadAheadTFs, mMaxTFID)) {
+      mReader->adviseTF(mNextTFToAdvise++);
+    }
+  }
 
   static o2f::RateLimiter limiter;
   limiter.check(ctx, mTFRateLimit, mMinSHM);
@@ -266,8 +282,21 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
       hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
       auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      fair::mq::MessagePtr plMessage;
+      size_t bread = 0;
+      if (mPartPerSP && mReader->getMapFiles() && link.nextBlock2Read >= 0 && link.nextBlock2Read < int(link.blocks.size())) { // send the superpage directly from the mapped file, the message keeps the mapping alive
+        auto mappedFile = mReader->getMappedFile(link.blocks[link.nextBlock2Read].fileID);
+        if (auto data = link.mapNextSuperPage(bread, &partsSP[hdrTmpl.splitPayloadIndex])) {
+          plMessage = fmqFactory->CreateMessage(
+            const_cast<char*>(data), bread, [](void*, void* hint) { delete static_cast<std::shared_ptr<const RawFileReader::MappedFile>*>(hint); },
+            new std::shared_ptr<const RawFileReader::MappedFile>(std::move(mappedFile)));
+          mMappedMessages++;
+        }
+      }
+      if (!plMessage) {
+        plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+        bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      }
       if (bread != hdrTmpl.payloadSize) {
         LOG(error) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
                    << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
@@ -342,6 +371,7 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     if (!mReader->isProcessingStopped() && !mReader->isEmpty() && --mLoop) {
       mLoopsDone++;
       mReader->setNextTFToRead(tfID = 0);
+      mNextTFToAdvise = 0;
       LOG(info) << "Shall start new loop " << mLoopsDone << " from the beginning of data";
     } else {
       if (!mRawChannelName.empty()) { // send endOfStream message to raw channel
@@ -362,7 +392,7 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
       }
       ctx.services().get<o2f::ControlService>().readyToQuit(o2f::QuitRequest::Me);
       mTimer.Stop();
-      LOGP(info, "Finished: payload of {} bytes in {} messages sent for {} TFs, total timing: Real:{:3f}/CPU:{:3f}", mSentSize, mSentMessages, mTFCounter, mTimer.RealTime(), mTimer.CpuTime());
+      LOGP(info, "Finished: payload of {} bytes in {} messages ({} from mapped files) sent for {} TFs, total timing: Real:{:3f}/CPU:{:3f}", mSentSize, mSentMessages, mMappedMessages, mTFCounter, mTimer.RealTime(), mTimer.CpuTime());
     }
   }
 }
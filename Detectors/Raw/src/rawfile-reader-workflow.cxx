@@ -38,6 +38,10 @@ void customize(std::vector<o2::framework::ConfigParamSpec>& workflowOptions)
   options.push_back(ConfigParamSpec{"part-per-sp", VariantType::Bool, false, {"FMQ parts per superpage instead of per HBF"}});
   options.push_back(ConfigParamSpec{"raw-channel-config", VariantType::String, "", {"optional raw FMQ channel for non-DPL output"}});
   options.push_back(ConfigParamSpec{"cache-data", VariantType::Bool, false, {"cache data at 1st reading, may require excessive memory!!!"}});
+  options.push_back(ConfigParamSpec{"map-files", VariantType::Bool, false, {"map input files to memory, with part-per-sp the superpages are sent w/o copying"}});
+  options.push_back(ConfigParamSpec{"read-ahead-tfs", VariantType::Int, 2, {"number of TFs to request the read-ahead for (with map-files)"}});
+  options.push_back(ConfigParamSpec{"scan-threads", VariantType::Int, 1, {"number of threads for the input files scan"}});
+  options.push_back(ConfigParamSpec{"rdh-index", VariantType::Bool, false, {"use RDH index files <file>.rdhidx for the files scan, create them if absent"}});
   options.push_back(ConfigParamSpec{"detect-tf0", VariantType::Bool, false, {"autodetect HBFUtils start Orbit/BC from 1st TF seen"}});
   options.push_back(ConfigParamSpec{"calculate-tf-start", VariantType::Bool, false, {"calculate TF start instead of using TType"}});
   options.push_back(ConfigParamSpec{"drop-tf", VariantType::String, "none", {"Drop each TFid%(1)==(2) of detector, e.g. ITS,2,4;TPC,4[,0];..."}});
@@ -72,6 +76,10 @@ WorkflowSpec defineDataProcessing(ConfigContext const& configcontext)
   rinp.spSize = uint64_t(configcontext.options().get<int64_t>("super-page-size"));
   rinp.partPerSP = configcontext.options().get<bool>("part-per-sp");
   rinp.cache = configcontext.options().get<bool>("cache-data");
+  rinp.mapFiles = configcontext.options().get<bool>("map-files");
+  rinp.readAheadTFs = configcontext.options().get<int>("read-ahead-tfs");
+  rinp.scanThreads = configcontext.options().get<int>("scan-threads");
+  rinp.useIndexFiles = configcontext.options().get<bool>("rdh-index");
   rinp.autodetectTF0 = configcontext.options().get<bool>("detect-tf0");
   rinp.preferCalcTF = configcontext.options().get<bool>("calculate-tf-start");
   rinp.rawChannelConfig = configcontext.options().get<std::string>("raw-channel-config");
@@ -41,6 +41,8 @@ int main(int argc, char* argv[])
   desc_add_option("spsize,s", bpo::value<int>()->default_value(reader.getNominalSPageSize()), "nominal super-page size in bytes");
   desc_add_option("buffer-size,b", bpo::value<size_t>()->default_value(reader.getNominalSPageSize()), "buffer size for files preprocessing");
   desc_add_option("detect-tf0", "autodetect HBFUtils start Orbit/BC from 1st TF seen");
+  desc_add_option("threads,t", bpo::value<int>()->default_value(reader.getNThreads()), "number of threads for the files scan");
+  desc_add_option("rdh-index", "use RDH index files <file>.rdhidx, create them if absent");
   desc_add_option("calculate-tf-start", "calculate TF start instead of using TType");
   desc_add_option("rorc", "impose RORC as default detector mode");
   desc_add_option("configKeyValues", bpo::value(&configKeyValues)->default_value(""), "semicolon separated key=value strings");
@@ -93,6 +95,8 @@ int main(int argc, char* argv[])
   reader.setNominalSPageSize(vm["spsize"].as<int>());
   reader.setMaxTFToRead(vm["max-tf"].as<uint32_t>());
   reader.setBufferSize(vm["buffer-size"].as<size_t>());
+  reader.setNThreads(vm["threads"].as<int>());
+  reader.setUseIndexFiles(vm.count("rdh-index"));
   reader.setPreferCalculatedTFStart(vm.count("calculate-tf-start"));
   reader.setDefaultReadoutCardType(rocard);
   reader.setTFAutodetect(vm.count("detect-tf0") ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
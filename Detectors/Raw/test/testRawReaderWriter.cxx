@@ -13,7 +13,9 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <algorithm>
+#include <cstring>
 #include <string>
+#include <tuple>
 #include <iostream>
 #include <fstream>
 #include <TRandom.h>
@@ -189,9 +191,10 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
 
   std::unique_ptr<RawFileReader> reader;
   std::string confName;
+  bool mapFiles = false;
 
   //_________________________________________________________________
-  TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg") : confName(cfg) {}
+  TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg", bool map = false) : confName(cfg), mapFiles(map) {}
 
   //_________________________________________________________________
   void init()
@@ -200,6 +203,7 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
     uint32_t errCheck = 0xffffffff;
     errCheck ^= 0x1 << RawFileReader::ErrNoSuperPageForTF; // makes no sense for superpages not interleaved by others
     reader->setCheckErrors(errCheck);
+    reader->setMapFiles(mapFiles);
     reader->init();
   }
 
@@ -329,4 +333,73 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
   dr.run(); // read back and check
 }
 
+BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU_ParallelScan)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT.cfg"}; // this is a CRU detector with origin TST
+  dw.init();
+  dw.run(); // write output
+  //
+  // the parallel scan of small chunks and the scan using the index files must provide the same blocks as the sequential scan
+  auto getBlocks = [](int nThreads, bool useIndex) {
+    RawFileReader reader("test_raw_conf_GBT.cfg");
+    reader.setCheckErrors(0);
+    reader.setNThreads(nThreads);
+    reader.setScanChunkSize(RawFileReader::MinScanChunkSize);
+    reader.setUseIndexFiles(useIndex);
+    reader.init();
+    std::vector<std::tuple<int, size_t, uint32_t, uint32_t, uint16_t, uint8_t>> blocks;
+    for (int il = 0; il < reader.getNLinks(); il++) {
+      for (const auto& bl : reader.getLink(il).blocks) {
+        blocks.emplace_back(il, bl.offset, bl.size, bl.tfID, bl.fileID, bl.flags);
+      }
+    }
+    return blocks;
+  };
+  const auto blocksRef = getBlocks(1, false);
+  BOOST_CHECK(!blocksRef.empty());
+  BOOST_CHECK(getBlocks(4, false) == blocksRef);
+  BOOST_CHECK(getBlocks(4, true) == blocksRef); // creates the index files
+  BOOST_CHECK(getBlocks(1, true) == blocksRef); // loads the index files
+}
+
+BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU_Mapped)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT.cfg"}; // this is a CRU detector with origin TST
+  dw.init();
+  dw.run(); // write output
+  //
+  TestRawReader dr{"TST", "test_raw_conf_GBT.cfg", true}; // read back from the files mapped to memory
+  dr.init();
+  dr.run(); // read back and check
+  //
+  // superpages provided directly from the mapped files must be identical to those read from the files
+  TestRawReader drRead{"TST", "test_raw_conf_GBT.cfg"}, drMap{"TST", "test_raw_conf_GBT.cfg", true};
+  drRead.init();
+  drMap.init();
+  std::vector<RawFileReader::PartStat> parts;
+  std::vector<char> buff;
+  int nSPages = 0;
+  for (uint32_t tf = 0; tf < drRead.reader->getNTimeFrames(); tf++) {
+    for (int il = 0; il < drRead.reader->getNLinks(); il++) {
+      auto& lnkRead = drRead.reader->getLink(il);
+      auto& lnkMap = drMap.reader->getLink(il);
+      if (!lnkRead.rewindToTF(tf) || !lnkMap.rewindToTF(tf)) {
+        continue;
+      }
+      lnkRead.getNextTFSuperPagesStat(parts);
+      for (const auto& part : parts) {
+        size_t sz = 0;
+        buff.resize(part.size);
+        BOOST_CHECK(lnkRead.readNextSuperPage(buff.data(), &part) == size_t(part.size));
+        auto data = lnkMap.mapNextSuperPage(sz, &part);
+        BOOST_REQUIRE(data != nullptr);
+        BOOST_CHECK(sz == size_t(part.size));
+        BOOST_CHECK(std::memcmp(data, buff.data(), sz) == 0);
+        nSPages++;
+      }
+    }
+  }
+  BOOST_CHECK(nSPages > 0);
+}
+
 } // namespace o2
@@ -23,6 +23,7 @@
 #include <array>
 #include <bitset>
 #include <string>
+#include <functional>
 
 #include "DataFormatsTPC/Defs.h"
 #include "SpacePoints/SpacePointsCalibParam.h"
@@ -162,6 +163,22 @@ class TrackResiduals
   /// \param iSec Sector to process
   void processSectorResiduals(Int_t iSec);
 
+  /// Processes given residuals for one sector without dumping the results.
+  /// Only the data of this sector is modified, so different sectors can be processed concurrently
+  /// provided their results containers were initialized beforehand.
+  /// \param iSec Sector to process
+  /// \param residuals Binned residuals of this sector
+  /// \return false if all X-bins of the sector were disabled and no smoothing was done
+  bool processSectorResiduals(int iSec, const std::vector<LocalResid>& residuals);
+
+  /// Processes the residuals of all sectors in parallel and dumps the results in the order of sectors.
+  /// The residuals of each sector are provided by fillSector(iSec, residuals) which is never called concurrently,
+  /// so it may do non thread-safe I/O. Only the residuals of at most nThreads sectors are kept in memory at a time.
+  /// The results do not depend on the number of threads.
+  /// \param fillSector Function filling the residuals (and the voxel statistics) of given sector
+  /// \param nThreads Number of threads to use
+  void processResiduals(const std::function<void(int iSec, std::vector<LocalResid>& residuals)>& fillSector, int nThreads = 1);
+
   /// Performs the robust linear fit for one voxel to estimate the distortions in X, Y and Z and their errors.
   /// \param dy Vector with residuals in y
   /// \param dz Vector with residuals in z
@@ -493,7 +510,6 @@ class TrackResiduals
   std::array<int, VoxDim> mStepKern{};                             ///< N bins to consider with given kernel settings
   std::array<float, VoxDim> mKernelScaleEdge{};                    ///< optional scaling factors for kernel width on the edge
   std::array<float, VoxDim> mKernelWInv{};                         ///< inverse kernel width in bins
-  std::array<double, ResDim * sMaxSmtDim> mLastSmoothingRes{};     ///< results of last smoothing operation
   // calibrated parameters
   float mEffVdriftCorr{0.f}; ///< global correction factor for vDrift based on d(delta(z))/dz fit
   float mEffT0Corr{0.f};     ///< global correction for T0 shift from offset of d(delta(z))/dz fit
@@ -504,7 +520,7 @@ class TrackResiduals
   VoxRes mVoxelResultsOut{};                                                                ///< the results from mVoxelResults are copied in here to be able to stream them
   VoxRes* mVoxelResultsOutPtr{&mVoxelResultsOut};                                           ///< pointer to set the branch address to for the output
 
-  ClassDefNV(TrackResiduals, 3);
+  ClassDefNV(TrackResiduals, 4);
 };
 
 //_____________________________________________________
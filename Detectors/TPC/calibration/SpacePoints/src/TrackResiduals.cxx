@@ -362,12 +362,51 @@ void TrackResiduals::fillStats(int iSec)
 //______________________________________________________________________________
 void TrackResiduals::processSectorResiduals(int iSec)
 {
-  LOGP(info, "Processing {} voxel residuals for sector {}", mLocalResidualsIn.size(), iSec);
+  if (processSectorResiduals(iSec, mLocalResidualsIn)) {
+    dumpResults(iSec);
+  }
+}
+
+//______________________________________________________________________________
+void TrackResiduals::processResiduals(const std::function<void(int iSec, std::vector<LocalResid>& residuals)>& fillSector, int nThreads)
+{
+  const int nSectors = SECTORSPERSIDE * SIDES;
+  // the flags of all sectors are kept in the same bitset, so it must not be modified by the concurrent threads
+  for (int iSec = 0; iSec < nSectors; ++iSec) {
+    initResultsContainer(iSec);
+  }
+  std::array<bool, SECTORSPERSIDE * SIDES> sectorDone{};
+  TStopwatch sw;
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int iSec = 0; iSec < nSectors; ++iSec) {
+    std::vector<LocalResid> residuals;
+#ifdef WITH_OPENMP
+#pragma omp critical(TrackResidualsFillSector)
+#endif
+    fillSector(iSec, residuals);
+    sectorDone[iSec] = processSectorResiduals(iSec, residuals);
+  }
+  sw.Stop();
+  LOGP(info, "Processed residuals of {} sectors using {} threads in {:.2f} s", nSectors, nThreads, sw.RealTime());
+  for (int iSec = 0; iSec < nSectors; ++iSec) {
+    if (sectorDone[iSec]) {
+      dumpResults(iSec);
+    }
+  }
+}
+
+//______________________________________________________________________________
+bool TrackResiduals::processSectorResiduals(int iSec, const std::vector<LocalResid>& residuals)
+{
+  LOGP(info, "Processing {} voxel residuals for sector {}", residuals.size(), iSec);
   initResultsContainer(iSec);
   // effective t0 correction changes sign between A-/C-side
   float effT0corr = (iSec < SECTORSPERSIDE) ? mEffT0Corr : -1. * mEffT0Corr;
   std::vector<size_t> binData;
-  for (const auto& res : mLocalResidualsIn) {
+  binData.reserve(residuals.size());
+  for (const auto& res : residuals) {
     binData.push_back(getGlbVoxBin(res.bvox));
   }
   // sort in voxel increasing order
@@ -401,11 +440,11 @@ void TrackResiduals::processSectorResiduals(int iSec)
       dzVec.clear();
       tgVec.clear();
     }
-    dyVec.push_back(mLocalResidualsIn[idx].dy * param::MaxResid / 0x7fff);
-    dzVec.push_back(mLocalResidualsIn[idx].dz * param::MaxResid / 0x7fff -
+    dyVec.push_back(residuals[idx].dy * param::MaxResid / 0x7fff);
+    dzVec.push_back(residuals[idx].dz * param::MaxResid / 0x7fff -
                     mEffVdriftCorr * secData[currVoxBin].stat[VoxZ] * secData[currVoxBin].stat[VoxX] -
                     effT0corr);
-    tgVec.push_back(mLocalResidualsIn[idx].tgSlp * param::MaxTgSlp / 0x7fff);
+    tgVec.push_back(residuals[idx].tgSlp * param::MaxTgSlp / 0x7fff);
 
     ++nPointsInVox;
     ++nProcessed;
@@ -421,7 +460,7 @@ void TrackResiduals::processSectorResiduals(int iSec)
   LOG(info) << "number of validated X rows: " << nRowsOK;
   if (!nRowsOK) {
     LOG(warning) << "sector " << iSec << ": all X-bins disabled, abandon smoothing";
-    return;
+    return false;
   } else {
     smooth(iSec);
   }
@@ -446,8 +485,8 @@ void TrackResiduals::processSectorResiduals(int iSec)
       dyVec.clear();
       tgVec.clear();
     }
-    dyVec.push_back(mLocalResidualsIn[idx].dy * param::MaxResid / 0x7fff);
-    tgVec.push_back(mLocalResidualsIn[idx].tgSlp * param::MaxTgSlp / 0x7fff);
+    dyVec.push_back(residuals[idx].dy * param::MaxResid / 0x7fff);
+    tgVec.push_back(residuals[idx].tgSlp * param::MaxTgSlp / 0x7fff);
     ++nPointsInVox;
     ++nProcessed;
   }
@@ -472,7 +511,7 @@ void TrackResiduals::processSectorResiduals(int iSec)
     }
   }
   LOG(info) << "Done processing residuals for sector " << iSec;
-  dumpResults(iSec);
+  return true;
 }
 
 //______________________________________________________________________________
@@ -770,9 +809,10 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
   maxTrials[VoxX] = mParams->maxBadXBinsToCover * 2;
 
   std::array<int, VoxDim> trial{0};
+  std::array<double, ResDim * sMaxSmtDim> smoothingRes; // results of the smoothing, local to be thread-safe
 
   while (true) {
-    std::fill(mLastSmoothingRes.begin(), mLastSmoothingRes.end(), 0);
+    std::fill(smoothingRes.begin(), smoothingRes.end(), 0);
     memset(&cmat[0][0], 0, sizeof(cmat));
 
     int nbOK = 0; // accounted neighbours
@@ -958,7 +998,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
           wi /= (voxNb->E[iDim] * voxNb->E[iDim]);
         }
         std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>& cmatD = cmat[iDim];
-        double* rhsD = &mLastSmoothingRes[iDim * sMaxSmtDim];
+        double* rhsD = &smoothingRes[iDim * sMaxSmtDim];
         unsigned short iMat = 0;
         unsigned short iRhs = 0;
         // linear part
@@ -1024,7 +1064,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
       }
       matrix.Zero(); // reset matrix
       std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>& cmatD = cmat[iDim];
-      double* rhsD = &mLastSmoothingRes[iDim * sMaxSmtDim];
+      double* rhsD = &smoothingRes[iDim * sMaxSmtDim];
       short iMat = -1;
       short row = -1;
 
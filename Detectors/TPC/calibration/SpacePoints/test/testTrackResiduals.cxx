@@ -19,6 +19,7 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include "SpacePoints/TrackResiduals.h"
+#include <random>
 
 namespace o2::tpc
 {
@@ -58,4 +59,54 @@ BOOST_AUTO_TEST_CASE(TrackResidualsBinning_test)
   }
 }
 
+// the voxel results must not depend on the number of threads used to process the sectors
+BOOST_AUTO_TEST_CASE(TrackResidualsParallel_test)
+{
+  auto fillSector = [](TrackResiduals& resid, int iSec, std::vector<TrackResiduals::LocalResid>& residuals) {
+    std::mt19937 gen(iSec);
+    std::normal_distribution<float> gaus(0.f, 300.f);      // ~1.8 mm in units of param::MaxResid / 0x7fff
+    std::uniform_int_distribution<int> tgs(-10000, 10000); // ~0.3 in units of param::MaxTgSlp / 0x7fff
+    std::vector<TrackResiduals::VoxStats> stats(resid.getNVoxelsPerSector());
+    for (int ix = 0; ix < resid.getNXBins(); ++ix) {
+      for (int ip = 0; ip < resid.getNY2XBins(); ++ip) {
+        for (int iz = 0; iz < resid.getNZ2XBins(); ++iz) {
+          auto& stat = stats[resid.getGlbVoxBin(ix, ip, iz)];
+          resid.getVoxelCoordinates(iSec, ix, ip, iz, stat.meanPos[TrackResiduals::VoxX], stat.meanPos[TrackResiduals::VoxF], stat.meanPos[TrackResiduals::VoxZ]);
+          stat.nEntries = 30;
+          for (int i = 0; i < 30; ++i) {
+            float offs = 100.f * (ix % 3) + 50.f * ip - 20.f * iz;
+            residuals.emplace_back(short(offs + gaus(gen)), short(offs + gaus(gen)), short(tgs(gen)), std::array<unsigned char, TrackResiduals::VoxDim>{(unsigned char)iz, (unsigned char)ip, (unsigned char)ix});
+          }
+        }
+      }
+    }
+    resid.setStats(stats, iSec);
+  };
+
+  TrackResiduals resid1, residN;
+  for (auto* resid : {&resid1, &residN}) {
+    resid->setNXBins(20);
+    resid->setNY2XBins(6);
+    resid->setNZ2XBins(4);
+    resid->init();
+  }
+  resid1.processResiduals([&](int iSec, std::vector<TrackResiduals::LocalResid>& residuals) { fillSector(resid1, iSec, residuals); }, 1);
+  residN.processResiduals([&](int iSec, std::vector<TrackResiduals::LocalResid>& residuals) { fillSector(residN, iSec, residuals); }, 4);
+
+  int nSmoothed = 0, nDiff = 0;
+  for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
+    const auto& res1 = resid1.getVoxelResults()[iSec];
+    const auto& resN = residN.getVoxelResults()[iSec];
+    BOOST_REQUIRE_EQUAL(res1.size(), resN.size());
+    for (size_t iVox = 0; iVox < res1.size(); ++iVox) {
+      nSmoothed += (res1[iVox].flags & TrackResiduals::SmoothDone) != 0;
+      if (res1[iVox].flags != resN[iVox].flags || res1[iVox].D != resN[iVox].D || res1[iVox].E != resN[iVox].E || res1[iVox].DS != resN[iVox].DS) {
+        ++nDiff;
+      }
+    }
+  }
+  BOOST_CHECK(nSmoothed > 0);
+  BOOST_CHECK_EQUAL(nDiff, 0);
+}
+
 } // namespace o2::tpc
@@ -244,7 +244,17 @@ class IDCFactorization : public IDCGroupHelperSector
   /// \param idcs vector containing the IDCs
   /// \param cru CRU
   /// \param timeframe time frame of the IDCs
-  void setIDCs(std::vector<float>&& idcs, const unsigned int cru, const unsigned int timeframe) { mIDCs[cru][timeframe] = std::move(idcs); }
+  void setIDCs(std::vector<float>&& idcs, const unsigned int cru, const unsigned int timeframe);
+
+  /// process the IDCs already when they are set: the IDCs are normalized and summed up for I_0 for each received TF instead of for all TFs when calling factorizeIDCs(),
+  /// which reduces the processing time at the end of the aggregation interval. The norm parameter of factorizeIDCs() and calcIDCZero() is then ignored.
+  /// I_0 can differ from the one obtained without streaming only by the order of the summation. Has to be called before the IDCs are set
+  /// \param stream enable processing of the IDCs when they are set
+  /// \param norm normalize IDCs to pad area
+  void setStreamIDCs(const bool stream, const bool norm = true);
+
+  /// \return returns true if the IDCs are processed when they are set
+  bool getStreamIDCs() const { return mStreamIDCs; }
 
   /// set the number of threads used for some of the calculations
   /// \param nThreads number of threads
@@ -427,6 +437,10 @@ class IDCFactorization : public IDCGroupHelperSector
   std::vector<unsigned int> mIntegrationIntervalsPerTF{};           ///< storage of integration intervals per TF (taken dropped TFs into account)
   long mTimeStamp{0};                                               ///< first time stamp of IDCs
   int mRun{0};                                                      ///< run number of IDCs
+  bool mStreamIDCs{false};                                          ///<! process the IDCs when they are set
+  bool mStreamNorm{true};                                           ///<! normalize the IDCs to the pad area when they are set
+  bool mIDCZeroSumValid{true};                                      ///<! sum of IDCs in mIDCZeroSum contains all set IDCs (false if IDCs were overwritten or cleared)
+  std::vector<std::vector<float>> mIDCZeroSum{};                    ///<! sides -> sum of the IDCs set for the current aggregation interval
 
   /// helper function for drawing IDCDelta
   void drawIDCDeltaHelper(const bool type, const Sector sector, const unsigned int integrationInterval, const IDCDeltaCompression compression, const std::string filename, const float minZ, const float maxZ) const;
@@ -456,6 +470,9 @@ class IDCFactorization : public IDCGroupHelperSector
   /// \return returns true if all IDCs have same size
   bool checkReceivedIDCs();
 
+  /// normalize the IDCs of one CRU and TF and add them to mIDCZeroSum
+  void streamIDCs(const unsigned int cru, const unsigned int timeframe);
+
   ClassDefNV(IDCFactorization, 2)
 };
 
@@ -237,6 +237,46 @@ void o2::tpc::IDCFactorization::dumpIDCDeltaToTree(const Side side, const int ch
   helper.dumpToTreeIDCDelta(side, outFileName);
 }
 
+void o2::tpc::IDCFactorization::setIDCs(std::vector<float>&& idcs, const unsigned int cru, const unsigned int timeframe)
+{
+  if (mStreamIDCs && !mIDCs[cru][timeframe].empty()) {
+    LOGP(warning, "IDCs for CRU {} and TF {} are overwritten!", cru, timeframe);
+    mIDCZeroSumValid = false;
+  }
+  mIDCs[cru][timeframe] = std::move(idcs);
+  if (mStreamIDCs) {
+    streamIDCs(cru, timeframe);
+  }
+}
+
+void o2::tpc::IDCFactorization::setStreamIDCs(const bool stream, const bool norm)
+{
+  mStreamIDCs = stream;
+  mStreamNorm = norm;
+  mIDCZeroSumValid = true;
+  mIDCZeroSum.clear();
+  if (mStreamIDCs) {
+    mIDCZeroSum.resize(mSides.size(), std::vector<float>(mNIDCsPerSector * o2::tpc::SECTORSPERSIDE));
+  }
+}
+
+void o2::tpc::IDCFactorization::streamIDCs(const unsigned int cru, const unsigned int timeframe)
+{
+  const o2::tpc::CRU cruTmp(cru);
+  const unsigned int region = cruTmp.region();
+  const auto factorIndexGlob = mRegionOffs[region] + mNIDCsPerSector * (cruTmp.sector() % o2::tpc::SECTORSPERSIDE);
+  const float normFac = mStreamNorm ? Mapper::INVPADAREA[region] : 1;
+  auto& idcZeroSum = mIDCZeroSum[mSideIndex[cruTmp.side()]];
+  auto& idcs = mIDCs[cru][timeframe];
+  for (unsigned int i = 0; i < idcs.size(); ++i) {
+    if ((idcs[i] == -1) || (idcs[i] == 0)) {
+      continue;
+    }
+    idcs[i] *= normFac;
+    idcZeroSum[(i % mNIDCsPerCRU[region]) + factorIndexGlob] += idcs[i];
+  }
+}
+
 void o2::tpc::IDCFactorization::calcIDCZero(const bool norm)
 {
   const unsigned int nIDCsSide = mNIDCsPerSector * o2::tpc::SECTORSPERSIDE;
@@ -245,23 +285,35 @@ void o2::tpc::IDCFactorization::calcIDCZero(const bool norm)
     idcZero.resize(nIDCsSide);
   }
 
+  if (mStreamIDCs && mIDCZeroSumValid) {
+    // IDCs are already summed up when they were set
+    for (unsigned int i = 0; i < mIDCZero.size(); ++i) {
+      std::copy(mIDCZeroSum[i].begin(), mIDCZeroSum[i].end(), mIDCZero[i].mIDCZero.begin());
+    }
+  } else {
+    if (mStreamIDCs) {
+      LOGP(info, "Set IDCs were modified. Summing up all IDCs for IDC0");
+    }
+    const bool normIDCs = mStreamIDCs ? false : norm; // streamed IDCs are already normalized
+
 #pragma omp parallel for num_threads(sNThreads)
-  for (unsigned int cruInd = 0; cruInd < mCRUs.size(); ++cruInd) {
-    const unsigned int cru = mCRUs[cruInd];
-    const o2::tpc::CRU cruTmp(cru);
-    const auto side = cruTmp.side();
-    const unsigned int region = cruTmp.region();
-    const auto factorIndexGlob = mRegionOffs[region] + mNIDCsPerSector * (cruTmp.sector() % o2::tpc::SECTORSPERSIDE);
-    for (unsigned int timeframe = 0; timeframe < mTimeFrames; ++timeframe) {
-      for (unsigned int idcs = 0; idcs < mIDCs[cru][timeframe].size(); ++idcs) {
-        if ((mIDCs[cru][timeframe][idcs] == -1) || (mIDCs[cru][timeframe][idcs] == 0)) {
-          continue;
-        }
-        if (norm) {
-          mIDCs[cru][timeframe][idcs] *= Mapper::INVPADAREA[region];
+    for (unsigned int cruInd = 0; cruInd < mCRUs.size(); ++cruInd) {
+      const unsigned int cru = mCRUs[cruInd];
+      const o2::tpc::CRU cruTmp(cru);
+      const auto side = cruTmp.side();
+      const unsigned int region = cruTmp.region();
+      const auto factorIndexGlob = mRegionOffs[region] + mNIDCsPerSector * (cruTmp.sector() % o2::tpc::SECTORSPERSIDE);
+      for (unsigned int timeframe = 0; timeframe < mTimeFrames; ++timeframe) {
+        for (unsigned int idcs = 0; idcs < mIDCs[cru][timeframe].size(); ++idcs) {
+          if ((mIDCs[cru][timeframe][idcs] == -1) || (mIDCs[cru][timeframe][idcs] == 0)) {
+            continue;
+          }
+          if (normIDCs) {
+            mIDCs[cru][timeframe][idcs] *= Mapper::INVPADAREA[region];
+          }
+          const unsigned int indexGlob = (idcs % mNIDCsPerCRU[region]) + factorIndexGlob;
+          mIDCZero[mSideIndex[side]].fillValueIDCZero(mIDCs[cru][timeframe][idcs], indexGlob);
         }
-        const unsigned int indexGlob = (idcs % mNIDCsPerCRU[region]) + factorIndexGlob;
-        mIDCZero[mSideIndex[side]].fillValueIDCZero(mIDCs[cru][timeframe][idcs], indexGlob);
       }
     }
   }
@@ -850,7 +902,10 @@ void o2::tpc::IDCFactorization::factorizeIDCs(const bool norm, const bool calcDe
 
   LOGP(info, "Using {} threads for factorization of IDCs", sNThreads);
   LOGP(info, "Checking received IDCs for consistency");
-  checkReceivedIDCs();
+  if (!checkReceivedIDCs()) {
+    // cleared IDCs are contained in the sum of the streamed IDCs
+    mIDCZeroSumValid = false;
+  }
 
   LOGP(info, "Calculating IDC0");
 
@@ -982,6 +1037,10 @@ void o2::tpc::IDCFactorization::reset()
       idcs.clear();
     }
   }
+  for (auto& idcZeroSum : mIDCZeroSum) {
+    std::fill(idcZeroSum.begin(), idcZeroSum.end(), 0);
+  }
+  mIDCZeroSumValid = true;
 }
 
 void o2::tpc::IDCFactorization::drawIDCDeltaHelper(const bool type, const Sector sector, const unsigned int integrationInterval, const IDCDeltaCompression compression, const std::string filename, const float minZ, const float maxZ) const
@@ -15,6 +15,8 @@
 #include "Framework/Logger.h"
 #include "TFile.h"
 #include <fftw3.h>
+#include <mutex>
+#include <unordered_map>
 
 #if (defined(WITH_OPENMP) || defined(_OPENMP)) && !defined(__CLING__)
 #include <omp.h>
@@ -22,6 +24,28 @@
 static inline int omp_get_thread_num() { return 0; }
 #endif
 
+namespace
+{
+/// \return returns FFTW plan for the real to complex (or complex to real for inverse) FT of rangeIDC values
+/// the plans are created only once and are shared by all objects, as the creation of the plans is not thread safe and expensive compared to the FT itself
+fftwf_plan getFFTWPlan(const unsigned int rangeIDC, const bool inverse)
+{
+  static std::mutex planMutex;
+  static std::unordered_map<unsigned int, fftwf_plan> plans[2];
+  std::lock_guard<std::mutex> lock(planMutex);
+  auto& plan = plans[inverse][rangeIDC];
+  if (!plan) {
+    // the buffers are only used for the planning: the plan is executed with the new-array execute functions
+    float* val1DIDCs = fftwf_alloc_real(rangeIDC);
+    fftwf_complex* coefficients = fftwf_alloc_complex(rangeIDC / 2 + 1);
+    plan = inverse ? fftwf_plan_dft_c2r_1d(rangeIDC, coefficients, val1DIDCs, FFTW_ESTIMATE) : fftwf_plan_dft_r2c_1d(rangeIDC, val1DIDCs, coefficients, FFTW_ESTIMATE);
+    fftwf_free(coefficients);
+    fftwf_free(val1DIDCs);
+  }
+  return plan;
+}
+} // namespace
+
 template <class Type>
 o2::tpc::IDCFourierTransform<Type>::~IDCFourierTransform()
 {
@@ -29,7 +53,6 @@ o2::tpc::IDCFourierTransform<Type>::~IDCFourierTransform()
     fftwf_free(mVal1DIDCs[thread]);
     fftwf_free(mCoefficients[thread]);
   }
-  fftwf_destroy_plan(mFFTWPlan);
 }
 
 template <class Type>
@@ -39,7 +62,7 @@ void o2::tpc::IDCFourierTransform<Type>::initFFTW3Members()
     mVal1DIDCs[thread] = fftwf_alloc_real(this->mRangeIDC);
     mCoefficients[thread] = fftwf_alloc_complex(getNMaxCoefficients());
   }
-  mFFTWPlan = fftwf_plan_dft_r2c_1d(this->mRangeIDC, mVal1DIDCs.front(), mCoefficients.front(), FFTW_ESTIMATE);
+  mFFTWPlan = getFFTWPlan(this->mRangeIDC, false);
 }
 
 template <class Type>
@@ -60,9 +83,10 @@ void o2::tpc::IDCFourierTransform<Type>::calcFourierCoefficientsNaive()
   const bool add = mFourierCoefficients.getNCoefficientsPerTF() % 2;
   const unsigned int lastCoeff = mFourierCoefficients.getNCoefficientsPerTF() / 2;
 
+  const std::vector<float> idcOneExpanded{this->getExpandedIDCOne()}; // 1D-IDC values which will be used for the FFT
+
 #pragma omp parallel for num_threads(sNThreads)
   for (unsigned int interval = 0; interval < this->getNIntervals(); ++interval) {
-    const std::vector<float>& idcOneExpanded{this->getExpandedIDCOne()}; // 1D-IDC values which will be used for the FFT
     for (unsigned int coeff = 0; coeff < lastCoeff; ++coeff) {
       const unsigned int indexDataReal = mFourierCoefficients.getIndex(interval, 2 * coeff); // index for storing real fourier coefficient
       const unsigned int indexDataImag = indexDataReal + 1;                                  // index for storing complex fourier coefficient
@@ -167,20 +191,22 @@ std::vector<std::vector<float>> o2::tpc::IDCFourierTransform<Type>::inverseFouri
   std::vector<std::vector<float>> inverse(this->getNIntervals());
 
   // loop over all the intervals. For each interval the coefficients are calculated
-  // this loop and execution of FFTW is not optimized as it is used only for debugging
+  // this loop is not optimized as it is used only for debugging
+  const fftwf_plan fftwPlan = getFFTWPlan(this->mRangeIDC, true);
+  fftwf_complex* coefficients = fftwf_alloc_complex(getNMaxCoefficients());
+  float* val1DIDCs = fftwf_alloc_real(this->mRangeIDC);
   for (unsigned int interval = 0; interval < this->getNIntervals(); ++interval) {
-    inverse[interval].resize(this->mRangeIDC);
-    std::vector<std::array<float, 2>> val1DIDCs;
-    val1DIDCs.reserve(this->mRangeIDC);
     for (unsigned int index = 0; index < getNMaxCoefficients(); ++index) {
       const unsigned int indexDataReal = mFourierCoefficients.getIndex(interval, 2 * index); // index for storing real fourier coefficient
       const unsigned int indexDataImag = indexDataReal + 1;                                  // index for storing complex fourier coefficient
-      val1DIDCs.emplace_back(std::array<float, 2>{mFourierCoefficients(indexDataReal), mFourierCoefficients(indexDataImag)});
+      coefficients[index][0] = mFourierCoefficients(indexDataReal);
+      coefficients[index][1] = mFourierCoefficients(indexDataImag);
     }
-    const fftwf_plan fftwPlan = fftwf_plan_dft_c2r_1d(this->mRangeIDC, reinterpret_cast<fftwf_complex*>(val1DIDCs.data()), inverse[interval].data(), FFTW_ESTIMATE);
-    fftwf_execute(fftwPlan);
-    fftwf_destroy_plan(fftwPlan);
+    fftwf_execute_dft_c2r(fftwPlan, coefficients, val1DIDCs);
+    inverse[interval].assign(val1DIDCs, val1DIDCs + this->mRangeIDC);
   }
+  fftwf_free(val1DIDCs);
+  fftwf_free(coefficients);
   return inverse;
 }
 
@@ -231,23 +257,17 @@ void o2::tpc::IDCFourierTransform<Type>::dumpToTree(const char* outFileName) con
 template <class Type>
 void o2::tpc::IDCFourierTransform<Type>::printFFTWPlan() const
 {
-  float* val1DIDCs = fftwf_alloc_real(this->mRangeIDC);
-  fftwf_complex* coefficients = fftwf_alloc_complex(getNMaxCoefficients());
-  fftwf_plan fftwPlan = fftwf_plan_dft_r2c_1d(this->mRangeIDC, val1DIDCs, coefficients, FFTW_ESTIMATE);
-  char* splan = fftwf_sprint_plan(fftwPlan);
+  char* splan = fftwf_sprint_plan(mFFTWPlan);
 
   LOGP(info, "========= printing FFTW plan ========= \n {}", splan);
   double add = 0;
   double mul = 0;
   double fusedMultAdd = 0;
-  fftwf_flops(fftwPlan, &add, &mul, &fusedMultAdd);
+  fftwf_flops(mFFTWPlan, &add, &mul, &fusedMultAdd);
   LOGP(info, "additions: {}    multiplications: {}    fused multiply-add: {}    sum: {}", add, mul, fusedMultAdd, add + mul + fusedMultAdd);
 
   // free memory
   free(splan);
-  fftwf_free(coefficients);
-  fftwf_free(val1DIDCs);
-  fftwf_destroy_plan(fftwPlan);
 }
 
 template <class Type>
@@ -28,6 +28,7 @@
 #include "Riostream.h"
 #include <fairlogger/Logger.h>
 #include <thread>
+#include <atomic>
 #include "TStopwatch.h"
 
 using namespace o2::gpu;
@@ -37,6 +38,22 @@ namespace o2
 namespace tpc
 {
 
+namespace
+{
+/// runs f(iThread) in nThreads threads and waits for them to finish
+template <typename F>
+void runInThreads(int nThreads, F&& f)
+{
+  std::vector<std::thread> threads(nThreads);
+  for (int i = 0; i < nThreads; i++) {
+    threads[i] = std::thread(f, i);
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+}
+} // namespace
+
 TPCFastSpaceChargeCorrectionHelper* TPCFastSpaceChargeCorrectionHelper::sInstance = nullptr;
 
 TPCFastSpaceChargeCorrectionHelper* TPCFastSpaceChargeCorrectionHelper::instance()
@@ -127,54 +144,51 @@ void TPCFastSpaceChargeCorrectionHelper::fillSpaceChargeCorrectionFromMap(TPCFas
     return;
   }
 
-  LOG(info) << "fast space charge correction helper: init from data points";
-
-  for (int slice = 0; slice < correction.getGeometry().getNumberOfSlices(); slice++) {
+  LOG(info) << "fast space charge correction helper: init from data points using " << mNthreads << " threads";
+  TStopwatch watch;
 
-    auto myThread = [&](int iThread) {
-      for (int row = iThread; row < correction.getGeometry().getNumberOfRows(); row += mNthreads) {
-
-        TPCFastSpaceChargeCorrection::SplineType& spline = correction.getSpline(slice, row);
-        Spline2DHelper<float> helper;
-        float* splineParameters = correction.getSplineData(slice, row);
-        const std::vector<o2::gpu::TPCFastSpaceChargeCorrectionMap::CorrectionPoint>& data = mCorrectionMap.getPoints(slice, row);
-        int nDataPoints = data.size();
-        if (nDataPoints >= 4) {
-          std::vector<double> pointSU(nDataPoints);
-          std::vector<double> pointSV(nDataPoints);
-          std::vector<double> pointCorr(3 * nDataPoints); // 3 dimensions
-          for (int i = 0; i < nDataPoints; ++i) {
-            double su, sv, dx, du, dv;
-            getSpaceChargeCorrection(correction, slice, row, data[i], su, sv, dx, du, dv);
-            pointSU[i] = su;
-            pointSV[i] = sv;
-            pointCorr[3 * i + 0] = dx;
-            pointCorr[3 * i + 1] = du;
-            pointCorr[3 * i + 2] = dv;
-          }
-          helper.approximateDataPoints(spline, splineParameters, 0., spline.getGridX1().getNumberOfKnots() - 1, 0., spline.getGridX2().getNumberOfKnots() - 1, &pointSU[0],
-                                       &pointSV[0], &pointCorr[0], nDataPoints);
-        } else {
-          for (int i = 0; i < spline.getNumberOfParameters(); i++) {
-            splineParameters[i] = 0.f;
-          }
+  // the (slice, row) fits are independent, they are distributed dynamically between the threads
+  const int nRows = correction.getGeometry().getNumberOfRows();
+  const int nTasks = correction.getGeometry().getNumberOfSlices() * nRows;
+  std::atomic<int> nextTask{0};
+
+  auto myThread = [&](int iThread) {
+    // the helper with its solver workspace and the data point buffers are reused for all the rows of the thread
+    Spline2DHelper<float> helper;
+    std::vector<double> pointSU, pointSV, pointCorr;
+    for (int task = nextTask++; task < nTasks; task = nextTask++) {
+      const int slice = task / nRows;
+      const int row = task % nRows;
+      TPCFastSpaceChargeCorrection::SplineType& spline = correction.getSpline(slice, row);
+      float* splineParameters = correction.getSplineData(slice, row);
+      const std::vector<o2::gpu::TPCFastSpaceChargeCorrectionMap::CorrectionPoint>& data = mCorrectionMap.getPoints(slice, row);
+      int nDataPoints = data.size();
+      if (nDataPoints >= 4) {
+        pointSU.resize(nDataPoints);
+        pointSV.resize(nDataPoints);
+        pointCorr.resize(3 * nDataPoints); // 3 dimensions
+        for (int i = 0; i < nDataPoints; ++i) {
+          double su, sv, dx, du, dv;
+          getSpaceChargeCorrection(correction, slice, row, data[i], su, sv, dx, du, dv);
+          pointSU[i] = su;
+          pointSV[i] = sv;
+          pointCorr[3 * i + 0] = dx;
+          pointCorr[3 * i + 1] = du;
+          pointCorr[3 * i + 2] = dv;
         }
-      } // row
-    };  // thread
-
-    std::vector<std::thread> threads(mNthreads);
-
-    // run n threads
-    for (int i = 0; i < mNthreads; i++) {
-      threads[i] = std::thread(myThread, i);
-    }
+        helper.approximateDataPoints(spline, splineParameters, 0., spline.getGridX1().getNumberOfKnots() - 1, 0., spline.getGridX2().getNumberOfKnots() - 1, &pointSU[0],
+                                     &pointSV[0], &pointCorr[0], nDataPoints);
+      } else {
+        for (int i = 0; i < spline.getNumberOfParameters(); i++) {
+          splineParameters[i] = 0.f;
+        }
+      }
+    } // slice, row
+  };  // thread
 
-    // wait for the threads to finish
-    for (auto& th : threads) {
-      th.join();
-    }
+  runInThreads(mNthreads, myThread);
 
-  } // slice
+  LOGP(info, "Fit of the correction splines took: {}s", watch.RealTime());
 
   initInverse(correction, 0);
 }
@@ -278,42 +292,33 @@ std::unique_ptr<TPCFastSpaceChargeCorrection> TPCFastSpaceChargeCorrectionHelper
     int nRows = mGeo.getNumberOfRows();
     mCorrectionMap.init(nRocs, nRows);
 
-    for (int iRoc = 0; iRoc < nRocs; iRoc++) {
-
-      auto myThread = [&](int iThread) {
-        for (int iRow = iThread; iRow < nRows; iRow += mNthreads) {
-          const auto& info = mGeo.getRowInfo(iRow);
-          double vMax = mGeo.getTPCzLength(iRoc);
-          double dv = vMax / (6. * (nKnotsZ - 1));
-
-          double dpad = info.maxPad / (6. * (nKnotsY - 1));
-          for (double pad = 0; pad < info.maxPad + .5 * dpad; pad += dpad) {
-            float u = mGeo.convPadToU(iRow, pad);
-            for (double v = 0.; v < vMax + .5 * dv; v += dv) {
-              float ly, lz;
-              mGeo.convUVtoLocal(iRoc, u, v, ly, lz);
-              double dx, dy, dz;
-              correctionLocal(iRoc, iRow, ly, lz, dx, dy, dz);
-              mCorrectionMap.addCorrectionPoint(iRoc, iRow,
-                                                ly, lz, dx, dy, dz);
-            }
-          }
-        } // row
-      };  // thread
-
-      std::vector<std::thread> threads(mNthreads);
-
-      // run n threads
-      for (int i = 0; i < mNthreads; i++) {
-        threads[i] = std::thread(myThread, i);
-      }
+    const int nTasks = nRocs * nRows;
+    std::atomic<int> nextTask{0};
 
-      // wait for the threads to finish
-      for (auto& th : threads) {
-        th.join();
-      }
+    auto myThread = [&](int iThread) {
+      for (int task = nextTask++; task < nTasks; task = nextTask++) {
+        const int iRoc = task / nRows;
+        const int iRow = task % nRows;
+        const auto& info = mGeo.getRowInfo(iRow);
+        double vMax = mGeo.getTPCzLength(iRoc);
+        double dv = vMax / (6. * (nKnotsZ - 1));
+
+        double dpad = info.maxPad / (6. * (nKnotsY - 1));
+        for (double pad = 0; pad < info.maxPad + .5 * dpad; pad += dpad) {
+          float u = mGeo.convPadToU(iRow, pad);
+          for (double v = 0.; v < vMax + .5 * dv; v += dv) {
+            float ly, lz;
+            mGeo.convUVtoLocal(iRoc, u, v, ly, lz);
+            double dx, dy, dz;
+            correctionLocal(iRoc, iRow, ly, lz, dx, dy, dz);
+            mCorrectionMap.addCorrectionPoint(iRoc, iRow,
+                                              ly, lz, dx, dy, dz);
+          }
+        }
+      } // roc, row
+    };  // thread
 
-    } // roc
+    runInThreads(mNthreads, myThread);
 
     fillSpaceChargeCorrectionFromMap(correction);
   }
@@ -678,141 +683,135 @@ void TPCFastSpaceChargeCorrectionHelper::initInverse(std::vector<o2::gpu::TPCFas
   tpcR2max = tpcR2max / cos(2 * M_PI / mGeo.getNumberOfSlicesA() / 2) + 1.;
   tpcR2max = tpcR2max * tpcR2max;
 
-  for (int slice = 0; slice < mGeo.getNumberOfSlices(); slice++) {
-    // LOG(info) << "inverse transform for slice " << slice ;
-    double vLength = (slice < mGeo.getNumberOfSlicesA()) ? mGeo.getTPCzLengthA() : mGeo.getTPCzLengthC();
-
-    auto myThread = [&](int iThread) {
-      Spline2DHelper<float> helper;
-      std::vector<float> splineParameters;
-      ChebyshevFit1D chebFitterX, chebFitterU, chebFitterV;
+  // distribute the (slice, row) fits dynamically between the threads
+  const int nRows = mGeo.getNumberOfRows();
+  const int nTasks = mGeo.getNumberOfSlices() * nRows;
+  std::atomic<int> nextTask{0};
+
+  auto myThread = [&](int iThread) {
+    // per-thread workspace
+    Spline2DHelper<float> helper;
+    std::vector<float> splineParameters;
+    std::vector<double> dataPointCU, dataPointCV, dataPointF;
+
+    for (int task = nextTask++; task < nTasks; task = nextTask++) {
+      const int slice = task / nRows;
+      const int row = task % nRows;
+      TPCFastSpaceChargeCorrection::SplineType spline = correction.getSpline(slice, row);
+      dataPointCU.clear();
+      dataPointCV.clear();
+      dataPointF.clear();
+
+      float u0, u1, v0, v1;
+      mGeo.convScaledUVtoUV(slice, row, 0., 0., u0, v0);
+      mGeo.convScaledUVtoUV(slice, row, 1., 1., u1, v1);
 
-      for (int row = iThread; row < mGeo.getNumberOfRows(); row += mNthreads) {
-        TPCFastSpaceChargeCorrection::SplineType spline = correction.getSpline(slice, row);
-        helper.setSpline(spline, 10, 10);
-        std::vector<double> dataPointCU, dataPointCV, dataPointF;
+      double x = mGeo.getRowInfo(row).x;
+      int nPointsU = (spline.getGridX1().getNumberOfKnots() - 1) * 10;
+      int nPointsV = (spline.getGridX2().getNumberOfKnots() - 1) * 10;
 
-        float u0, u1, v0, v1;
-        mGeo.convScaledUVtoUV(slice, row, 0., 0., u0, v0);
-        mGeo.convScaledUVtoUV(slice, row, 1., 1., u1, v1);
+      double stepU = (u1 - u0) / (nPointsU - 1);
+      double stepV = (v1 - v0) / (nPointsV - 1);
 
-        double x = mGeo.getRowInfo(row).x;
-        int nPointsU = (spline.getGridX1().getNumberOfKnots() - 1) * 10;
-        int nPointsV = (spline.getGridX2().getNumberOfKnots() - 1) * 10;
+      if (prn) {
+        LOG(info) << "u0 " << u0 << " u1 " << u1 << " v0 " << v0 << " v1 " << v1;
+      }
+      TPCFastSpaceChargeCorrection::RowActiveArea& area = correction.getSliceRowInfo(slice, row).activeArea;
+      area.cuMin = 1.e10;
+      area.cuMax = -1.e10;
+
+      /*
+      v1 = area.vMax;
+      stepV = (v1 - v0) / (nPointsU - 1);
+      if (stepV < 1.f) {
+        stepV = 1.f;
+      }
+      */
 
-        double stepU = (u1 - u0) / (nPointsU - 1);
-        double stepV = (v1 - v0) / (nPointsV - 1);
+      for (double u = u0; u < u1 + stepU; u += stepU) {
+        for (double v = v0; v < v1 + stepV; v += stepV) {
+          float dx, du, dv;
+          correction.getCorrection(slice, row, u, v, dx, du, dv);
+          dx *= scaling[0];
+          du *= scaling[0];
+          dv *= scaling[0];
+          // add remaining corrections
+          for (int i = 1; i < corrections.size(); ++i) {
+            float dxTmp, duTmp, dvTmp;
+            corrections[i]->getCorrection(slice, row, u, v, dxTmp, duTmp, dvTmp);
+            dx += dxTmp * scaling[i];
+            du += duTmp * scaling[i];
+            dv += dvTmp * scaling[i];
+          }
+          double cx = x + dx;
+          double cu = u + du;
+          double cv = v + dv;
+          if (cu < area.cuMin) {
+            area.cuMin = cu;
+          }
+          if (cu > area.cuMax) {
+            area.cuMax = cu;
+          }
 
-        if (prn) {
-          LOG(info) << "u0 " << u0 << " u1 " << u1 << " v0 " << v0 << " v1 " << v1;
-        }
-        TPCFastSpaceChargeCorrection::RowActiveArea& area = correction.getSliceRowInfo(slice, row).activeArea;
-        area.cuMin = 1.e10;
-        area.cuMax = -1.e10;
-
-        /*
-        v1 = area.vMax;
-        stepV = (v1 - v0) / (nPointsU - 1);
-        if (stepV < 1.f) {
-          stepV = 1.f;
-        }
-        */
-
-        for (double u = u0; u < u1 + stepU; u += stepU) {
-          for (double v = v0; v < v1 + stepV; v += stepV) {
-            float dx, du, dv;
-            correction.getCorrection(slice, row, u, v, dx, du, dv);
-            dx *= scaling[0];
-            du *= scaling[0];
-            dv *= scaling[0];
-            // add remaining corrections
-            for (int i = 1; i < corrections.size(); ++i) {
-              float dxTmp, duTmp, dvTmp;
-              corrections[i]->getCorrection(slice, row, u, v, dxTmp, duTmp, dvTmp);
-              dx += dxTmp * scaling[i];
-              du += duTmp * scaling[i];
-              dv += dvTmp * scaling[i];
-            }
-            double cx = x + dx;
-            double cu = u + du;
-            double cv = v + dv;
-            if (cu < area.cuMin) {
-              area.cuMin = cu;
-            }
-            if (cu > area.cuMax) {
-              area.cuMax = cu;
-            }
-
-            dataPointCU.push_back(cu);
-            dataPointCV.push_back(cv);
-            dataPointF.push_back(dx);
-            dataPointF.push_back(du);
-            dataPointF.push_back(dv);
-
-            if (prn) {
-              LOG(info) << "measurement cu " << cu << " cv " << cv << " dx " << dx << " du " << du << " dv " << dv;
-            }
-          } // v
-        }   // u
-
-        if (area.cuMax - area.cuMin < 0.2) {
-          area.cuMax = .1;
-          area.cuMin = -.1;
-        }
-        if (area.cvMax < 0.1) {
-          area.cvMax = .1;
-        }
-        if (prn) {
-          LOG(info) << "slice " << slice << " row " << row << " max drift L = " << correction.getMaxDriftLength(slice, row)
-                    << " active area: cuMin " << area.cuMin << " cuMax " << area.cuMax << " vMax " << area.vMax << " cvMax " << area.cvMax;
-        }
+          dataPointCU.push_back(cu);
+          dataPointCV.push_back(cv);
+          dataPointF.push_back(dx);
+          dataPointF.push_back(du);
+          dataPointF.push_back(dv);
 
-        TPCFastSpaceChargeCorrection::SliceRowInfo& info = correction.getSliceRowInfo(slice, row);
-        info.gridCorrU0 = area.cuMin;
-        info.scaleCorrUtoGrid = spline.getGridX1().getUmax() / (area.cuMax - area.cuMin);
-        info.scaleCorrVtoGrid = spline.getGridX2().getUmax() / area.cvMax;
+          if (prn) {
+            LOG(info) << "measurement cu " << cu << " cv " << cv << " dx " << dx << " du " << du << " dv " << dv;
+          }
+        } // v
+      }   // u
 
-        info.gridCorrU0 = u0;
-        info.gridCorrV0 = info.gridV0;
-        info.scaleCorrUtoGrid = spline.getGridX1().getUmax() / (u1 - info.gridCorrU0);
-        info.scaleCorrVtoGrid = spline.getGridX2().getUmax() / (v1 - info.gridCorrV0);
+      if (area.cuMax - area.cuMin < 0.2) {
+        area.cuMax = .1;
+        area.cuMin = -.1;
+      }
+      if (area.cvMax < 0.1) {
+        area.cvMax = .1;
+      }
+      if (prn) {
+        LOG(info) << "slice " << slice << " row " << row << " max drift L = " << correction.getMaxDriftLength(slice, row)
+                  << " active area: cuMin " << area.cuMin << " cuMax " << area.cuMax << " vMax " << area.vMax << " cvMax " << area.cvMax;
+      }
 
-        int nDataPoints = dataPointCU.size();
-        for (int i = 0; i < nDataPoints; i++) {
-          dataPointCU[i] = (dataPointCU[i] - info.gridCorrU0) * info.scaleCorrUtoGrid;
-          dataPointCV[i] = (dataPointCV[i] - info.gridCorrV0) * info.scaleCorrVtoGrid;
-        }
+      TPCFastSpaceChargeCorrection::SliceRowInfo& info = correction.getSliceRowInfo(slice, row);
+      info.gridCorrU0 = area.cuMin;
+      info.scaleCorrUtoGrid = spline.getGridX1().getUmax() / (area.cuMax - area.cuMin);
+      info.scaleCorrVtoGrid = spline.getGridX2().getUmax() / area.cvMax;
 
-        splineParameters.resize(spline.getNumberOfParameters());
+      info.gridCorrU0 = u0;
+      info.gridCorrV0 = info.gridV0;
+      info.scaleCorrUtoGrid = spline.getGridX1().getUmax() / (u1 - info.gridCorrU0);
+      info.scaleCorrVtoGrid = spline.getGridX2().getUmax() / (v1 - info.gridCorrV0);
 
-        helper.approximateDataPoints(spline, splineParameters.data(), 0., spline.getGridX1().getUmax(),
-                                     0., spline.getGridX2().getUmax(),
-                                     dataPointCU.data(), dataPointCV.data(),
-                                     dataPointF.data(), dataPointCU.size());
+      int nDataPoints = dataPointCU.size();
+      for (int i = 0; i < nDataPoints; i++) {
+        dataPointCU[i] = (dataPointCU[i] - info.gridCorrU0) * info.scaleCorrUtoGrid;
+        dataPointCV[i] = (dataPointCV[i] - info.gridCorrV0) * info.scaleCorrVtoGrid;
+      }
 
-        float* splineX = correction.getSplineData(slice, row, 1);
-        float* splineUV = correction.getSplineData(slice, row, 2);
-        for (int i = 0; i < spline.getNumberOfParameters() / 3; i++) {
-          splineX[i] = splineParameters[3 * i + 0];
-          splineUV[2 * i + 0] = splineParameters[3 * i + 1];
-          splineUV[2 * i + 1] = splineParameters[3 * i + 2];
-        }
-      } // row
-    };  // thread
+      splineParameters.resize(spline.getNumberOfParameters());
 
-    std::vector<std::thread> threads(mNthreads);
+      helper.approximateDataPoints(spline, splineParameters.data(), 0., spline.getGridX1().getUmax(),
+                                   0., spline.getGridX2().getUmax(),
+                                   dataPointCU.data(), dataPointCV.data(),
+                                   dataPointF.data(), dataPointCU.size());
 
-    // run n threads
-    for (int i = 0; i < mNthreads; i++) {
-      threads[i] = std::thread(myThread, i);
-    }
+      float* splineX = correction.getSplineData(slice, row, 1);
+      float* splineUV = correction.getSplineData(slice, row, 2);
+      for (int i = 0; i < spline.getNumberOfParameters() / 3; i++) {
+        splineX[i] = splineParameters[3 * i + 0];
+        splineUV[2 * i + 0] = splineParameters[3 * i + 1];
+        splineUV[2 * i + 1] = splineParameters[3 * i + 2];
+      }
+    } // slice, row
+  };  // thread
 
-    // wait for the threads to finish
-    for (auto& th : threads) {
-      th.join();
-    }
+  runInThreads(mNthreads, myThread);
 
-  } // slice
   float duration = watch.RealTime();
   LOGP(info, "Inverse took: {}s", duration);
 }
@@ -230,20 +230,27 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CompressedClusters& ccl, co
   ec->setANSHeader(mANSVersion);
 
   o2::ctf::CTFIOSize iosize;
-  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor(), &iosize](auto begin, auto end, CTF::Slots slot, size_t probabilityBits, std::vector<bool>* reject = nullptr) {
+  std::vector<BlockEncoder> blockEncoders(getNThreads() > 1 ? CTF::getNBlocks() : 0);
+  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor(), &iosize, &blockEncoders](auto begin, auto end, CTF::Slots slot, size_t probabilityBits, std::vector<bool>* reject = nullptr) {
     // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
     const auto slotVal = static_cast<int>(slot);
-    if (reject && begin != end) {
-      std::vector<std::decay_t<decltype(*begin)>> tmp;
-      tmp.reserve(std::distance(begin, end));
-      for (auto i = begin; i != end; i++) {
-        if (!(*reject)[std::distance(begin, i)]) {
-          tmp.emplace_back(*i);
+    auto encodeBlock = [begin, end, slotVal, probabilityBits, reject, &optField, &coders, mfc](auto& buffer) {
+      if (reject && begin != end) {
+        std::vector<std::decay_t<decltype(*begin)>> tmp;
+        tmp.reserve(std::distance(begin, end));
+        for (auto i = begin; i != end; i++) {
+          if (!(*reject)[std::distance(begin, i)]) {
+            tmp.emplace_back(*i);
+          }
         }
+        return CTF::get(buffer.data())->encode(tmp.begin(), tmp.end(), slotVal, probabilityBits, optField[slotVal], &buffer, coders[slotVal], mfc);
       }
-      iosize += CTF::get(buff.data())->encode(tmp.begin(), tmp.end(), slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal], mfc);
-    } else {
-      iosize += CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal], mfc);
+      return CTF::get(buffer.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buffer, coders[slotVal], mfc);
+    };
+    if (blockEncoders.empty()) {
+      iosize += encodeBlock(buff);
+    } else { // columns are independent, encode them concurrently at the end
+      blockEncoders[slotVal] = encodeBlock;
     }
   };
 
@@ -313,6 +320,7 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CompressedClusters& ccl, co
   encodeTPC(trigComp.deltaOrbit.begin(), trigComp.deltaOrbit.end(), CTF::BLCTrigOrbitInc, 0);
   encodeTPC(trigComp.deltaBC.begin(), trigComp.deltaBC.end(), CTF::BLCTrigBCInc, 0);
   encodeTPC(trigComp.triggerType.begin(), trigComp.triggerType.end(), CTF::BLCTrigType, 0);
+  iosize += encodeBlocks<CTF>(buff, blockEncoders);
 
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
@@ -345,9 +353,15 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec, TRIGVEC&
 
   // decode encoded data directly to destination buff
   o2::ctf::CTFIOSize iosize;
-  auto decodeTPC = [&ec, &coders = mCoders, &iosize](auto begin, CTF::Slots slot) {
+  std::vector<BlockTask> blockDecoders;
+  auto decodeTPC = [&ec, &coders = mCoders, &iosize, &blockDecoders, parallel = getNThreads() > 1](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
-    iosize += ec.decode(begin, slotVal, coders[slotVal]);
+    auto decodeBlock = [&ec, &coders, begin, slotVal]() { return ec.decode(begin, slotVal, coders[slotVal]); };
+    if (parallel) { // columns are independent, decode them concurrently at the end
+      blockDecoders.emplace_back(decodeBlock);
+    } else {
+      iosize += decodeBlock();
+    }
   };
 
   if (mCombineColumns) {
@@ -408,6 +422,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec, TRIGVEC&
   decodeTPC(trigInfo.deltaOrbit.data(), CTF::BLCTrigOrbitInc);
   decodeTPC(trigInfo.deltaBC.data(), CTF::BLCTrigBCInc);
   decodeTPC(trigInfo.triggerType.data(), CTF::BLCTrigType);
+  iosize += runBlockTasks(blockDecoders);
   // convert trigger info to output format
   uint32_t prevOrbit = header.firstOrbitTrig;
   uint16_t prevBC = 0;
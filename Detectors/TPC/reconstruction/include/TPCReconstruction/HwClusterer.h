@@ -111,6 +111,11 @@ class HwClusterer : public Clusterer
   ///               2 for minimum contributes only to left/older peak
   void setSplittingMode(short mode);
 
+  /// Sets the number of threads used to process the row sets of the sector in parallel
+  /// The output is identical to the single threaded processing, independent of the number of threads
+  /// \param nThreads  Number of threads, 1 for sequential processing
+  void setNThreads(int nThreads);
+
  private:
   /*
    * Helper functions
@@ -150,13 +155,20 @@ class HwClusterer : public Clusterer
   /// \param timeOffset   Time offset of cluster container
   void writeOutputWithTimeOffset(int timeOffset);
 
+  /// Does the peak finding for the given timebin, computes the clusters of timebin - 3 and clears timebin + 1 in all row sets
+  /// The row sets are processed in parallel, the found clusters are merged afterwards in row set order
+  /// \param timebin  Latest timebin in the buffer
+  void processTimebin(int timebin);
+
   /// Processes and collects the peaks after they were found
   /// \param timebin  Timebin to cluster peaks
-  void computeClusterForTime(int timebin);
+  /// \param row      Row set to be processed
+  void computeClusterForTime(int timebin, unsigned short row);
 
-  /// Does the Peak Finding in all rows for given timebin
+  /// Does the Peak Finding in the given row set for given timebin
   /// \param timebin  Timebin to cluster peaks
-  void findPeaksForTime(int timebin);
+  /// \param row      Row set to be processed
+  void findPeaksForTime(int timebin, unsigned short row);
 
   /// Searches for last remaining cluster and writes them out
   /// \param clear    Clears data buffer afterwards (for not continuous readout)
@@ -166,6 +178,15 @@ class HwClusterer : public Clusterer
   /// \param timebin  Timebin to be cleared
   void clearBuffer(int timebin);
 
+  /// Clears the data of the given row set in the buffer at given timebin
+  /// \param timebin  Timebin to be cleared
+  /// \param row      Row set to be cleared
+  void clearRowSet(int timebin, unsigned short row);
+
+  /// Clears the MC truth information of the buffer at given timebin
+  /// \param timebin  Timebin to be cleared
+  void clearMCtruth(int timebin);
+
   /// Returns least significant set bit of mCurrentMcContainerInBuffer, only the mTimebinsInBuffer LSBs are checked
   /// \return LSB index which is set
   short getFirstSetBitOfField();
@@ -200,6 +221,7 @@ class HwClusterer : public Clusterer
   bool mRejectSinglePadClusters;         ///< Switch to reject single pad clusters, sigmaPad2Pre == 0
   bool mRejectSingleTimeClusters;        ///< Switch to reject single time clusters, sigmaTime2Pre == 0
   bool mRejectLaterTimebin;              ///< Switch to reject peaks in later timebins of the same pad
+  int mNThreads;                         ///< Number of threads to process the row sets in parallel
 
   std::vector<unsigned short> mPadsPerRow;                       ///< Number of pads for given row (offset of 2 pads on both sides is already added)
   std::vector<unsigned short> mPadsPerRowSet;                    ///< Number of pads for given row set (offset of 2 pads on both sides is already added), a row set combines rows for parallel SIMD processing
@@ -214,6 +236,10 @@ class HwClusterer : public Clusterer
   std::vector<std::unique_ptr<std::vector<ClusterHardware>>> mTmpClusterArray;                             ///< Temporary cluster storage for each region to accumulate cluster before filling output container
   std::vector<std::unique_ptr<std::vector<std::vector<std::pair<MCCompLabel, unsigned>>>>> mTmpLabelArray; ///< Temporary cluster storage for each region to accumulate cluster before filling output container
 
+  std::vector<std::vector<std::pair<unsigned short, ClusterHardware>>> mRowSetClusterArray;                 ///< Clusters (with region) found in the current timebin for each row set, merged into mTmpClusterArray
+  std::vector<std::vector<std::vector<std::pair<MCCompLabel, unsigned>>>> mRowSetLabelArray;                ///< MC labels of the clusters found in the current timebin for each row set
+  std::vector<std::vector<std::unique_ptr<std::vector<std::pair<MCCompLabel, unsigned>>>>> mRowSetMcLabels; ///< Reused buffers to collect the MC labels of the clusters of a row set
+
   std::vector<ClusterHardwareContainer8kb>* mClusterArray; ///< Pointer to output cluster container
   MCLabelContainer* mClusterMcLabelArray;                  ///< Pointer to MC Label container
 };
@@ -263,6 +289,11 @@ inline void HwClusterer::setSplittingMode(short mode)
   mSplittingMode = mode;
 }
 
+inline void HwClusterer::setNThreads(int nThreads)
+{
+  mNThreads = nThreads > 0 ? nThreads : 1;
+}
+
 inline int HwClusterer::mapTimeInRange(int time)
 {
   return (mTimebinsInBuffer + (time % mTimebinsInBuffer)) % mTimebinsInBuffer;
@@ -47,6 +47,7 @@ HwClusterer::HwClusterer(
     mRejectSinglePadClusters(false),
     mRejectSingleTimeClusters(false),
     mRejectLaterTimebin(false),
+    mNThreads(1),
     mPadsPerRowSet(),
     mGlobalRowToRegion(),
     mGlobalRowToLocalRow(),
@@ -57,6 +58,9 @@ HwClusterer::HwClusterer(
     mMCtruth(),
     mTmpClusterArray(),
     mTmpLabelArray(),
+    mRowSetClusterArray(),
+    mRowSetLabelArray(),
+    mRowSetMcLabels(),
     mClusterMcLabelArray(labelOutput),
     mClusterArray(clusterOutputContainer)
 {
@@ -100,6 +104,15 @@ HwClusterer::HwClusterer(
     mTmpLabelArray[region] = std::make_unique<std::vector<std::vector<std::pair<MCCompLabel, unsigned>>>>();
   }
 
+  mRowSetClusterArray.resize(mNumRowSets);
+  mRowSetLabelArray.resize(mNumRowSets);
+  mRowSetMcLabels.resize(mNumRowSets);
+  for (auto& mcLabels : mRowSetMcLabels) {
+    for (int i = 0; i < Vc::uint_v::Size; ++i) {
+      mcLabels.emplace_back(std::make_unique<std::vector<std::pair<MCCompLabel, unsigned>>>());
+    }
+  }
+
   mGlobalRowToRegion.resize(mNumRows);
   mGlobalRowToLocalRow.resize(mNumRows);
   unsigned short row = 0;
@@ -127,6 +140,7 @@ void HwClusterer::init()
   mRejectSinglePadClusters = param.rejectSinglePadClusters;
   mRejectSingleTimeClusters = param.rejectSingleTimeClusters;
   mRejectLaterTimebin = param.rejectLaterTimebin;
+  setNThreads(param.nThreads);
 }
 
 //______________________________________________________________________________
@@ -218,10 +232,7 @@ void HwClusterer::process(gsl::span<o2::tpc::Digit const> const& digits, ConstMC
          *    4 |
          *       ---------
          */
-        findPeaksForTime(i);
-        computeClusterForTime(i - 3);
-
-        clearBuffer(i + 1);
+        processTimebin(i);
 
         mLastHB = HB;
       }
@@ -297,9 +308,9 @@ void HwClusterer::hwClusterProcessor(const Vc::uint_m peakMask, unsigned qMaxInd
   Vc::int_v flags = 0;
 
   using labelPair = std::pair<MCCompLabel, unsigned>;
-  std::vector<std::unique_ptr<std::vector<labelPair>>> mcLabels(Vc::uint_v::Size);
-  for (int i = 0; i < Vc::uint_v::Size; ++i) {
-    mcLabels[i] = std::make_unique<std::vector<labelPair>>();
+  auto& mcLabels = mRowSetMcLabels[row];
+  for (auto& labels : mcLabels) {
+    labels->clear();
   }
 
   const unsigned llttIndex = mapTimeInRange(centerTime - 2) * mPadsPerRowSet[row] + centerPad - 2;
@@ -599,8 +610,8 @@ void HwClusterer::hwClusterProcessor(const Vc::uint_m peakMask, unsigned qMaxInd
   for (int i = 0; i < Vc::uint_v::Size; ++i) {
     if (selectionMask[i]) {
 
-      mTmpClusterArray[mGlobalRowToRegion[row * Vc::uint_v::Size + i]]->emplace_back();
-      mTmpClusterArray[mGlobalRowToRegion[row * Vc::uint_v::Size + i]]->back().setCluster(
+      mRowSetClusterArray[row].emplace_back(mGlobalRowToRegion[row * Vc::uint_v::Size + i], ClusterHardware());
+      mRowSetClusterArray[row].back().second.setCluster(
         centerPad - 2,    // we have two artificial empty pads "on the left" which needs to be subtracted
         centerTime % 447, // the time within a HB
         pad[i], time[i],
@@ -611,7 +622,7 @@ void HwClusterer::hwClusterProcessor(const Vc::uint_m peakMask, unsigned qMaxInd
         flags[i]);
 
       std::sort(mcLabels[i]->begin(), mcLabels[i]->end(), [](const labelPair& a, const labelPair& b) { return a.second > b.second; });
-      mTmpLabelArray[mGlobalRowToRegion[row * Vc::uint_v::Size + i]]->push_back(std::move(*mcLabels[i]));
+      mRowSetLabelArray[row].push_back(*mcLabels[i]);
     }
   }
 }
@@ -766,67 +777,92 @@ void HwClusterer::writeOutputWithTimeOffset(int timeOffset)
 }
 
 //______________________________________________________________________________
-void HwClusterer::findPeaksForTime(int timebin)
+void HwClusterer::processTimebin(int timebin)
+{
+  // Each row set has its own part of the buffers, so the peak finding, the
+  // cluster computation and the clearing of the row sets are independent of
+  // each other. The clusters found in a row set are collected separately and
+  // merged afterwards in row set order, which gives the same order within a
+  // region as the sequential processing, independent of the number of threads.
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic) if (mNThreads > 1)
+#endif
+  for (int row = 0; row < mNumRowSets; ++row) {
+    findPeaksForTime(timebin, row);
+    computeClusterForTime(timebin - 3, row);
+    clearRowSet(timebin + 1, row);
+  }
+
+  // the MC truth of timebin + 1 might still be needed for the clusters of timebin - 3
+  clearMCtruth(timebin + 1);
+
+  for (unsigned short row = 0; row < mNumRowSets; ++row) {
+    auto& clusters = mRowSetClusterArray[row];
+    auto& labels = mRowSetLabelArray[row];
+    for (size_t c = 0; c < clusters.size(); ++c) {
+      mTmpClusterArray[clusters[c].first]->emplace_back(clusters[c].second);
+      mTmpLabelArray[clusters[c].first]->emplace_back(std::move(labels[c]));
+    }
+    clusters.clear();
+    labels.clear();
+  }
+}
+
+//______________________________________________________________________________
+void HwClusterer::findPeaksForTime(int timebin, unsigned short row)
 {
   if (timebin < 0) {
     return;
   }
 
   const unsigned timeBinWrapped = mapTimeInRange(timebin);
-  for (unsigned short row = 0; row < mNumRowSets; ++row) {
-    const unsigned padOffset = timeBinWrapped * mPadsPerRowSet[row];
-    // two empty pads on the left and right without a cluster peak, check one
-    // beyond rightmost pad for remaining relations
-    for (short pad = 1; pad < mPadsPerRowSet[row] - 1; ++pad) {
-      const unsigned qMaxIndex = padOffset + pad;
-      hwPeakFinder(qMaxIndex, pad, timeBinWrapped, row);
-    }
+  const unsigned padOffset = timeBinWrapped * mPadsPerRowSet[row];
+  // two empty pads on the left and right without a cluster peak, check one
+  // beyond rightmost pad for remaining relations
+  for (short pad = 1; pad < mPadsPerRowSet[row] - 1; ++pad) {
+    const unsigned qMaxIndex = padOffset + pad;
+    hwPeakFinder(qMaxIndex, pad, timeBinWrapped, row);
   }
 }
 
 //______________________________________________________________________________
-void HwClusterer::computeClusterForTime(int timebin)
+void HwClusterer::computeClusterForTime(int timebin, unsigned short row)
 {
   if (timebin < 0) {
     return;
   }
 
   const unsigned timeBinWrapped = mapTimeInRange(timebin);
+  const unsigned padOffset = timeBinWrapped * mPadsPerRowSet[row];
   if (mRejectLaterTimebin) {
     const unsigned previousTimeBinWrapped = mapTimeInRange(timebin - 2);
-    for (unsigned short row = 0; row < mNumRowSets; ++row) {
-      const unsigned padOffset = timeBinWrapped * mPadsPerRowSet[row];
-      const unsigned previousPadOffset = previousTimeBinWrapped * mPadsPerRowSet[row];
-      // two empty pads on the left and right without a cluster peak
-      for (short pad = 2; pad < mPadsPerRowSet[row] - 2; ++pad) {
-        const unsigned qMaxIndex = padOffset + pad;
-        const unsigned qMaxPreviousIndex = previousPadOffset + pad;
-
-        // TODO: define needed difference
-        const auto peakMask = ((mDataBuffer[row][qMaxIndex] >> 27) == 0x1F) &                                              //  True if current pad is peak AND
-                              (getFpOfADC(mDataBuffer[row][qMaxIndex]) > getFpOfADC(mDataBuffer[row][qMaxPreviousIndex]) | // previous has smaller charge
-                               !((mDataBuffer[row][qMaxPreviousIndex] >> 27) == 0x1F));                                    //  or previous one was not a peak
-        if (peakMask.isEmpty()) {
-          continue;
-        }
-
-        hwClusterProcessor(peakMask, qMaxIndex, pad, timebin, row);
+    const unsigned previousPadOffset = previousTimeBinWrapped * mPadsPerRowSet[row];
+    // two empty pads on the left and right without a cluster peak
+    for (short pad = 2; pad < mPadsPerRowSet[row] - 2; ++pad) {
+      const unsigned qMaxIndex = padOffset + pad;
+      const unsigned qMaxPreviousIndex = previousPadOffset + pad;
+
+      // TODO: define needed difference
+      const auto peakMask = ((mDataBuffer[row][qMaxIndex] >> 27) == 0x1F) &                                              //  True if current pad is peak AND
+                            (getFpOfADC(mDataBuffer[row][qMaxIndex]) > getFpOfADC(mDataBuffer[row][qMaxPreviousIndex]) | // previous has smaller charge
+                             !((mDataBuffer[row][qMaxPreviousIndex] >> 27) == 0x1F));                                    //  or previous one was not a peak
+      if (peakMask.isEmpty()) {
+        continue;
       }
+
+      hwClusterProcessor(peakMask, qMaxIndex, pad, timebin, row);
     }
   } else {
-    for (unsigned short row = 0; row < mNumRowSets; ++row) {
-      const unsigned padOffset = timeBinWrapped * mPadsPerRowSet[row];
-      // two empty pads on the left and right without a cluster peak
-      for (short pad = 2; pad < mPadsPerRowSet[row] - 2; ++pad) {
-        const unsigned qMaxIndex = padOffset + pad;
-
-        const auto peakMask = ((mDataBuffer[row][qMaxIndex] >> 27) == 0x1F);
-        if (peakMask.isEmpty()) {
-          continue;
-        }
+    // two empty pads on the left and right without a cluster peak
+    for (short pad = 2; pad < mPadsPerRowSet[row] - 2; ++pad) {
+      const unsigned qMaxIndex = padOffset + pad;
 
-        hwClusterProcessor(peakMask, qMaxIndex, pad, timebin, row);
+      const auto peakMask = ((mDataBuffer[row][qMaxIndex] >> 27) == 0x1F);
+      if (peakMask.isEmpty()) {
+        continue;
       }
+
+      hwClusterProcessor(peakMask, qMaxIndex, pad, timebin, row);
     }
   }
 }
@@ -842,9 +878,7 @@ void HwClusterer::finishFrame(bool clear)
       writeOutputWithTimeOffset(mLastHB * 447);
     }
 
-    findPeaksForTime(i);
-    computeClusterForTime(i - 3);
-    clearBuffer(i + 1);
+    processTimebin(i);
     mLastHB = HB;
   }
   writeOutputWithTimeOffset(mLastHB * 447);
@@ -858,17 +892,30 @@ void HwClusterer::finishFrame(bool clear)
 
 //______________________________________________________________________________
 void HwClusterer::clearBuffer(int timebin)
+{
+  clearMCtruth(timebin);
+  for (unsigned short row = 0; row < mNumRowSets; ++row) {
+    clearRowSet(timebin, row);
+  }
+}
+
+//______________________________________________________________________________
+void HwClusterer::clearRowSet(int timebin, unsigned short row)
+{
+  const int wrappedTime = mapTimeInRange(timebin);
+  // reset timebin which is not needed anymore
+  std::fill(mDataBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row],
+            mDataBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row] + mPadsPerRowSet[row], 0);
+  std::fill(mIndexBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row],
+            mIndexBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row] + mPadsPerRowSet[row], -1);
+}
+
+//______________________________________________________________________________
+void HwClusterer::clearMCtruth(int timebin)
 {
   const int wrappedTime = mapTimeInRange(timebin);
   mMCtruth[wrappedTime].reset();
   mCurrentMcContainerInBuffer &= ~(0x1 << wrappedTime); // clear bit
-  for (unsigned short row = 0; row < mNumRowSets; ++row) {
-    // reset timebin which is not needed anymore
-    std::fill(mDataBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row],
-              mDataBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row] + mPadsPerRowSet[row], 0);
-    std::fill(mIndexBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row],
-              mIndexBuffer[row].begin() + wrappedTime * mPadsPerRowSet[row] + mPadsPerRowSet[row], -1);
-  }
 }
 
 //______________________________________________________________________________
@@ -29,9 +29,13 @@
 #include "Riostream.h"
 #include <fairlogger/Logger.h>
 
+#include <TStopwatch.h>
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <random>
+#include <algorithm>
+#include <numeric>
 
 using namespace o2::gpu;
 
@@ -94,6 +98,60 @@ BOOST_AUTO_TEST_CASE(FastTransform_test1)
   BOOST_CHECK(fabs(maxDy) < 1.e-5);
 }
 
+/// @brief Test 2 bulk transformation versus the transformation cluster by cluster
+BOOST_AUTO_TEST_CASE(FastTransform_test_bulk)
+{
+  std::unique_ptr<TPCFastTransform> fastTransformPtr(TPCFastTransformHelperO2::instance()->create(0));
+  const TPCFastTransform& fastTransform = *fastTransformPtr;
+  const TPCFastTransformGeo& geo = fastTransform.getGeometry();
+
+  // random clusters, processed in random order and grouped by slice and row as in the ClusterNativeAccess
+  const int nClusters = 1000000;
+  std::mt19937 rnd(12345);
+  std::vector<int> slice(nClusters), row(nClusters);
+  std::vector<float> pad(nClusters), time(nClusters);
+  for (int i = 0; i < nClusters; i++) {
+    slice[i] = rnd() % geo.getNumberOfSlices();
+    row[i] = rnd() % geo.getNumberOfRows();
+    pad[i] = std::uniform_real_distribution<float>(0.f, geo.getRowInfo(row[i]).maxPad)(rnd);
+    time[i] = std::uniform_real_distribution<float>(0.f, fastTransform.getMaxDriftTime(slice[i]))(rnd);
+  }
+  std::vector<int> grouped(nClusters);
+  std::iota(grouped.begin(), grouped.end(), 0);
+  std::stable_sort(grouped.begin(), grouped.end(), [&](int i, int j) { return slice[i] < slice[j] || (slice[i] == slice[j] && row[i] < row[j]); });
+
+  for (int iOrder = 0; iOrder < 2; iOrder++) {
+    std::vector<int> sliceT(nClusters), rowT(nClusters);
+    std::vector<float> padT(nClusters), timeT(nClusters);
+    for (int i = 0; i < nClusters; i++) {
+      int j = iOrder ? grouped[i] : i;
+      sliceT[i] = slice[j];
+      rowT[i] = row[j];
+      padT[i] = pad[j];
+      timeT[i] = time[j];
+    }
+    std::vector<float> x(nClusters), y(nClusters), z(nClusters), xB(nClusters), yB(nClusters), zB(nClusters);
+    TStopwatch sw;
+    sw.Start();
+    for (int i = 0; i < nClusters; i++) {
+      fastTransform.Transform(sliceT[i], rowT[i], padT[i], timeT[i], x[i], y[i], z[i]);
+    }
+    sw.Stop();
+    double tSingle = sw.RealTime();
+    sw.Start();
+    fastTransform.TransformBulk(nClusters, sliceT.data(), rowT.data(), padT.data(), timeT.data(), xB.data(), yB.data(), zB.data());
+    sw.Stop();
+    double tBulk = sw.RealTime();
+    LOG(info) << (iOrder ? "grouped" : "random order") << " clusters: per cluster " << nClusters / tSingle << " clusters/s, bulk " << nClusters / tBulk << " clusters/s";
+
+    float maxDiff = 0.f;
+    for (int i = 0; i < nClusters; i++) {
+      maxDiff = std::max({maxDiff, std::abs(x[i] - xB[i]), std::abs(y[i] - yB[i]), std::abs(z[i] - zB[i])});
+    }
+    BOOST_CHECK_SMALL(maxDiff, 1.e-4f);
+  }
+}
+
 #ifdef XXX
 BOOST_AUTO_TEST_CASE(FastTransform_test_setSpaceChargeCorrection)
 {
@@ -28,6 +28,8 @@
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <cstring>
+#include <random>
 
 using MCLabelContainer = o2::dataformats::MCLabelContainer;
 
@@ -1003,5 +1005,57 @@ BOOST_AUTO_TEST_CASE(HwClusterer_test6)
   std::cout << "##" << std::endl
             << std::endl;
 }
+
+/// @brief Test 7 Parallel processing of the row sets
+BOOST_AUTO_TEST_CASE(HwClusterer_test7)
+{
+  std::cout << "##" << std::endl;
+  std::cout << "## Starting test 7, parallel processing of the row sets." << std::endl;
+
+  // random digits in all rows of the sector, spanning several heartbeats
+  const Mapper& mapper = Mapper::instance();
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> charge(0, 100);
+  std::vector<Digit> digits;
+  MCLabelContainer labelContainer;
+  for (int time = 0; time < 600; ++time) {
+    for (int row = 0; row < mapper.getNumberOfRows(); ++row) {
+      for (int pad = 0; pad < mapper.getNumberOfPadsInRowSector(row); pad += 3 + (gen() % 8)) {
+        labelContainer.addElement(digits.size(), {int(gen() % 100), 0, 0, false});
+        digits.emplace_back(0, charge(gen), row, pad, time);
+      }
+    }
+  }
+  o2::dataformats::ConstMCTruthContainer<o2::MCCompLabel> flatLabels;
+  labelContainer.flatten_to(flatLabels);
+
+  std::array<std::vector<ClusterHardwareContainer8kb>, 2> clusterArrays;
+  std::array<MCLabelContainer, 2> labelArrays;
+  const std::array<int, 2> nThreads{1, 4};
+  for (int i = 0; i < 2; ++i) {
+    HwClusterer clusterer(&clusterArrays[i], 5, &labelArrays[i]);
+    clusterer.setNThreads(nThreads[i]);
+    clusterer.process(digits, flatLabels);
+    clusterer.finishProcess(std::vector<Digit>(), o2::dataformats::ConstMCTruthContainer<o2::MCCompLabel>(), false);
+  }
+
+  // the output must be identical, independent of the number of threads
+  BOOST_CHECK(clusterArrays[0].size() > 1);
+  BOOST_CHECK_EQUAL(clusterArrays[0].size(), clusterArrays[1].size());
+  for (size_t c = 0; c < std::min(clusterArrays[0].size(), clusterArrays[1].size()); ++c) {
+    BOOST_CHECK(std::memcmp(&clusterArrays[0][c], &clusterArrays[1][c], sizeof(ClusterHardwareContainer8kb)) == 0);
+  }
+  BOOST_CHECK_EQUAL(labelArrays[0].getIndexedSize(), labelArrays[1].getIndexedSize());
+  BOOST_CHECK_EQUAL(labelArrays[0].getNElements(), labelArrays[1].getNElements());
+  for (size_t l = 0; l < std::min(labelArrays[0].getIndexedSize(), labelArrays[1].getIndexedSize()); ++l) {
+    const auto labels0 = labelArrays[0].getLabels(l);
+    const auto labels1 = labelArrays[1].getLabels(l);
+    BOOST_CHECK(std::equal(labels0.begin(), labels0.end(), labels1.begin(), labels1.end()));
+  }
+
+  std::cout << "## Test 7 done." << std::endl;
+  std::cout << "##" << std::endl
+            << std::endl;
+}
 } // namespace tpc
 } // namespace o2
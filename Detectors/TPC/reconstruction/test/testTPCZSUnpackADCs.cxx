@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCZSUnpackADCs.cxx
+/// \brief Compares the group-wise unpacking of the ZS ADC values with the sample by sample bit accumulator
+
+#define BOOST_TEST_MODULE Test TPC ZS unpackADCs
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "CfUtils.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace GPUCA_NAMESPACE::gpu;
+
+namespace
+{
+// pack the values LSB first, as in the ZS payload
+std::vector<uint8_t> packADCs(const std::vector<uint16_t>& adcs, uint32_t nBits)
+{
+  std::vector<uint8_t> packed;
+  uint32_t byte = 0, bits = 0;
+  for (auto adc : adcs) {
+    byte |= uint32_t(adc) << bits;
+    bits += nBits;
+    while (bits >= 8) {
+      packed.push_back(byte & 0xFF);
+      byte >>= 8;
+      bits -= 8;
+    }
+  }
+  if (bits) {
+    packed.push_back(byte & 0xFF);
+  }
+  return packed;
+}
+
+// reference: the bit accumulator used by the decoders before, one sample at a time
+std::vector<uint16_t> unpackADCsBitByBit(const uint8_t* adcData, uint32_t nSamples, uint32_t nBits)
+{
+  std::vector<uint16_t> adcs(nSamples);
+  uint32_t byte = 0, bits = 0;
+  for (uint32_t i = 0; i < nSamples; i++) {
+    while (bits < nBits) {
+      byte |= uint32_t(*(adcData++)) << bits;
+      bits += 8;
+    }
+    adcs[i] = byte & ((1 << nBits) - 1);
+    byte >>= nBits;
+    bits -= nBits;
+  }
+  return adcs;
+}
+
+template <uint32_t NBits>
+void checkUnpacking()
+{
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<uint16_t> adcDist(0, (1 << NBits) - 1);
+  // all tails of the groups, odd numbers of samples and the maximum number of samples per row
+  std::vector<uint32_t> nSamplesList;
+  for (uint32_t n = 0; n <= 41; n++) {
+    nSamplesList.push_back(n);
+  }
+  nSamplesList.insert(nSamplesList.end(), {127, 253, 254, 255});
+  for (int iter = 0; iter < 10; iter++) {
+    for (auto nSamples : nSamplesList) {
+      std::vector<uint16_t> adcs(nSamples);
+      for (auto& adc : adcs) {
+        adc = adcDist(rng);
+      }
+      // the packed payload is followed by a guard which must not leak into the values
+      auto packed = packADCs(adcs, NBits);
+      const size_t nBytes = packed.size();
+      BOOST_REQUIRE(nBytes == (nSamples * NBits + 7) / 8);
+      packed.resize(nBytes + 8, 0xFF);
+
+      std::vector<uint16_t> unpacked(nSamples + 1, 0xABCD);
+      CfUtils::unpackADCs<NBits>(packed.data(), nSamples, unpacked.data());
+      BOOST_CHECK(unpacked[nSamples] == 0xABCD); // nothing written beyond nSamples
+      unpacked.resize(nSamples);
+
+      const auto reference = unpackADCsBitByBit(packed.data(), nSamples, NBits);
+      BOOST_CHECK(reference == adcs);
+      BOOST_CHECK_MESSAGE(unpacked == reference, "mismatch for " << NBits << " bit and " << nSamples << " samples");
+    }
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ZSUnpackADCs10bit)
+{
+  checkUnpacking<10>();
+}
+
+BOOST_AUTO_TEST_CASE(ZSUnpackADCs12bit)
+{
+  checkUnpacking<12>();
+}
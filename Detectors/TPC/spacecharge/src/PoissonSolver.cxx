@@ -1220,12 +1220,14 @@ template <typename DataT>
 void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
                                    const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const
 {
-  // Gauss-Seidel (Read Black}
+  // Gauss-Seidel (Red Black)
   if (MGParameters::relaxType == RelaxType::GaussSeidel) {
-    // for each slice
+    // in each pass only the vertices of one colour are updated, which depend only on the vertices of the other colour: the phi slices can be relaxed in parallel.
+    // Without symmetry and for an odd number of slices the first and the last slice are neighbours of the same colour, the last slice is then relaxed after the others as in the sequential sweep
+    const int nPhiParallel = ((symmetry == 0) && (iPhi % 2)) ? iPhi - 1 : iPhi;
     for (int iPass = 1; iPass <= 2; ++iPass) {
       const int msw = (iPass % 2) ? 1 : 2;
-      for (int m = 0; m < iPhi; ++m) {
+      auto relaxSlice = [&](const int m) {
         const int jsw = ((msw + m) % 2) ? 1 : 2;
         int mp1 = m + 1;
         int signPlus = 1;
@@ -1264,8 +1266,16 @@ void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matri
             (matricesCurrentV)(i, j, m) = (coefficient2[i] * (matricesCurrentV)(i - 1, j, m) + tempRatioZ * ((matricesCurrentV)(i, j - 1, m) + (matricesCurrentV)(i, j + 1, m)) + coefficient1[i] * (matricesCurrentV)(i + 1, j, m) + coefficient3[i] * (signPlus * (matricesCurrentV)(i, j, mp1) + signMinus * (matricesCurrentV)(i, j, mm1)) + (h2 * (matricesCurrentCharge)(i, j, m))) * coefficient4[i];
           } // end cols
         }   // end mParamGrid.NRVertices
-      }     // end phi
-    }       // end sweep
+      };
+
+#pragma omp parallel for num_threads(sNThreads)
+      for (int m = 0; m < nPhiParallel; ++m) {
+        relaxSlice(m);
+      } // end phi
+      if (nPhiParallel < iPhi) {
+        relaxSlice(iPhi - 1);
+      }
+    } // end sweep
   } else if (MGParameters::relaxType == RelaxType::Jacobi) {
     // for each slice
     for (int m = 0; m < iPhi; ++m) {
@@ -1323,8 +1333,10 @@ void PoissonSolver<DataT>::relax2D(Vector& matricesCurrentV, const Vector& matri
   if (MGParameters::relaxType == RelaxType::GaussSeidel) {
     int jsw = 1;
     for (int iPass = 1; iPass <= 2; ++iPass, jsw = 3 - jsw) {
-      int isw = jsw;
-      for (int j = 1; j < tnZColumn - 1; ++j, isw = 3 - isw) {
+      // the vertices of one colour depend only on the vertices of the other colour: the z columns of one pass are independent
+#pragma omp parallel for num_threads(sNThreads)
+      for (int j = 1; j < tnZColumn - 1; ++j) {
+        const int isw = (j % 2) ? jsw : 3 - jsw;
         for (int i = isw; i < tnRRow - 1; i += 2) {
           matricesCurrentV(i, j, iPhi) = tempFourth * (coefficient1[i] * matricesCurrentV(i + 1, j, iPhi) + coefficient2[i] * matricesCurrentV(i - 1, j, iPhi) +
                                                        tempRatio * (matricesCurrentV(i, j + 1, iPhi) + matricesCurrentV(i, j - 1, iPhi)) + (h2 * matricesCurrentCharge(i, j, iPhi)));
@@ -1262,11 +1262,11 @@ void SpaceCharge<DataT>::calcLocalDistortionsCorrections(const SpaceCharge<DataT
     initContainer(mLocalCorrdRPhi[side], true);
   }
 
-  // calculate local distortions/corrections for each vertex in the tpc
-#pragma omp parallel for num_threads(sNThreads)
+  // calculate local distortions/corrections for each vertex in the tpc. The drift lines (iPhi, iR) are distributed dynamically over the threads, each line fills contiguous memory of the containers
+#pragma omp parallel for collapse(2) schedule(dynamic) num_threads(sNThreads)
   for (size_t iPhi = 0; iPhi < mParamGrid.NPhiVertices; ++iPhi) {
-    const DataT phi = getPhiVertex(iPhi, side);
     for (size_t iR = 0; iR < mParamGrid.NRVertices; ++iR) {
+      const DataT phi = getPhiVertex(iPhi, side);
       const DataT radius = getRVertex(iR, side);
       for (size_t iZ = 0; iZ < mParamGrid.NZVertices - 1; ++iZ) {
         // set z coordinate depending on distortions or correction calculation
@@ -1382,10 +1382,10 @@ void SpaceCharge<DataT>::calcLocalDistortionsCorrectionsRK4(const SpaceCharge<Da
   }
   // see: https://en.wikipedia.org/wiki/Runge%E2%80%93Kutta_methods
   // calculate local distortions/corrections for each vertex in the tpc using Runge Kutta 4 method
-#pragma omp parallel for num_threads(sNThreads)
+#pragma omp parallel for collapse(2) schedule(dynamic) num_threads(sNThreads)
   for (size_t iPhi = 0; iPhi < mParamGrid.NPhiVertices; ++iPhi) {
-    const DataT phi = getPhiVertex(iPhi, side);
     for (size_t iR = 0; iR < mParamGrid.NRVertices; ++iR) {
+      const DataT phi = getPhiVertex(iPhi, side);
       const DataT radius = getRVertex(iR, side);
       for (size_t iZ = 0; iZ < mParamGrid.NZVertices - 1; ++iZ) {
         // set z coordinate depending on distortions or correction calculation
@@ -1508,10 +1508,10 @@ void SpaceCharge<DataT>::calcGlobalDistortions(const Fields& formulaStruct, cons
   initContainer(mGlobalDistdRPhi[side], true);
   const DataT stepSize = formulaStruct.getID() == 2 ? getGridSpacingZ(side) : getGridSpacingZ(side) / sSteps; // if one used local distortions then no smaller stepsize is needed. if electric fields are used then smaller stepsize can be used
   // loop over tpc volume and let the electron drift from each vertex to the readout of the tpc
-#pragma omp parallel for num_threads(sNThreads)
+#pragma omp parallel for collapse(2) schedule(dynamic) num_threads(sNThreads)
   for (size_t iPhi = 0; iPhi < mParamGrid.NPhiVertices; ++iPhi) {
-    const DataT phi0 = getPhiVertex(iPhi, side);
     for (size_t iR = 0; iR < mParamGrid.NRVertices; ++iR) {
+      const DataT phi0 = getPhiVertex(iPhi, side);
       const DataT r0 = getRVertex(iR, side);
       for (size_t iZ = 0; iZ < mParamGrid.NZVertices - 1; ++iZ) {
         const DataT z0 = getZVertex(iZ, side); // the electron starts at z0, r0, phi0
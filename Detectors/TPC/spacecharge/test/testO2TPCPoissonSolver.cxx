@@ -22,6 +22,7 @@
 #include "TPCSpaceCharge/SpaceChargeHelpers.h"
 #include "TPCSpaceCharge/PoissonSolverHelpers.h"
 #include "TPCSpaceCharge/DataContainer3D.h"
+#include <algorithm>
 
 namespace o2
 {
@@ -226,6 +227,36 @@ void poissonSolver2D()
   testAlmostEqualArray2D<DataT>(potentialAnalytical, potentialNumerical);
 }
 
+template <typename DataT>
+void poissonSolver3DThreads()
+{
+  // the red-black relaxation is parallelized over the colours: the potential has to be independent of the number of threads
+  using GridProp = GridProperties<DataT>;
+  const ParamSpaceCharge params{NR, NZ, NPHI};
+  const o2::tpc::RegularGrid3D<DataT> grid3D{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI), params};
+
+  using DataContainer = o2::tpc::DataContainer3D<DataT>;
+  DataContainer potentialSingle(NZ, NR, NPHI);
+  DataContainer charge(NZ, NR, NPHI);
+  const o2::tpc::AnalyticalFields<DataT> analyticalFields;
+  setChargeDensityFromFormula<DataT>(analyticalFields, grid3D, charge);
+  setPotentialBoundaryFromFormula<DataT>(analyticalFields, grid3D, potentialSingle);
+  DataContainer potentialMulti = potentialSingle;
+
+  const int nThreads = PoissonSolver<DataT>::getNThreads();
+  const int symmetry = 0;
+  PoissonSolver<DataT> poissonSolver(grid3D);
+  PoissonSolver<DataT>::setNThreads(1);
+  poissonSolver.poissonSolver3D(potentialSingle, charge, symmetry);
+  PoissonSolver<DataT>::setNThreads(std::max(nThreads, 4));
+  poissonSolver.poissonSolver3D(potentialMulti, charge, symmetry);
+  PoissonSolver<DataT>::setNThreads(nThreads);
+
+  for (size_t i = 0; i < potentialSingle.getNDataPoints(); ++i) {
+    BOOST_CHECK_EQUAL(potentialSingle[i], potentialMulti[i]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(PoissonSolver3D_test)
 {
   o2::tpc::MGParameters::isFull3D = true; // 3D
@@ -243,5 +274,11 @@ BOOST_AUTO_TEST_CASE(PoissonSolver2D_test)
   poissonSolver2D<DataT>();
 }
 
+BOOST_AUTO_TEST_CASE(PoissonSolver3D_threads_test)
+{
+  o2::tpc::MGParameters::isFull3D = true; // 3D
+  poissonSolver3DThreads<DataT>();
+}
+
 } // namespace tpc
 } // namespace o2
@@ -58,6 +58,7 @@ class TPCFactorizeIDCSpec : public o2::framework::Task
   {
     mUpdateGroupingPar = mLaneId == 0 ? !(ic.options().get<bool>("update-not-grouping-parameter")) : false;
     mIDCFactorization.setUsePadStatusMap(ic.options().get<bool>("enablePadStatusMap"));
+    mIDCFactorization.setStreamIDCs(ic.options().get<bool>("stream-IDCs"));
     mEnableWritingPadStatusMap = ic.options().get<bool>("enableWritingPadStatusMap");
     mNOrbitsIDC = ic.options().get<int>("orbits-IDCs");
     mDumpIDC0 = ic.options().get<bool>("dump-IDC0");
@@ -498,6 +499,7 @@ DataProcessorSpec getTPCFactorizeIDCSpec(const int lane, const std::vector<uint3
     Options{{"gainMapFile", VariantType::String, "", {"file to reference gain map, which will be used for correcting the cluster charge"}},
             {"enablePadStatusMap", VariantType::Bool, false, {"Enabling the usage of the pad-by-pad status map during factorization."}},
             {"enableWritingPadStatusMap", VariantType::Bool, false, {"Write the pad status map to CCDB."}},
+            {"stream-IDCs", VariantType::Bool, false, {"Normalize the IDCs and sum them up for IDC0 when they are received instead of at the end of the aggregation interval."}},
             {"orbits-IDCs", VariantType::Int, 12, {"Number of orbits over which the IDCs are integrated."}},
             {"dump-IDCs", VariantType::Bool, false, {"Dump IDCs to file"}},
             {"dump-IDC0", VariantType::Bool, false, {"Dump IDC0 to file"}},
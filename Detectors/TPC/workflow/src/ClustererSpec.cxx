@@ -20,6 +20,7 @@
 #include "Headers/DataHeader.h"
 #include "DataFormatsTPC/Digit.h"
 #include "TPCReconstruction/HwClusterer.h"
+#include "TPCReconstruction/HwClustererParam.h"
 #include "TPCBase/Sector.h"
 #include "DataFormatsTPC/TPCSectorHeader.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
@@ -48,8 +49,8 @@ DataProcessorSpec getClustererSpec(bool sendMC)
 
   constexpr static size_t NSectors = o2::tpc::Sector::MAXSECTOR;
   struct ProcessAttributes {
-    std::vector<o2::tpc::ClusterHardwareContainer8kb> clusterArray;
-    MCLabelContainer mctruthArray;
+    std::array<std::vector<o2::tpc::ClusterHardwareContainer8kb>, NSectors> clusterArrays;
+    std::array<MCLabelContainer, NSectors> mctruthArrays;
     std::array<std::shared_ptr<o2::tpc::HwClusterer>, NSectors> clusterers;
     int verbosity = 1;
     bool sendMC = false;
@@ -63,69 +64,52 @@ DataProcessorSpec getClustererSpec(bool sendMC)
     auto processAttributes = std::make_shared<ProcessAttributes>();
     processAttributes->sendMC = sendMC;
 
-    auto processSectorFunction = [processAttributes](ProcessingContext& pc, DataRef const& dataref, DataRef const& mclabelref) {
-      auto& clusterArray = processAttributes->clusterArray;
-      auto& mctruthArray = processAttributes->mctruthArray;
-      auto& clusterers = processAttributes->clusterers;
-      auto& verbosity = processAttributes->verbosity;
-      auto const* sectorHeader = DataRefUtils::getHeader<o2::tpc::TPCSectorHeader*>(dataref);
-      if (sectorHeader == nullptr) {
-        LOG(error) << "sector header missing on header stack";
-        return;
-      }
-      auto const* dataHeader = DataRefUtils::getHeader<o2::header::DataHeader*>(dataref);
-      o2::header::DataHeader::SubSpecificationType fanSpec = dataHeader->subSpecification;
+    struct SectorInput {
+      int sector = -1;
+      DataRef dataref;
+      DataRef mclabelref;
+      gsl::span<const o2::tpc::Digit> digits;
+      ConstMCLabelContainerView mcLabels;
+    };
 
-      const auto sector = sectorHeader->sector();
-      if (sector < 0) {
-        // forward the control information
-        // FIXME define and use flags in TPCSectorHeader
-        o2::tpc::TPCSectorHeader header{sector};
-        pc.outputs().snapshot(Output{gDataOriginTPC, "CLUSTERHW", fanSpec, {header}}, fanSpec);
-        if (DataRefUtils::isValid(mclabelref)) {
-          pc.outputs().snapshot(Output{gDataOriginTPC, "CLUSTERHWMCLBL", fanSpec, {header}}, fanSpec);
-        }
-        return;
-      }
-      ConstMCLabelContainerView inMCLabels;
-      if (DataRefUtils::isValid(mclabelref)) {
-        inMCLabels = pc.inputs().get<gsl::span<char>>(mclabelref);
-      }
-      auto inDigits = pc.inputs().get<gsl::span<o2::tpc::Digit>>(dataref);
-      if (verbosity > 0 && inMCLabels.getBuffer().size()) {
-        LOG(info) << "received " << inDigits.size() << " digits, "
-                  << inMCLabels.getIndexedSize() << " MC label objects"
-                  << " input MC label size " << DataRefUtils::getPayloadSize(mclabelref);
-      }
+    // clusterize the digits of one sector, the clusterers of different sectors have their own target arrays
+    // and can be invoked in parallel
+    auto processSectorFunction = [processAttributes](SectorInput const& input, int nThreads) {
+      const auto sector = input.sector;
+      auto& clusterers = processAttributes->clusterers;
       if (!clusterers[sector]) {
-        // create the clusterer for this sector, take the same target arrays for all clusterers
-        // as they are not invoked in parallel
         // the cost of creating the clusterer should be small so we do it in the processing
-        clusterers[sector] = std::make_shared<o2::tpc::HwClusterer>(&clusterArray, sector, &mctruthArray);
+        clusterers[sector] = std::make_shared<o2::tpc::HwClusterer>(&processAttributes->clusterArrays[sector], sector, &processAttributes->mctruthArrays[sector]);
         clusterers[sector]->init();
       }
       auto& clusterer = clusterers[sector];
+      clusterer->setNThreads(nThreads);
 
-      if (verbosity > 0) {
-        LOG(info) << "processing " << inDigits.size() << " digit object(s) of sector " << sectorHeader->sector()
-                  << " input size " << DataRefUtils::getPayloadSize(dataref);
-      }
       // process the digits and MC labels, the bool parameter controls whether to clear all
       // internal data or not. Have to clear it inside the process method as not only the containers
       // are cleared but also the cluster counter. Clearing the containers externally leaves the
       // cluster counter unchanged and leads to an inconsistency between cluster container and
       // MC label container (the latter just grows with every call).
-      clusterer->process(inDigits, inMCLabels, true /* clear output containers and cluster counter */);
+      clusterer->process(input.digits, input.mcLabels, true /* clear output containers and cluster counter */);
       const std::vector<o2::tpc::Digit> emptyDigits;
       ConstMCLabelContainerView emptyLabels;
       clusterer->finishProcess(emptyDigits, emptyLabels, false); // keep here the false, otherwise the clusters are lost of they are not stored in the meantime
-      if (verbosity > 0) {
+    };
+
+    // publish the clusters of one sector
+    auto publishSectorFunction = [processAttributes](ProcessingContext& pc, SectorInput const& input) {
+      auto& clusterArray = processAttributes->clusterArrays[input.sector];
+      auto& mctruthArray = processAttributes->mctruthArrays[input.sector];
+      auto const* sectorHeader = DataRefUtils::getHeader<o2::tpc::TPCSectorHeader*>(input.dataref);
+      auto const* dataHeader = DataRefUtils::getHeader<o2::header::DataHeader*>(input.dataref);
+      o2::header::DataHeader::SubSpecificationType fanSpec = dataHeader->subSpecification;
+      if (processAttributes->verbosity > 0) {
         LOG(info) << "clusterer produced "
                   << std::accumulate(clusterArray.begin(), clusterArray.end(), size_t(0), [](size_t l, auto const& r) { return l + r.getContainer()->numberOfClusters; })
                   << " cluster(s)"
                   << " for sector " << sectorHeader->sector()
                   << " total size " << sizeof(ClusterHardwareContainer8kb) * clusterArray.size();
-        if (DataRefUtils::isValid(mclabelref)) {
+        if (DataRefUtils::isValid(input.mclabelref)) {
           LOG(info) << "clusterer produced " << mctruthArray.getIndexedSize() << " MC label object(s) for sector " << sectorHeader->sector();
         }
       }
@@ -133,14 +117,14 @@ DataProcessorSpec getClustererSpec(bool sendMC)
       // block by using move semantics
       auto outputPages = pc.outputs().make<ClusterHardwareContainer8kb>(Output{gDataOriginTPC, "CLUSTERHW", fanSpec, {*sectorHeader}}, clusterArray.size());
       std::copy(clusterArray.begin(), clusterArray.end(), outputPages.begin());
-      if (DataRefUtils::isValid(mclabelref)) {
+      if (DataRefUtils::isValid(input.mclabelref)) {
         ConstMCLabelContainer mcflat;
         mctruthArray.flatten_to(mcflat);
         pc.outputs().snapshot(Output{gDataOriginTPC, "CLUSTERHWMCLBL", fanSpec, {*sectorHeader}}, mcflat);
       }
     };
 
-    auto processingFct = [processAttributes, processSectorFunction](ProcessingContext& pc) {
+    auto processingFct = [processAttributes, processSectorFunction, publishSectorFunction](ProcessingContext& pc) {
       struct SectorInputDesc {
         DataRef dataref;
         DataRef mclabelref;
@@ -166,11 +150,67 @@ DataProcessorSpec getClustererSpec(bool sendMC)
           inputs[sector].mclabelref = inputRef;
         }
       }
+
+      // collect the inputs of all sectors, the framework is only accessed from this thread
+      std::vector<SectorInput> sectorInputs;
       for (auto const& input : inputs) {
         if (processAttributes->sendMC && !DataRefUtils::isValid(input.second.mclabelref)) {
           throw std::runtime_error("missing the required MC label data for sector " + std::to_string(input.first));
         }
-        processSectorFunction(pc, input.second.dataref, input.second.mclabelref);
+        auto const& dataref = input.second.dataref;
+        auto const& mclabelref = input.second.mclabelref;
+        auto const* sectorHeader = DataRefUtils::getHeader<o2::tpc::TPCSectorHeader*>(dataref);
+        if (sectorHeader == nullptr) {
+          LOG(error) << "sector header missing on header stack";
+          continue;
+        }
+        const auto sector = sectorHeader->sector();
+        if (sector < 0) {
+          // forward the control information
+          // FIXME define and use flags in TPCSectorHeader
+          auto const* dataHeader = DataRefUtils::getHeader<o2::header::DataHeader*>(dataref);
+          o2::header::DataHeader::SubSpecificationType fanSpec = dataHeader->subSpecification;
+          o2::tpc::TPCSectorHeader header{sector};
+          pc.outputs().snapshot(Output{gDataOriginTPC, "CLUSTERHW", fanSpec, {header}}, fanSpec);
+          if (DataRefUtils::isValid(mclabelref)) {
+            pc.outputs().snapshot(Output{gDataOriginTPC, "CLUSTERHWMCLBL", fanSpec, {header}}, fanSpec);
+          }
+          continue;
+        }
+        auto& sectorInput = sectorInputs.emplace_back();
+        sectorInput.sector = sector;
+        sectorInput.dataref = dataref;
+        sectorInput.mclabelref = mclabelref;
+        if (DataRefUtils::isValid(mclabelref)) {
+          sectorInput.mcLabels = pc.inputs().get<gsl::span<char>>(mclabelref);
+        }
+        sectorInput.digits = pc.inputs().get<gsl::span<o2::tpc::Digit>>(dataref);
+        if (processAttributes->verbosity > 0 && sectorInput.mcLabels.getBuffer().size()) {
+          LOG(info) << "received " << sectorInput.digits.size() << " digits, "
+                    << sectorInput.mcLabels.getIndexedSize() << " MC label objects"
+                    << " input MC label size " << DataRefUtils::getPayloadSize(mclabelref);
+        }
+        if (processAttributes->verbosity > 0) {
+          LOG(info) << "processing " << sectorInput.digits.size() << " digit object(s) of sector " << sector
+                    << " input size " << DataRefUtils::getPayloadSize(dataref);
+        }
+      }
+
+      // with several sectors in the input, the sectors are processed in parallel, otherwise the
+      // threads are used to process the row sets of the single sector in parallel
+      const int nThreads = std::max(HwClustererParam::Instance().nThreads, 1);
+      const int nSectorInputs = sectorInputs.size();
+      const int nThreadsSector = (nSectorInputs > 1) ? 1 : nThreads;
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(nThreads) schedule(dynamic) if (nSectorInputs > 1 && nThreads > 1)
+#endif
+      for (int i = 0; i < nSectorInputs; ++i) {
+        processSectorFunction(sectorInputs[i], nThreadsSector);
+      }
+
+      // publish the clusters in sector order
+      for (auto const& sectorInput : sectorInputs) {
+        publishSectorFunction(pc, sectorInput);
       }
     };
     return processingFct;
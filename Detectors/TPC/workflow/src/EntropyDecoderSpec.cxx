@@ -81,6 +81,7 @@ DataProcessorSpec getEntropyDecoderSpec(int verbosity, unsigned int sspec)
             OutputSpec{{"ctfrep"}, "TPC", "CTFDECREP", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(verbosity)},
     Options{{"ctf-dict", VariantType::String, "ccdb", {"CTF dictionary: empty or ccdb=CCDB, none=no external dictionary otherwise: local filename"}},
+            {"ctf-threads", VariantType::Int, 1, {"number of threads for the concurrent decoding of the CTF blocks"}},
             {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
 }
 
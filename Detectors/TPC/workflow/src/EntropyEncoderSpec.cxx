@@ -78,6 +78,7 @@ void EntropyEncoderSpec::init(o2::framework::InitContext& ic)
   }
 
   mNThreads = ic.options().get<unsigned int>("nThreads-tpc-encoder");
+  mCTFCoder.setNThreads(mNThreads);
   mMaxZ = ic.options().get<float>("irframe-clusters-maxz");
   mMaxEta = ic.options().get<float>("irframe-clusters-maxeta");
 
@@ -333,6 +334,7 @@ DataProcessorSpec getEntropyEncoderSpec(bool inputFromFile, bool selIR)
             {"irframe-clusters-maxz", VariantType::Float, 25.f, {"Max z for non assigned clusters (combined with maxeta)"}},
             {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
             {"nThreads-tpc-encoder", VariantType::UInt32, 1u, {"number of threads to use for decoding"}},
+            {"ctf-dict-adaptive", VariantType::Bool, false, {"use the external dictionary only for the blocks it compresses better than a per-TF dictionary"}},
             {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
 }
 
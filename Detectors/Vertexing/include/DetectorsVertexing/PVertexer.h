@@ -69,6 +69,7 @@ class PVertexer
               const gsl::span<const o2::MCCompLabel> lblTracks, std::vector<o2::MCEventLabel>& lblVtx);
 
   int processFromExternalPool(const std::vector<TrackVF>& pool, std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs);
+  size_t clusterizeExternalPool(const std::vector<TrackVF>& pool); // run only DBScan TZ-clusterization, e.g. for benchmarking
 
   bool findVertex(const VertexingInput& input, PVertex& vtx);
 
@@ -134,6 +135,9 @@ class PVertexer
 
   void setPoolDumpDirectory(const std::string& d) { mPoolDumpDirectory = d; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   void printInpuTracksStatus(const VertexingInput& input) const;
 
  private:
@@ -147,12 +151,13 @@ class PVertexer
   void reduceDebris(std::vector<PVertex>& vertices, std::vector<int>& timeSort, const std::vector<o2::MCEventLabel>& lblVtx);
   FitStatus fitIteration(const VertexingInput& input, VertexSeed& vtxSeed);
   void finalizeVertex(const VertexingInput& input, const PVertex& vtx, std::vector<PVertex>& vertices, std::vector<V2TRef>& v2tRefs, std::vector<uint32_t>& trackIDs, SeedHistoTZ* histo = nullptr);
-  void accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const;
+  void accountTrack(TrackVF& trc, VertexSeed& vtxSeed, float chi2T) const;
   bool solveVertex(VertexSeed& vtxSeed) const;
   FitStatus evalIterations(VertexSeed& vtxSeed, PVertex& vtx) const;
   TimeEst timeEstimate(const VertexingInput& input) const;
   float findZSeedHistoPeak() const;
   void initMeanVertexConstraint();
+  void initDBScan();
   void applyConstraint(VertexSeed& vtxSeed) const;
   bool upscaleSigma(VertexSeed& vtxSeed) const;
   bool relateTrackToMeanVertex(o2::track::TrackParCov& trc, float vtxErr2);
@@ -189,6 +194,9 @@ class PVertexer
   float mBz = 0.;                           ///< mag.field at beam line
   float mDBScanDeltaT = 0.;                 ///< deltaT cut for DBScan check
   float mDBSMaxZ2InvCorePoint = 0;          ///< inverse of max sigZ^2 of the track which can be core point in the DBScan
+  float mDBSMaxDist = 0.;                   ///< sqrt of the DBScan distance^2 cut
+  TimeZIndex mDBSIndex;                     ///< time-Z index of the tracks pool for the DBScan range queries
+  std::vector<int> mDBSAccepted;            ///< neighbours accepted by the current DBScan range query
   bool mValidateWithIR = false;             ///< require vertex validation with InteractionCandidates (if available)
   o2::InteractionRecord mStartIR{0, 0};     ///< IR corresponding to the start of the TF
   // structure for the vertex refit
@@ -205,6 +213,7 @@ class PVertexer
   static constexpr float kHugeF = 1.e12;     ///< very large float
   static constexpr float kAlmost0F = 1e-12;  ///< tiny float
   static constexpr double kAlmost0D = 1e-16; ///< tiny double
+  int mNThreads = 1;
   int mNIniFound = 0;
   int mNKilledBCValid = 0;
   int mNKilledIntCand = 0;
@@ -16,6 +16,7 @@
 #ifndef O2_PVERTEXER_HELPERS_H
 #define O2_PVERTEXER_HELPERS_H
 
+#include <algorithm>
 #include "gsl/span"
 #include "ReconstructionDataFormats/PrimaryVertex.h"
 #include "ReconstructionDataFormats/Track.h"
@@ -217,6 +218,18 @@ struct TrackVF {
   ClassDefNV(TrackVF, 1);
 };
 
+/// SoA copy of the TrackVF parameters entering the track-to-vertex chi2, packed contiguously for the tested tracks
+struct TrackVFPoolSoA {
+  std::vector<float> x, y, z, sig2YI, sig2ZI, sigYZI, tgP, tgL, cosAlp, sinAlp, t, te;
+
+  // pack the parameters of the pool tracks with indices ids
+  void fill(const std::vector<TrackVF>& pool, const std::vector<int>& ids);
+  size_t size() const { return x.size(); }
+
+  // chi2 of all packed tracks to the vertex, bit-identical to the TrackVF::evalChi2ToVertex
+  void evalChi2ToVertex(const PVertex& vtx, bool useTime, float* __restrict__ chi2) const;
+};
+
 struct SeedHistoTZ : public o2::dataformats::FlatHisto2D_f {
   using o2::dataformats::FlatHisto2D<float>::FlatHisto2D;
 
@@ -251,6 +264,70 @@ struct TimeZCluster {
   TimeEst timeEst{};
 };
 
+/// Index of the tracks pool for the DBScan range queries: tracks are grouped in time slices of the DBScan deltaT width
+/// and in classes of their Z error, within each such cell they are sorted in Z. The neighbours of the track are then looked
+/// for by binary search in the Z-window allowed by the largest Z error of every cell of the adjacent time slices.
+struct TimeZIndex {
+  static constexpr int NSigZClasses = 8;       // Z error classes, the upper bound of each next class is 2 times larger
+  static constexpr float SigZClass0 = 50e-4f;  // upper bound of the 1st Z error class
+  struct Cell {
+    int first = 0;
+    int n = 0;
+    float maxSigZ = 0.f;
+  };
+  std::vector<Cell> cells; // cells of time slice it and Z error class ic are at it*NSigZClasses+ic
+  std::vector<float> zSorted;
+  std::vector<int> ids;
+  float tMin = 0.f;
+  float deltaT = 0.f;
+  float deltaTI = 0.f;
+  int nTBins = 0;
+
+  void build(const std::vector<TrackVF>& pool, float dT);
+
+  int getTBin(float t) const
+  {
+    int ib = int((t - tMin) * deltaTI);
+    return ib < 0 ? 0 : (ib < nTBins ? ib : nTBins - 1);
+  }
+
+  static int getSigZClass(float sig2ZI)
+  {
+    int cl = 0;
+    float lim2I = 1.f / (SigZClass0 * SigZClass0);
+    while (sig2ZI < lim2I && cl < NSigZClasses - 1) {
+      lim2I *= 1.f / 4;
+      cl++;
+    }
+    return cl;
+  }
+
+  /// call f(trackID) for every track within deltaT from t which may be at Z-distance < maxDist * sigZ_track from z.
+  /// This is a superset of the real neighbours, which must be validated by the caller
+  template <typename F>
+  void forEachCandidate(float t, float z, float maxDist, F&& f) const
+  {
+    if (!nTBins) {
+      return;
+    }
+    const float margT = 1e-3f * deltaT; // safety margin against the rounding
+    int tb0 = getTBin(t - deltaT - margT), tb1 = getTBin(t + deltaT + margT);
+    for (int tb = tb0; tb <= tb1; tb++) {
+      for (int ic = 0; ic < NSigZClasses; ic++) {
+        const auto& cell = cells[tb * NSigZClasses + ic];
+        if (!cell.n) {
+          continue;
+        }
+        float dz = maxDist * cell.maxSigZ * 1.001f + 1e-6f;
+        const float *zBeg = zSorted.data() + cell.first, *zEnd = zBeg + cell.n, zMax = z + dz;
+        for (auto zp = std::lower_bound(zBeg, zEnd, z - dz); zp < zEnd && *zp <= zMax; zp++) {
+          f(ids[zp - zSorted.data()]);
+        }
+      }
+    }
+  }
+};
+
 // structure to produce debug dump for neighbouring vertices comparison
 struct PVtxCompDump {
   PVertex vtx0{};
@@ -28,6 +28,7 @@
 #include "CommonDataFormat/RangeReference.h"
 #include "DataFormatsTPC/ClusterNativeHelper.h"
 #include "DCAFitter/DCAFitterN.h"
+#include "DCAFitter/DCAFitterBulk.h"
 #include "DetectorsVertexing/SVertexerParams.h"
 #include "DetectorsVertexing/SVertexHypothesis.h"
 #include "StrangenessTracking/StrangenessTracker.h"
@@ -187,6 +188,9 @@ class SVertexer
   std::vector<std::vector<Decay3BodyIndex>> m3bodyIdxTmp;
   std::array<std::vector<TrackCand>, 2> mTracksPool{}; // pools of positive and negative seeds sorted in min VtxID
   std::array<std::vector<int>, 2> mVtxFirstTrack{};    // 1st pos. and neg. track of the pools for each vertex
+  std::array<TrackCirclesSoA, 2> mTracksPoolCircles{}; // circle params of the pools tracks for the V0 pairs prefiltering
+  std::vector<std::vector<int>> mV0PartnersTmp;        // per thread neg. tracks to pair with the current pos. one
+  std::vector<std::vector<uint8_t>> mV0PartnersMaskTmp; // per thread selection mask of these pairs
 
   o2::dataformats::VertexBase mMeanVertex{{0., 0., 0.}, {0.1 * 0.1, 0., 0.1 * 0.1, 0., 0., 6. * 6.}};
   const SVertexerParams* mSVParams = nullptr;
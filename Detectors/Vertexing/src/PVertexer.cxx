@@ -22,6 +22,10 @@
 #include "CommonUtils/StringUtils.h"
 #include <TH2F.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::vertexing;
 using DetID = o2::detectors::DetID;
 constexpr float PVertexer::kAlmost0F;
@@ -63,9 +67,22 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
   mTimeVertexing.Start();
-  int cntTZ = 0;
-  for (auto tc : mTimeZClusters) {
-    size_t nnold = verticesLoc.size();
+  // TZ-clusters are disjoint sets of tracks, hence can be processed in parallel, the results are merged in the clusters order
+  int nTZClusters = mTimeZClusters.size(), nThreads = mNThreads;
+#ifdef _PV_DEBUG_TREE_
+  nThreads = 1; // debug output is not thread-safe
+#endif
+  struct ClusterOutput {
+    std::vector<PVertex> vertices;
+    std::vector<uint32_t> trackIDs;
+    std::vector<V2TRef> v2tRefs;
+  };
+  std::vector<ClusterOutput> clusOutput(nTZClusters);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int itc = 0; itc < nTZClusters; itc++) {
+    auto& tc = mTimeZClusters[itc];
     VertexingInput inp;
     inp.idRange = gsl::span<int>(tc.trackIDs);
     inp.scaleSigma2 = mPVParams->iniScale2;
@@ -73,7 +90,20 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
 #ifdef _PV_DEBUG_TREE_
     doDBScanDump(inp, lblTracks);
 #endif
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
+    auto& out = clusOutput[itc];
+    findVertices(inp, out.vertices, out.trackIDs, out.v2tRefs);
+  }
+  for (auto& out : clusOutput) {
+    int vtxOffs = verticesLoc.size(), trOffs = trackIDs.size();
+    for (auto& ref : out.v2tRefs) {
+      ref.setFirstEntry(ref.getFirstEntry() + trOffs);
+      v2tRefsLoc.push_back(ref);
+    }
+    for (auto id : out.trackIDs) {
+      mTracksPool[id].vtxID += vtxOffs;
+      trackIDs.push_back(id);
+    }
+    verticesLoc.insert(verticesLoc.end(), out.vertices.begin(), out.vertices.end());
   }
   mTimeVertexing.Stop();
   // sort in time
@@ -223,19 +253,27 @@ int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& v
     auto clTime = tCurr - tStart;
     if (clTime > mPVParams->maxTimeMSPerCluster) {
       LOGP(warn, "Time per TZ-cluster ({}ms) of {} tracks exceeded limit after {} trials, abandon", clTime, mult, nTrials);
+#ifdef WITH_OPENMP
+#pragma omp critical(PVertexerPoolDump)
+#endif
       if (!mPoolDumpProduced) {
         dumpPool();
       }
       break;
     }
   }
-  mTotTrials += nTrials;
-  if (size_t(nTrials) > mMaxTrialPerCluster) {
-    mMaxTrialPerCluster = nTrials;
-  }
-  if (tCurr - tStart > mLongestClusterTimeMS) {
-    mLongestClusterTimeMS = tCurr - tStart;
-    mLongestClusterMult = mult;
+#ifdef WITH_OPENMP
+#pragma omp critical(PVertexerStat)
+#endif
+  {
+    mTotTrials += nTrials;
+    if (size_t(nTrials) > mMaxTrialPerCluster) {
+      mMaxTrialPerCluster = nTrials;
+    }
+    if (tCurr - tStart > mLongestClusterTimeMS) {
+      mLongestClusterTimeMS = tCurr - tStart;
+      mLongestClusterMult = mult;
+    }
   }
   return nfound;
 }
@@ -294,15 +332,25 @@ bool PVertexer::findVertex(const VertexingInput& input, PVertex& vtx)
 //___________________________________________________________________
 PVertexer::FitStatus PVertexer::fitIteration(const VertexingInput& input, VertexSeed& vtxSeed)
 {
-  int nTested = 0;
+  // the usable tracks are packed contiguously, their chi2 is evaluated in unit-stride loops which the compiler can vectorize,
+  // then the tracks are accounted in their original order, so that the result does not depend on the vectorization
+  thread_local std::vector<int> ids;
+  thread_local std::vector<float> chi2s;
+  thread_local TrackVFPoolSoA tested;
+  ids.clear();
   for (int i : input.idRange) {
     if (mTracksPool[i].canUse()) {
-      accountTrack(mTracksPool[i], vtxSeed);
-      //      printf("#%d z:%f t:%f te:%f w:%f wh:%f\n", nTested, mTracksPool[i].z, mTracksPool[i].timeEst.getTimeStamp(),
-      //             mTracksPool[i].timeEst.getTimeStampError(), mTracksPool[i].wgh, mTracksPool[i].wghHisto);
-      nTested++;
+      ids.push_back(i);
     }
   }
+  int nTested = ids.size();
+  tested.fill(mTracksPool, ids);
+  chi2s.resize(nTested);
+  bool useTime = vtxSeed.getTimeStamp().getTimeStampError() >= 0.f;
+  tested.evalChi2ToVertex(vtxSeed, useTime && mPVParams->useTimeInChi2, chi2s.data());
+  for (int it = 0; it < nTested; it++) {
+    accountTrack(mTracksPool[ids[it]], vtxSeed, chi2s[it]);
+  }
 
   vtxSeed.maxScaleSigma2Tested = vtxSeed.scaleSigma2;
   if (vtxSeed.getNContributors() < mPVParams->minTracksPerVtx) {
@@ -318,11 +366,10 @@ PVertexer::FitStatus PVertexer::fitIteration(const VertexingInput& input, Vertex
 }
 
 //___________________________________________________________________
-void PVertexer::accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const
+void PVertexer::accountTrack(TrackVF& trc, VertexSeed& vtxSeed, float chi2T) const
 {
-  // deltas defined as track - vertex
+  // deltas defined as track - vertex, chi2T is the track-to-vertex chi2
   bool useTime = vtxSeed.getTimeStamp().getTimeStampError() >= 0.f;
-  auto chi2T = trc.evalChi2ToVertex(vtxSeed, useTime && mPVParams->useTimeInChi2);
   float wghT = (1.f - chi2T * vtxSeed.scaleSig2ITuk2I); // weighted distance to vertex
   if (wghT < kAlmost0F) {
     trc.wgh = 0.f;
@@ -812,6 +859,14 @@ TimeEst PVertexer::timeEstimate(const VertexingInput& input) const
   return {t, te2};
 }
 
+//___________________________________________________________________
+void PVertexer::initDBScan()
+{
+  mDBScanDeltaT = mPVParams->dbscanDeltaT > 0.f ? mPVParams->dbscanDeltaT : mITSROFrameLengthMUS * (-mPVParams->dbscanDeltaT);
+  mDBSMaxZ2InvCorePoint = mPVParams->dbscanMaxSigZCorPoint > 0 ? 1. / (mPVParams->dbscanMaxSigZCorPoint * mPVParams->dbscanMaxSigZCorPoint) : 1e6;
+  mDBSMaxDist = std::sqrt(mPVParams->dbscanMaxDist2);
+}
+
 //___________________________________________________________________
 void PVertexer::init()
 {
@@ -820,8 +875,7 @@ void PVertexer::init()
   setTukey(mPVParams->tukey);
   auto* prop = o2::base::Propagator::Instance();
   setBz(prop->getNominalBz());
-  mDBScanDeltaT = mPVParams->dbscanDeltaT > 0.f ? mPVParams->dbscanDeltaT : mITSROFrameLengthMUS * (-mPVParams->dbscanDeltaT);
-  mDBSMaxZ2InvCorePoint = mPVParams->dbscanMaxSigZCorPoint > 0 ? 1. / (mPVParams->dbscanMaxSigZCorPoint * mPVParams->dbscanMaxSigZCorPoint) : 1e6;
+  initDBScan();
 
   mMaxTDiffDebris = mPVParams->maxTDiffDebris < 0 ? mITSROFrameLengthMUS * (-mPVParams->maxTDiffDebris) : mPVParams->maxTDiffDebris;
   mMaxTDiffDebrisExtra = mPVParams->maxTDiffDebrisExtra == 0 ? -1 : (mPVParams->maxTDiffDebrisExtra < 0 ? mITSROFrameLengthMUS * (-mPVParams->maxTDiffDebrisExtra) : mPVParams->maxTDiffDebrisExtra);
@@ -1028,38 +1082,36 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
   if (tI.sig2ZI < mDBSMaxZ2InvCorePoint) {
     return nFound;
   }
-  int ntr = mTracksPool.size();
-
-  auto procPnt = [this, &tI, &status, &cand, &nFound, id](int idN) {
+  // the candidates are provided by the time-Z index, the accepted ones are added in the order of the linear scan
+  // of the time-sorted pool (first decreasing indices, then increasing ones) to keep the clusterization result unchanged
+  auto& accepted = mDBSAccepted;
+  accepted.clear();
+  mDBSIndex.forEachCandidate(tI.timeEst.getTimeStamp(), tI.z, mDBSMaxDist, [this, &tI, &status, &accepted, &nFound, id](int idN) {
+    if (idN == id) {
+      return;
+    }
     const auto& tL = this->mTracksPool[idN];
     if (std::abs(tI.timeEst.getTimeStamp() - tL.timeEst.getTimeStamp()) > this->mDBScanDeltaT) {
-      return -1;
+      return;
     }
     auto statN = status[idN], stat = status[id];
     if (statN >= 0 && (stat < 0 || (stat >= 0 && statN != stat))) { // do not consider as a neighbour if already added to other cluster
-      return 0;
+      return;
     }
     auto dist2 = tL.getDist2(tI);
     if (dist2 < this->mPVParams->dbscanMaxDist2) {
       nFound++;
       if (statN < 0 && statN > DBS_INCHECK) { // no point in adding for check already assigned point, or which is already in the list (i.e. < INCHECK)
-        cand.push_back(idN);
-        status[idN] += DBS_INCHECK; // flag that the track is in the candidates list (i.e. DBS_UDEF-10 = -12 or DPB_NOISE-10 = -11).
+        accepted.push_back(idN);
       }
     }
-    return 1;
-  };
-  int idL = id;
-  while (--idL >= 0) { // index in time decreasing direction
-    if (procPnt(idL) < 0) {
-      break;
-    }
-  }
-  int idU = id;
-  while (++idU < ntr) { // index in time increasing direction
-    if (procPnt(idU) < 0) {
-      break;
-    }
+  });
+  std::sort(accepted.begin(), accepted.end());
+  auto upper = std::lower_bound(accepted.begin(), accepted.end(), id);
+  std::reverse(accepted.begin(), upper);
+  for (auto idN : accepted) {
+    cand.push_back(idN);
+    status[idN] += DBS_INCHECK; // flag that the track is in the candidates list (i.e. DBS_UDEF-10 = -12 or DPB_NOISE-10 = -11).
   }
   return nFound;
 }
@@ -1069,6 +1121,7 @@ void PVertexer::dbscan_clusterize()
 {
   mTimeZClusters.clear();
   int ntr = mTracksPool.size();
+  mDBSIndex.build(mTracksPool, mDBScanDeltaT);
   std::vector<int> status(ntr, DBS_UNDEF);
   int clID = -1;
 
@@ -1379,6 +1432,34 @@ int PVertexer::processFromExternalPool(const std::vector<TrackVF>& pool, std::ve
   return runVertexing(gids, intCand, vertices, vertexTrackIDs, v2tRefs, lblTracks, lblVtx);
 }
 
+//______________________________________________
+size_t PVertexer::clusterizeExternalPool(const std::vector<TrackVF>& pool)
+{
+  if (!mPVParams) { // no full initialization is needed for the clusterization only
+    mPVParams = &PVertexerParams::Instance();
+    initDBScan();
+  }
+  mTracksPool = pool;
+  for (auto& tr : mTracksPool) {
+    tr.vtxID = TrackVF::kNoVtx;
+    tr.wgh = 0.;
+  }
+  mTimeDBScan.Start(false);
+  dbscan_clusterize();
+  mTimeDBScan.Stop();
+  return mNTZClustersIni;
+}
+
+//______________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 void PVertexer::setTrackSources(GTrackID::mask_t s)
 {
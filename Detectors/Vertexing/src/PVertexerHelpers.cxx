@@ -14,6 +14,8 @@
 /// \author ruben.shahoyan@cern.ch
 
 #include "DetectorsVertexing/PVertexerHelpers.h"
+#include <cmath>
+#include <limits>
 
 using namespace o2::vertexing;
 
@@ -60,3 +62,106 @@ void TrackVF::reportBadTrack(const o2::track::TrackParCov& src, const TimeEst& t
     LOG(warn) << msg;
   }
 }
+
+void TrackVFPoolSoA::fill(const std::vector<TrackVF>& pool, const std::vector<int>& ids)
+{
+  size_t n = ids.size();
+  for (auto* v : {&x, &y, &z, &sig2YI, &sig2ZI, &sigYZI, &tgP, &tgL, &cosAlp, &sinAlp, &t, &te}) {
+    v->resize(n);
+  }
+  for (size_t k = 0; k < n; k++) {
+    const auto& trc = pool[ids[k]];
+    x[k] = trc.x;
+    y[k] = trc.y;
+    z[k] = trc.z;
+    sig2YI[k] = trc.sig2YI;
+    sig2ZI[k] = trc.sig2ZI;
+    sigYZI[k] = trc.sigYZI;
+    tgP[k] = trc.tgP;
+    tgL[k] = trc.tgL;
+    cosAlp[k] = trc.cosAlp;
+    sinAlp[k] = trc.sinAlp;
+    t[k] = trc.timeEst.getTimeStamp();
+    te[k] = trc.timeEst.getTimeStampError();
+  }
+}
+
+void TrackVFPoolSoA::evalChi2ToVertex(const PVertex& vtx, bool useTime, float* __restrict__ chi2) const
+{
+  // branch-free loops with unit stride over the packed tracks, the operations and their precision follow exactly TrackVF::evalChi2ToVertex
+  // the arrays are accessed via local pointers, since the chi2 stores could otherwise alias the vectors data pointers
+  constexpr float NDOF2I = 1. / 2, NDOF3I = 1. / 3;
+  const float vx = vtx.getX(), vy = vtx.getY(), vz = vtx.getZ();
+  const float *x = this->x.data(), *y = this->y.data(), *z = this->z.data(), *tgP = this->tgP.data(), *tgL = this->tgL.data();
+  const float *sig2YI = this->sig2YI.data(), *sig2ZI = this->sig2ZI.data(), *sigYZI = this->sigYZI.data();
+  const float *cosAlp = this->cosAlp.data(), *sinAlp = this->sinAlp.data(), *t = this->t.data(), *te = this->te.data();
+  const int n = size();
+  for (int i = 0; i < n; i++) {
+    float dx = vx * cosAlp[i] + vy * sinAlp[i] - x[i]; // VX rotated to track frame - trackX
+    float dy = y[i] + tgP[i] * dx - (-vx * sinAlp[i] + vy * cosAlp[i]);
+    float dz = z[i] + tgL[i] * dx - vz;
+    chi2[i] = (dy * dy * sig2YI[i] + dz * dz * sig2ZI[i]) + 2. * dy * dz * sigYZI[i];
+  }
+  if (useTime) {
+    const float vt = vtx.getTimeStamp().getTimeStamp();
+    for (int i = 0; i < n; i++) {
+      float dt = t[i] - vt;
+      chi2[i] += dt * dt / (te[i] * te[i]);
+      chi2[i] *= NDOF3I;
+    }
+  } else {
+    for (int i = 0; i < n; i++) {
+      chi2[i] *= NDOF2I;
+    }
+  }
+}
+
+void TimeZIndex::build(const std::vector<TrackVF>& pool, float dT)
+{
+  cells.clear();
+  zSorted.clear();
+  ids.clear();
+  nTBins = 0;
+  int ntr = pool.size();
+  if (!ntr) {
+    return;
+  }
+  deltaT = dT;
+  deltaTI = dT > 0.f ? 1.f / dT : 0.f;
+  tMin = pool.front().timeEst.getTimeStamp();
+  float tMax = tMin;
+  for (const auto& trc : pool) {
+    tMin = std::min(tMin, trc.timeEst.getTimeStamp());
+    tMax = std::max(tMax, trc.timeEst.getTimeStamp());
+  }
+  nTBins = 1 + int((tMax - tMin) * deltaTI);
+  cells.resize(nTBins * NSigZClasses);
+  // count tracks per cell, then fill the cells in place
+  std::vector<int> cellID(ntr);
+  for (int i = 0; i < ntr; i++) {
+    const auto& trc = pool[i];
+    cellID[i] = getTBin(trc.timeEst.getTimeStamp()) * NSigZClasses + getSigZClass(trc.sig2ZI);
+    auto& cell = cells[cellID[i]];
+    cell.n++;
+    cell.maxSigZ = std::max(cell.maxSigZ, trc.sig2ZI > 0.f ? 1.f / std::sqrt(trc.sig2ZI) : std::numeric_limits<float>::max());
+  }
+  int first = 0;
+  for (auto& cell : cells) {
+    cell.first = first;
+    first += cell.n;
+    cell.n = 0;
+  }
+  ids.resize(ntr);
+  for (int i = 0; i < ntr; i++) {
+    auto& cell = cells[cellID[i]];
+    ids[cell.first + cell.n++] = i;
+  }
+  zSorted.resize(ntr);
+  for (const auto& cell : cells) {
+    auto idBeg = ids.begin() + cell.first, idEnd = idBeg + cell.n;
+    std::sort(idBeg, idEnd, [&pool](int a, int b) { return pool[a].z < pool[b].z; });
+    for (int k = cell.first; k < cell.first + cell.n; k++) {
+      zSorted[k] = pool[ids[k]].z;
+    }
+  }
+}
@@ -51,6 +51,13 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData, o2::f
     mStrTracker->loadData(recoData);
     mStrTracker->prepareITStracks();
   }
+  // the pairs with circles too far in XY are rejected in a vectorized loop before calling the fitter
+  float bz = mFitterV0[0].getBz(), maxDXYIni = mFitterV0[0].getMaxDXYIni();
+  if (mSVParams->mTPCTrackPhotonTune) {
+    maxDXYIni = std::max(maxDXYIni, mSVParams->mTPCTrackMaxDXYIni > 0 ? mSVParams->mTPCTrackMaxDXYIni : 1e9f);
+  }
+  mTracksPoolCircles[POS].fill(mTracksPool[POS], bz);
+  mTracksPoolCircles[NEG].fill(mTracksPool[NEG], bz);
 #ifdef WITH_OPENMP
   int dynGrp = std::min(4, std::max(1, mNThreads / 2));
 #pragma omp parallel for schedule(dynamic, dynGrp) num_threads(mNThreads)
@@ -62,6 +69,14 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData, o2::f
       LOG(debug) << "No partner is found for pos.track " << itp << " out of " << ntrP;
       continue;
     }
+#ifdef WITH_OPENMP
+    int iThread = omp_get_thread_num();
+#else
+    int iThread = 0;
+#endif
+    auto& partners = mV0PartnersTmp[iThread];
+    auto& mask = mV0PartnersMaskTmp[iThread];
+    partners.clear();
     for (int itn = firstN; itn < ntrN; itn++) { // start from the 1st negative track of lowest-ID vertex of positive
       auto& seedN = mTracksPool[NEG][itn];
       if (seedN.vBracket > seedP.vBracket) { // all vertices compatible with seedN are in future wrt that of seedP
@@ -71,12 +86,16 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData, o2::f
       if (mSVParams->maxPVContributors < 2 && seedP.gid.isPVContributor() + seedN.gid.isPVContributor() > mSVParams->maxPVContributors) {
         continue;
       }
-#ifdef WITH_OPENMP
-      int iThread = omp_get_thread_num();
-#else
-      int iThread = 0;
-#endif
-      checkV0(seedP, seedN, itp, itn, iThread);
+      partners.push_back(itn);
+    }
+    mask.resize(partners.size());
+    if (!selectPairsXY(mTracksPoolCircles[POS], itp, mTracksPoolCircles[NEG], partners.data(), partners.size(), maxDXYIni, mask.data())) {
+      continue;
+    }
+    for (size_t ip = 0; ip < partners.size(); ip++) {
+      if (mask[ip]) {
+        checkV0(seedP, mTracksPool[NEG][partners[ip]], itp, partners[ip], iThread);
+      }
     }
   }
 
@@ -346,6 +365,8 @@ void SVertexer::setupThreads()
   mCascadesIdxTmp.resize(mNThreads);
   m3bodyIdxTmp.resize(mNThreads);
   mFitterV0.resize(mNThreads);
+  mV0PartnersTmp.resize(mNThreads);
+  mV0PartnersMaskTmp.resize(mNThreads);
   mBz = o2::base::Propagator::Instance()->getNominalBz();
   int fitCounter = 0;
   for (auto& fitter : mFitterV0) {
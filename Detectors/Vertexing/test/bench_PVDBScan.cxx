@@ -0,0 +1,67 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_PVDBScan.cxx
+/// \brief Benchmark of the PVertexer DBScan TZ-clusterization on synthetic tracks pools
+
+#include "benchmark/benchmark.h"
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include "DetectorsVertexing/PVertexer.h"
+
+using namespace o2::vertexing;
+
+// Pool of tracks from collisions uniformly distributed over the TF duration, sorted in time as the PVertexer one.
+std::vector<TrackVF> generatePool(int nTracks, int multPerVertex = 50)
+{
+  constexpr float TFDurationMUS = 11400.f; // 128 orbits
+  std::mt19937 mt(12345);
+  std::uniform_real_distribution<float> distT(0.f, TFDurationMUS);
+  std::normal_distribution<float> distZV(0.f, 6.f), gaus(0.f, 1.f);
+  std::uniform_real_distribution<float> distLogSigZ(std::log(20e-4f), std::log(0.5f));
+  std::uniform_real_distribution<float> distSigT(0.1f, 2.5f);
+
+  std::vector<TrackVF> pool;
+  pool.reserve(nTracks);
+  float tv = 0.f, zv = 0.f;
+  for (int i = 0; i < nTracks; i++) {
+    if (i % multPerVertex == 0) {
+      tv = distT(mt);
+      zv = distZV(mt);
+    }
+    auto& trc = pool.emplace_back();
+    float sigZ = std::exp(distLogSigZ(mt)), sigT = distSigT(mt);
+    trc.z = zv + sigZ * gaus(mt);
+    trc.sig2ZI = 1.f / (sigZ * sigZ);
+    trc.timeEst = TimeEst{tv + sigT * gaus(mt), sigT};
+    trc.entry = i;
+  }
+  std::sort(pool.begin(), pool.end(), [](const TrackVF& a, const TrackVF& b) { return a.timeEst.getTimeStamp() < b.timeEst.getTimeStamp(); });
+  return pool;
+}
+
+static void BM_DBScanClusterize(benchmark::State& state)
+{
+  auto pool = generatePool(state.range(0));
+  PVertexer vertexer;
+  vertexer.setITSROFrameLength(5.f);
+  size_t nClusters = 0;
+  for (auto _ : state) {
+    nClusters = vertexer.clusterizeExternalPool(pool);
+  }
+  state.counters["clusters"] = nClusters;
+  state.SetItemsProcessed(state.iterations() * pool.size());
+}
+
+BENCHMARK(BM_DBScanClusterize)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,249 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testPVDBScan.cxx
+/// \brief Compares the PVertexer DBScan TZ-clusters found with the time-Z index to those of the linear range query
+
+#define BOOST_TEST_MODULE Test PVertexer DBScan
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsVertexing/PVertexer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace o2::vertexing;
+
+namespace
+{
+constexpr float ITSROFrameLengthMUS = 5.f;
+
+// reference: DBScan clusterization with the range query scanning linearly the time-sorted pool within deltaT of the seed,
+// as it was done before the time-Z index
+class LinearDBScan
+{
+ public:
+  LinearDBScan(const std::vector<TrackVF>& pool) : mPool(pool), mParams(PVertexerParams::Instance())
+  {
+    mDeltaT = mParams.dbscanDeltaT > 0.f ? mParams.dbscanDeltaT : ITSROFrameLengthMUS * (-mParams.dbscanDeltaT);
+    mMaxZ2InvCorePoint = mParams.dbscanMaxSigZCorPoint > 0 ? 1. / (mParams.dbscanMaxSigZCorPoint * mParams.dbscanMaxSigZCorPoint) : 1e6;
+  }
+
+  float getDeltaT() const { return mDeltaT; }
+
+  std::vector<std::vector<int>> clusterize()
+  {
+    std::vector<std::vector<int>> clusters;
+    int ntr = mPool.size();
+    std::vector<int> status(ntr, UNDEF);
+    int clID = -1;
+    std::vector<int> nbVec;
+    for (int it = 0; it < ntr; it++) {
+      if (status[it] != UNDEF) {
+        continue;
+      }
+      nbVec.clear();
+      auto nnb0 = rangeQuery(it, nbVec, status);
+      int minNeighbours = mParams.minTracksPerVtx - 1;
+      if (nnb0 < minNeighbours) {
+        status[it] = NOISE;
+        continue;
+      }
+      if (nnb0 > minNeighbours) {
+        minNeighbours = std::max(minNeighbours, int(nnb0 * mParams.dbscanAdaptCoef));
+      }
+      status[it] = ++clID;
+      auto& clusVec = clusters.emplace_back();
+      clusVec.push_back(it);
+      for (int j = 0; j < nnb0; j++) {
+        int jt = nbVec[j];
+        auto statjt = status[jt];
+        if (statjt >= 0) {
+          continue;
+        }
+        status[jt] = clID;
+        clusVec.push_back(jt);
+        if (statjt == NOISE + INCHECK) {
+          continue;
+        }
+        int ncurr = nbVec.size();
+        if (clusVec.size() > minNeighbours) {
+          minNeighbours = std::max(minNeighbours, int(clusVec.size() * mParams.dbscanAdaptCoef));
+        }
+        auto nnb1 = rangeQuery(jt, nbVec, status);
+        if (nnb1 < minNeighbours) {
+          for (unsigned k = ncurr; k < nbVec.size(); k++) {
+            if (status[nbVec[k]] < INCHECK) {
+              status[nbVec[k]] -= INCHECK;
+            }
+          }
+          nbVec.resize(ncurr);
+        } else {
+          nnb0 = nbVec.size();
+        }
+      }
+    }
+    for (auto& clus : clusters) {
+      if (clus.size() < mParams.minTracksPerVtx) {
+        clus.clear();
+      }
+    }
+    return clusters;
+  }
+
+ private:
+  static constexpr int UNDEF = -2, NOISE = -1, INCHECK = -10;
+
+  int rangeQuery(int id, std::vector<int>& cand, std::vector<int>& status) const
+  {
+    int nFound = 0;
+    const auto& tI = mPool[id];
+    if (tI.sig2ZI < mMaxZ2InvCorePoint) {
+      return nFound;
+    }
+    auto procPnt = [&](int idN) {
+      const auto& tL = mPool[idN];
+      if (std::abs(tI.timeEst.getTimeStamp() - tL.timeEst.getTimeStamp()) > mDeltaT) {
+        return -1;
+      }
+      auto statN = status[idN], stat = status[id];
+      if (statN >= 0 && (stat < 0 || (stat >= 0 && statN != stat))) {
+        return 0;
+      }
+      if (tL.getDist2(tI) < mParams.dbscanMaxDist2) {
+        nFound++;
+        if (statN < 0 && statN > INCHECK) {
+          cand.push_back(idN);
+          status[idN] += INCHECK;
+        }
+      }
+      return 1;
+    };
+    for (int idL = id - 1; idL >= 0 && procPnt(idL) >= 0; idL--) {
+    }
+    for (int idU = id + 1; idU < int(mPool.size()) && procPnt(idU) >= 0; idU++) {
+    }
+    return nFound;
+  }
+
+  const std::vector<TrackVF>& mPool;
+  const PVertexerParams& mParams;
+  float mDeltaT = 0.f;
+  float mMaxZ2InvCorePoint = 0.f;
+};
+
+TrackVF makeTrack(float t, float sigT, float z, float sig2ZI)
+{
+  TrackVF trc{};
+  trc.z = z;
+  trc.sig2ZI = sig2ZI;
+  trc.timeEst = TimeEst{t, sigT};
+  return trc;
+}
+
+// tracks of collisions uniformly distributed over the TF duration, with Z errors from 20 microns to 5 mm
+std::vector<TrackVF> generatePool(int nTracks, float tfDuration, int multPerVertex, std::mt19937& mt)
+{
+  std::uniform_real_distribution<float> distT(0.f, tfDuration);
+  std::normal_distribution<float> distZV(0.f, 6.f), gaus(0.f, 1.f);
+  std::uniform_real_distribution<float> distLogSigZ(std::log(20e-4f), std::log(0.5f));
+  std::uniform_real_distribution<float> distSigT(0.1f, 2.5f);
+  std::vector<TrackVF> pool;
+  float tv = 0.f, zv = 0.f;
+  for (int i = 0; i < nTracks; i++) {
+    if (i % multPerVertex == 0) {
+      tv = distT(mt);
+      zv = distZV(mt);
+    }
+    float sigZ = std::exp(distLogSigZ(mt)), sigT = distSigT(mt);
+    pool.push_back(makeTrack(tv + sigT * gaus(mt), sigT, zv + sigZ * gaus(mt), 1.f / (sigZ * sigZ)));
+  }
+  return pool;
+}
+
+void sortAndCompare(std::vector<TrackVF>& pool, const char* name)
+{
+  std::stable_sort(pool.begin(), pool.end(), [](const TrackVF& a, const TrackVF& b) { return a.timeEst.getTimeStamp() < b.timeEst.getTimeStamp(); });
+  for (int i = 0; i < int(pool.size()); i++) {
+    pool[i].entry = i;
+  }
+  LinearDBScan reference(pool);
+  const auto refClusters = reference.clusterize();
+
+  PVertexer vertexer;
+  vertexer.setITSROFrameLength(ITSROFrameLengthMUS);
+  auto nClusters = vertexer.clusterizeExternalPool(pool);
+  const auto& clusters = vertexer.getTimeZClusters();
+
+  BOOST_REQUIRE_MESSAGE(nClusters == refClusters.size() && clusters.size() == refClusters.size(), name << ": " << clusters.size() << " clusters vs " << refClusters.size() << " in the reference");
+  size_t nClustered = 0;
+  for (size_t ic = 0; ic < clusters.size(); ic++) {
+    BOOST_CHECK_MESSAGE(clusters[ic].trackIDs == refClusters[ic], name << ": cluster " << ic << " differs");
+    nClustered += clusters[ic].trackIDs.size();
+  }
+  BOOST_CHECK_MESSAGE(nClustered > 0, name << ": no clustered tracks");
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PVDBScanRandomPools)
+{
+  std::mt19937 mt(12345);
+  // from sparse to heavily overlapping collisions
+  for (float tfDuration : {11400.f, 1000.f, 100.f}) {
+    auto pool = generatePool(20000, tfDuration, 50, mt);
+    sortAndCompare(pool, "random pool");
+  }
+  // low multiplicities, many noise tracks
+  auto pool = generatePool(5000, 2000.f, 3, mt);
+  sortAndCompare(pool, "low multiplicity pool");
+}
+
+BOOST_AUTO_TEST_CASE(PVDBScanNoZError)
+{
+  // tracks w/o valid Z error: their Z window is not bounded and they cannot be core points, but are neighbours of any core point in time
+  std::mt19937 mt(54321);
+  auto pool = generatePool(10000, 2000.f, 40, mt);
+  std::uniform_int_distribution<int> distID(0, pool.size() - 1);
+  std::uniform_real_distribution<float> distZ(-20.f, 20.f);
+  for (int i = 0; i < 1000; i++) {
+    auto& trc = pool[distID(mt)];
+    trc.sig2ZI = i % 2 ? 0.f : -1.f;
+    trc.z = distZ(mt);
+  }
+  sortAndCompare(pool, "pool with sig2ZI <= 0");
+}
+
+BOOST_AUTO_TEST_CASE(PVDBScanTimeSliceEdges)
+{
+  // tracks placed on the edges of the time slices of the index and at exactly deltaT from each other,
+  // with time errors large enough for the tracks at deltaT to pass the distance cut
+  const float deltaT = LinearDBScan(std::vector<TrackVF>{}).getDeltaT();
+  BOOST_REQUIRE(deltaT > 0.f);
+  std::mt19937 mt(777);
+  std::normal_distribution<float> gaus(0.f, 1.f);
+  std::uniform_real_distribution<float> distSigZ(20e-4f, 0.05f);
+  std::vector<TrackVF> pool;
+  for (int it = 0; it < 200; it++) {
+    float t = it * deltaT;
+    for (float tEdge : {t, std::nextafter(t, -1e9f), std::nextafter(t, 1e9f), t + 0.5f * deltaT}) {
+      float zv = 0.1f * (it % 7);
+      for (int i = 0; i < 3; i++) {
+        float sigZ = distSigZ(mt);
+        pool.push_back(makeTrack(tEdge, 2.f, zv + sigZ * gaus(mt), 1.f / (sigZ * sigZ)));
+      }
+    }
+  }
+  pool.push_back(makeTrack(0.f, 0.5f, 0.f, 0.f)); // the first time slice with an unbounded Z window
+  sortAndCompare(pool, "time slice edges pool");
+}
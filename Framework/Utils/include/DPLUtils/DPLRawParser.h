@@ -23,6 +23,7 @@
 #include "Framework/Logger.h"
 #include "Framework/DataProcessingHeader.h"
 #include "Headers/DataHeader.h"
+#include <algorithm>
 #include <utility> // std::declval
 
 namespace o2::framework
@@ -63,6 +64,13 @@ namespace o2::framework
 ///     // offset of payload in the raw page
 ///     size_t offset = it.offset();
 ///   }
+///
+/// Alternatively, the pages of each input part can be accessed via the RDHIndex:
+///   parser.indexParts([](RDHIndex const& index, DataRef const& ref) {
+///     for (size_t i = 0; i < index.size(); i++) {
+///       auto const* payload = index.getPayload(i);
+///     }
+///   });
 template <bool BOUNDS_CHECKS = true>
 class DPLRawParser
 {
@@ -242,22 +250,6 @@ class DPLRawParser
 
     bool next()
     {
-      auto logFailure = [this](const std::string& msg, const std::runtime_error& e) {
-        if (!this->mExtFailureCounter || (*this->mExtFailureCounter)++ < this->mMaxFailureMessages) {
-          if (this->mSeverity == fair::Severity::alarm) {
-            LOG(alarm) << msg << (*this->mInputIterator).spec->binding << " : " << e.what();
-          } else if (this->mSeverity == fair::Severity::warn) {
-            LOG(warn) << msg << (*this->mInputIterator).spec->binding << " : " << e.what();
-          } else if (this->mSeverity == fair::Severity::fatal) {
-            LOG(fatal) << msg << (*this->mInputIterator).spec->binding << " : " << e.what();
-          } else if (this->mSeverity == fair::Severity::info) {
-            LOG(info) << msg << (*this->mInputIterator).spec->binding << " : " << e.what();
-          } else {
-            LOG(debug) << msg << (*this->mInputIterator).spec->binding << " : " << e.what();
-          }
-        }
-      };
-
       while (mInputIterator != mEnd) {
         bool isInitial = mParser == nullptr;
         while (mPartIterator != mInputIterator.end()) {
@@ -289,7 +281,7 @@ class DPLRawParser
           try {
             raw = mParent.get<gsl::span<char>>(*mPartIterator);
           } catch (const std::runtime_error& e) {
-            logFailure("failed to read data from ", e);
+            logFailure(mSeverity, mMaxFailureMessages, mExtFailureCounter, "failed to read data from ", (*mInputIterator).spec->binding, e);
           }
           if (raw.size() == 0) {
             continue;
@@ -298,7 +290,7 @@ class DPLRawParser
           try {
             mParser = std::make_unique<parser_type>(raw.data(), raw.size());
           } catch (const std::runtime_error& e) {
-            logFailure("can not create raw parser from ", e);
+            logFailure(mSeverity, mMaxFailureMessages, mExtFailureCounter, "can not create raw parser from ", (*mInputIterator).spec->binding, e);
           }
 
           if (mParser != nullptr) {
@@ -336,11 +328,60 @@ class DPLRawParser
     return const_iterator(mInputs, mInputs.end(), mInputs.end(), mFilterSpecs, mSeverity, mMaxFailureMessages, mExtFailureCounter);
   }
 
+  /// Index the raw pages of each input part selected by the filter specs and call processor
+  /// for each part with signature
+  ///     void(RDHIndex const&, DataRef const&)
+  /// The index is built with a single walk over the RDHs of the part, see RDHIndex. The same
+  /// index object is reused for all parts and is valid only during the processor call.
+  template <typename Processor>
+  void indexParts(Processor&& processor) const
+  {
+    RDHIndex index;
+    for (auto inputIt = mInputs.begin(), inputEnd = mInputs.end(); inputIt != inputEnd; ++inputIt) {
+      for (auto partIt = inputIt.begin(), partEnd = inputIt.end(); partIt != partEnd; ++partIt) {
+        auto const& ref = *partIt;
+        if (mFilterSpecs.size() > 0 && std::none_of(mFilterSpecs.begin(), mFilterSpecs.end(), [&ref](auto const& spec) { return DataRefUtils::match(ref, spec); })) {
+          continue;
+        }
+        gsl::span<const char> raw;
+        try {
+          raw = mInputs.get<gsl::span<char>>(ref);
+        } catch (const std::runtime_error& e) {
+          logFailure(mSeverity, mMaxFailureMessages, mExtFailureCounter, "failed to read data from ", (*inputIt).spec->binding, e);
+        }
+        if (raw.size() == 0) {
+          continue;
+        }
+        index.build(raw.data(), raw.size());
+        processor(static_cast<RDHIndex const&>(index), ref);
+      }
+    }
+  }
+
   /// Format helper for stream output of the iterator content,
   /// print RDH version and table header
   using RDHInfo = typename o2::framework::DPLRawParser<BOUNDS_CHECKS>::const_iterator::template Fmt<raw_parser::FormatSpec::Info>;
 
  private:
+  /// Log the failure to access an input with the requested severity, at most maxMessages times if the counter is provided
+  static void logFailure(fair::Severity severity, size_t maxMessages, size_t* counter, const char* msg, std::string const& binding, std::runtime_error const& e)
+  {
+    if (counter && (*counter)++ >= maxMessages) {
+      return;
+    }
+    if (severity == fair::Severity::alarm) {
+      LOG(alarm) << msg << binding << " : " << e.what();
+    } else if (severity == fair::Severity::warn) {
+      LOG(warn) << msg << binding << " : " << e.what();
+    } else if (severity == fair::Severity::fatal) {
+      LOG(fatal) << msg << binding << " : " << e.what();
+    } else if (severity == fair::Severity::info) {
+      LOG(info) << msg << binding << " : " << e.what();
+    } else {
+      LOG(debug) << msg << binding << " : " << e.what();
+    }
+  }
+
   InputRecord& mInputs;
   std::vector<InputSpec> mFilterSpecs;
   size_t mMaxFailureMessages = -1;
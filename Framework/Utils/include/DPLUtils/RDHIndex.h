@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_UTILS_RDHINDEX_H
+#define FRAMEWORK_UTILS_RDHINDEX_H
+
+/// @file   RDHIndex.h
+/// @brief  Index of the raw pages of a buffer, built with a single walk over the RDHs
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// @class RDHIndex
+/// Index of the consecutive raw pages of a buffer (e.g. a superpage), built with a single walk over the RDHs.
+/// The RDH fields needed for the navigation and for the consistency checks are stored in compact arrays,
+/// one per field, so that the checks run over contiguous data in branch-free loops which are vectorized
+/// by the compiler, and the pages can be iterated w/o decoding the RDHs again.
+/// RDH versions 4 to 7 are supported, all pages must have the version of the 1st RDH.
+///
+/// \par Usage:
+///
+///     RDHIndex index;
+///     index.build(buffer, size); // or parser.index(index) for the RawParser
+///     if (!index.isComplete() || index.check()) {
+///       // index.getErrors()[i] provides the ErrorFlag's of the page i
+///     }
+///     for (size_t i = 0; i < index.size(); i++) {
+///       process(index.getFeeIds()[i], index.getPayload(i), index.getPayloadSize(i));
+///     }
+class RDHIndex
+{
+ public:
+  /// flags set by the consistency checks for the page, the counters and orbit are compared to the previous
+  /// page in the buffer if it belongs to the same FEE and link
+  enum ErrorFlag : uint8_t {
+    ErrPacketCounter = 0x1, ///< packet counter is not incremented
+    ErrPageCounter = 0x2,   ///< page counter is not incremented, or is not 0 after the stop
+    ErrOrbit = 0x4,         ///< orbit is changed w/o stop
+    ErrMemorySize = 0x8,    ///< memory size is smaller than the header size or exceeds the offset to the next page
+  };
+
+  /// Index the pages of the buffer, return the number of pages.
+  /// The indexing stops at the 1st RDH which is not valid or does not fit to the buffer, see isComplete().
+  /// The buffer must stay valid while the index is used.
+  size_t build(const void* buffer, size_t size);
+
+  /// Run the consistency checks on the indexed pages, return the number of pages with errors
+  size_t check();
+
+  void clear();
+
+  size_t size() const { return mOffsets.size(); }
+  bool empty() const { return mOffsets.empty(); }
+  /// whether the RDHs chain covers the whole buffer
+  bool isComplete() const { return mIndexedSize == mSize; }
+  size_t getIndexedSize() const { return mIndexedSize; }
+  int getVersion() const { return mVersion; }
+  int getHeaderSize() const { return mHeaderSize; }
+
+  const std::vector<uint32_t>& getOffsets() const { return mOffsets; }
+  const std::vector<uint16_t>& getFeeIds() const { return mFeeIds; }
+  const std::vector<uint8_t>& getLinkIDs() const { return mLinkIDs; }
+  const std::vector<uint32_t>& getOrbits() const { return mOrbits; }
+  const std::vector<uint8_t>& getPacketCounters() const { return mPacketCounters; }
+  const std::vector<uint16_t>& getPageCounters() const { return mPageCounters; }
+  const std::vector<uint8_t>& getStops() const { return mStops; }
+  const std::vector<uint16_t>& getMemorySizes() const { return mMemorySizes; }
+  const std::vector<uint16_t>& getOffsetsToNext() const { return mOffsetsToNext; }
+  const std::vector<uint8_t>& getErrors() const { return mErrors; }
+
+  /// pointer to the RDH of the page
+  const unsigned char* getPage(size_t i) const { return mBuffer + mOffsets[i]; }
+  /// pointer to the payload of the page
+  const unsigned char* getPayload(size_t i) const { return mBuffer + mOffsets[i] + mHeaderSize; }
+  /// size of the payload of the page
+  size_t getPayloadSize(size_t i) const { return mMemorySizes[i] > mHeaderSize ? mMemorySizes[i] - mHeaderSize : 0; }
+
+ private:
+  template <typename RDH>
+  void fill();
+
+  const unsigned char* mBuffer = nullptr;
+  size_t mSize = 0;
+  size_t mIndexedSize = 0;
+  int mVersion = 0;
+  int mHeaderSize = 0;
+  std::vector<uint32_t> mOffsets;
+  std::vector<uint16_t> mFeeIds;
+  std::vector<uint8_t> mLinkIDs;
+  std::vector<uint32_t> mOrbits;
+  std::vector<uint8_t> mPacketCounters;
+  std::vector<uint16_t> mPageCounters;
+  std::vector<uint8_t> mStops;
+  std::vector<uint16_t> mMemorySizes;
+  std::vector<uint16_t> mOffsetsToNext;
+  std::vector<uint8_t> mErrors;
+};
+
+} // namespace o2::framework
+
+#endif // FRAMEWORK_UTILS_RDHINDEX_H
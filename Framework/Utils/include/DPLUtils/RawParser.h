@@ -19,6 +19,7 @@
 #include "Headers/RAWDataHeader.h"
 #include "Framework/VariantHelpers.h" // definition of `overloaded`
 #include "Framework/Logger.h"
+#include "DPLUtils/RDHIndex.h"
 #include <functional>
 #include <memory>
 #include <variant>
@@ -325,6 +326,12 @@ class ConcreteRawParser
     return mNErrors;
   }
 
+  /// Index all pages of the buffer with a single walk over the RDHs, return the number of pages
+  size_t index(RDHIndex& idx) const
+  {
+    return idx.build(mRawBuffer, mSize);
+  }
+
   /// Comparison: instances are equal if they serve the same buffer and are in the same
   /// state, i.e. at same position
   template <typename T = self_type>
@@ -458,6 +465,13 @@ U const* get_if(T& instances)
 ///       auto dataptr = it.data();
 ///     }
 ///
+///     // option 3: index, the RDH fields of all pages are extracted at once, see RDHIndex
+///     RDHIndex index;
+///     parser.index(index);
+///     for (size_t i = 0; i < index.size(); i++) {
+///       auto dataptr = index.getPayload(i);
+///     }
+///
 /// TODO:
 /// - iterators are not independent at the moment and this can cause conflicts, this must be
 ///   improved
@@ -644,6 +658,12 @@ class RawParser
     return std::visit([](auto& parser) { return parser.getNErrors(); }, mParser);
   }
 
+  /// Index all pages of the buffer with a single walk over the RDHs, return the number of pages
+  size_t index(RDHIndex& idx) const
+  {
+    return std::visit([&idx](auto& parser) { return parser.index(idx); }, mParser);
+  }
+
   static void setCheckIncompleteHBF(bool v)
   {
     raw_parser::RawParserHelper::sCheckIncompleteHBF = v;
@@ -0,0 +1,143 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   RDHIndex.cxx
+/// @brief  Index of the raw pages of a buffer, built with a single walk over the RDHs
+
+#include "DPLUtils/RDHIndex.h"
+#include "Headers/RAWDataHeader.h"
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace o2::framework
+{
+
+size_t RDHIndex::build(const void* buffer, size_t size)
+{
+  clear();
+  mBuffer = static_cast<const unsigned char*>(buffer);
+  mSize = size;
+  if (mBuffer == nullptr || mSize < sizeof(header::RAWDataHeaderV5)) {
+    return 0;
+  }
+  // the version field is at the same position for all RDH versions
+  mVersion = reinterpret_cast<const header::RAWDataHeaderV5*>(mBuffer)->version;
+  switch (mVersion) {
+    case 7:
+      fill<header::RAWDataHeaderV7>();
+      break;
+    case 6:
+      fill<header::RAWDataHeaderV6>();
+      break;
+    case 5:
+      fill<header::RAWDataHeaderV5>();
+      break;
+    case 4:
+      fill<header::RAWDataHeaderV4>();
+      break;
+    default:
+      break;
+  }
+  return this->size();
+}
+
+template <typename RDH>
+void RDHIndex::fill()
+{
+  mHeaderSize = sizeof(RDH);
+  const size_t maxSize = std::min(mSize, size_t(std::numeric_limits<uint32_t>::max()));
+  const size_t nPagesExp = maxSize / 8192 + 1; // typical CRU page
+  for (auto* v : {&mOffsets, &mOrbits}) {
+    v->reserve(nPagesExp);
+  }
+  for (auto* v : {&mFeeIds, &mPageCounters, &mMemorySizes, &mOffsetsToNext}) {
+    v->reserve(nPagesExp);
+  }
+  for (auto* v : {&mLinkIDs, &mPacketCounters, &mStops}) {
+    v->reserve(nPagesExp);
+  }
+  size_t pos = 0;
+  while (pos + sizeof(RDH) <= maxSize) {
+    const auto& rdh = *reinterpret_cast<const RDH*>(mBuffer + pos);
+    if (rdh.version != mVersion || rdh.headerSize != sizeof(RDH) || pos + std::max(size_t(rdh.memorySize), sizeof(RDH)) > maxSize) {
+      break;
+    }
+    mOffsets.push_back(pos);
+    mFeeIds.push_back(rdh.feeId);
+    mLinkIDs.push_back(rdh.linkID);
+    if constexpr (std::is_same_v<RDH, header::RAWDataHeaderV4>) {
+      mOrbits.push_back(rdh.heartbeatOrbit);
+    } else {
+      mOrbits.push_back(rdh.orbit);
+    }
+    mPacketCounters.push_back(rdh.packetCounter);
+    mPageCounters.push_back(rdh.pageCnt);
+    mStops.push_back(rdh.stop);
+    mMemorySizes.push_back(rdh.memorySize);
+    mOffsetsToNext.push_back(rdh.offsetToNext);
+    if (rdh.offsetToNext < sizeof(RDH)) { // cannot navigate further
+      pos += std::max(size_t(rdh.memorySize), sizeof(RDH));
+      break;
+    }
+    pos += rdh.offsetToNext;
+  }
+  mIndexedSize = std::min(pos, mSize);
+}
+
+size_t RDHIndex::check()
+{
+  const size_t n = size();
+  mErrors.resize(n);
+  const auto* __restrict__ feeId = mFeeIds.data();
+  const auto* __restrict__ linkID = mLinkIDs.data();
+  const auto* __restrict__ orbit = mOrbits.data();
+  const auto* __restrict__ packetCounter = mPacketCounters.data();
+  const auto* __restrict__ pageCounter = mPageCounters.data();
+  const auto* __restrict__ stop = mStops.data();
+  const auto* __restrict__ memorySize = mMemorySizes.data();
+  const auto* __restrict__ offsetToNext = mOffsetsToNext.data();
+  auto* __restrict__ errors = mErrors.data();
+  const uint16_t headerSize = mHeaderSize;
+  // the loops are kept branch-free to let the compiler vectorize them
+  for (size_t i = 0; i < n; i++) {
+    errors[i] = uint8_t((memorySize[i] < headerSize) | (memorySize[i] > offsetToNext[i])) * ErrMemorySize;
+  }
+  for (size_t i = 1; i < n; i++) {
+    const uint8_t sameLink = (feeId[i] == feeId[i - 1]) & (linkID[i] == linkID[i - 1]);
+    const uint8_t afterStop = stop[i - 1] != 0;
+    const uint8_t errPacket = uint8_t(packetCounter[i - 1] + 1) != packetCounter[i];
+    const uint16_t expPage = uint16_t(pageCounter[i - 1] + 1) * (1 - afterStop); // 0 expected after the stop
+    const uint8_t errPage = expPage != pageCounter[i];
+    const uint8_t errOrbit = (1 - afterStop) & (orbit[i] != orbit[i - 1]);
+    errors[i] |= sameLink * (errPacket * ErrPacketCounter | errPage * ErrPageCounter | errOrbit * ErrOrbit);
+  }
+  return n - std::count(errors, errors + n, 0);
+}
+
+void RDHIndex::clear()
+{
+  mBuffer = nullptr;
+  mSize = mIndexedSize = 0;
+  mVersion = mHeaderSize = 0;
+  mOffsets.clear();
+  mFeeIds.clear();
+  mLinkIDs.clear();
+  mOrbits.clear();
+  mPacketCounters.clear();
+  mPageCounters.clear();
+  mStops.clear();
+  mMemorySizes.clear();
+  mOffsetsToNext.clear();
+  mErrors.clear();
+}
+
+} // namespace o2::framework
@@ -34,6 +34,9 @@ class TestPages
       mPages[pageNo].rdh.version = 4;
       mPages[pageNo].rdh.headerSize = sizeof(V4);
       mPages[pageNo].rdh.offsetToNext = PageSize;
+      mPages[pageNo].rdh.memorySize = PageSize;
+      mPages[pageNo].rdh.packetCounter = pageNo;
+      mPages[pageNo].rdh.pageCnt = pageNo;
       auto* data = reinterpret_cast<size_t*>(&mPages[pageNo].data);
       *data = pageNo;
     }
@@ -70,6 +73,7 @@ static void BM_RawParserAuto(benchmark::State& state)
   for (auto _ : state) {
     parser.parse(processor);
   }
+  state.SetItemsProcessed(state.iterations() * nofPages);
 }
 
 static void BM_RawParserV4(benchmark::State& state)
@@ -87,9 +91,46 @@ static void BM_RawParserV4(benchmark::State& state)
   for (auto _ : state) {
     parser.parse(processor);
   }
+  state.SetItemsProcessed(state.iterations() * nofPages);
+}
+
+// index all pages and iterate over the payloads
+static void BM_RDHIndex(benchmark::State& state)
+{
+  size_t nofPages = state.range(0);
+  if (nofPages > TestPages::MaxNPages) {
+    return;
+  }
+  RDHIndex index;
+  size_t count = 0;
+  for (auto _ : state) {
+    index.build(gPages.data(), nofPages * TestPages::PageSize);
+    for (size_t i = 0; i < index.size(); i++) {
+      count += index.getPayloadSize(i);
+    }
+  }
+  benchmark::DoNotOptimize(count);
+  state.SetItemsProcessed(state.iterations() * nofPages);
+}
+
+// consistency checks of the indexed pages
+static void BM_RDHIndexCheck(benchmark::State& state)
+{
+  size_t nofPages = state.range(0);
+  if (nofPages > TestPages::MaxNPages) {
+    return;
+  }
+  RDHIndex index;
+  index.build(gPages.data(), nofPages * TestPages::PageSize);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.check());
+  }
+  state.SetItemsProcessed(state.iterations() * nofPages);
 }
 
 BENCHMARK(BM_RawParserV4)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
 BENCHMARK(BM_RawParserAuto)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
+BENCHMARK(BM_RDHIndex)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
+BENCHMARK(BM_RDHIndexCheck)->Arg(1)->Arg(8)->Arg(256)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
 
 BENCHMARK_MAIN();
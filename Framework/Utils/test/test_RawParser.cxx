@@ -82,4 +82,44 @@ TEMPLATE_TEST_CASE("test_RawParser", "[RDH][template]", V5, V6, V7)
   }
 }
 
+TEMPLATE_TEST_CASE("test_RDHIndex", "[RDH][template]", V4, V5, V6, V7)
+{
+  constexpr size_t NofPages = 4;
+  std::array<unsigned char, NofPages * PageSize> buffer;
+  fillPages<TestType>(buffer);
+
+  RawParser parser(buffer.data(), buffer.size());
+  RDHIndex index;
+  REQUIRE(parser.index(index) == NofPages);
+  REQUIRE(index.isComplete());
+  REQUIRE(index.getHeaderSize() == sizeof(TestType));
+  size_t count = 0;
+  for (auto it = parser.begin(), end = parser.end(); it != end; ++it, ++count) {
+    REQUIRE(index.getPage(count) == it.raw());
+    REQUIRE(index.getPayload(count) == it.data());
+    REQUIRE(index.getPayloadSize(count) == it.size());
+    REQUIRE(index.getPageCounters()[count] == count);
+  }
+  REQUIRE(count == NofPages);
+  REQUIRE(index.check() == 0);
+
+  // packet counter of the 2nd page breaks the sequence with both neighbours
+  reinterpret_cast<TestType*>(buffer.data() + PageSize)->packetCounter = 7;
+  // memory size of the 3rd page exceeds the offset to the next page
+  reinterpret_cast<TestType*>(buffer.data() + 2 * PageSize)->memorySize = PageSize + 1;
+  index.build(buffer.data(), buffer.size());
+  REQUIRE(index.size() == NofPages);
+  REQUIRE(index.check() == 2);
+  REQUIRE(index.getErrors()[0] == 0);
+  REQUIRE(index.getErrors()[1] == RDHIndex::ErrPacketCounter);
+  REQUIRE(index.getErrors()[2] == (RDHIndex::ErrPacketCounter | RDHIndex::ErrMemorySize));
+  REQUIRE(index.getErrors()[3] == 0);
+
+  // truncated buffer: the last page is not indexed
+  index.build(buffer.data(), buffer.size() - 1);
+  REQUIRE(index.size() == NofPages - 1);
+  REQUIRE(!index.isComplete());
+  REQUIRE(index.getIndexedSize() == (NofPages - 1) * PageSize);
+}
+
 } // namespace o2::framework
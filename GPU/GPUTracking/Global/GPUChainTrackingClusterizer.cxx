@@ -533,6 +533,21 @@ int32_t GPUChainTracking::RunTPCClusterizer_prepare(bool restorePointers)
 
   if (mIOPtrs.tpcZS) {
     GPUInfo("Event has %u 8kb TPC ZS pages (version %d), %ld digits", mCFContext->nPagesTotal, mCFContext->zsVersion, (int64_t)mRec->MemoryScalers()->nTPCdigits);
+    if (GetProcessingSettings().debugLevel >= 1) { // Account the ZS pages to the decoder kernel, to print the decoding throughput with the kernel timing
+      const size_t zsSize = (size_t)mCFContext->nPagesTotal * TPCZSHDR::TPC_ZS_PAGE_SIZE;
+      switch (mCFContext->zsVersion) {
+        case ZSVersionRowBased10BitADC:
+        case ZSVersionRowBased12BitADC:
+          getKernelTimer<GPUTPCCFDecodeZS, GPUTPCCFDecodeZS::decodeZS>(RecoStep::TPCClusterFinding, 0, zsSize, false);
+          break;
+        case ZSVersionLinkBasedWithMeta:
+          getKernelTimer<GPUTPCCFDecodeZSLink, 0>(RecoStep::TPCClusterFinding, 0, zsSize, false);
+          break;
+        case ZSVersionDenseLinkBased:
+          getKernelTimer<GPUTPCCFDecodeZSDenseLink, 0>(RecoStep::TPCClusterFinding, 0, zsSize, false);
+          break;
+      }
+    }
   } else {
     GPUInfo("Event has %ld TPC Digits", (int64_t)mRec->MemoryScalers()->nTPCdigits);
   }
@@ -46,6 +46,42 @@ class CfUtils
 
   static GPUdi() bool isAboveThreshold(uint8_t peak) { return peak >> 1; }
 
+  // Unpack nSamples tightly packed (LSB first) 10 or 12 bit ADC values.
+  // Groups of samples filling whole bytes are decoded independently of each other, so the main loop can be vectorized by the compiler.
+  template <uint32_t DecodeBits>
+  static GPUdi() void unpackADCs(const uint8_t* adcData, uint32_t nSamples, uint16_t* adcs)
+  {
+    static_assert(DecodeBits == 10 || DecodeBits == 12, "Only 10 and 12 bit ADC values supported");
+    constexpr uint32_t SamplesPerGroup = (DecodeBits == 10) ? 4 : 2;
+    constexpr uint32_t BytesPerGroup = SamplesPerGroup * DecodeBits / 8;
+    const uint32_t nGroups = nSamples / SamplesPerGroup;
+    for (uint32_t i = 0; i < nGroups; i++) {
+      const uint8_t* in = adcData + i * BytesPerGroup;
+      uint16_t* out = adcs + i * SamplesPerGroup;
+      if CONSTEXPR (DecodeBits == 12) {
+        out[0] = in[0] | ((in[1] & 0x0F) << 8);
+        out[1] = (in[1] >> 4) | (in[2] << 4);
+      } else {
+        out[0] = in[0] | ((in[1] & 0x03) << 8);
+        out[1] = (in[1] >> 2) | ((in[2] & 0x0F) << 6);
+        out[2] = (in[2] >> 4) | ((in[3] & 0x3F) << 4);
+        out[3] = (in[3] >> 6) | (in[4] << 2);
+      }
+    }
+    // Remaining samples of the last incomplete group, reading only the bytes containing them
+    const uint8_t* in = adcData + nGroups * BytesPerGroup;
+    uint32_t byte = 0, bits = 0;
+    for (uint32_t i = nGroups * SamplesPerGroup; i < nSamples; i++) {
+      while (bits < DecodeBits) {
+        byte |= static_cast<uint32_t>(*(in++)) << bits;
+        bits += 8;
+      }
+      adcs[i] = byte & ((1 << DecodeBits) - 1);
+      byte >>= DecodeBits;
+      bits -= DecodeBits;
+    }
+  }
+
   static GPUdi() int32_t warpPredicateScan(int32_t pred, int32_t* sum)
   {
 #ifdef __HIPCC__
@@ -145,6 +145,37 @@ GPUdii() void GPUTPCCFDecodeZS::decode(GPUTPCClusterFinder& clusterer, GPUShared
             const int32_t nSeqPerThread = (nSeqRead + s.nThreadsPerRow - 1) / s.nThreadsPerRow;
             const int32_t mySequenceStart = mySequence * nSeqPerThread;
             const int32_t mySequenceEnd = CAMath::Min(mySequenceStart + nSeqPerThread, nSeqRead);
+#ifndef GPUCA_GPUCODE
+            if (mySequenceStart == 0 && mySequenceEnd == nSeqRead) {
+              // CPU: a single thread decodes the full row, unpack all ADC values of the row at once
+              const uint8_t* adcData = rowData + 2 * nSeqRead + 1;
+              const uint32_t nSamples = rowData[2 * nSeqRead];
+              uint16_t adcs[256]; // the number of samples per row is stored in 8 bits
+              if (decode12bit) {
+                CfUtils::unpackADCs<TPCZSHDR::TPC_ZS_NBITS_V2>(adcData, nSamples, adcs);
+              } else {
+                CfUtils::unpackADCs<TPCZSHDR::TPC_ZS_NBITS_V1>(adcData, nSamples, adcs);
+              }
+              const CfFragment& fragment = clusterer.mPmemory->fragment;
+              const TPCTime globalTime = timeBin + l;
+              const bool inFragment = fragment.contains(globalTime);
+              const Row row = rowOffset + m;
+              uint32_t iSample = 0;
+              for (int32_t nSeq = 0; nSeq < nSeqRead; nSeq++) {
+                Pad pad = rowData[nSeq * 2 + 1];
+                for (; iSample < rowData[(nSeq + 1) * 2]; iSample++, pad++) {
+                  ChargePos pos(row, Pad(pad), inFragment ? fragment.toLocal(globalTime) : INVALID_TIME_BIN);
+                  positions[nDigitsTmp++] = pos;
+                  if (inFragment) {
+                    float q = float(adcs[iSample]) * decodeBitsFactor;
+                    q *= clusterer.GetConstantMem()->calibObjects.tpcPadGain->getGainCorrection(slice, row, pad);
+                    chargeMap[pos] = PackedCharge(q);
+                  }
+                }
+              }
+              continue;
+            }
+#endif
             if (mySequenceEnd > mySequenceStart) {
               const uint8_t* adcData = rowData + 2 * nSeqRead + 1;
               const uint32_t nSamplesStart = mySequenceStart ? rowData[2 * mySequenceStart] : 0;
@@ -855,8 +886,8 @@ GPUd() uint16_t GPUTPCCFDecodeZSDenseLink::DecodeTBSingleThread(
   const CfFragment& fragment = clusterer.mPmemory->fragment;
 
   uint8_t linkIds[MaxNLinksPerTimebin];
-  uint8_t channelMasks[MaxNLinksPerTimebin * 10] = {0};
-  uint16_t nSamplesWritten = 0;
+  uint16_t rawFECChannels[MaxNLinksPerTimebin * ChannelPerTBHeader]; // Channel of each sample, link * ChannelPerTBHeader + channel in link
+  uint16_t adcs[MaxNLinksPerTimebin * ChannelPerTBHeader];
 
   // Read timebin block header
   uint16_t tbbHdr = ConsumeByte(page);
@@ -887,15 +918,18 @@ GPUd() uint16_t GPUTPCCFDecodeZSDenseLink::DecodeTBSingleThread(
 
     for (int32_t i = 0; i < 10; i++) {
       if (bitmaskL2 & 1 << i) {
-        nSamplesInTB += CAMath::Popcount(*Peek(page));
-        channelMasks[10 * iLink + i] = ConsumeByte(page);
+        // Store the active channels in order, iterating only over the set bits
+        for (uint32_t channelMask = ConsumeByte(page); channelMask; channelMask &= channelMask - 1) {
+          rawFECChannels[nSamplesInTB++] = iLink * ChannelPerTBHeader + i * CHAR_BIT + CAMath::Popcount((channelMask & -channelMask) - 1);
+        }
         MAYBE_PAGE_OVERFLOW(page);
       }
     }
 
   } // for (uint8_t iLink = 0; iLink < nLinksInTimebin; iLink++)
 
-  const uint8_t* adcData = ConsumeBytes(page, (nSamplesInTB * DECODE_BITS + 7) / 8);
+  const uint32_t nBytesADC = (nSamplesInTB * DECODE_BITS + 7) / 8;
+  const uint8_t* adcData = ConsumeBytes(page, nBytesADC);
   MAYBE_PAGE_OVERFLOW(page);
 
   if (not fragment.contains(timeBin)) {
@@ -903,42 +937,40 @@ GPUd() uint16_t GPUTPCCFDecodeZSDenseLink::DecodeTBSingleThread(
     return nSamplesInTB;
   }
 
-  // Unpack ADC
-  uint32_t byte = 0, bits = 0;
-  uint16_t rawFECChannel = 0;
-
-  // unpack adc values, assume tightly packed data
-  while (nSamplesWritten < nSamplesInTB) {
-    byte |= static_cast<uint32_t>(ConsumeByte(adcData)) << bits;
-    MAYBE_PAGE_OVERFLOW(adcData);
-    bits += CHAR_BIT;
-    while (bits >= DECODE_BITS) {
-
-      // Find next channel with data
-      for (; !ChannelIsActive(channelMasks, rawFECChannel); rawFECChannel++) {
+  // Unpack ADC, assume tightly packed data
+  if (!PayloadExtendsToNextPage || adcData >= nextPage || adcData + nBytesADC <= payloadEnd) {
+    // Unpack the whole timebin at once
+    CfUtils::unpackADCs<DECODE_BITS>(adcData, nSamplesInTB, adcs);
+  } else {
+    // ADC data continues on next page
+    uint32_t byte = 0, bits = 0;
+    uint16_t nSamplesUnpacked = 0;
+    while (nSamplesUnpacked < nSamplesInTB) {
+      byte |= static_cast<uint32_t>(ConsumeByte(adcData)) << bits;
+      MAYBE_PAGE_OVERFLOW(adcData);
+      bits += CHAR_BIT;
+      while (bits >= DECODE_BITS) {
+        adcs[nSamplesUnpacked++] = byte & DECODE_MASK;
+        byte >>= DECODE_BITS;
+        bits -= DECODE_BITS;
       }
+    }
+  }
 
-      int32_t iLink = rawFECChannel / ChannelPerTBHeader;
-      int32_t rawFECChannelLink = rawFECChannel % ChannelPerTBHeader;
-
-      // Unpack data for cluster finder
-      o2::tpc::PadPos padAndRow = GetPadAndRowFromFEC(clusterer, cru, rawFECChannelLink, linkIds[iLink]);
+  for (uint16_t sample = 0; sample < nSamplesInTB; sample++) {
+    int32_t iLink = rawFECChannels[sample] / ChannelPerTBHeader;
+    int32_t rawFECChannelLink = rawFECChannels[sample] % ChannelPerTBHeader;
 
-      float charge = ADCToFloat(byte, DECODE_MASK, DECODE_BITS_FACTOR);
-      WriteCharge(clusterer, charge, padAndRow, fragment.toLocal(timeBin), pageDigitOffset + nSamplesWritten);
+    // Unpack data for cluster finder
+    o2::tpc::PadPos padAndRow = GetPadAndRowFromFEC(clusterer, cru, rawFECChannelLink, linkIds[iLink]);
 
-      byte >>= DECODE_BITS;
-      bits -= DECODE_BITS;
-      nSamplesWritten++;
-      rawFECChannel++; // Ensure we don't decode same channel twice
-    }                  // while (bits >= DECODE_BITS)
-  }                    // while (nSamplesWritten < nAdc)
+    float charge = ADCToFloat(adcs[sample], DECODE_MASK, DECODE_BITS_FACTOR);
+    WriteCharge(clusterer, charge, padAndRow, fragment.toLocal(timeBin), pageDigitOffset + sample);
+  }
 
-  assert(PayloadExtendsToNextPage || adcData <= page);
   assert(PayloadExtendsToNextPage || page <= payloadEnd);
-  assert(nSamplesWritten == nSamplesInTB);
 
-  return nSamplesWritten;
+  return nSamplesInTB;
 
 #undef MAYBE_PAGE_OVERFLOW
 }
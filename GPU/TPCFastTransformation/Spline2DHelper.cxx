@@ -338,7 +338,8 @@ void Spline2DHelper<DataT>::approximateDataPoints(
 
   const int32_t nPar = 4 * spline.getNumberOfKnots(); // n parameters for 1-dimensional F
 
-  SymMatrixSolver solver(nPar, nFdim);
+  SymMatrixSolver& solver = mSolver;
+  solver.reset(nPar, nFdim);
 
   for (int32_t iPoint = 0; iPoint < nDataPoints; ++iPoint) {
     double u = fGridU.convXtoU(dataPointX1[iPoint]);
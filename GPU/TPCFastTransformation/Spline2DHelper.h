@@ -25,6 +25,7 @@
 #include "Spline1D.h"
 #include "Spline2D.h"
 #include "Spline1DHelperOld.h"
+#include "SymMatrixSolver.h"
 #include <functional>
 #include <string>
 
@@ -129,6 +130,7 @@ class Spline2DHelper
   Spline1DHelperOld<DataT> mHelperU2;
   Spline1D<double, 0> fGridU;
   Spline1D<double, 0> fGridV;
+  SymMatrixSolver mSolver; //! workspace of approximateDataPoints(), reused between the calls
 
 #ifndef GPUCA_ALIROOT_LIB
   ClassDefNV(Spline2DHelper, 0);
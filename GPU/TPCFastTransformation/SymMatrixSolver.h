@@ -38,10 +38,18 @@ namespace gpu
 class SymMatrixSolver
 {
  public:
-  SymMatrixSolver(int32_t N, int32_t M) : mN(N), mM(M), mShift(mN + mM)
+  SymMatrixSolver() = default;
+
+  SymMatrixSolver(int32_t N, int32_t M) { reset(N, M); }
+
+  /// set the dimensions and zero all the elements, the allocated memory is reused
+  void reset(int32_t N, int32_t M)
   {
     assert(N > 0 && M > 0);
-    mA.resize(mN * mShift, 0.);
+    mN = N;
+    mM = M;
+    mShift = mN + mM;
+    mA.assign(mN * mShift, 0.);
   }
 
   /// access to A elements
@@ -23,6 +23,7 @@
 
 #if !defined(GPUCA_GPUCODE)
 #include <iostream>
+#include <vector>
 #endif
 
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
@@ -165,6 +166,107 @@ void TPCFastTransform::print() const
 #endif
 }
 
+#if !defined(GPUCA_GPUCODE)
+
+void TPCFastTransform::TransformBulk(int32_t n, const int32_t* slice, const int32_t* row, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime) const
+{
+  /// Bulk version of Transform(), see the header for the description
+
+  bool perCluster = (mCorrectionSlow != nullptr);
+  GPUCA_DEBUG_STREAMER_CHECK(if (o2::utils::DebugStreamer::checkStream(o2::utils::StreamFlags::streamFastTransform)) { perCluster = true; });
+  if (perCluster) {
+    for (int32_t i = 0; i < n; i++) {
+      Transform(slice[i], row[i], pad[i], time[i], x[i], y[i], z[i], vertexTime);
+    }
+    return;
+  }
+
+  // group the clusters by slice and row with the counting sort, unless they are grouped already
+  const int32_t nRows = getGeometry().getNumberOfRows();
+  const int32_t nGroups = getGeometry().getNumberOfSlices() * nRows;
+  auto groupID = [&](int32_t i) { return slice[i] * nRows + row[i]; };
+  thread_local std::vector<int32_t> order, groupStart;
+  bool isGrouped = true;
+  for (int32_t i = 1; i < n && isGrouped; i++) {
+    isGrouped = groupID(i - 1) <= groupID(i);
+  }
+  if (!isGrouped) {
+    groupStart.assign(nGroups + 1, 0);
+    for (int32_t i = 0; i < n; i++) {
+      groupStart[groupID(i) + 1]++;
+    }
+    for (int32_t ig = 0; ig < nGroups; ig++) {
+      groupStart[ig + 1] += groupStart[ig];
+    }
+    order.resize(n);
+    for (int32_t i = 0; i < n; i++) {
+      order[groupStart[groupID(i)]++] = i;
+    }
+  }
+  auto clusterID = [&](int32_t i) { return isGrouped ? i : order[i]; };
+
+  constexpr int32_t BlockSize = 64;
+  float bu[BlockSize], bv[BlockSize], bx[BlockSize], by[BlockSize], bz[BlockSize];
+  int32_t first = 0;
+  while (first < n) {
+    const int32_t sl = slice[clusterID(first)], rw = row[clusterID(first)];
+    int32_t last = first + 1;
+    while (last < n && slice[clusterID(last)] == sl && row[clusterID(last)] == rw) {
+      last++;
+    }
+    const float rowX = getGeometry().getRowInfo(rw).x;
+    const TPCFastSpaceChargeCorrection::SplineType& spline = mCorrection.getSpline(sl, rw);
+    const float* splineData = mCorrection.getSplineData(sl, rw);
+
+    for (int32_t blockStart = first; blockStart < last; blockStart += BlockSize) {
+      const int32_t nb = CAMath::Min(BlockSize, last - blockStart);
+      for (int32_t k = 0; k < nb; k++) {
+        const int32_t i = clusterID(blockStart + k);
+        bx[k] = rowX;
+        convPadTimeToUV(sl, rw, pad[i], time[i], bu[k], bv[k], vertexTime);
+      }
+      if (mApplyCorrection) {
+        for (int32_t k = 0; k < nb; k++) {
+          // same as TPCFastSpaceChargeCorrection::getCorrection with the spline of the group
+          float gridU = 0, gridV = 0;
+          mCorrection.convUVtoGrid(sl, rw, bu[k], bv[k], gridU, gridV);
+          float dxuv[3];
+          spline.interpolateU(splineData, gridU, gridV, dxuv);
+          if (CAMath::Abs(dxuv[0]) > 100 || CAMath::Abs(dxuv[1]) > 100 || CAMath::Abs(dxuv[2]) > 100) {
+            dxuv[0] = dxuv[1] = dxuv[2] = 0;
+          }
+          bx[k] += dxuv[0];
+          bu[k] += dxuv[1];
+          bv[k] += dxuv[2];
+        }
+      }
+      for (int32_t k = 0; k < nb; k++) {
+        getGeometry().convUVtoLocal(sl, bu[k], bv[k], by[k], bz[k]);
+        float dzTOF = 0;
+        getTOFcorrection(sl, rw, bx[k], by[k], bz[k], dzTOF);
+        bz[k] += dzTOF;
+      }
+      for (int32_t k = 0; k < nb; k++) {
+        const int32_t i = clusterID(blockStart + k);
+        x[i] = bx[k];
+        y[i] = by[k];
+        z[i] = bz[k];
+      }
+    }
+    first = last;
+  }
+}
+
+void TPCFastTransform::TransformInTimeFrameBulk(int32_t n, const int32_t* slice, const int32_t* row, const float* pad, const float* time, float* x, float* y, float* z, float maxTimeBin) const
+{
+  /// Bulk version of TransformInTimeFrame(), no corrections are involved, so the clusters are not reordered
+  for (int32_t i = 0; i < n; i++) {
+    TransformInTimeFrame(slice[i], row[i], pad[i], time[i], x[i], y[i], z[i], maxTimeBin);
+  }
+}
+
+#endif
+
 #if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE) && !defined(GPUCA_ALIROOT_LIB)
 
 int32_t TPCFastTransform::writeToFile(std::string outFName, std::string name)
@@ -189,6 +189,18 @@ class TPCFastTransform : public FlatObject
   GPUd() void TransformInTimeFrame(int32_t slice, int32_t row, float pad, float time, float& x, float& y, float& z, float maxTimeBin) const;
   GPUd() void TransformInTimeFrame(int32_t slice, float time, float& z, float maxTimeBin) const;
 
+#if !defined(GPUCA_GPUCODE)
+  /// Bulk version of Transform() for the CPU: transforms n clusters given by the arrays slice, row, pad, time.
+  /// The clusters are processed in groups of the same slice and row, such that the row geometry and the correction
+  /// spline are fetched once per group, the coordinate conversions are done in loops over blocks of clusters.
+  /// The results are the same as of Transform() w/o reference maps and scaling. Input in arbitrary order is accepted,
+  /// the input already grouped by slice and row (e.g. ClusterNativeAccess) is processed w/o reordering.
+  void TransformBulk(int32_t n, const int32_t* slice, const int32_t* row, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime = 0) const;
+
+  /// Bulk version of TransformInTimeFrame()
+  void TransformInTimeFrameBulk(int32_t n, const int32_t* slice, const int32_t* row, const float* pad, const float* time, float* x, float* y, float* z, float maxTimeBin) const;
+#endif
+
   /// Inverse transformation
   GPUd() void InverseTransformInTimeFrame(int32_t slice, int32_t row, float /*x*/, float y, float z, float& pad, float& time, float maxTimeBin) const;
 
@@ -0,0 +1,211 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_HuffmanCodec.cxx
+/// @brief  compares Huffman and rANS encoding and decoding on ITS and TPC like symbol distributions
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../include/DataCompression/dc_primitives.h"
+#include "../include/DataCompression/HuffmanCodec.h"
+#include "rANS/factory.h"
+#include "rANS/histogram.h"
+
+using namespace o2::data_compression;
+
+inline constexpr size_t MessageSize = 1ull << 22;
+
+/// source message of MessageSize values drawn from a distribution and clamped to the alphabet range [0, MaxSymbol]
+template <uint16_t MaxSymbol>
+class SourceMessage
+{
+ public:
+  static constexpr uint16_t max_symbol = MaxSymbol;
+
+  template <typename Distribution>
+  SourceMessage(Distribution dist) : mSourceMessage(MessageSize)
+  {
+    std::mt19937 mt(0); // same seed we want always the same distribution of random numbers
+    std::generate(mSourceMessage.begin(), mSourceMessage.end(), [&dist, &mt]() {
+      return uint16_t(std::clamp<double>(std::round(dist(mt)), 0, MaxSymbol));
+    });
+  }
+
+  const auto& get() const { return mSourceMessage; }
+
+  /// Shannon entropy in bits per symbol
+  double getEntropy() const
+  {
+    std::vector<size_t> counts(MaxSymbol + 1);
+    for (auto v : mSourceMessage) {
+      counts[v]++;
+    }
+    double entropy = 0.;
+    for (auto c : counts) {
+      if (c > 0) {
+        double p = double(c) / mSourceMessage.size();
+        entropy -= p * std::log2(p);
+      }
+    }
+    return entropy;
+  }
+
+ private:
+  std::vector<uint16_t> mSourceMessage;
+};
+
+// ITS like: row and column increments of the fired pixels
+inline const SourceMessage<255> itsRowInc{std::geometric_distribution<int>(0.3)};
+inline const SourceMessage<1023> itsColInc{std::geometric_distribution<int>(0.05)};
+// TPC like: charge with a long tail and pad residual around the track prediction
+inline const SourceMessage<1023> tpcQTot{std::lognormal_distribution<double>(4., 0.7)};
+inline const SourceMessage<255> tpcPadRes{std::normal_distribution<double>(128., 8.)};
+
+template <uint16_t MaxSymbol>
+using HuffmanModel_t = HuffmanModel<ProbabilityModel<ZeroBoundContiguousAlphabet<uint16_t, MaxSymbol>>, std::bitset<32>, true>;
+
+template <uint16_t MaxSymbol>
+auto makeHuffmanCodec(const std::vector<uint16_t>& values)
+{
+  std::vector<size_t> counts(MaxSymbol + 1);
+  for (auto v : values) {
+    counts[v]++;
+  }
+  HuffmanModel_t<MaxSymbol> model;
+  // pseudo-count for all symbols of the alphabet, keeps the codes of unused symbols within 32 bit
+  model.init(1.);
+  for (uint16_t s = 0; s <= MaxSymbol; s++) {
+    model.addWeight(s, counts[s]);
+  }
+  model.normalize();
+  model.GenerateHuffmanTree();
+  return HuffmanCodec<HuffmanModel_t<MaxSymbol>>(model);
+}
+
+template <typename SourceT>
+void setCounters(benchmark::State& st, const SourceT& source, size_t compressedSize)
+{
+  const auto& inputData = source.get();
+  st.SetItemsProcessed(static_cast<int64_t>(inputData.size()) * static_cast<int64_t>(st.iterations()));
+  st.SetBytesProcessed(static_cast<int64_t>(inputData.size()) * sizeof(uint16_t) * static_cast<int64_t>(st.iterations()));
+  st.counters["Entropy"] = source.getEntropy();
+  st.counters["BitsPerSymbol"] = 8. * compressedSize / inputData.size();
+  st.counters["SourceSize"] = inputData.size() * sizeof(uint16_t);
+  st.counters["CompressedSize"] = compressedSize;
+  st.counters["Compression"] = st.counters["SourceSize"] / static_cast<double>(st.counters["CompressedSize"]);
+  st.counters["CompressionWRTEntropy"] = st.counters["CompressedSize"] / (inputData.size() * st.counters["Entropy"] / 8);
+}
+
+template <typename SourceT>
+void huffmanEncodeBenchmark(benchmark::State& st, const SourceT& source)
+{
+  const auto& inputData = source.get();
+  const auto codec = makeHuffmanCodec<SourceT::max_symbol>(inputData);
+  std::vector<uint32_t> buffer(codec.getMaxEncodedWords(inputData.size()));
+  uint32_t* bufferEnd = buffer.data();
+  size_t nBits = 0;
+  for (auto _ : st) {
+    bufferEnd = codec.Encode(inputData.begin(), inputData.end(), buffer.data(), nBits);
+    benchmark::DoNotOptimize(bufferEnd);
+  }
+  st.counters["MaxCodeLength"] = codec.getCodingModel().getMaxCodeLength();
+  setCounters(st, source, std::distance(buffer.data(), bufferEnd) * sizeof(uint32_t));
+}
+
+template <typename SourceT>
+void huffmanDecodeBenchmark(benchmark::State& st, const SourceT& source)
+{
+  const auto& inputData = source.get();
+  const auto codec = makeHuffmanCodec<SourceT::max_symbol>(inputData);
+  std::vector<uint32_t> buffer;
+  codec.Encode(inputData.begin(), inputData.end(), buffer);
+  std::vector<uint16_t> decoded(inputData.size());
+  for (auto _ : st) {
+    codec.Decode(buffer.data(), buffer.size(), decoded.begin(), decoded.size());
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  if (decoded != inputData) {
+    st.SkipWithError("Missmatch between encoded and decoded Message");
+  }
+  setCounters(st, source, buffer.size() * sizeof(uint32_t));
+}
+
+template <typename SourceT>
+void ransEncodeBenchmark(benchmark::State& st, const SourceT& source)
+{
+  using namespace o2::rans;
+  const auto& inputData = source.get();
+  const auto histogram = makeDenseHistogram::fromSamples(gsl::span<const uint16_t>(inputData));
+  Metrics<uint16_t> metrics{histogram};
+  const auto renormedHistogram = renorm(histogram, metrics, RenormingPolicy::Auto, 10);
+  auto encoder = makeDenseEncoder<>::fromRenormed(renormedHistogram);
+  std::vector<uint32_t> buffer(2 * inputData.size());
+  uint32_t* bufferEnd = buffer.data();
+  for (auto _ : st) {
+    bufferEnd = encoder.process(inputData.data(), inputData.data() + inputData.size(), buffer.data());
+    benchmark::DoNotOptimize(bufferEnd);
+  }
+  setCounters(st, source, std::distance(buffer.data(), bufferEnd) * sizeof(uint32_t));
+}
+
+template <typename SourceT>
+void ransDecodeBenchmark(benchmark::State& st, const SourceT& source)
+{
+  using namespace o2::rans;
+  const auto& inputData = source.get();
+  const auto histogram = makeDenseHistogram::fromSamples(gsl::span<const uint16_t>(inputData));
+  Metrics<uint16_t> metrics{histogram};
+  const auto renormedHistogram = renorm(histogram, metrics, RenormingPolicy::Auto, 10);
+  auto encoder = makeDenseEncoder<>::fromRenormed(renormedHistogram);
+  std::vector<uint32_t> buffer(2 * inputData.size());
+  uint32_t* bufferEnd = encoder.process(inputData.data(), inputData.data() + inputData.size(), buffer.data());
+  auto decoder = makeDecoder<>::fromRenormed(renormedHistogram);
+  std::vector<uint16_t> decoded(inputData.size());
+  for (auto _ : st) {
+    decoder.process(bufferEnd, decoded.data(), inputData.size(), encoder.getNStreams());
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  if (decoded != inputData) {
+    st.SkipWithError("Missmatch between encoded and decoded Message");
+  }
+  setCounters(st, source, std::distance(buffer.data(), bufferEnd) * sizeof(uint32_t));
+}
+
+BENCHMARK_CAPTURE(huffmanEncodeBenchmark, its_rowInc, itsRowInc);
+BENCHMARK_CAPTURE(huffmanEncodeBenchmark, its_colInc, itsColInc);
+BENCHMARK_CAPTURE(huffmanEncodeBenchmark, tpc_qTot, tpcQTot);
+BENCHMARK_CAPTURE(huffmanEncodeBenchmark, tpc_padRes, tpcPadRes);
+
+BENCHMARK_CAPTURE(ransEncodeBenchmark, its_rowInc, itsRowInc);
+BENCHMARK_CAPTURE(ransEncodeBenchmark, its_colInc, itsColInc);
+BENCHMARK_CAPTURE(ransEncodeBenchmark, tpc_qTot, tpcQTot);
+BENCHMARK_CAPTURE(ransEncodeBenchmark, tpc_padRes, tpcPadRes);
+
+BENCHMARK_CAPTURE(huffmanDecodeBenchmark, its_rowInc, itsRowInc);
+BENCHMARK_CAPTURE(huffmanDecodeBenchmark, its_colInc, itsColInc);
+BENCHMARK_CAPTURE(huffmanDecodeBenchmark, tpc_qTot, tpcQTot);
+BENCHMARK_CAPTURE(huffmanDecodeBenchmark, tpc_padRes, tpcPadRes);
+
+BENCHMARK_CAPTURE(ransDecodeBenchmark, its_rowInc, itsRowInc);
+BENCHMARK_CAPTURE(ransDecodeBenchmark, its_colInc, itsColInc);
+BENCHMARK_CAPTURE(ransDecodeBenchmark, tpc_qTot, tpcQTot);
+BENCHMARK_CAPTURE(ransDecodeBenchmark, tpc_padRes, tpcPadRes);
+
+BENCHMARK_MAIN();
@@ -23,6 +23,8 @@
 
 #include <cstdint>
 #include <cerrno>
+#include <algorithm>
+#include <iterator>
 #include <set>
 #include <map>
 #include <vector>
@@ -194,6 +196,47 @@ class HuffmanCodec
     return true;
   }
 
+  /// Encode a sequence of values into a buffer of 32 bit words
+  /// @param first      begin of the value sequence
+  /// @param last       end of the value sequence
+  /// @param buffer     [out] buffer the words are appended to
+  /// @return number of written bits
+  template <typename InputIt>
+  size_t Encode(InputIt first, InputIt last, std::vector<uint32_t>& buffer) const
+  {
+    return mCodingModel.Encode(first, last, buffer);
+  }
+
+  /// Encode a sequence of values into a preallocated buffer of 32 bit words
+  /// @param first      begin of the value sequence
+  /// @param last       end of the value sequence
+  /// @param out        [out] target words, at least getMaxEncodedWords(number of values)
+  /// @param nBits      [out] number of written bits
+  /// @return pointer behind the last written word
+  template <typename InputIt>
+  uint32_t* Encode(InputIt first, InputIt last, uint32_t* out, size_t& nBits) const
+  {
+    return mCodingModel.Encode(first, last, out, nBits);
+  }
+
+  /// Maximum number of words written by the sequence encoder for nValues values
+  size_t getMaxEncodedWords(size_t nValues) const
+  {
+    return mCodingModel.getMaxEncodedWords(nValues);
+  }
+
+  /// Decode a sequence of values from a buffer written by the sequence encoder
+  /// @param buffer     pointer to the encoded words
+  /// @param nWords     number of encoded words
+  /// @param out        output iterator for the decoded values
+  /// @param nValues    number of values to be decoded
+  /// @return number of decoded bits
+  template <typename OutputIt>
+  size_t Decode(const uint32_t* buffer, size_t nWords, OutputIt out, size_t nValues) const
+  {
+    return mCodingModel.Decode(buffer, nWords, out, nValues);
+  }
+
   /// Get the underlying coding model
   model_type const& getCodingModel() const
   {
@@ -225,6 +268,12 @@ class HuffmanCodec
  * @brief Probability model implementing Huffman functionality
  * This is a mixin class which extends the ProbabilityModel base
  *
+ * The generated Huffman codes are canonical, i.e. they are assigned in order of
+ * code length and symbol index. The codes are looked up for encoding from flat
+ * tables, the decoding resolves up to DecodeTableBits code bits with one lookup
+ * in a table indexed by the leading code bits, only longer codes continue by
+ * walking the tree from the node reached after these bits.
+ *
  * TODO:
  * - Alphabet object: right now only a default object of the alphabet is
  *   supported, all functionality needs to be implemented in the type
@@ -232,7 +281,6 @@ class HuffmanCodec
  *   alternatively a struct combining code value and length and assignment operator=
  * - type traits for code_type to provide set and reset functions for primitive
  *   data types
- * - check max length possible by code_type to be compatible with required length
  * - class StorageType as template parameter for Alphabet type
  * - error policy
  */
@@ -248,6 +296,8 @@ class HuffmanModel : public _BASE
   using node_type = HuffmanNode<code_type>;
   using value_type = typename _BASE::value_type;
   static constexpr bool OrderMSB = orderMSB;
+  /// number of code bits resolved by one lookup in the decoding table
+  static constexpr uint16_t DecodeTableBits = 10;
 
   int init(double v = 1.) { return _BASE::initWeight(mAlphabet, v); }
 
@@ -262,10 +312,10 @@ class HuffmanModel : public _BASE
   {
     codeLength = 0;
     auto nodeIndex = _BASE::alphabet_type::getIndex(symbol);
-    if (nodeIndex < mLeaveNodes.size()) {
+    if (nodeIndex < mCodeLengths.size()) {
       // valid symbol/value
-      codeLength = mLeaveNodes[nodeIndex]->getBinaryCodeLength();
-      return mLeaveNodes[nodeIndex]->getBinaryCode();
+      codeLength = mCodeLengths[nodeIndex];
+      return mCodes[nodeIndex];
     } else {
       std::string msg = "symbol ";
       msg += symbol;
@@ -289,48 +339,150 @@ class HuffmanModel : public _BASE
    */
   value_type Decode(code_type code, uint16_t& codeLength) const
   {
-    // TODO: need to check if there is a loaded tree, but don't
-    // want to check this every time when calling. Maybe its enough
-    // to let the dereferencing below throw an exception
     codeLength = 0;
-    typename _BASE::value_type v = 0;
-    // dereference the iterator and get raw pointer from shared pointer
-    // TODO: work on shared pointers here as well
-    // the top node is the only element in the multiset after using the
-    // weighted sort algorithm to build the tree, all nodes are referenced
-    // from their parents in the tree.
-    const node_type* node = (*mTreeNodes.begin()).get();
-    uint16_t codeMSB = code.size() - 1;
-    while (node) {
-      // N.B.: nodes have either both child nodes or none of them
-      if (node->getLeftChild() == nullptr) {
-        // this is a leave node, retrieve value for corresponding index
-        // TODO: validity check for index, this can be done once after
-        // initializing the Huffman configuration, either after training
-        // or loading the configuration
-        return _BASE::alphabet_type::getSymbol(node->getIndex());
-      }
-      if (codeLength > codeMSB) {
-        // the size of the code type is shorter than the Huffman tree length
-        throw std::range_error("code type length insufficient for Huffman tree length");
-        break;
-      }
-      bool bit = false;
-      if (OrderMSB) {
-        bit = code.test(codeMSB - codeLength);
-      } else {
-        bit = code.test(codeLength);
+    if (mDecodeTable.empty()) {
+      // TODO: need to check if there is a loaded tree, but don't
+      // want to check this every time when calling. Maybe its enough
+      // to let the dereferencing below throw an exception
+      return decodeTree((*mTreeNodes.begin()).get(), code, codeLength);
+    }
+    unsigned long tableIndex = 0;
+    if (OrderMSB) {
+      tableIndex = (code >> (code.size() - mDecodeTableBits)).to_ulong();
+    } else {
+      tableIndex = (code & mDecodeTableMask).to_ulong();
+    }
+    auto const& entry = mDecodeTable[tableIndex];
+    if (entry.node == nullptr) {
+      codeLength = entry.length;
+      return entry.symbol;
+    }
+    // code is longer than the bits resolved by the table
+    codeLength = mDecodeTableBits;
+    return decodeTree(entry.node, code, codeLength);
+  }
+
+  /**
+   * Maximum number of 32 bit words written by the sequence encoder for nValues symbols,
+   * including one word for the unconditional store after the last code
+   */
+  size_t getMaxEncodedWords(size_t nValues) const
+  {
+    return (nValues * mMaxCodeLength) / 32 + 2;
+  }
+
+  /**
+   * Encode a sequence of symbols into a preallocated buffer of 32 bit words
+   *
+   * The codes are packed MSB first without gaps, the last word is padded with zeros.
+   * The bit writer does not branch on the word boundaries: the current word is stored
+   * after every code and the output position is advanced only when the word is complete.
+   * Requires MSB ordering and a maximum code length of 32 bit.
+   * @arg first   [in]  begin of the symbol sequence
+   * @arg last    [in]  end of the symbol sequence
+   * @arg out     [OUT] target words, at least getMaxEncodedWords(number of symbols)
+   * @arg nBits   [OUT] number of written bits
+   * @return pointer behind the last written word
+   */
+  template <typename InputIt>
+  uint32_t* Encode(InputIt first, InputIt last, uint32_t* out, size_t& nBits) const
+  {
+    static_assert(OrderMSB, "sequence encoding is implemented for MSB ordering only");
+    checkSequenceCoding();
+    uint64_t bits = 0;
+    unsigned nPending = 0;
+    nBits = 0;
+    out = encodeSequence(first, last, out, bits, nPending, nBits);
+    if (nPending > 0) {
+      *out++ = uint32_t(bits << (32 - nPending));
+    }
+    return out;
+  }
+
+  /**
+   * Encode a sequence of symbols and append the words to the buffer
+   *
+   * The words are written to a chunk on the stack and appended to the buffer, which
+   * thus grows with its usual policy instead of being initialized for the worst case.
+   * @arg first   [in]  begin of the symbol sequence
+   * @arg last    [in]  end of the symbol sequence
+   * @arg buffer  [OUT] target buffer
+   * @return number of written bits
+   */
+  template <typename InputIt>
+  size_t Encode(InputIt first, InputIt last, std::vector<uint32_t>& buffer) const
+  {
+    static_assert(OrderMSB, "sequence encoding is implemented for MSB ordering only");
+    checkSequenceCoding();
+    constexpr size_t ChunkWords = 512;
+    uint32_t chunk[ChunkWords];
+    // symbols of a chunk including the store after the last code
+    const size_t chunkValues = (ChunkWords - 2) * 32 / std::max<uint16_t>(mMaxCodeLength, 1);
+    uint64_t bits = 0;
+    unsigned nPending = 0;
+    size_t nBits = 0;
+    for (size_t nRemaining = std::distance(first, last); nRemaining > 0;) {
+      const size_t n = std::min(nRemaining, chunkValues);
+      auto chunkLast = std::next(first, n);
+      uint32_t* chunkEnd = encodeSequence(first, chunkLast, chunk, bits, nPending, nBits);
+      buffer.insert(buffer.end(), &chunk[0], chunkEnd);
+      first = chunkLast;
+      nRemaining -= n;
+    }
+    if (nPending > 0) {
+      buffer.push_back(uint32_t(bits << (32 - nPending)));
+    }
+    return nBits;
+  }
+
+  /**
+   * Decode a sequence of symbols from a buffer written by the sequence encoder
+   *
+   * The code bits are provided in a 64 bit window holding at least 32 valid bits
+   * before decoding of each symbol.
+   * @arg buffer  [in]  encoded words
+   * @arg nWords  [in]  number of encoded words
+   * @arg out     [OUT] output iterator for the decoded symbols
+   * @arg nValues [in]  number of symbols to be decoded
+   * @return number of decoded bits
+   */
+  template <typename OutputIt>
+  size_t Decode(const uint32_t* buffer, size_t nWords, OutputIt out, size_t nValues) const
+  {
+    static_assert(OrderMSB, "sequence decoding is implemented for MSB ordering only");
+    checkSequenceCoding();
+    const unsigned codeSize = mDecodeTableMask.size();
+    const unsigned windowCodeBits = std::min(codeSize, 32u);
+    const unsigned tableShift = 64 - mDecodeTableBits;
+    uint64_t window = 0;
+    unsigned nValid = 0;
+    size_t position = 0;
+    size_t nBits = 0;
+    for (size_t i = 0; i < nValues; i++) {
+      if (nValid < 32) {
+        window |= uint64_t(position < nWords ? buffer[position] : 0) << (32 - nValid);
+        position++;
+        nValid += 32;
       }
-      ++codeLength;
-      if (bit) {
-        node = node->getLeftChild();
-      } else {
-        node = node->getRightChild();
+      auto const& entry = mDecodeTable[window >> tableShift];
+      uint16_t codeLength = entry.length;
+      value_type symbol = entry.symbol;
+      if (entry.node != nullptr) {
+        code_type code(window >> (64 - windowCodeBits));
+        code <<= codeSize - windowCodeBits;
+        codeLength = mDecodeTableBits;
+        symbol = decodeTree(entry.node, code, codeLength);
       }
+      *out++ = symbol;
+      window <<= codeLength;
+      nValid -= codeLength;
+      nBits += codeLength;
     }
-    return v;
+    return nBits;
   }
 
+  uint16_t getMaxCodeLength() const { return mMaxCodeLength; }
+
   /**
    * 'less' functor used in the multiset for sorting in the order less
    * probable to more probable
@@ -403,6 +555,8 @@ class HuffmanModel : public _BASE
     // dereference iterator and shared_ptr to get the raw pointer
     // TODO: change method to work on shared instead of raw pointers
     assignCode((*mTreeNodes.begin()).get());
+    makeCanonical();
+    buildTables();
     return true;
   }
 
@@ -609,6 +763,7 @@ class HuffmanModel : public _BASE
                 << "; " << treeNodes.size() << " tree nodes(s), expected 1" << std::endl;
     }
     mTreeNodes.insert(treeNodes.begin()->second);
+    buildTables();
     return 0;
   }
 
@@ -625,6 +780,205 @@ class HuffmanModel : public _BASE
   };
 
  private:
+  /// entry of the decoding table, either the resolved symbol or the node reached
+  /// after DecodeTableBits for longer codes
+  struct DecodeTableEntry {
+    const node_type* node = nullptr;
+    value_type symbol = 0;
+    uint16_t length = 0;
+  };
+
+  /// leave node with canonical code
+  struct CanonicalCode {
+    uint16_t length = 0;
+    uint16_t index = 0;
+    uint64_t code = 0;
+  };
+
+  /**
+   * Decode the remaining bits of a code by walking the tree from a node
+   * @arg node        [in]  start node
+   * @arg code        [in]  code bits
+   * @arg codeLength  [IN/OUT] number of decoded bits, initially the depth of the node
+   */
+  value_type decodeTree(const node_type* node, code_type code, uint16_t& codeLength) const
+  {
+    typename _BASE::value_type v = 0;
+    uint16_t codeMSB = code.size() - 1;
+    while (node) {
+      // N.B.: nodes have either both child nodes or none of them
+      if (node->getLeftChild() == nullptr) {
+        // this is a leave node, retrieve value for corresponding index
+        // TODO: validity check for index, this can be done once after
+        // initializing the Huffman configuration, either after training
+        // or loading the configuration
+        return _BASE::alphabet_type::getSymbol(node->getIndex());
+      }
+      if (codeLength > codeMSB) {
+        // the size of the code type is shorter than the Huffman tree length
+        throw std::range_error("code type length insufficient for Huffman tree length");
+        break;
+      }
+      bool bit = false;
+      if (OrderMSB) {
+        bit = code.test(codeMSB - codeLength);
+      } else {
+        bit = code.test(codeLength);
+      }
+      ++codeLength;
+      if (bit) {
+        node = node->getLeftChild();
+      } else {
+        node = node->getRightChild();
+      }
+    }
+    return v;
+  }
+
+  /**
+   * Replace the codes by the canonical codes of the same lengths
+   *
+   * The codes are assigned in order of code length and symbol index and the tree
+   * is rebuilt from them. The codes of the tree are kept for code lengths
+   * exceeding 64 bit.
+   */
+  void makeCanonical()
+  {
+    std::vector<CanonicalCode> codes;
+    for (auto const& leave : mLeaveNodes) {
+      if (!leave) {
+        continue;
+      }
+      if (leave->getBinaryCodeLength() > 64) {
+        return;
+      }
+      codes.push_back({leave->getBinaryCodeLength(), leave->getIndex(), 0});
+    }
+    if (codes.size() < 2) {
+      return;
+    }
+    std::sort(codes.begin(), codes.end(), [](const CanonicalCode& a, const CanonicalCode& b) {
+      return a.length < b.length || (a.length == b.length && a.index < b.index);
+    });
+    uint64_t code = 0;
+    uint16_t length = codes.front().length;
+    for (auto& c : codes) {
+      code <<= c.length - length;
+      length = c.length;
+      c.code = code++;
+    }
+    auto topNode = makeCanonicalNode(codes.begin(), codes.end(), 0);
+    mTreeNodes.clear();
+    mTreeNodes.insert(topNode);
+    assignCode(topNode.get());
+  }
+
+  /// build the (sub)tree for a range of canonical codes sharing the first depth bits
+  template <typename Iterator>
+  std::shared_ptr<node_type> makeCanonicalNode(Iterator first, Iterator last, uint16_t depth)
+  {
+    if (first == last) {
+      return {};
+    }
+    if (std::next(first) == last && first->length == depth) {
+      return mLeaveNodes[first->index];
+    }
+    // canonical codes are in lexicographic order, the '0' branch comes first
+    auto middle = std::partition_point(first, last, [depth](const CanonicalCode& c) {
+      return ((c.code >> (c.length - 1 - depth)) & 0x1) == 0;
+    });
+    // left child is the '1' branch, see assignCode
+    return std::make_shared<node_type>(makeCanonicalNode(middle, last, depth + 1), makeCanonicalNode(first, middle, depth + 1));
+  }
+
+  /// fill the flat encoding tables and the decoding table from the leave nodes and the tree
+  void buildTables()
+  {
+    mCodes.assign(mLeaveNodes.size(), code_type());
+    mCodeLengths.assign(mLeaveNodes.size(), 0);
+    mMaxCodeLength = 0;
+    for (size_t i = 0; i < mLeaveNodes.size(); i++) {
+      if (mLeaveNodes[i]) {
+        mCodes[i] = mLeaveNodes[i]->getBinaryCode();
+        mCodeLengths[i] = mLeaveNodes[i]->getBinaryCodeLength();
+        mMaxCodeLength = std::max(mMaxCodeLength, mCodeLengths[i]);
+      }
+    }
+    mSequenceCodes.clear();
+    if (mMaxCodeLength <= 32) {
+      for (auto const& code : mCodes) {
+        mSequenceCodes.push_back(code.to_ulong());
+      }
+    }
+
+    mDecodeTable.clear();
+    if (mTreeNodes.empty()) {
+      return;
+    }
+    const unsigned codeSize = mDecodeTableMask.size();
+    mDecodeTableBits = std::max<uint16_t>(1, std::min<unsigned>({mMaxCodeLength, DecodeTableBits, codeSize}));
+    mDecodeTableMask = code_type((1ull << mDecodeTableBits) - 1);
+    mDecodeTable.resize(size_t(1) << mDecodeTableBits);
+    const node_type* topNode = (*mTreeNodes.begin()).get();
+    for (size_t tableIndex = 0; tableIndex < mDecodeTable.size(); tableIndex++) {
+      // walk the tree along the code bits of the table index
+      const node_type* node = topNode;
+      uint16_t length = 0;
+      while (node && node->getLeftChild() && length < mDecodeTableBits) {
+        bool bit = false;
+        if (OrderMSB) {
+          bit = (tableIndex >> (mDecodeTableBits - 1 - length)) & 0x1;
+        } else {
+          bit = (tableIndex >> length) & 0x1;
+        }
+        node = bit ? node->getLeftChild() : node->getRightChild();
+        ++length;
+      }
+      auto& entry = mDecodeTable[tableIndex];
+      if (node && node->getLeftChild() == nullptr) {
+        entry.symbol = _BASE::alphabet_type::getSymbol(node->getIndex());
+        entry.length = length;
+      } else {
+        entry.node = node;
+      }
+    }
+  }
+
+  /// Bit writer of the sequence encoder: the completed words are stored at out, the remaining
+  /// nPending < 32 bits are kept in the LSBs of bits for the next call
+  template <typename InputIt>
+  uint32_t* encodeSequence(InputIt first, InputIt last, uint32_t* out, uint64_t& bitsState, unsigned& nPendingState, size_t& nBitsTotal) const
+  {
+    uint64_t bits = bitsState;
+    unsigned nPending = nPendingState;
+    size_t nBits = nBitsTotal;
+    for (; first != last; ++first) {
+      auto nodeIndex = _BASE::alphabet_type::getIndex(*first);
+      if (nodeIndex >= mCodeLengths.size()) {
+        throw std::range_error("symbol not found in alphabet " + std::string(_BASE::getName()));
+      }
+      const auto codeLength = mCodeLengths[nodeIndex];
+      bits = (bits << codeLength) | mSequenceCodes[nodeIndex];
+      nPending += codeLength;
+      nBits += codeLength;
+      const unsigned complete = nPending >= 32;
+      nPending -= 32 * complete;
+      *out = uint32_t(bits >> nPending);
+      out += complete;
+    }
+    bitsState = bits;
+    nPendingState = nPending;
+    nBitsTotal = nBits;
+    return out;
+  }
+
+  void checkSequenceCoding() const
+  {
+    if (mDecodeTable.empty() || mMaxCodeLength > 32) {
+      throw std::range_error("sequence coding requires a Huffman table with code length up to 32 bit");
+    }
+  }
+
   /**
    * @brief Recursive write of the node content.
    *
@@ -658,6 +1012,16 @@ class HuffmanModel : public _BASE
   std::vector<std::shared_ptr<node_type>> mLeaveNodes;
   // multiset, order determined by less functor working on pointers
   std::multiset<std::shared_ptr<node_type>, isless<std::shared_ptr<node_type>>> mTreeNodes;
+  // codes and code lengths indexed by symbol index
+  std::vector<code_type> mCodes;
+  std::vector<uint16_t> mCodeLengths;
+  // codes as plain words for the sequence encoding
+  std::vector<uint32_t> mSequenceCodes;
+  uint16_t mMaxCodeLength = 0;
+  // decoding table indexed by the leading code bits
+  std::vector<DecodeTableEntry> mDecodeTable;
+  uint16_t mDecodeTableBits = 0;
+  code_type mDecodeTableMask = 0;
 };
 
 } // namespace data_compression
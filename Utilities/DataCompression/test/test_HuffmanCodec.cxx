@@ -23,6 +23,8 @@
 #include <iomanip>
 #include <sstream>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 #include <bitset>
 #include <thread>
 #include <stdexcept> // exeptions, runtime_error
@@ -104,6 +106,7 @@ void checkRandom(CodecT& codec, GeneratorT& generator, int nRolls = 1000000)
   std::cout << "... done" << std::endl;
 }
 
+template <bool OrderMSB = true>
 auto setupCodec(int verbosity = 0)
 {
   // defining a contiguous alphabet of integral 16 bit unsigned numbers
@@ -124,7 +127,7 @@ auto setupCodec(int verbosity = 0)
   // third template parameter determines whether code has to be decoded
   // MSB to LSB (true) or LSB to MSB (false)
   using HuffmanModel_t =
-    HuffmanModel<ProbabilityModel<SimpleRangeAlphabet_t>, std::bitset<32>, true>;
+    HuffmanModel<ProbabilityModel<SimpleRangeAlphabet_t>, std::bitset<32>, OrderMSB>;
   HuffmanModel_t huffmanmodel;
 
   huffmanmodel.init(0.);
@@ -204,6 +207,95 @@ BOOST_AUTO_TEST_CASE(test_HuffmanCodec_basic)
   checkRandom(codec, dg);
 }
 
+BOOST_AUTO_TEST_CASE(test_HuffmanCodec_canonical)
+{
+  auto setup = setupCodec();
+  auto& codec = setup.first;
+  auto const& huffmanmodel = codec.getCodingModel();
+  using CodeT = decltype(setup.first)::code_type;
+
+  // canonical codes: codes of same length are consecutive in order of the symbols,
+  // the first code of a length follows the last code of the previous length
+  std::vector<std::pair<uint16_t, int>> codes;
+  for (auto const& i : huffmanmodel) {
+    uint16_t codeLen = 0;
+    CodeT code;
+    codec.Encode(i.first, code, codeLen);
+    codes.emplace_back(codeLen, i.first);
+  }
+  std::sort(codes.begin(), codes.end());
+  uint64_t expected = 0;
+  uint16_t lastLen = codes.front().first;
+  for (auto const& [codeLen, value] : codes) {
+    expected <<= codeLen - lastLen;
+    lastLen = codeLen;
+    uint16_t len = 0;
+    CodeT code;
+    codec.Encode(value, code, len);
+    BOOST_CHECK(code.to_ullong() == expected);
+    expected++;
+  }
+
+  // LSB to MSB order
+  auto setupLSB = setupCodec<false>();
+  checkRandom(setupLSB.first, setupLSB.second);
+}
+
+BOOST_AUTO_TEST_CASE(test_HuffmanCodec_sequence)
+{
+  auto setup = setupCodec();
+  auto& codec = setup.first;
+  auto& dg = setup.second;
+  using ValueT = decltype(setup.first)::value_type;
+  using CodeT = decltype(setup.first)::code_type;
+
+  const size_t nValues = 100000;
+  std::vector<ValueT> values(nValues);
+  size_t nBitsExpected = 0;
+  for (auto& v : values) {
+    v = dg();
+    uint16_t codeLen = 0;
+    CodeT code;
+    codec.Encode(v, code, codeLen);
+    nBitsExpected += codeLen;
+  }
+
+  std::vector<uint32_t> buffer;
+  auto nBits = codec.Encode(values.begin(), values.end(), buffer);
+  BOOST_CHECK(nBits == nBitsExpected);
+  BOOST_CHECK(buffer.size() == (nBits + 31) / 32);
+
+  // the 1st code is in the MSBs of the 1st word
+  uint16_t codeLen = 0;
+  ValueT decodedValue;
+  codec.Decode(decodedValue, CodeT(buffer[0]), codeLen);
+  BOOST_CHECK(decodedValue == values[0]);
+
+  std::vector<ValueT> decoded;
+  auto nDecodedBits = codec.Decode(buffer.data(), buffer.size(), std::back_inserter(decoded), nValues);
+  BOOST_CHECK(nDecodedBits == nBits);
+  BOOST_CHECK(decoded == values);
+
+  // the same words are written to a preallocated buffer
+  std::vector<uint32_t> preallocated(codec.getMaxEncodedWords(nValues));
+  size_t nBitsPrealloc = 0;
+  auto end = codec.Encode(values.begin(), values.end(), preallocated.data(), nBitsPrealloc);
+  BOOST_CHECK(nBitsPrealloc == nBits);
+  BOOST_REQUIRE(size_t(end - preallocated.data()) == buffer.size());
+  BOOST_CHECK(std::equal(buffer.begin(), buffer.end(), preallocated.begin()));
+
+  // the words are appended to the content of the buffer
+  for (size_t n : {size_t(0), size_t(1), size_t(33), size_t(5000)}) {
+    std::vector<uint32_t> appended{0xdeadbeef};
+    auto nBitsAppended = codec.Encode(values.begin(), values.begin() + n, appended);
+    BOOST_CHECK(appended.front() == 0xdeadbeef);
+    BOOST_REQUIRE(appended.size() == 1 + (nBitsAppended + 31) / 32);
+    std::vector<ValueT> decodedAppended;
+    codec.Decode(appended.data() + 1, appended.size() - 1, std::back_inserter(decodedAppended), n);
+    BOOST_CHECK(std::equal(decodedAppended.begin(), decodedAppended.end(), values.begin(), values.begin() + n));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_HuffmanCodec_configuration)
 {
   auto setup = setupCodec();
@@ -76,9 +76,6 @@ struct SymbolTraits<CoderTag::SingleStream> {
   using type = PrecomputedSymbol;
 };
 
-template <typename T>
-struct getStreamingLowerBound;
-
 template <size_t lowerBound_V>
 struct getStreamingLowerBound<CompatEncoderImpl<lowerBound_V>> : public std::integral_constant<size_t, lowerBound_V> {
 };
@@ -101,21 +98,7 @@ struct getStreamingLowerBound<AVXEncoderImpl<lowerBound_V>> : public std::integr
 };
 #endif /* RANS_AVX2 */
 
-template <size_t lowerBound_V>
-struct getStreamingLowerBound<DecoderImpl<lowerBound_V>> : public std::integral_constant<size_t, lowerBound_V> {
-};
-
-template <typename T>
-inline constexpr size_t getStreamingLowerBound_v = getStreamingLowerBound<T>::value;
-
 } // namespace internal
-
-namespace utils
-{
-using internal::getStreamingLowerBound;
-using internal::getStreamingLowerBound_v;
-
-} // namespace utils
 } // namespace o2::rans
 
 #endif /* RANS_INTERNAL_COMMON_TYPETRAITS_H_ */
\ No newline at end of file
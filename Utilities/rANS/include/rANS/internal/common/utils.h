@@ -150,6 +150,13 @@ inline uint32_t safeadd(uint32_t a, uint32_t b)
   return result;
 }
 
+// streaming lower bound (log2) of the coder implementations, specialized with the coders
+template <typename T>
+struct getStreamingLowerBound;
+
+template <typename T>
+inline constexpr size_t getStreamingLowerBound_v = getStreamingLowerBound<T>::value;
+
 } // namespace internal
 
 inline constexpr std::uint8_t operator"" _u8(unsigned long long int value) { return static_cast<uint8_t>(value); };
@@ -160,6 +167,9 @@ inline constexpr std::int16_t operator"" _i16(unsigned long long int value) { re
 
 namespace utils
 {
+using internal::getStreamingLowerBound;
+using internal::getStreamingLowerBound_v;
+
 inline constexpr size_t toBytes(size_t bits) noexcept { return (bits / 8) + (bits % 8 != 0); };
 
 inline constexpr size_t pow2(size_t n) noexcept
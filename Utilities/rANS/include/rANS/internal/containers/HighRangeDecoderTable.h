@@ -60,6 +60,8 @@ class HighRangeDecoderTable
 
   [[nodiscard]] inline size_type getPrecision() const noexcept { return mSymbolTablePrecision; };
 
+  [[nodiscard]] inline const storage_type* data() const noexcept { return mContainer.data(); };
+
  private:
   container_type mContainer{};
   symbol_type mEscapeSymbol{};
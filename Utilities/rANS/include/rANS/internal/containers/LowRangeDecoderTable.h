@@ -67,6 +67,8 @@ class LowRangeDecoderTable
 
   [[nodiscard]] inline size_type getPrecision() const noexcept { return this->mSymbolTable.getPrecision(); };
 
+  [[nodiscard]] inline size_type getAlphabetSize() const noexcept { return this->mSymbolTable.size(); };
+
  private:
   symbolTable_type mSymbolTable;
   internal::ReverseSymbolLookupTable<source_type> mRLUT;
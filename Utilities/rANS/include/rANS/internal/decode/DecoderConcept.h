@@ -22,6 +22,7 @@
 
 #include "rANS/internal/common/utils.h"
 #include "rANS/internal/containers/RenormedHistogram.h"
+#include "rANS/internal/decode/simdKernel.h"
 
 namespace o2::rans
 {
@@ -63,6 +64,14 @@ class DecoderConcept
         throw DecodingError(fmt::format("Invalid number of decoder streams {}", nStreams));
       }
 
+#ifdef RANS_AVX2
+      if constexpr (isSIMDDecodable_v<stream_IT>) {
+        if (processSIMD(inputEnd, outputBegin, messageLength, nStreams, literalsEnd)) {
+          return;
+        }
+      }
+#endif
+
       stream_IT inputIter = inputEnd;
       --inputIter;
       source_IT outputIter = outputBegin;
@@ -125,6 +134,101 @@ class DecoderConcept
  protected:
   symbolTable_type mSymbolTable{};
 
+#ifdef RANS_AVX2
+ private:
+  inline static constexpr size_t SIMDLanes = 4;
+
+  template <typename stream_IT>
+  inline static constexpr bool isSIMDDecodable_v = std::is_pointer_v<stream_IT> &&
+                                                   std::is_same_v<std::remove_cv_t<std::remove_pointer_t<stream_IT>>, uint32_t> &&
+                                                   std::is_same_v<stream_type, uint32_t> &&
+                                                   sizeof(source_type) <= sizeof(uint32_t) &&
+                                                   utils::getStreamingLowerBound_v<coder_type> < 31;
+
+  // interleaved decoding of 4 streams per AVX2 register. The streams are processed in the same order as by the scalar decoder,
+  // so renorming words and literals are consumed in identical order and the output is bit-identical.
+  // The number of registers is a template parameter, so the states of all streams are kept in registers.
+  template <typename stream_IT, typename source_IT, typename literals_IT>
+  bool processSIMD(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, size_t nStreams, literals_IT literalsEnd) const
+  {
+    if (!internal::simd::isSIMDDecodingPreferred(this->mSymbolTable)) {
+      return false;
+    }
+    switch (nStreams / SIMDLanes) {
+      case 2:
+        processSIMDImpl<2>(inputEnd, outputBegin, messageLength, literalsEnd);
+        return true;
+      case 4:
+        processSIMDImpl<4>(inputEnd, outputBegin, messageLength, literalsEnd);
+        return true;
+      case 8:
+        processSIMDImpl<8>(inputEnd, outputBegin, messageLength, literalsEnd);
+        return true;
+      default:
+        return false;
+    }
+  };
+
+  template <size_t nGroups_V, typename stream_IT, typename source_IT, typename literals_IT>
+  void processSIMDImpl(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, literals_IT literalsEnd) const
+  {
+    constexpr size_t nStreams = nGroups_V * SIMDLanes;
+    const uint32_t* streamPosition = inputEnd - 1;
+    source_IT outputIter = outputBegin;
+    literals_IT literalsIter = literalsEnd;
+
+    const size_t precision = this->mSymbolTable.getPrecision();
+    const __m128i precisionVec = _mm_cvtsi64_si128(precision);
+    const __m256i cumulativeMask = _mm256_set1_epi64x(utils::pow2(precision) - 1);
+
+    // the state of stream i is in lane i % 4 of group i / 4
+    __m256i states[nGroups_V];
+    for (auto& state : states) {
+      alignas(32) uint64_t initialStates[SIMDLanes];
+      for (auto& initialState : initialStates) {
+        initialState = static_cast<uint64_t>(streamPosition[0]) | (static_cast<uint64_t>(streamPosition[-1]) << 32);
+        streamPosition -= 2;
+      }
+      state = _mm256_load_si256(reinterpret_cast<const __m256i*>(initialStates));
+    }
+
+    auto lookupGroup = [&, this](__m256i state, uint32_t* sourceSymbols, size_t nLanes, __m256i& frequency, __m256i& symbolCumulative) {
+      const __m256i cumulative = _mm256_and_si256(state, cumulativeMask);
+      const uint32_t escapeMask = internal::simd::lookupSymbols(this->mSymbolTable, cumulative, sourceSymbols, frequency, symbolCumulative);
+      if constexpr (!std::is_null_pointer_v<literals_IT>) {
+        for (uint32_t mask = escapeMask & ((1u << nLanes) - 1); mask != 0; mask &= mask - 1) {
+          sourceSymbols[__builtin_ctz(mask)] = static_cast<uint32_t>(*(--literalsIter));
+        }
+      }
+    };
+
+    const size_t nLoops = messageLength / nStreams;
+    const size_t nLoopRemainder = messageLength % nStreams;
+    uint32_t sourceSymbols[SIMDLanes];
+    __m256i frequency, symbolCumulative;
+
+    for (size_t i = 0; i < nLoops; ++i) {
+      for (auto& state : states) {
+        lookupGroup(state, sourceSymbols, SIMDLanes, frequency, symbolCumulative);
+        state = internal::simd::ransDecode(state, frequency, symbolCumulative, precisionVec, cumulativeMask);
+        streamPosition = internal::simd::ransRenorm<utils::pow2(utils::getStreamingLowerBound_v<coder_type>)>(state, streamPosition);
+        for (size_t lane = 0; lane < SIMDLanes; ++lane) {
+          *outputIter++ = static_cast<source_type>(sourceSymbols[lane]);
+        }
+      }
+    }
+
+    // the remaining symbols are decoded by the first streams, the states are not needed anymore afterwards
+    for (size_t group = 0; group < nGroups_V && nLoopRemainder > group * SIMDLanes; ++group) {
+      const size_t nLanes = std::min(SIMDLanes, nLoopRemainder - group * SIMDLanes);
+      lookupGroup(states[group], sourceSymbols, nLanes, frequency, symbolCumulative);
+      for (size_t lane = 0; lane < nLanes; ++lane) {
+        *outputIter++ = static_cast<source_type>(sourceSymbols[lane]);
+      }
+    }
+  };
+#endif /* RANS_AVX2 */
+
   static_assert(coder_type::getNstreams() == 1, "implementation supports only single stream encoders");
 };
 
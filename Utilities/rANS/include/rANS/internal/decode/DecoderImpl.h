@@ -118,6 +118,10 @@ inline auto DecoderImpl<LowerBound_V>::renorm(state_type state, stream_IT inputI
   return std::make_tuple(state, streamPosition);
 };
 
+template <size_t lowerBound_V>
+struct getStreamingLowerBound<DecoderImpl<lowerBound_V>> : public std::integral_constant<size_t, lowerBound_V> {
+};
+
 } // namespace o2::rans::internal
 
 #endif /* RANS_INTERNAL_DECODE_DECODERIMPL_H_ */
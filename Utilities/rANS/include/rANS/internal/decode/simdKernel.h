@@ -0,0 +1,174 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   simdKernel.h
+/// @brief  Kernels performing interleaved rANS decoding of 4 streams at a time using AVX2.
+
+#ifndef RANS_INTERNAL_DECODE_SIMDKERNEL_H_
+#define RANS_INTERNAL_DECODE_SIMDKERNEL_H_
+
+#include "rANS/internal/common/defines.h"
+
+#ifdef RANS_AVX2
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+
+#include "rANS/internal/common/utils.h"
+#include "rANS/internal/containers/Symbol.h"
+#include "rANS/internal/containers/HighRangeDecoderTable.h"
+#include "rANS/internal/containers/LowRangeDecoderTable.h"
+
+namespace o2::rans::internal::simd
+{
+
+//
+// rans Decode
+//
+// x = D(s,x) = frequency * (x >> precision) + (x & (2^precision - 1)) - cumulative
+inline __m256i ransDecode(__m256i state, __m256i frequency, __m256i cumulative, __m128i precision, __m256i cumulativeMask) noexcept
+{
+  const __m256i quotient = _mm256_srl_epi64(state, precision);
+  // the quotient can exceed 32 Bits for small symbol table precisions, so multiply in two 32 Bit halfs
+  const __m256i productLow = _mm256_mul_epu32(quotient, frequency);
+  const __m256i productHigh = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(quotient, 32), frequency), 32);
+  const __m256i remainder = _mm256_and_si256(state, cumulativeMask);
+  return _mm256_sub_epi64(_mm256_add_epi64(_mm256_add_epi64(productLow, productHigh), remainder), cumulative);
+};
+
+// For each 4 Bit renorming mask: the lanes of the words to load from the (up to) 4 words preceding and including the current stream position,
+// and the permutation which moves the word read by each renormed stream into its lane. Streams read in the order of their lanes, like the scalar decoder.
+struct alignas(16) RenormLUTEntry {
+  std::array<int32_t, 4> loadMask;
+  std::array<int32_t, 4> permutation;
+};
+
+inline constexpr std::array<RenormLUTEntry, 16> RenormLUT = []() {
+  std::array<RenormLUTEntry, 16> lut{};
+  for (uint32_t mask = 0; mask < 16; ++mask) {
+    uint32_t nRenorms = 0;
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      lut[mask].permutation[lane] = 3 - nRenorms;
+      nRenorms += (mask >> lane) & 0x1;
+    }
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      lut[mask].loadMask[lane] = lane >= 4 - nRenorms ? -1 : 0;
+    }
+  }
+  return lut;
+}();
+
+//
+// rans Renorm
+//
+// every state below the lower bound reads the next 32 Bit word from the stream, the words are read backwards in the order of the lanes.
+// The masked load only touches the words which are actually read, so it never reads beyond the stream.
+template <uint64_t lowerBound_V>
+inline const uint32_t* ransRenorm(__m256i& state, const uint32_t* streamPosition) noexcept
+{
+  static_assert(lowerBound_V < utils::pow2(31), "states are compared as signed 64 Bit integers");
+
+  const __m256i renormMask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(lowerBound_V), state);
+  const uint32_t mask = _mm256_movemask_pd(_mm256_castsi256_pd(renormMask));
+  const auto& lut = RenormLUT[mask];
+
+  const __m128i loadMask = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.loadMask.data()));
+  const __m128i permutation = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.permutation.data()));
+  const __m128i words = _mm_maskload_epi32(reinterpret_cast<const int*>(streamPosition - 3), loadMask);
+  const __m128i streamWords = _mm_castps_si128(_mm_permutevar_ps(_mm_castsi128_ps(words), permutation));
+
+  const __m256i renormedState = _mm256_or_si256(_mm256_slli_epi64(state, 32), _mm256_cvtepu32_epi64(streamWords));
+  state = _mm256_blendv_epi8(state, renormedState, renormMask);
+  return streamPosition - _mm_popcnt_u32(mask);
+};
+
+//
+// Symbol lookup
+//
+// generic lookup of the symbols of 4 lanes, returns the mask of lanes with an escape symbol
+template <typename symbolTable_T>
+inline uint32_t lookupSymbols(const symbolTable_T& symbolTable, __m256i cumulative, uint32_t* __restrict__ sourceSymbols, __m256i& frequency, __m256i& symbolCumulative) noexcept
+{
+  alignas(32) uint64_t cumul[4];
+  uint64_t symbols[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(cumul), cumulative);
+
+  uint32_t escapeMask = 0;
+  for (size_t lane = 0; lane < 4; ++lane) {
+    if (symbolTable.isEscapeSymbol(cumul[lane])) {
+      const auto& escapeSymbol = symbolTable.getEscapeSymbol();
+      symbols[lane] = escapeSymbol.getFrequency() | (static_cast<uint64_t>(escapeSymbol.getCumulative()) << 32);
+      escapeMask |= 1u << lane;
+    } else {
+      const auto [sourceSymbol, symbol] = symbolTable[cumul[lane]];
+      sourceSymbols[lane] = static_cast<uint32_t>(sourceSymbol);
+      symbols[lane] = symbol.getFrequency() | (static_cast<uint64_t>(symbol.getCumulative()) << 32);
+    }
+  }
+  // assembled from registers, a vector load would stall on forwarding the scalar stores
+  const __m256i symbolVec = _mm256_setr_epi64x(symbols[0], symbols[1], symbols[2], symbols[3]);
+  frequency = _mm256_and_si256(symbolVec, _mm256_set1_epi64x(0xFFFFFFFFull));
+  symbolCumulative = _mm256_srli_epi64(symbolVec, 32);
+  return escapeMask;
+};
+
+// the high range decoder table stores the decoder symbols of all cumulative frequencies in one flat array,
+// so the symbols can be gathered directly
+template <typename source_T>
+inline uint32_t lookupSymbols(const HighRangeDecoderTable<source_T>& symbolTable, __m256i cumulative, uint32_t* __restrict__ sourceSymbols, __m256i& frequency, __m256i& symbolCumulative) noexcept
+{
+  using decoderSymbol_type = DecoderSymbol<source_T>;
+  static_assert(sizeof(source_T) <= sizeof(uint32_t));
+  static_assert(sizeof(Symbol) == sizeof(uint64_t));
+  constexpr size_t SymbolOffset = sizeof(decoderSymbol_type) - sizeof(Symbol);
+
+  const __m256i escapeLanes = _mm256_cmpgt_epi64(cumulative, _mm256_set1_epi64x(static_cast<int64_t>(symbolTable.size()) - 1));
+  const __m256i validLanes = _mm256_xor_si256(escapeLanes, _mm256_set1_epi64x(-1));
+  const __m256i byteOffsets = _mm256_mul_epu32(cumulative, _mm256_set1_epi64x(sizeof(decoderSymbol_type)));
+  const auto* base = reinterpret_cast<const char*>(symbolTable.data());
+
+  const auto& escapeSymbol = symbolTable.getEscapeSymbol();
+  const __m256i escapeVec = _mm256_set1_epi64x(escapeSymbol.getFrequency() | (static_cast<uint64_t>(escapeSymbol.getCumulative()) << 32));
+  const __m256i symbolVec = _mm256_mask_i64gather_epi64(escapeVec, reinterpret_cast<const long long*>(base + SymbolOffset), byteOffsets, validLanes, 1);
+  // reads the 32 Bit word starting at the source symbol, the bytes beyond the source symbol are padding and discarded later
+  const __m128i validLanes32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(validLanes, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7)));
+  const __m128i sourceSymbolVec = _mm256_mask_i64gather_epi32(_mm_setzero_si128(), reinterpret_cast<const int*>(base), byteOffsets, validLanes32, 1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sourceSymbols), sourceSymbolVec);
+
+  frequency = _mm256_and_si256(symbolVec, _mm256_set1_epi64x(0xFFFFFFFFull));
+  symbolCumulative = _mm256_srli_epi64(symbolVec, 32);
+  return _mm256_movemask_pd(_mm256_castsi256_pd(escapeLanes));
+};
+
+//
+// Decoder selection
+//
+// With few interleaved streams the SIMD decoder has less independent work in flight than the scalar decoder and is slower
+// as long as the decoder tables are cache resident. For large alphabets the branchless SIMD decoder keeps overlapping
+// the cache misses of the table lookups and wins.
+template <typename source_T>
+inline bool isSIMDDecodingPreferred(const LowRangeDecoderTable<source_T>& symbolTable) noexcept
+{
+  return symbolTable.getAlphabetSize() >= utils::pow2(14);
+};
+
+template <typename source_T>
+inline bool isSIMDDecodingPreferred(const HighRangeDecoderTable<source_T>& symbolTable) noexcept
+{
+  return symbolTable.getPrecision() >= 16;
+};
+
+} // namespace o2::rans::internal::simd
+
+#endif /* RANS_AVX2 */
+#endif /* RANS_INTERNAL_DECODE_SIMDKERNEL_H_ */
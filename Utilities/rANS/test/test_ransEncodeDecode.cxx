@@ -144,6 +144,44 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, test_types, testCase_types)
   BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), encodeString.begin(), encodeString.end());
 };
 
+using decodePath_types = boost::mp11::mp_product<boost::mp11::mp_list, coder_types, boost::mp11::mp_list<uint8_t, int16_t, int32_t>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_decodeStreamPointer, test_types, decodePath_types)
+{
+  // decoding from a raw stream pointer can take the interleaved SIMD path, it has to give the same result as decoding through an iterator.
+  // int32_t gives a high range decoder table, uint8_t (small alphabet, always scalar) and int16_t low range tables. Only a part of the message
+  // is used to build the dictionary, so the remaining symbols are stored as literals. The message length is not a multiple of the number of streams.
+  using coder_type = boost::mp11::mp_at_c<test_types, 0>;
+  using source_type = boost::mp11::mp_at_c<test_types, 1>;
+  using stream_type = uint32_t;
+  constexpr CoderTag coderTag = coder_type::value;
+
+  std::vector<source_type> message;
+  const int64_t range = std::is_same_v<source_type, int32_t> ? 1 << 20 : std::numeric_limits<source_type>::max();
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+  for (size_t i = 0; i < 100003; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    const auto r = static_cast<int64_t>((seed >> 33) % 1021) * static_cast<int64_t>((seed >> 13) % 1021);
+    message.push_back(static_cast<source_type>(r % range));
+  }
+
+  auto renormed = renorm(makeDenseHistogram::fromSamples(message.begin(), message.begin() + message.size() / 2), 20, RenormingPolicy::ForceIncompressible);
+  auto encoder = makeDenseEncoder<coderTag>::fromRenormed(renormed);
+  auto decoder = makeDecoder<>::fromRenormed(renormed);
+
+  std::vector<source_type> literals(message.size());
+  std::vector<stream_type> encodeBuffer(2 * message.size());
+  auto [encodeBufferEnd, literalsEnd] = encoder.process(message.begin(), message.end(), encodeBuffer.begin(), literals.begin());
+
+  std::vector<source_type> decodeIter(message.size());
+  decoder.process(encodeBufferEnd, decodeIter.begin(), message.size(), encoder.getNStreams(), literalsEnd);
+  BOOST_CHECK_EQUAL_COLLECTIONS(decodeIter.begin(), decodeIter.end(), message.begin(), message.end());
+
+  std::vector<source_type> decodePtr(message.size());
+  decoder.process(encodeBuffer.data() + std::distance(encodeBuffer.begin(), encodeBufferEnd), decodePtr.data(), message.size(), encoder.getNStreams(), literals.data() + std::distance(literals.begin(), literalsEnd));
+  BOOST_CHECK_EQUAL_COLLECTIONS(decodePtr.begin(), decodePtr.end(), message.begin(), message.end());
+};
+
 #ifndef RANS_SINGLE_STREAM
 BOOST_AUTO_TEST_CASE(test_NoSingleStream)
 {